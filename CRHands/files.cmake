@@ -10,10 +10,18 @@ set(module_headers
 )
 
 set(source_src
+    "${PROJECT_SOURCE_DIR}/src/headless_runner.cpp"
+    "${PROJECT_SOURCE_DIR}/src/headless_runner.hpp"
+    "${PROJECT_SOURCE_DIR}/src/latency_pulse_source.cpp"
+    "${PROJECT_SOURCE_DIR}/src/latency_pulse_source.hpp"
     "${PROJECT_SOURCE_DIR}/src/local_user.cpp"
     "${PROJECT_SOURCE_DIR}/src/local_user.hpp"
     "${PROJECT_SOURCE_DIR}/src/main.cpp"
     "${PROJECT_SOURCE_DIR}/src/main.hpp"
+    "${PROJECT_SOURCE_DIR}/src/performance_suite.cpp"
+    "${PROJECT_SOURCE_DIR}/src/performance_suite.hpp"
+    "${PROJECT_SOURCE_DIR}/src/session_capture.cpp"
+    "${PROJECT_SOURCE_DIR}/src/session_capture.hpp"
     "${PROJECT_SOURCE_DIR}/src/user.cpp"
     "${PROJECT_SOURCE_DIR}/src/user.hpp"
 )
@@ -22,32 +30,97 @@ set(source_main_gui
     "${PROJECT_SOURCE_DIR}/src/main_gui/hand_mocap_gui.cpp"
     "${PROJECT_SOURCE_DIR}/src/main_gui/main_gui.hpp"
     "${PROJECT_SOURCE_DIR}/src/main_gui/main_gui.cpp"
+    "${PROJECT_SOURCE_DIR}/src/main_gui/performance_gui.cpp"
+    "${PROJECT_SOURCE_DIR}/src/main_gui/session_gui.cpp"
+    "${PROJECT_SOURCE_DIR}/src/main_gui/soma_cube_gui.cpp"
 )
 
 set(source_hand
     "${PROJECT_SOURCE_DIR}/src/hand/hand.cpp"
     "${PROJECT_SOURCE_DIR}/src/hand/hand.hpp"
+    "${PROJECT_SOURCE_DIR}/src/hand/contact_view.cpp"
+    "${PROJECT_SOURCE_DIR}/src/hand/contact_view.hpp"
+    "${PROJECT_SOURCE_DIR}/src/hand/force_feedback_controller.cpp"
+    "${PROJECT_SOURCE_DIR}/src/hand/force_feedback_controller.hpp"
+    "${PROJECT_SOURCE_DIR}/src/hand/grasp_detection.cpp"
+    "${PROJECT_SOURCE_DIR}/src/hand/grasp_detection.hpp"
+    "${PROJECT_SOURCE_DIR}/src/hand/grasp_ownership.cpp"
+    "${PROJECT_SOURCE_DIR}/src/hand/grasp_ownership.hpp"
+    "${PROJECT_SOURCE_DIR}/src/hand/grasp_ownership_memory.cpp"
+    "${PROJECT_SOURCE_DIR}/src/hand/grasp_ownership_memory.hpp"
     "${PROJECT_SOURCE_DIR}/src/hand/hand_manager.hpp"
     "${PROJECT_SOURCE_DIR}/src/hand/hand_manager.cpp"
+    "${PROJECT_SOURCE_DIR}/src/hand/hand_device_session.cpp"
+    "${PROJECT_SOURCE_DIR}/src/hand/hand_device_session.hpp"
+    "${PROJECT_SOURCE_DIR}/src/hand/hand_kinematics.cpp"
+    "${PROJECT_SOURCE_DIR}/src/hand/hand_kinematics.hpp"
     "${PROJECT_SOURCE_DIR}/src/hand/hand_leap.cpp"
     "${PROJECT_SOURCE_DIR}/src/hand/hand_leap.hpp"
+    "${PROJECT_SOURCE_DIR}/src/hand/hand_registry.cpp"
+    "${PROJECT_SOURCE_DIR}/src/hand/hand_registry.hpp"
+    "${PROJECT_SOURCE_DIR}/src/hand/hand_retarget.cpp"
+    "${PROJECT_SOURCE_DIR}/src/hand/hand_retarget.hpp"
+    "${PROJECT_SOURCE_DIR}/src/hand/hand_state_snapshot.cpp"
+    "${PROJECT_SOURCE_DIR}/src/hand/hand_state_snapshot.hpp"
+    "${PROJECT_SOURCE_DIR}/src/hand/hand_topology.hpp"
     "${PROJECT_SOURCE_DIR}/src/hand/hand_hand_mocap.cpp"
     "${PROJECT_SOURCE_DIR}/src/hand/hand_unist_mocap.cpp"
     "${PROJECT_SOURCE_DIR}/src/hand/hand_listener.cpp"
+    "${PROJECT_SOURCE_DIR}/src/hand/hand_ownership.cpp"
+    "${PROJECT_SOURCE_DIR}/src/hand/hand_force_feedback.cpp"
 )
 
 set(source_object
     "${PROJECT_SOURCE_DIR}/src/object/base_object.cpp"
     "${PROJECT_SOURCE_DIR}/src/object/soma_cube.cpp"
+    "${PROJECT_SOURCE_DIR}/src/object/soma_cube.hpp"
+    "${PROJECT_SOURCE_DIR}/src/object/soma_solver.cpp"
+    "${PROJECT_SOURCE_DIR}/src/object/soma_solver.hpp"
 	"${PROJECT_SOURCE_DIR}/src/object/jewelry.cpp"
 	"${PROJECT_SOURCE_DIR}/src/object/jewelry.hpp"
 	"${PROJECT_SOURCE_DIR}/src/object/twisty_puzzle.cpp"
 	"${PROJECT_SOURCE_DIR}/src/object/twisty_puzzle.hpp"
+	"${PROJECT_SOURCE_DIR}/src/object/twisty_puzzle_state.cpp"
+	"${PROJECT_SOURCE_DIR}/src/object/twisty_puzzle_state.hpp"
 )
 
 set(source_util
     "${PROJECT_SOURCE_DIR}/src/util/math.hpp"
     "${PROJECT_SOURCE_DIR}/src/util/math.cpp"
+    "${PROJECT_SOURCE_DIR}/src/util/allocation_counter.hpp"
+    "${PROJECT_SOURCE_DIR}/src/util/allocation_counter.cpp"
+    "${PROJECT_SOURCE_DIR}/src/util/forward_kinematics.hpp"
+    "${PROJECT_SOURCE_DIR}/src/util/forward_kinematics.cpp"
+    "${PROJECT_SOURCE_DIR}/src/util/frame_arena.hpp"
+    "${PROJECT_SOURCE_DIR}/src/util/frame_arena.cpp"
+    "${PROJECT_SOURCE_DIR}/src/util/haptic_output_queue.hpp"
+    "${PROJECT_SOURCE_DIR}/src/util/haptic_output_queue.cpp"
+    "${PROJECT_SOURCE_DIR}/src/util/haptic_renderer.hpp"
+    "${PROJECT_SOURCE_DIR}/src/util/haptic_renderer.cpp"
+    "${PROJECT_SOURCE_DIR}/src/util/hinge_solver.hpp"
+    "${PROJECT_SOURCE_DIR}/src/util/hinge_solver.cpp"
+    "${PROJECT_SOURCE_DIR}/src/util/jerk_meter.hpp"
+    "${PROJECT_SOURCE_DIR}/src/util/jerk_meter.cpp"
+    "${PROJECT_SOURCE_DIR}/src/util/joint_write_cache.hpp"
+    "${PROJECT_SOURCE_DIR}/src/util/joint_write_cache.cpp"
+    "${PROJECT_SOURCE_DIR}/src/util/latency_probe.hpp"
+    "${PROJECT_SOURCE_DIR}/src/util/latency_probe.cpp"
+    "${PROJECT_SOURCE_DIR}/src/util/latest_value_mailbox.hpp"
+    "${PROJECT_SOURCE_DIR}/src/util/performance_monitor.hpp"
+    "${PROJECT_SOURCE_DIR}/src/util/performance_monitor.cpp"
+    "${PROJECT_SOURCE_DIR}/src/util/performance_report.hpp"
+    "${PROJECT_SOURCE_DIR}/src/util/performance_report.cpp"
+    "${PROJECT_SOURCE_DIR}/src/util/pose_resampler.hpp"
+    "${PROJECT_SOURCE_DIR}/src/util/pose_resampler.cpp"
+    "${PROJECT_SOURCE_DIR}/src/util/rigid_transform.hpp"
+    "${PROJECT_SOURCE_DIR}/src/util/rigid_transform.cpp"
+    "${PROJECT_SOURCE_DIR}/src/util/sample_ring_buffer.hpp"
+    "${PROJECT_SOURCE_DIR}/src/util/session_log.hpp"
+    "${PROJECT_SOURCE_DIR}/src/util/session_log.cpp"
+    "${PROJECT_SOURCE_DIR}/src/util/session_verifier.hpp"
+    "${PROJECT_SOURCE_DIR}/src/util/session_verifier.cpp"
+    "${PROJECT_SOURCE_DIR}/src/util/stage_profiler.hpp"
+    "${PROJECT_SOURCE_DIR}/src/util/stage_profiler.cpp"
 )
 
 # grouping
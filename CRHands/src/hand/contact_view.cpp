@@ -0,0 +1,37 @@
+/**
+* Coexistence Reality Software Framework (CRSF)
+* Copyright (c) Center of Human-centered Interaction for Coexistence. All rights reserved.
+* See the LICENSE.md file for more details.
+*/
+
+#include "contact_view.hpp"
+
+#include <crsf/CRModel/TCRModel.h>
+#include <crsf/CRModel/TPhysicsModel.h>
+#include <crsf/CRModel/THandPhysicsInteractor.h>
+
+void ContactView::assign(crsf::TCRModel* model)
+{
+    contacts_.clear();
+    interactor_count_ = 0;
+
+    // bind by const reference, so shared pointers are not copied
+    for (const auto& contacted_model : model->GetPhysicsModel()->GetContactInfo()->GetContactedModel())
+    {
+        crsf::TCRModel* contacted = contacted_model.get();
+        if (contacted->GetModelGroup() == crsf::EMODEL_GROUP_HANDPHYSICSINTERACTOR)
+        {
+            contacts_.push_back(Contact{ contacted, to_interactor(contacted), CONTACT_KIND_HAND_INTERACTOR });
+            ++interactor_count_;
+        }
+        else
+        {
+            contacts_.push_back(Contact{ contacted, nullptr, CONTACT_KIND_OTHER });
+        }
+    }
+}
+
+crsf::THandPhysicsInteractor* ContactView::to_interactor(crsf::TCRModel* model)
+{
+    return static_cast<crsf::THandPhysicsInteractor*>(model);
+}
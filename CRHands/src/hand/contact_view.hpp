@@ -0,0 +1,84 @@
+/**
+* Coexistence Reality Software Framework (CRSF)
+* Copyright (c) Center of Human-centered Interaction for Coexistence. All rights reserved.
+* See the LICENSE.md file for more details.
+*/
+
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+namespace crsf {
+class TCRModel;
+class THandPhysicsInteractor;
+}
+
+/**
+ * Non-owning view of contacted models of one physics model.
+ *
+ * Contacts are copied once as raw pointers with a kind tag, and hand physics interactors are
+ * resolved by model group instead of dynamic cast. So iterating the view has no refcount
+ * change and no RTTI. Pointers are valid in the physics step which built the view.
+ */
+class ContactView
+{
+public:
+    enum ContactKind : uint8_t
+    {
+        CONTACT_KIND_OTHER = 0,
+        CONTACT_KIND_HAND_INTERACTOR,
+    };
+
+    struct Contact
+    {
+        crsf::TCRModel* model;
+        crsf::THandPhysicsInteractor* interactor;   ///< nullptr if kind is not CONTACT_KIND_HAND_INTERACTOR
+        ContactKind kind;
+    };
+
+public:
+    /** Rebuild from contacts of @a model. Memory is reused between calls. */
+    void assign(crsf::TCRModel* model);
+
+    const Contact* begin() const;
+    const Contact* end() const;
+    std::size_t size() const;
+    bool empty() const;
+
+    int get_interactor_count() const;
+
+    /** Cast without RTTI. @a model should be in EMODEL_GROUP_HANDPHYSICSINTERACTOR group. */
+    static crsf::THandPhysicsInteractor* to_interactor(crsf::TCRModel* model);
+
+private:
+    std::vector<Contact> contacts_;
+    int interactor_count_ = 0;
+};
+
+// ************************************************************************************************
+
+inline const ContactView::Contact* ContactView::begin() const
+{
+    return contacts_.data();
+}
+
+inline const ContactView::Contact* ContactView::end() const
+{
+    return contacts_.data() + contacts_.size();
+}
+
+inline std::size_t ContactView::size() const
+{
+    return contacts_.size();
+}
+
+inline bool ContactView::empty() const
+{
+    return contacts_.empty();
+}
+
+inline int ContactView::get_interactor_count() const
+{
+    return interactor_count_;
+}
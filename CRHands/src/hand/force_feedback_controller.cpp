@@ -0,0 +1,101 @@
+/**
+* Coexistence Reality Software Framework (CRSF)
+* Copyright (c) Center of Human-centered Interaction for Coexistence. All rights reserved.
+* See the LICENSE.md file for more details.
+*/
+
+#include "force_feedback_controller.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+ForceFeedbackController::ForceFeedbackController(const Parameters& params) : params_(params)
+{
+    thread_ = std::thread(&ForceFeedbackController::run, this);
+}
+
+ForceFeedbackController::~ForceFeedbackController()
+{
+    is_running_.store(false);
+    if (thread_.joinable())
+        thread_.join();
+}
+
+void ForceFeedbackController::post_contacts(const ContactInput& input)
+{
+    input_mailbox_.write(input);
+}
+
+bool ForceFeedbackController::read_output(Command& command)
+{
+    return output_mailbox_.read(command);
+}
+
+bool ForceFeedbackController::read_command(Command& command)
+{
+    return command_mailbox_.read(command);
+}
+
+void ForceFeedbackController::run()
+{
+    using clock = std::chrono::steady_clock;
+
+    auto deadline = clock::now() + params_.period;
+    auto last_tick_time = clock::now();
+
+    while (is_running_.load(std::memory_order_relaxed))
+    {
+        std::this_thread::sleep_until(deadline);
+
+        const auto now = clock::now();
+        const auto interval = now - last_tick_time;
+        last_tick_time = now;
+
+        const auto jitter = std::chrono::duration_cast<std::chrono::nanoseconds>(interval - params_.period).count();
+        jitter_histogram_.record(static_cast<uint64_t>(std::abs(jitter)));
+
+        if (now - deadline > params_.period)
+        {
+            deadline_miss_count_.fetch_add(1, std::memory_order_relaxed);
+
+            // restart schedule instead of bursting missed ticks
+            deadline = now;
+        }
+
+        tick(now, std::chrono::duration<float>(interval).count());
+        tick_count_.fetch_add(1, std::memory_order_relaxed);
+
+        deadline += params_.period;
+    }
+}
+
+void ForceFeedbackController::tick(std::chrono::steady_clock::time_point now, float dt)
+{
+    input_mailbox_.read(input_);
+
+    const bool is_stale = now - input_.time > params_.input_timeout;
+    const float max_step = params_.max_rate * dt;
+
+    for (int hand = 0; hand < HAND_COUNT; ++hand)
+    {
+        for (int finger = 0; finger < FINGER_COUNT; ++finger)
+        {
+            const float depth = is_stale ? 0.0f : input_.depths[hand][finger];
+            const float depth_velocity = dt > 0.0f ? (depth - last_depths_[hand][finger]) / dt : 0.0f;
+            last_depths_[hand][finger] = depth;
+
+            float target = 0.0f;
+            if (depth > 0.0f)
+                target = (std::max)(0.0f, (std::min)(params_.stiffness * depth + params_.damping * depth_velocity, 1.0f));
+
+            // limit rate, so the device does not jerk on contact noise
+            float& resistance = command_.resistances[hand][finger];
+            resistance += (std::max)(-max_step, (std::min)(target - resistance, max_step));
+        }
+    }
+
+    command_.tick = tick_count_.load(std::memory_order_relaxed);
+
+    output_mailbox_.write(command_);
+    command_mailbox_.write(command_);
+}
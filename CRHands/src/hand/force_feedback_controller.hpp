@@ -0,0 +1,120 @@
+/**
+* Coexistence Reality Software Framework (CRSF)
+* Copyright (c) Center of Human-centered Interaction for Coexistence. All rights reserved.
+* See the LICENSE.md file for more details.
+*/
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <thread>
+
+#include "util/latest_value_mailbox.hpp"
+#include "util/stage_profiler.hpp"
+
+/**
+ * Force-feedback controller of kinesthetic hand exoskeleton.
+ *
+ * Physics step posts penetration depth of each fingertip to a mailbox, and the controller
+ * thread turns it to joint resistance in [0, 1] at fixed rate:
+ * resistance = stiffness * depth + damping * (depth velocity), limited by max_rate per second.
+ * If contact input is older than input_timeout, resistance is released (physics stopped or stalled).
+ *
+ * The newest command is posted to an output mailbox, and a publishing thread (main thread)
+ * sends it to the device at its own bounded rate. Another mailbox keeps the newest command
+ * for monitoring. So the controller never touches shared stage memory, and rendering and
+ * physics never wait for the device.
+ */
+class ForceFeedbackController
+{
+public:
+    static constexpr int HAND_COUNT = 2;
+    static constexpr int FINGER_COUNT = 5;
+
+    using FingerValues = std::array<std::array<float, FINGER_COUNT>, HAND_COUNT>;
+
+    struct ContactInput
+    {
+        FingerValues depths;                    ///< meters
+        std::chrono::steady_clock::time_point time;
+    };
+
+    struct Command
+    {
+        FingerValues resistances;               ///< [0, 1]
+        uint64_t tick;
+    };
+
+    struct Parameters
+    {
+        std::chrono::microseconds period = std::chrono::microseconds(2000);
+        float stiffness = 100.0f;               ///< 1 / meters
+        float damping = 0.5f;                   ///< seconds / meters
+        float max_rate = 20.0f;                 ///< resistance change per second
+        std::chrono::milliseconds input_timeout = std::chrono::milliseconds(100);
+    };
+
+public:
+    explicit ForceFeedbackController(const Parameters& params);
+    ~ForceFeedbackController();
+
+    ForceFeedbackController(const ForceFeedbackController&) = delete;
+    ForceFeedbackController& operator=(const ForceFeedbackController&) = delete;
+
+    /** Called from physics thread only. */
+    void post_contacts(const ContactInput& input);
+
+    /** Newest command to send to the device. Called from one publishing thread only. */
+    bool read_output(Command& command);
+
+    /** Newest command. Called from one monitoring thread only. */
+    bool read_command(Command& command);
+
+    uint64_t get_tick_count() const;
+    uint64_t get_deadline_miss_count() const;
+
+    /** Difference of tick interval from period. */
+    const StageHistogram& get_jitter_histogram() const;
+
+private:
+    void run();
+    void tick(std::chrono::steady_clock::time_point now, float dt);
+
+    const Parameters params_;
+
+    LatestValueMailbox<ContactInput> input_mailbox_;
+    LatestValueMailbox<Command> output_mailbox_;
+    LatestValueMailbox<Command> command_mailbox_;
+
+    // used by controller thread only
+    ContactInput input_ = {};
+    FingerValues last_depths_ = {};
+    Command command_ = {};
+
+    std::atomic<uint64_t> tick_count_{ 0 };
+    std::atomic<uint64_t> deadline_miss_count_{ 0 };
+    StageHistogram jitter_histogram_;
+
+    std::atomic<bool> is_running_{ true };
+    std::thread thread_;
+};
+
+// ************************************************************************************************
+
+inline uint64_t ForceFeedbackController::get_tick_count() const
+{
+    return tick_count_.load(std::memory_order_relaxed);
+}
+
+inline uint64_t ForceFeedbackController::get_deadline_miss_count() const
+{
+    return deadline_miss_count_.load(std::memory_order_relaxed);
+}
+
+inline const StageHistogram& ForceFeedbackController::get_jitter_histogram() const
+{
+    return jitter_histogram_;
+}
@@ -0,0 +1,81 @@
+/**
+* Coexistence Reality Software Framework (CRSF)
+* Copyright (c) Center of Human-centered Interaction for Coexistence. All rights reserved.
+* See the LICENSE.md file for more details.
+*/
+
+#include "grasp_detection.hpp"
+
+#include <crsf/CRModel/TCRModel.h>
+#include <crsf/CRModel/THandPhysicsInteractor.h>
+
+#include "hand/hand_topology.hpp"
+
+namespace {
+
+constexpr float OPPOSING_COS_ANGLE = -0.7f;
+
+}
+
+bool is_grasping(crsf::TCRModel* const* contacted_children, std::size_t count)
+{
+    for (std::size_t i = 0; i < count; ++i)
+    {
+        const auto& particles = contacted_children[i]->contacted_physics_particle;
+        for (std::size_t j = 0; j < particles.size(); ++j)
+        {
+            const LVecBase3 direction_1 = particles[j]->GetPenetrationDirection();
+            for (std::size_t k = j; k < particles.size(); ++k)
+            {
+                if (direction_1.dot(particles[k]->GetPenetrationDirection()) < OPPOSING_COS_ANGLE)
+                    return true;
+            }
+        }
+    }
+
+    return false;
+}
+
+int find_grasping_side(crsf::THandPhysicsInteractor* const* interactors, std::size_t count)
+{
+    int grasping_side = -1;
+    for (std::size_t i = 0; i < count; ++i)
+    {
+        const LVecBase3 dir1 = interactors[i]->GetPenetrationDirection();
+        const int side = hand_topology.get_side(interactors[i]->GetConnectedJointTag());
+        if (side < 0)
+            continue;
+
+        for (std::size_t j = i; j < count; ++j)
+        {
+            // opposing contacts in one side
+            if (dir1.dot(interactors[j]->GetPenetrationDirection()) < OPPOSING_COS_ANGLE && side == hand_topology.get_side(interactors[j]->GetConnectedJointTag()))
+            {
+                grasping_side = side;
+                break;
+            }
+        }
+    }
+
+    return grasping_side;
+}
+
+HandRegistry::HandMask collect_contacted_hands(const HandRegistry& hand_registry,
+    crsf::TCRModel* const* contacted_children, std::size_t count, FrameVector<crsf::TCRModel*>* contacted_hand)
+{
+    HandRegistry::HandMask contacted_hand_mask = 0;
+    for (std::size_t i = 0; i < count; ++i)
+    {
+        for (auto contacted_hand_pointer : contacted_children[i]->contacted_hand_pointer)
+        {
+            const int hand_id = hand_registry.find_hand_id(contacted_hand_pointer);
+            if (hand_id == HandRegistry::INVALID_HAND_ID)
+                continue;
+
+            contacted_hand_mask |= HandRegistry::to_mask(hand_id);
+            contacted_hand[hand_id].push_back(contacted_children[i]);
+        }
+    }
+
+    return contacted_hand_mask;
+}
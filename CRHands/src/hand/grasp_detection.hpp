@@ -0,0 +1,38 @@
+/**
+* Coexistence Reality Software Framework (CRSF)
+* Copyright (c) Center of Human-centered Interaction for Coexistence. All rights reserved.
+* See the LICENSE.md file for more details.
+*/
+
+#pragma once
+
+#include <cstddef>
+
+#include "hand/hand_registry.hpp"
+#include "util/frame_arena.hpp"
+
+namespace crsf {
+class TCRModel;
+class THandPhysicsInteractor;
+}
+
+// Grasp kinematic feasibility from contacts of physics interactors.
+//
+// A hand grasps when two of its interactors push the object from opposing directions.
+// These functions only read contact state of models, so they can run with test doubles of CRSF models.
+
+/** True if interactors contacting @a contacted_children have opposing penetration directions. */
+bool is_grasping(crsf::TCRModel* const* contacted_children, std::size_t count);
+
+/**
+ * Side (HandTopology::Side) of opposing interactors in one side, or -1.
+ * If both sides have opposing interactors, the side of the last pair wins.
+ */
+int find_grasping_side(crsf::THandPhysicsInteractor* const* interactors, std::size_t count);
+
+/**
+ * Append each child to the list of hands contacting it, and return mask of the hands.
+ * @param contacted_hand    list of contacted children per hand ID, usually on the step arena.
+ */
+HandRegistry::HandMask collect_contacted_hands(const HandRegistry& hand_registry,
+    crsf::TCRModel* const* contacted_children, std::size_t count, FrameVector<crsf::TCRModel*>* contacted_hand);
@@ -0,0 +1,147 @@
+/**
+* Coexistence Reality Software Framework (CRSF)
+* Copyright (c) Center of Human-centered Interaction for Coexistence. All rights reserved.
+* See the LICENSE.md file for more details.
+*/
+
+#include "grasp_ownership.hpp"
+
+#include <algorithm>
+
+GraspOwnership::GraspOwnership(unsigned int local_system_index) : local_system_index_(local_system_index)
+{
+}
+
+void GraspOwnership::set_object_count(int object_count)
+{
+    objects_.resize(object_count);
+}
+
+void GraspOwnership::request(int object_id)
+{
+    if (get_local_claim(object_id) != 0)
+        return;
+
+    set_claim(objects_[object_id], local_system_index_, ++clock_);
+}
+
+void GraspOwnership::release(int object_id)
+{
+    set_claim(objects_[object_id], local_system_index_, 0);
+}
+
+uint32_t GraspOwnership::get_local_claim(int object_id) const
+{
+    for (const auto& claim: objects_[object_id].claims)
+    {
+        if (claim.system_index == local_system_index_)
+            return claim.stamp;
+    }
+    return 0;
+}
+
+void GraspOwnership::observe_clock(uint32_t remote_clock)
+{
+    clock_ = (std::max)(clock_, remote_clock);
+}
+
+void GraspOwnership::set_remote_claim(int object_id, unsigned int system_index, uint32_t stamp)
+{
+    if (system_index == local_system_index_)
+        return;
+
+    observe_clock(stamp);
+    set_claim(objects_[object_id], system_index, stamp);
+}
+
+void GraspOwnership::remove_remote_node(unsigned int system_index)
+{
+    if (system_index == local_system_index_)
+        return;
+
+    for (auto&& entry: objects_)
+    {
+        set_claim(entry, system_index, 0);
+
+        // disconnected node does not publish the released object any more
+        if (entry.owner == system_index)
+        {
+            entry.owner = NO_OWNER;
+            entry.remote_state.count = 0;
+        }
+    }
+}
+
+void GraspOwnership::push_remote_state(int object_id, const ObjectState& state, double time)
+{
+    auto& buffer = objects_[object_id].remote_state;
+
+    buffer.previous = buffer.count == 0 ? state : buffer.latest;
+    buffer.previous_time = buffer.count == 0 ? time : buffer.latest_time;
+    buffer.latest = state;
+    buffer.latest_time = time;
+    buffer.count = (std::min)(buffer.count + 1, 2);
+}
+
+bool GraspOwnership::get_remote_state(int object_id, double time, ObjectState& state) const
+{
+    const auto& buffer = objects_[object_id].remote_state;
+    if (buffer.count == 0)
+        return false;
+
+    // move from previous to latest state during one update interval
+    const double interval = buffer.latest_time - buffer.previous_time;
+    float t = 1.0f;
+    if (interval > 0.0)
+        t = static_cast<float>((std::min)((time - buffer.latest_time) / interval, 1.0));
+    t = (std::max)(t, 0.0f);
+
+    state.pos = buffer.previous.pos + (buffer.latest.pos - buffer.previous.pos) * t;
+
+    // nlerp on shortest arc
+    LQuaternionf latest = buffer.latest.quat;
+    if (buffer.previous.quat.dot(latest) < 0.0f)
+        latest = -latest;
+    state.quat = buffer.previous.quat * (1.0f - t) + latest * t;
+    state.quat.normalize();
+
+    return true;
+}
+
+void GraspOwnership::set_claim(ObjectEntry& entry, unsigned int system_index, uint32_t stamp)
+{
+    auto found = std::find_if(entry.claims.begin(), entry.claims.end(), [system_index](const Claim& claim) {
+        return claim.system_index == system_index;
+    });
+
+    if (stamp == 0)
+    {
+        if (found != entry.claims.end())
+            entry.claims.erase(found);
+    }
+    else
+    {
+        if (found == entry.claims.end())
+            entry.claims.push_back(Claim{ system_index, stamp });
+        else
+            found->stamp = stamp;
+    }
+
+    resolve(entry);
+}
+
+void GraspOwnership::resolve(ObjectEntry& entry)
+{
+    // released object stays with the last owner
+    if (entry.claims.empty())
+        return;
+
+    auto winner = std::min_element(entry.claims.begin(), entry.claims.end(), [](const Claim& a, const Claim& b) {
+        return a.stamp != b.stamp ? a.stamp < b.stamp : a.system_index < b.system_index;
+    });
+
+    if (entry.owner != winner->system_index)
+        entry.remote_state.count = 0;
+
+    entry.owner = winner->system_index;
+}
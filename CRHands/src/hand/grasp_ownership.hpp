@@ -0,0 +1,133 @@
+/**
+* Coexistence Reality Software Framework (CRSF)
+* Copyright (c) Center of Human-centered Interaction for Coexistence. All rights reserved.
+* See the LICENSE.md file for more details.
+*/
+
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include <luse.h>
+
+/**
+ * Ownership of networked objects grasped by users of several nodes.
+ *
+ * A node claims an object when its hand grasps the object, and the owner node is the only
+ * authority which simulates and publishes the object state. Other nodes interpolate the
+ * received state.
+ *
+ * Claims are stamped with a Lamport clock, and concurrent claims are resolved by
+ * (stamp, system index), so every node picks the same owner once it has seen the same claims.
+ * When the owner releases, the next earliest claim (if any) becomes the owner. Without other claims,
+ * the last owner keeps the authority, so all nodes follow one simulation of the released object
+ * until a new claim wins. A claim of a node which follows a remote owner is queued in the same way.
+ *
+ * This class does not depend on CRSF, and GraspOwnershipMemory carries claims and states over DSM.
+ */
+class GraspOwnership
+{
+public:
+    static constexpr unsigned int NO_OWNER = 0;
+
+    struct ObjectState
+    {
+        LVecBase3f pos;
+        LQuaternionf quat;
+    };
+
+public:
+    explicit GraspOwnership(unsigned int local_system_index);
+
+    /** Resize the number of networked objects. Object ID is the index. */
+    void set_object_count(int object_count);
+    int get_object_count() const;
+
+    // local node
+    void request(int object_id);
+    void release(int object_id);
+
+    /** Claim stamp of local node (0 if local node does not claim). */
+    uint32_t get_local_claim(int object_id) const;
+
+    uint32_t get_clock() const;
+
+    // remote nodes
+    void observe_clock(uint32_t remote_clock);
+
+    /** Set claim of remote node. @a stamp is 0 if the node does not claim. */
+    void set_remote_claim(int object_id, unsigned int system_index, uint32_t stamp);
+
+    /** Remove all claims and released ownerships of the remote node (ex, disconnected). */
+    void remove_remote_node(unsigned int system_index);
+
+    // resolution
+    unsigned int get_owner(int object_id) const;
+    bool is_local_authority(int object_id) const;
+    bool is_remote_owned(int object_id) const;
+
+    /** Store received state of remote owned object. @a time is local receive time in seconds. */
+    void push_remote_state(int object_id, const ObjectState& state, double time);
+
+    /** Interpolate received states toward latest state. Return false if no state is received. */
+    bool get_remote_state(int object_id, double time, ObjectState& state) const;
+
+private:
+    struct Claim
+    {
+        unsigned int system_index;
+        uint32_t stamp;
+    };
+
+    struct RemoteStateBuffer
+    {
+        ObjectState previous;
+        ObjectState latest;
+        double previous_time = 0.0;
+        double latest_time = 0.0;
+        int count = 0;
+    };
+
+    struct ObjectEntry
+    {
+        std::vector<Claim> claims;     ///< active claims of all nodes
+        unsigned int owner = NO_OWNER;
+        RemoteStateBuffer remote_state;
+    };
+
+    void set_claim(ObjectEntry& entry, unsigned int system_index, uint32_t stamp);
+    static void resolve(ObjectEntry& entry);
+
+    const unsigned int local_system_index_;
+    uint32_t clock_ = 0;
+    std::vector<ObjectEntry> objects_;
+};
+
+// ************************************************************************************************
+
+inline int GraspOwnership::get_object_count() const
+{
+    return static_cast<int>(objects_.size());
+}
+
+inline uint32_t GraspOwnership::get_clock() const
+{
+    return clock_;
+}
+
+inline unsigned int GraspOwnership::get_owner(int object_id) const
+{
+    return objects_[object_id].owner;
+}
+
+inline bool GraspOwnership::is_local_authority(int object_id) const
+{
+    return objects_[object_id].owner == local_system_index_;
+}
+
+inline bool GraspOwnership::is_remote_owned(int object_id) const
+{
+    const unsigned int owner = objects_[object_id].owner;
+    return owner != NO_OWNER && owner != local_system_index_;
+}
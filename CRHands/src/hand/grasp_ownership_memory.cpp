@@ -0,0 +1,104 @@
+/**
+* Coexistence Reality Software Framework (CRSF)
+* Copyright (c) Center of Human-centered Interaction for Coexistence. All rights reserved.
+* See the LICENSE.md file for more details.
+*/
+
+#include "grasp_ownership_memory.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+#include <crsf/System/TPose.h>
+
+namespace {
+
+constexpr float STATE_LINEAR_EPSILON = 0.0001f;
+constexpr float STATE_ANGULAR_DOT_EPSILON = 1e-7f;
+
+constexpr uint32_t STATE_SEQUENCE_MASK = (1u << 24) - 1;
+
+LVecBase3 pack_stamp(uint32_t stamp, uint32_t value)
+{
+    return LVecBase3(static_cast<float>(stamp >> 16), static_cast<float>(stamp & 0xFFFFu), static_cast<float>(value));
+}
+
+uint32_t unpack_stamp(const LVecBase3& packed)
+{
+    return (static_cast<uint32_t>(packed[0]) << 16) | static_cast<uint32_t>(packed[1]);
+}
+
+bool is_state_changed(const GraspOwnership::ObjectState& a, const GraspOwnership::ObjectState& b)
+{
+    return (a.pos - b.pos).length_squared() > STATE_LINEAR_EPSILON * STATE_LINEAR_EPSILON ||
+        1.0f - std::abs(a.quat.dot(b.quat)) > STATE_ANGULAR_DOT_EPSILON;
+}
+
+}
+
+void GraspOwnershipMemory::set_object_count(int object_count, unsigned int max_system_index)
+{
+    published_states_.resize(object_count, GraspOwnership::ObjectState{ LVecBase3f(0), LQuaternionf::ident_quat() });
+    published_state_sequences_.resize(object_count, 0);
+
+    received_state_sequences_.resize(max_system_index + 1);
+    for (auto&& sequences: received_state_sequences_)
+        sequences.resize(object_count, 0);
+}
+
+void GraspOwnershipMemory::read(GraspOwnership& ownership, unsigned int system_index, const std::vector<crsf::TPose>& poses, double time)
+{
+    if (poses.empty() || system_index >= received_state_sequences_.size())
+        return;
+
+    ownership.observe_clock(unpack_stamp(poses[0].GetPosition()));
+
+    const int object_count = (std::min)(ownership.get_object_count(), static_cast<int>(received_state_sequences_[system_index].size()));
+    const int remote_object_count = (std::min)(object_count, static_cast<int>((poses.size() - 1) / 2));
+    for (int k = 0; k < remote_object_count; ++k)
+    {
+        const LVecBase3 claim = poses[1 + 2 * k].GetPosition();
+        ownership.set_remote_claim(k, system_index, unpack_stamp(claim));
+
+        if (ownership.get_owner(k) != system_index)
+            continue;
+
+        auto& received_sequence = received_state_sequences_[system_index][k];
+        const uint32_t sequence = static_cast<uint32_t>(claim[2]);
+        if (sequence == received_sequence)
+            continue;
+
+        received_sequence = sequence;
+        const auto& state_pose = poses[2 + 2 * k];
+        ownership.push_remote_state(k, GraspOwnership::ObjectState{ state_pose.GetPosition(), state_pose.GetQuaternion() }, time);
+    }
+}
+
+bool GraspOwnershipMemory::write(const GraspOwnership& ownership, const std::vector<GraspOwnership::ObjectState>& states, std::vector<crsf::TPose>& poses)
+{
+    const int object_count = (std::min)(ownership.get_object_count(), static_cast<int>(published_states_.size()));
+
+    bool is_changed = false;
+    for (int k = 0; k < object_count; ++k)
+    {
+        if (ownership.is_local_authority(k) && is_state_changed(states[k], published_states_[k]))
+        {
+            published_states_[k] = states[k];
+            published_state_sequences_[k] = (published_state_sequences_[k] + 1) & STATE_SEQUENCE_MASK;
+            poses[2 + 2 * k].MakePosQuat(states[k].pos, states[k].quat);
+            is_changed = true;
+        }
+
+        const LVecBase3 claim = pack_stamp(ownership.get_local_claim(k), published_state_sequences_[k]);
+        if (poses[1 + 2 * k].GetPosition() != claim)
+        {
+            poses[1 + 2 * k].MakePosition(claim);
+            is_changed = true;
+        }
+    }
+
+    if (is_changed)
+        poses[0].MakePosition(pack_stamp(ownership.get_clock(), object_count));
+
+    return is_changed;
+}
@@ -0,0 +1,60 @@
+/**
+* Coexistence Reality Software Framework (CRSF)
+* Copyright (c) Center of Human-centered Interaction for Coexistence. All rights reserved.
+* See the LICENSE.md file for more details.
+*/
+
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "hand/grasp_ownership.hpp"
+
+namespace crsf {
+class TPose;
+}
+
+/**
+ * Claims and owned object states of GraspOwnership in poses of avatar memory (one memory object per node).
+ *
+ * pose[0].position         = (Lamport clock (high 16 bits), Lamport clock (low 16 bits), object count)
+ * pose[1 + 2k].position    = (claim stamp of object k (high 16 bits), claim stamp (low 16 bits), state sequence of object k)
+ *                            claim stamp is 0 if no claim
+ * pose[2 + 2k]             = (position, quaternion) of object k in world, valid if this node owns it
+ *
+ * Pose components are float and hold integers exactly only below 2^24,
+ * so 32 bit stamps are split into 16 bit halves and state sequence wraps at 2^24.
+ *
+ * write() changes poses only when a claim or an owned state is changed,
+ * so the memory object is updated (and uses network bandwidth) only then.
+ */
+class GraspOwnershipMemory
+{
+public:
+    static int get_pose_count(int object_count);
+
+public:
+    void set_object_count(int object_count, unsigned int max_system_index);
+
+    /** Read claims and new states of remote node @a system_index. @a time is local receive time in seconds. */
+    void read(GraspOwnership& ownership, unsigned int system_index, const std::vector<crsf::TPose>& poses, double time);
+
+    /**
+     * Write claims of local node and @a states of objects which local node owns (other states are not read).
+     * Return true if @a poses are changed.
+     */
+    bool write(const GraspOwnership& ownership, const std::vector<GraspOwnership::ObjectState>& states, std::vector<crsf::TPose>& poses);
+
+private:
+    std::vector<GraspOwnership::ObjectState> published_states_;
+    std::vector<uint32_t> published_state_sequences_;
+    std::vector<std::vector<uint32_t>> received_state_sequences_;      ///< [system index][object ID]
+};
+
+// ************************************************************************************************
+
+inline int GraspOwnershipMemory::get_pose_count(int object_count)
+{
+    return 1 + 2 * object_count;
+}
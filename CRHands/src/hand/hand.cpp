@@ -7,9 +7,17 @@
 #include <crsf/CRModel/TCRModel.h>
 #include <crsf/CRModel/TWorld.h>
 #include <crsf/System/TCRProperty.h>
+#include <crsf/System/TPose.h>
 #include <crsf/CREngine/THandInteractionEngineConnector.h>
 #include <crsf/RenderingEngine/TGraphicRenderEngine.h>
 
+#include "hand/contact_view.hpp"
+#include "hand/hand_topology.hpp"
+#include "util/latency_probe.hpp"
+#include "util/stage_profiler.hpp"
+
+static_assert(JointWriteCache::JOINT_COUNT >= HandTopology::JOINT_COUNT, "JointWriteCache should cover all joints of hand topology.");
+
 Hand::Hand(const crsf::TCRProperty& props, crsf::TWorldObject* hand_model) : hand_object_(hand_model)
 {
     hand_ = std::make_unique<crsf::TCRHand>(props);
@@ -43,6 +51,8 @@ void Hand::setup_physics_interactor(float particle_radius)
 
 bool Hand::interactor_collision_event(const std::shared_ptr<crsf::TCRModel>& my_model, const std::shared_ptr<crsf::TCRModel>& evented_model)
 {
+    CRHANDS_PROFILE_STAGE(PROFILE_STAGE_CONTACT);
+
     // if contacted model is not interactable, return
     if (!evented_model->GetPhysicsModel()->GetIsHandInteractable())
         return false;
@@ -50,13 +60,41 @@ bool Hand::interactor_collision_event(const std::shared_ptr<crsf::TCRModel>& my_
     // get contact information
     crsf::TContactInfo* my_contact_info = my_model->GetPhysicsModel()->GetContactInfo();
 
-    auto physics_particle = hand_->FindPhysicsInteractor(my_model);
+    // listener is attached to interactors of this hand only
+    auto physics_particle = ContactView::to_interactor(my_model.get());
     physics_particle->SetPenetrationDirection(my_contact_info->GetNormalWorldOnB());
     physics_particle->SetPenetrationDirection(physics_particle->GetPenetrationDirection().normalized());
 
     return false;
 }
 
+LatencyProbe::Markers Hand::get_wrist_markers() const
+{
+    LatencyProbe::Markers markers = {};
+    const auto parent = hand_->Get3DModel()->GetParent();
+    if (!parent)
+        return markers;
+
+    for (int side = 0; side < HandTopology::SIDE_COUNT; ++side)
+    {
+        const auto wrist = hand_->GetJointData(HandTopology::get_wrist_index(side))->Get3DModel();
+        if (wrist)
+            markers[side] = wrist->GetPosition(parent);
+    }
+
+    return markers;
+}
+
+const HandKinematics& Hand::update_kinematics()
+{
+    if (!kinematics_.is_bound(hand_.get()))
+        kinematics_.bind(hand_.get());
+
+    kinematics_.update(crsf::TGraphicRenderEngine::GetInstance()->GetWorld());
+
+    return kinematics_;
+}
+
 void Hand::set_avatar_memory_object(crsf::TAvatarMemoryObject* amo)
 {
     if (amo && hand_->GetJointNumber() != amo->GetProperty().m_propAvatar.m_nJointNumber)
@@ -68,7 +106,24 @@ void Hand::set_avatar_memory_object(crsf::TAvatarMemoryObject* amo)
 void Hand::set_render_method(crsf::TAvatarMemoryObject* source_amo, const RenderMethodType& render_method)
 {
     render_method_ = render_method;
+    source_amo_ = source_amo;
     hand_connector_->ConnectHand([this](crsf::TAvatarMemoryObject* amo) {
+        if (is_render_suspended())
+            return;
+
+        // device memory may have been overwritten since pulse was injected
+        auto& latency_probe = get_latency_probe();
+        if (latency_probe.is_pulse_in_flight())
+        {
+            const auto& poses = amo->GetAvatarMemory();
+            if (static_cast<int>(poses.size()) >= HandTopology::JOINT_COUNT)
+            {
+                latency_probe.mark(LATENCY_STAGE_CALLBACK, LatencyProbe::Markers{
+                    poses[HandTopology::get_wrist_index(HandTopology::SIDE_LEFT)].GetPosition(),
+                    poses[HandTopology::get_wrist_index(HandTopology::SIDE_RIGHT)].GetPosition() });
+            }
+        }
+
         render_method_(this, amo);
     }, source_amo);
 }
@@ -87,29 +142,14 @@ void render_hand(Hand* hand, crsf::TAvatarMemoryObject* amo)
 
     auto world = crsf::TGraphicRenderEngine::GetInstance()->GetWorld();
 
-    // # joint
-    const unsigned int joint_number = crhand->GetJointNumber();
-
-    // loop left joint
-    const auto left_joint_number = (std::min)(joint_number, 22u);
-    for (unsigned int i = 1; i < left_joint_number; ++i)
+    // loop joints of both sides, except roots of sides
+    const auto joint_count = (std::min)(static_cast<int>(crhand->GetJointNumber()), HandTopology::JOINT_COUNT);
+    for (int i = 0; i < joint_count; ++i)
     {
-        // update 3D model's pose
-        crsf::TWorldObject* joint_model = crhand->GetJointData(i)->Get3DModel();
-        if (joint_model)
-        {
-            const auto& get_avatar_pose = amo->GetAvatarMemory(i);
+        const auto& joint = hand_topology.get_joint(i);
+        if (joint.kind == HandTopology::JOINT_KIND_ROOT)
+            continue;
 
-            joint_model->SetHPR(get_avatar_pose.GetQuaternion().get_hpr(), world);
-            if (i == 21) // root(wrist)
-                joint_model->SetPosition(get_avatar_pose.GetPosition(), world);
-        }
-    }
-
-    // loop right joint
-    const auto right_joint_number = (std::min)(joint_number, 44u);
-    for (unsigned int i = 23; i < right_joint_number; ++i)
-    {
         // update 3D model's pose
         crsf::TWorldObject* joint_model = crhand->GetJointData(i)->Get3DModel();
         if (joint_model)
@@ -117,7 +157,7 @@ void render_hand(Hand* hand, crsf::TAvatarMemoryObject* amo)
             const auto& get_avatar_pose = amo->GetAvatarMemory(i);
 
             joint_model->SetHPR(get_avatar_pose.GetQuaternion().get_hpr(), world);
-            if (i == 43) // root(wrist)
+            if (joint.kind == HandTopology::JOINT_KIND_WRIST)
                 joint_model->SetPosition(get_avatar_pose.GetPosition(), world);
         }
     }
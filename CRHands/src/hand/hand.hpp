@@ -6,8 +6,16 @@
 
 #pragma once
 
+#include <atomic>
 #include <memory>
 #include <functional>
+#include <vector>
+
+#include "hand/hand_kinematics.hpp"
+#include "util/jerk_meter.hpp"
+#include "util/joint_write_cache.hpp"
+#include "util/latency_probe.hpp"
+#include "util/pose_resampler.hpp"
 
 namespace crsf {
 class TCRHand;
@@ -17,6 +25,7 @@ class TCRProperty;
 class THandInteractionEngineConnector;
 class TCRModel;
 class TAvatarMemoryObject;
+class TPose;
 }
 
 class Hand
@@ -41,6 +50,31 @@ public:
 
     void set_render_method(crsf::TAvatarMemoryObject* source_amo, const RenderMethodType& render_method);
 
+    /** Device memory connected by set_render_method. */
+    crsf::TAvatarMemoryObject* get_source_memory_object() const;
+
+    /** Skip render method of hand connector, for example while recorded joints are replayed. */
+    void set_render_suspended(bool is_suspended);
+    bool is_render_suspended() const;
+
+    JointWriteCache& get_joint_write_cache();
+    const JointWriteCache& get_joint_write_cache() const;
+
+    /** Reused buffer for poses written to destination AMO, to avoid allocation per frame. */
+    std::vector<crsf::TPose>& get_dest_pose_buffer();
+
+    /** Positions of wrist models in parent of hand model (device space of Leap), as latency probe markers. Main thread only. */
+    LatencyProbe::Markers get_wrist_markers() const;
+
+    /** Compute world poses of all joints from current joint models. */
+    const HandKinematics& update_kinematics();
+
+    /** Timestamped device samples, evaluated at display time by render method. */
+    PoseResampler& get_pose_resampler();
+
+    /** Wrist jerk of device samples as read (@a resampled is false) or as rendered. */
+    JerkMeter& get_jerk_meter(bool resampled);
+
 private:
     bool interactor_collision_event(const std::shared_ptr<crsf::TCRModel>& my_model, const std::shared_ptr<crsf::TCRModel>& evented_model);
 
@@ -49,8 +83,20 @@ private:
     std::unique_ptr<crsf::THandInteractionEngineConnector> hand_connector_;
 
     RenderMethodType render_method_;
+    crsf::TAvatarMemoryObject* source_amo_ = nullptr;
+    std::atomic<bool> is_render_suspended_{ false };
 
     crsf::TAvatarMemoryObject* hand_amo_ = nullptr;
+
+    JointWriteCache joint_write_cache_;
+
+    std::vector<crsf::TPose> dest_pose_buffer_;
+
+    HandKinematics kinematics_;
+
+    PoseResampler pose_resampler_;
+    JerkMeter raw_jerk_meter_;
+    JerkMeter resampled_jerk_meter_;
 };
 
 inline crsf::TCRHand* Hand::get_hand() const
@@ -73,6 +119,46 @@ inline crsf::TAvatarMemoryObject* Hand::get_avatar_memory_object() const
     return hand_amo_;
 }
 
+inline crsf::TAvatarMemoryObject* Hand::get_source_memory_object() const
+{
+    return source_amo_;
+}
+
+inline void Hand::set_render_suspended(bool is_suspended)
+{
+    is_render_suspended_.store(is_suspended, std::memory_order_release);
+}
+
+inline bool Hand::is_render_suspended() const
+{
+    return is_render_suspended_.load(std::memory_order_acquire);
+}
+
+inline JointWriteCache& Hand::get_joint_write_cache()
+{
+    return joint_write_cache_;
+}
+
+inline const JointWriteCache& Hand::get_joint_write_cache() const
+{
+    return joint_write_cache_;
+}
+
+inline std::vector<crsf::TPose>& Hand::get_dest_pose_buffer()
+{
+    return dest_pose_buffer_;
+}
+
+inline PoseResampler& Hand::get_pose_resampler()
+{
+    return pose_resampler_;
+}
+
+inline JerkMeter& Hand::get_jerk_meter(bool resampled)
+{
+    return resampled ? resampled_jerk_meter_ : raw_jerk_meter_;
+}
+
 // ************************************************************************************************
 
 void render_hand(Hand* hand, crsf::TAvatarMemoryObject* amo);
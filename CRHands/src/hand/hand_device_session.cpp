@@ -0,0 +1,123 @@
+/**
+* Coexistence Reality Software Framework (CRSF)
+* Copyright (c) Center of Human-centered Interaction for Coexistence. All rights reserved.
+* See the LICENSE.md file for more details.
+*/
+
+#include "hand_device_session.hpp"
+
+#include <iterator>
+
+#include <crsf/CREngine/TDynamicModuleManager.h>
+#include <crsf/RealWorldInterface/TInterfaceManager.h>
+
+#include <leapmotion_interface.h>
+#include <hand_mocap_interface.h>
+#include <kinesthethic_hand_mocap_interface.h>
+
+namespace {
+
+// modules of interfaces which the session resolves
+enum DeviceModule
+{
+    DEVICE_MODULE_LEAPMOTION = 0,
+    DEVICE_MODULE_HAND_MOCAP,
+    DEVICE_MODULE_KINESTHETIC_HAND_MOCAP,
+    DEVICE_MODULE_OPENVR,
+};
+
+const char* const DEVICE_MODULE_NAMES[] = { "leapmotion", "hand_mocap", "kinesthetic_hand_mocap", "openvr" };
+
+}
+
+HandDeviceSession::HandDeviceSession(bool use_unist_mocap) : use_unist_mocap_(use_unist_mocap)
+{
+    publish(std::make_shared<const Devices>());
+
+    refresh();
+
+    accept(REFRESH_EVENT_NAME, [this](const Event*) { refresh(); });
+
+    // unloaded interfaces are cleared in the next frame
+    add_task([this](rppanda::FunctionalTask*) {
+        check_modules();
+        return AsyncTask::DS_cont;
+    }, "HandDeviceSession::check_modules");
+}
+
+HandDeviceSession::~HandDeviceSession()
+{
+    publish(std::make_shared<const Devices>());
+}
+
+void HandDeviceSession::refresh()
+{
+    auto interface_manager = crsf::TInterfaceManager::GetInstance();
+
+    enabled_modules_ = get_enabled_modules();
+    auto is_enabled = [this](DeviceModule module) { return (enabled_modules_ & (1u << module)) != 0; };
+
+    auto devices = std::make_shared<Devices>();
+
+    // interfaces of disabled modules may be unloaded, so they are not resolved
+    // Leap Motion
+    if (is_enabled(DEVICE_MODULE_LEAPMOTION))
+        devices->leap_motion = dynamic_cast<LeapMotionInterface*>(interface_manager->GetInputInterface("LeapMotion"));
+    if (devices->leap_motion && devices->leap_motion->GetMode() == "HMD")
+        devices->leap_mode = LEAP_MOTION_MODE_HMD;
+
+    // CHIC mocap
+    if (is_enabled(DEVICE_MODULE_HAND_MOCAP))
+        devices->hand_mocap = dynamic_cast<Hand_MoCAPInterface*>(interface_manager->GetInputInterface("Hand_MoCAP"));
+    if (devices->hand_mocap)
+        devices->hand_mocap_mode_name = devices->hand_mocap->GetMoCAPMode();
+
+    // UNIST mocap
+    if (use_unist_mocap_ && is_enabled(DEVICE_MODULE_KINESTHETIC_HAND_MOCAP))
+        devices->unist_mocap = dynamic_cast<Kinesthetic_HandMoCAPInterface*>(interface_manager->GetInputInterface("KinestheticHandMoCAP"));
+
+    devices->is_openvr_enabled = is_enabled(DEVICE_MODULE_OPENVR);
+    devices->generation = get_generation() + 1;
+
+    // publish to physics and haptic threads
+    if (before_refresh_)
+        before_refresh_();
+
+    publish(devices);
+
+    if (after_refresh_)
+        after_refresh_();
+
+    throw_event(REFRESHED_EVENT_NAME);
+}
+
+void HandDeviceSession::set_refresh_hooks(const RefreshHook& before, const RefreshHook& after)
+{
+    before_refresh_ = before;
+    after_refresh_ = after;
+}
+
+unsigned int HandDeviceSession::get_enabled_modules()
+{
+    auto module_manager = crsf::TDynamicModuleManager::GetInstance();
+
+    unsigned int enabled_modules = 0;
+    for (std::size_t k = 0; k < std::size(DEVICE_MODULE_NAMES); ++k)
+    {
+        if (module_manager->IsModuleEnabled(DEVICE_MODULE_NAMES[k]))
+            enabled_modules |= 1u << k;
+    }
+    return enabled_modules;
+}
+
+void HandDeviceSession::publish(const std::shared_ptr<const Devices>& devices)
+{
+    std::atomic_store_explicit(&devices_, devices, std::memory_order_release);
+}
+
+void HandDeviceSession::check_modules()
+{
+    // modules are enabled or disabled at runtime
+    if (get_enabled_modules() != enabled_modules_)
+        refresh();
+}
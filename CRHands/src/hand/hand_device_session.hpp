@@ -0,0 +1,146 @@
+/**
+* Coexistence Reality Software Framework (CRSF)
+* Copyright (c) Center of Human-centered Interaction for Coexistence. All rights reserved.
+* See the LICENSE.md file for more details.
+*/
+
+#pragma once
+
+#include <functional>
+#include <memory>
+#include <string>
+
+#include <render_pipeline/rppanda/showbase/direct_object.hpp>
+
+#include "hand/hand_retarget.hpp"
+
+class LeapMotionInterface;
+class Hand_MoCAPInterface;
+class Kinesthetic_HandMoCAPInterface;
+
+/**
+ * Input interfaces and modes of hand devices.
+ *
+ * Interfaces are looked up by name and cast once, and mode strings are parsed to enums.
+ * Per-frame code reads this instead of querying TInterfaceManager and TDynamicModuleManager.
+ *
+ * Enabled state of device modules is checked every frame, and the session is refreshed when
+ * it changes. Interfaces of disabled modules are cleared. Send REFRESH_EVENT_NAME to refresh immediately.
+ * REFRESHED_EVENT_NAME is sent after every refresh.
+ *
+ * Interfaces and modes are published together as one immutable Devices snapshot, so physics and
+ * haptic threads read a consistent set while main thread refreshes. Code using several of them
+ * takes one snapshot by get_devices().
+ *
+ * A snapshot does not keep modules loaded. Threads calling into interfaces stop in the before-refresh
+ * hook and read the interface again after the refresh.
+ */
+class HandDeviceSession : public rppanda::DirectObject
+{
+public:
+    static constexpr const char* REFRESH_EVENT_NAME = "HandDeviceSession::refresh";
+    static constexpr const char* REFRESHED_EVENT_NAME = "HandDeviceSession::refreshed";
+
+    struct Devices
+    {
+        LeapMotionInterface* leap_motion = nullptr;
+        LeapMotionMode leap_mode = LEAP_MOTION_MODE_FLOOR;
+
+        Hand_MoCAPInterface* hand_mocap = nullptr;
+        std::string hand_mocap_mode_name;
+
+        Kinesthetic_HandMoCAPInterface* unist_mocap = nullptr;
+
+        bool is_openvr_enabled = false;
+
+        unsigned int generation = 0;
+    };
+
+    using RefreshHook = std::function<void()>;
+
+public:
+    /** @param use_unist_mocap  resolve UNIST mocap interface. */
+    explicit HandDeviceSession(bool use_unist_mocap);
+    ~HandDeviceSession();
+
+    void refresh();
+
+    /**
+     * Called on main thread right before and after a refresh publishes new interfaces.
+     * @a before should return only when no thread calls into the current interfaces.
+     */
+    void set_refresh_hooks(const RefreshHook& before, const RefreshHook& after);
+
+    std::shared_ptr<const Devices> get_devices() const;
+
+    LeapMotionInterface* get_leap_motion() const;
+    LeapMotionMode get_leap_mode() const;
+
+    Hand_MoCAPInterface* get_hand_mocap() const;
+    std::string get_hand_mocap_mode_name() const;
+
+    Kinesthetic_HandMoCAPInterface* get_unist_mocap() const;
+
+    bool is_openvr_enabled() const;
+
+    /** Incremented by every refresh(). */
+    unsigned int get_generation() const;
+
+private:
+    /** Bit mask of enabled device modules. */
+    static unsigned int get_enabled_modules();
+
+    void check_modules();
+
+    void publish(const std::shared_ptr<const Devices>& devices);
+
+    const bool use_unist_mocap_;
+
+    std::shared_ptr<const Devices> devices_;        ///< accessed by atomic_load and atomic_store
+    unsigned int enabled_modules_ = 0;
+
+    RefreshHook before_refresh_;
+    RefreshHook after_refresh_;
+};
+
+// ************************************************************************************************
+
+inline std::shared_ptr<const HandDeviceSession::Devices> HandDeviceSession::get_devices() const
+{
+    return std::atomic_load_explicit(&devices_, std::memory_order_acquire);
+}
+
+inline LeapMotionInterface* HandDeviceSession::get_leap_motion() const
+{
+    return get_devices()->leap_motion;
+}
+
+inline LeapMotionMode HandDeviceSession::get_leap_mode() const
+{
+    return get_devices()->leap_mode;
+}
+
+inline Hand_MoCAPInterface* HandDeviceSession::get_hand_mocap() const
+{
+    return get_devices()->hand_mocap;
+}
+
+inline std::string HandDeviceSession::get_hand_mocap_mode_name() const
+{
+    return get_devices()->hand_mocap_mode_name;
+}
+
+inline Kinesthetic_HandMoCAPInterface* HandDeviceSession::get_unist_mocap() const
+{
+    return get_devices()->unist_mocap;
+}
+
+inline bool HandDeviceSession::is_openvr_enabled() const
+{
+    return get_devices()->is_openvr_enabled;
+}
+
+inline unsigned int HandDeviceSession::get_generation() const
+{
+    return get_devices()->generation;
+}
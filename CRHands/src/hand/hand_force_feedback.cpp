@@ -0,0 +1,150 @@
+/**
+* Coexistence Reality Software Framework (CRSF)
+* Copyright (c) Center of Human-centered Interaction for Coexistence. All rights reserved.
+* See the LICENSE.md file for more details.
+*/
+
+#include "hand_manager.hpp"
+
+#include <cmath>
+
+#include <spdlog/logger.h>
+
+#include <crsf/CoexistenceInterface/TDynamicStageMemory.h>
+#include <crsf/CoexistenceInterface/TAvatarMemoryObject.h>
+#include <crsf/CREngine/TPhysicsManager.h>
+#include <crsf/System/TPose.h>
+
+#include "main.hpp"
+
+extern spdlog::logger* global_logger;
+
+// Layout of kinesthetic force-feedback memory (TAvatarMemoryObject read by UNIST exoskeleton module)
+//
+// pose[0].position                 = (command tick, 0, 0)
+// pose[1 + 5 * hand + finger]      = (resistance [0, 1], 0, 0), hand: 0 = left, 1 = right
+//
+// Memory object is written from main thread at most subsystem.unistmocap_force_publish_rate per second,
+// and only when a resistance is changed more than FORCE_EPSILON.
+
+namespace {
+
+constexpr int FORCE_FEEDBACK_POSE_COUNT = 1 + ForceFeedbackController::HAND_COUNT * ForceFeedbackController::FINGER_COUNT;
+constexpr float FORCE_EPSILON = 0.005f;
+
+}
+
+void HandManager::setup_force_feedback()
+{
+    if (!device_session_->get_unist_mocap() || !props_.get("subsystem.unistmocap_force_feedback", false))
+        return;
+
+    force_feedback_memory_name_ = props_.get("subsystem.unistmocap_force_memory", std::string("KinestheticForceFeedback"));
+
+    ForceFeedbackController::Parameters params;
+    params.period = std::chrono::microseconds(1000000 / (std::max)(1, props_.get("subsystem.unistmocap_force_rate", 500)));
+    params.stiffness = props_.get("subsystem.unistmocap_force_stiffness", params.stiffness);
+    params.damping = props_.get("subsystem.unistmocap_force_damping", params.damping);
+    force_feedback_controller_ = std::make_unique<ForceFeedbackController>(params);
+
+    crsf::TPhysicsManager::GetInstance()->AddTask([this](void) {
+        flush_force_feedback();
+        return false;
+    }, "flush_force_feedback");
+
+    // device memory is written by main thread, which keeps running when physics stalls
+    force_feedback_publish_interval_ = std::chrono::microseconds(1000000 / (std::max)(1, props_.get("subsystem.unistmocap_force_publish_rate", 100)));
+    add_task([this](rppanda::FunctionalTask*) {
+        publish_force_feedback();
+        return AsyncTask::DS_cont;
+    }, "HandManager::publish_force_feedback");
+}
+
+void HandManager::release_force_feedback()
+{
+    if (!force_feedback_controller_)
+        return;
+
+    remove_task("HandManager::publish_force_feedback");
+    force_feedback_controller_.reset();
+
+    // release exoskeleton
+    write_force_feedback(ForceFeedbackController::Command{});
+}
+
+void HandManager::flush_force_feedback()
+{
+    CRHANDS_PROFILE_STAGE(PROFILE_STAGE_HAPTICS);
+
+    ForceFeedbackController::ContactInput input;
+    input.depths = step_force_depths_;
+    input.time = std::chrono::steady_clock::now();
+    force_feedback_controller_->post_contacts(input);
+
+    step_force_depths_ = {};
+}
+
+void HandManager::publish_force_feedback()
+{
+    const auto now = std::chrono::steady_clock::now();
+    if (now - last_force_feedback_publish_time_ < force_feedback_publish_interval_)
+        return;
+
+    ForceFeedbackController::Command command;
+    if (!force_feedback_controller_->read_output(command))
+        return;
+
+    last_force_feedback_publish_time_ = now;
+    write_force_feedback(command);
+}
+
+void HandManager::write_force_feedback(const ForceFeedbackController::Command& command)
+{
+    // called from main thread
+    auto dsm = app_.dsm_;
+    if (!dsm->HasMemoryObject<crsf::TAvatarMemoryObject>(force_feedback_memory_name_))
+    {
+        if (!force_feedback_memory_error_)
+            global_logger->error("Failed to get AvatarMemoryObject of force feedback: {}", force_feedback_memory_name_);
+        force_feedback_memory_error_ = true;
+        return;
+    }
+
+    auto amo = dsm->GetAvatarMemoryObjectByName(force_feedback_memory_name_);
+    if (force_feedback_poses_.empty())
+        force_feedback_poses_ = amo->GetAvatarMemory();
+
+    if (static_cast<int>(force_feedback_poses_.size()) < FORCE_FEEDBACK_POSE_COUNT)
+    {
+        if (!force_feedback_memory_error_)
+            global_logger->error("AvatarMemoryObject {} needs {} joints.", force_feedback_memory_name_, FORCE_FEEDBACK_POSE_COUNT);
+        force_feedback_memory_error_ = true;
+        return;
+    }
+
+    bool is_changed = false;
+    for (int hand = 0; hand < ForceFeedbackController::HAND_COUNT; ++hand)
+    {
+        for (int finger = 0; finger < ForceFeedbackController::FINGER_COUNT; ++finger)
+        {
+            const float resistance = command.resistances[hand][finger];
+            auto& pose = force_feedback_poses_[1 + ForceFeedbackController::FINGER_COUNT * hand + finger];
+
+            // always send full release
+            const float old_resistance = pose.GetPosition()[0];
+            if (std::abs(resistance - old_resistance) > FORCE_EPSILON || (resistance == 0.0f && old_resistance != 0.0f))
+            {
+                pose.MakePosition(LVecBase3(resistance, 0.0f, 0.0f));
+                is_changed = true;
+            }
+        }
+    }
+
+    if (!is_changed)
+        return;
+
+    force_feedback_poses_[0].MakePosition(LVecBase3(static_cast<float>(command.tick), 0.0f, 0.0f));
+
+    amo->SetAvatarMemory(force_feedback_poses_);
+    amo->UpdateAvatarMemoryObject();
+}
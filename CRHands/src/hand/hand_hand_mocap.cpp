@@ -17,283 +17,225 @@
 #include <crsf/System/TPose.h>
 
 #include "hand/hand.hpp"
+#include "hand/hand_retarget.hpp"
+#include "hand/hand_topology.hpp"
 #include "main.hpp"
+#include "util/latency_probe.hpp"
+#include "util/stage_profiler.hpp"
 
-void HandManager::render_hand_mocap_side(crsf::TCRHand* hand, crsf::TAvatarMemoryObject* amo, HandIndex hand_side)
+void HandManager::render_hand_mocap_side(crsf::TCRHand* hand, JointWriteCache& joint_write_cache, crsf::TAvatarMemoryObject* amo, HandIndex hand_side)
 {
     auto world = crsf::TGraphicRenderEngine::GetInstance()->GetWorld();
 
-    for (int f = 0; f < 3; f++)
+    // finger joints do not move the wrist, so wrist pose is read once per side
+    const bool is_position_tracked = props_.get("subsystem.handmocap_position", false);
+    LQuaternionf root_quat;
+    LVecBase3 root_pos;
+    if (is_position_tracked)
+    {
+        auto root = hand->GetJointData(HandTopology::get_wrist_index(hand_side));
+        root_quat = root->GetOrientation();
+        root_pos = root->Get3DModel()->GetPosition(world);
+    }
+
     {
-        for (int j = 0; j < 4; j++)
+        CRHANDS_PROFILE_STAGE(PROFILE_STAGE_RETARGET);
+
+        for (int f = 0; f < 3; f++)
         {
-            const int index = (hand_side * 12) + (f * 4) + j;
-            const int model_index = 1 + (hand_side * 22) + (f * 4) + j;
+            for (int j = 0; j < 4; j++)
+            {
+                const int index = (hand_side * 12) + (f * 4) + j;
+                const int model_index = HandTopology::get_joint_index(hand_side, f, j);
 
-            // Get TPose from avatar memory object
-            const auto& getTPose = amo->GetAvatarMemory(index);
+                // Get TPose from avatar memory object
+                const auto& getTPose = amo->GetAvatarMemory(index);
 
-            // <<Rotation>>
-            // Get quaternion from sensor
-            LQuaternionf a = getTPose.GetQuaternion();
+                // <<Rotation>>
+                // Get quaternion from sensor
+                LQuaternionf a = getTPose.GetQuaternion();
 
-            // Set quaternion onto joint data
-            hand->GetJointData(model_index)->SetOrientation(a);
+                // Set quaternion onto joint data
+                hand->GetJointData(model_index)->SetOrientation(a);
 
-            // Rotate to hand model origin pose
-            LQuaternionf quat_result;
+                // Rotate to hand model origin pose
+                // (thumb base also multiplies initial quaternion)
+                const LQuaternionf quat_result = retarget_hand_mocap_joint(a, hand_side, f == 0 && j == 0);
 
-            if (hand_side == 0) // left
-            {
+                // Set rotation on 3d model if the joint is rotated
+                if (j != 3 && joint_write_cache.update_rotation(model_index, quat_result)) // Not tip (tip does not have joint)
                 {
-                    LQuaternionf aa;
-                    aa.set_from_axis_angle(180, LVecBase3(1, 0, 0));
-                    a = aa.conjugate() * a * aa;
-                }
+                    auto hpr = quat_result.get_hpr();
+                    hand->GetJointData(model_index)->Get3DModel()->SetHPR(hpr);
 
-                if (f == 0 && j == 0)
-                {
-                    LQuaternionf b, c, cb;
-                    b.set_from_axis_angle(-90, LVecBase3(0, -1, 0));
-                    c.set_from_axis_angle(-90, LVecBase3(0, 0, 1));
-                    cb = c * b;
-                    quat_result = cb.conjugate() * a * cb;
-                }
-                else
-                {
-                    LQuaternionf b, c, cb;
-                    b.set_from_axis_angle(90, LVecBase3(0, 1, 0));
-                    c.set_from_axis_angle(90, LVecBase3(0, 0, -1));
-                    cb = c * b;
-                    quat_result = cb.conjugate() * a * cb;
+                    // Set rotation about ring & pinky joints same with middle joint
+                    if (f == HandTopology::FINGER_MIDDLE)
+                    {
+                        hand->GetJointData(HandTopology::get_joint_index(hand_side, HandTopology::FINGER_RING, j))->Get3DModel()->SetHPR(hpr);
+                        hand->GetJointData(HandTopology::get_joint_index(hand_side, HandTopology::FINGER_PINKY, j))->Get3DModel()->SetHPR(hpr);
+                    }
                 }
-            }
-            else if (hand_side == 1) // right
-            {
-                LQuaternionf b, c, cb;
-                b.set_from_axis_angle(90, LVecBase3(0, 1, 0));
-                c.set_from_axis_angle(-90, LVecBase3(0, 0, 1));
-                cb = c * b;
-                quat_result = cb.conjugate() * a * cb;
-            }
 
-            if ((hand_side == 0) && f == 0 && j == 0) // Left thumb - multiply initial quaternion
-            {
-                LQuaternionf e, f, g, gfe;
-                e.set_from_axis_angle(1.39323033616515f * 180.0f / M_PI, LVecBase3(-1, 0, 0));
-                f.set_from_axis_angle(0.533031068419669f * 180.0f / M_PI, LVecBase3(0, 0, -1));
-                g.set_from_axis_angle(0.907932313878427f * 180.0f / M_PI, LVecBase3(0, 1, 0));
-                gfe = g * f * e;
-                LQuaternionf h;
-                h.set_from_axis_angle(-45, LVecBase3(0, 1, 0));
-                gfe = h * gfe;
-                quat_result = quat_result * gfe;
-            }
-            else if ((hand_side == 1) && f == 0 && j == 0) // Right thumb - multiply initial quaternion
-            {
-                LQuaternionf e, f, g, gfe;
-                e.set_from_axis_angle(-1.39323033616515f * 180.0f / M_PI, LVecBase3(1, 0, 0));
-                f.set_from_axis_angle(0.533031068419669f * 180.0f / M_PI, LVecBase3(0, 0, -1));
-                g.set_from_axis_angle(0.907932313878427f * 180.0f / M_PI, LVecBase3(0, 1, 0));
-                gfe = g * f * e;
-                LQuaternionf h;
-                h.set_from_axis_angle(-45, LVecBase3(0, 1, 0));
-                gfe = h * gfe;
-                quat_result = quat_result * gfe;
-            }
-
-            // Set rotation on 3d model
-            auto hpr = quat_result.get_hpr();
-            if (j != 3) // Not tip (tip does not have joint)
-                hand->GetJointData(model_index)->Get3DModel()->SetHPR(hpr);
+                // <<Position>>
+                // Get position from sensor (local coordinate from root(=wrist))
+                LVecBase3 temp_pos = getTPose.GetPosition();
+                temp_pos *= 0.001f;
+                if (j != 3)
+                    hand->GetJointData(model_index)->SetPosition(temp_pos); // Save the local position
 
-            // Set rotation about ring & pinky joints same with middle joint
-            if (f == 2 && j != 3)
-            {
-                hand->GetJointData(model_index + 4)->Get3DModel()->SetHPR(hpr);
-                hand->GetJointData(model_index + 8)->Get3DModel()->SetHPR(hpr);
-            }
+                if (is_position_tracked)
+                {
+                    // Rotate to hand model origin pose
+                    temp_pos = rotate_pos_by_quat(temp_pos, root_quat);
 
-            // <<Position>>
-            // Get position from sensor (local coordinate from root(=wrist))
-            LVecBase3 temp_pos = getTPose.GetPosition();
-            temp_pos *= 0.001f;
-            if (j != 3)
-                hand->GetJointData(model_index)->SetPosition(temp_pos); // Save the local position
+                    // Set local position to world position
+                    LVecBase3 new_pos;
+                    new_pos = root_pos + temp_pos;
 
-            if (props_.get("subsystem.handmocap_position", false))
-            {
-                // Rotate to hand model origin pose
-                LQuaternionf root_quat;
-                if (hand_side == 0)
-                    root_quat = hand->GetJointData(21)->GetOrientation();
-                else if (hand_side == 1)
-                    root_quat = hand->GetJointData(43)->GetOrientation();
-                temp_pos = rotate_pos_by_quat(temp_pos, root_quat);
-
-                // Set local position to world position
-                LVecBase3 root_pos;
-                if (hand_side == 0)
-                    root_pos = hand->GetJointData(21)->Get3DModel()->GetPosition(world);
-                else if (hand_side == 1)
-                    root_pos = hand->GetJointData(43)->Get3DModel()->GetPosition(world);
-                LVecBase3 new_pos;
-                new_pos = root_pos + temp_pos;
-
-                // Set position on 3d model
-                if (j != 3)
-                    hand->GetJointData(model_index)->Get3DModel()->SetPosition(new_pos, world);
+                    // Set position on 3d model (world space depends on ancestors, so not cached)
+                    if (j != 3)
+                        hand->GetJointData(model_index)->Get3DModel()->SetPosition(new_pos, world);
+                }
             }
         }
     }
 
     if (props_.get("subsystem.handmocap_scale", false))
     {
-        // Set sensor offset
-        if (hand_side == 0)
-        {
-            // Left palm
-            const int i = 21;
+        CRHANDS_PROFILE_STAGE(PROFILE_STAGE_SCALE);
 
-            // offset
-            {
-                float dist = hand->GetJointData(9)->GetPosition().length(); // middle finger_1
-                hand->GetJointData(i)->SetSensorOffset(dist);
-            }
-        }
-        else if (hand_side == 1)
-        {
-            // Right palm
-            const int i = 43;
-
-            // offset
-            {
-                float dist = hand->GetJointData(31)->GetPosition().length(); // middle finger_1
-                hand->GetJointData(i)->SetSensorOffset(dist);
-            }
-
-            // width
-            {
-                const LVecBase3& middle_1 = hand->GetJointData(31)->GetPosition();
-                const LVecBase3& thumb_1 = hand->GetJointData(23)->GetPosition();
-                float dist = (middle_1 - thumb_1).length();
-                hand->GetJointData(i)->SetSensorWidth(dist);
-            }
-
-            // thickness
-            {
-                float dist = hand->GetJointData(23)->GetPosition().length();
-                hand->GetJointData(i)->SetSensorThickness(dist);
-            }
-        }
-
-        // Finger bone
+        // finger bone lengths measured by sensor
+        ScaleSegmentLengths segment_lengths;
         for (int f = 0; f < 3; f++)
         {
             for (int j = 0; j < 3; j++)
             {
                 const int index = (hand_side * 12) + (f * 4) + j;
-                const int model_index = 1 + (hand_side * 22) + (f * 4) + j;
+                const int model_index = HandTopology::get_joint_index(hand_side, f, j);
 
-                // offset
+                const auto& pos_cur = hand->GetJointData(model_index)->GetPosition();
                 if (j != 2)
                 {
-                    const auto& pos_cur = hand->GetJointData(model_index)->GetPosition();
                     const auto& pos_next = hand->GetJointData(model_index + 1)->GetPosition();
-                    float dist = (pos_cur - pos_next).length();
-                    hand->GetJointData(model_index)->SetSensorOffset(dist);
+                    segment_lengths[f * 3 + j] = (pos_cur - pos_next).length();
                 }
                 else
                 {
-                    const auto& pos_cur = hand->GetJointData(model_index)->GetPosition();
-                    const auto& pos_next = amo->GetAvatarMemory().at(index + 1).GetPosition() * 0.001f;
-                    float dist = (pos_cur - pos_next).length();
-                    hand->GetJointData(model_index)->SetSensorOffset(dist);
+                    const auto& pos_next = amo->GetAvatarMemory(index + 1).GetPosition() * 0.001f;
+                    segment_lengths[f * 3 + j] = (pos_cur - pos_next).length();
                 }
             }
         }
 
-        // Do auto-scaling by offset ratio on mechanism
-        // Left palm
-        if (hand_side == 0)
+        // scaling is updated only after calibration or when the lengths are changed
+        if (is_hand_scale_dirty(hand_side, segment_lengths))
         {
-            int i = 21;
+            update_hand_mocap_scale(hand, hand_side, segment_lengths);
+            scaled_segment_lengths_[hand_side] = segment_lengths;
+            is_scale_dirty_[hand_side] = false;
+        }
+    }
+}
 
-            LVecBase3 origin_scale = hand->GetJointData(i)->Get3DModelStandardPoseScale();
+void HandManager::update_hand_mocap_scale(crsf::TCRHand* hand, HandIndex hand_side, const ScaleSegmentLengths& segment_lengths)
+{
+    const int palm_index = HandTopology::get_wrist_index(hand_side);
+    const int thumb_1 = HandTopology::get_joint_index(hand_side, HandTopology::FINGER_THUMB, 0);
+    const int middle_1 = HandTopology::get_joint_index(hand_side, HandTopology::FINGER_MIDDLE, 0);
 
-            float modified_offset_ratio = hand->GetJointData(i)->GetScalingRatio_Offset();
-            float modified_width_ratio = hand->GetJointData(i)->GetScalingRatio_Width();
-            float modified_thickness_ratio = hand->GetJointData(i)->GetScalingRatio_Thickness();
+    // Set sensor offset
+    {
+        // offset
+        {
+            float dist = hand->GetJointData(middle_1)->GetPosition().length();
+            hand->GetJointData(palm_index)->SetSensorOffset(dist);
+        }
 
-            LVecBase3 modified_scale = LVecBase3(origin_scale[0] * modified_offset_ratio,
-                origin_scale[1] * modified_width_ratio,
-                origin_scale[2] * modified_thickness_ratio);
-            hand->GetJointData(i)->Get3DModel()->SetScale(modified_scale);
+        // width and thickness are measured only in right palm
+        if (hand_side == HAND_INDEX_RIGHT)
+        {
+            // width
+            {
+                const LVecBase3& middle_1_pos = hand->GetJointData(middle_1)->GetPosition();
+                const LVecBase3& thumb_1_pos = hand->GetJointData(thumb_1)->GetPosition();
+                float dist = (middle_1_pos - thumb_1_pos).length();
+                hand->GetJointData(palm_index)->SetSensorWidth(dist);
+            }
 
-            int thumb_start = 1;
-            for (int j = 0; j < 5; j++)
+            // thickness
             {
-                int cur_index = thumb_start + (j * 4);
-                // hierarchy tree scaling (local scale balancing)
-                LVecBase3 nextJoint_scale = hand->GetJointData(cur_index)->Get3DModelStandardPoseScale();
-                nextJoint_scale[0] *= 1.0f / modified_offset_ratio;
-                hand->GetJointData(cur_index)->Get3DModel()->SetScale(nextJoint_scale);
+                float dist = hand->GetJointData(thumb_1)->GetPosition().length();
+                hand->GetJointData(palm_index)->SetSensorThickness(dist);
             }
         }
-        else if (hand_side == 1)    // Right palm
+    }
+
+    // Finger bone
+    for (int f = 0; f < 3; f++)
+    {
+        for (int j = 0; j < 3; j++)
         {
-            int i = 43;
+            const int model_index = HandTopology::get_joint_index(hand_side, f, j);
+            hand->GetJointData(model_index)->SetSensorOffset(segment_lengths[f * 3 + j]);
+        }
+    }
 
-            LVecBase3 origin_scale = hand->GetJointData(i)->Get3DModelStandardPoseScale();
+    // Do auto-scaling by offset ratio on mechanism
+    {
+        LVecBase3 origin_scale = hand->GetJointData(palm_index)->Get3DModelStandardPoseScale();
 
-            float modified_offset_ratio = hand->GetJointData(i)->GetScalingRatio_Offset();
-            float modified_width_ratio = hand->GetJointData(i)->GetScalingRatio_Width();
-            float modified_thickness_ratio = hand->GetJointData(i)->GetScalingRatio_Thickness();
+        float modified_offset_ratio = hand->GetJointData(palm_index)->GetScalingRatio_Offset();
 
-            LVecBase3 modified_scale = LVecBase3(origin_scale[0] * modified_offset_ratio,
-                origin_scale[1],
-                origin_scale[2]);
-            hand->GetJointData(i)->Get3DModel()->SetScale(modified_scale);
+        LVecBase3 modified_scale = LVecBase3(origin_scale[0] * modified_offset_ratio,
+            origin_scale[1],
+            origin_scale[2]);
 
-            int thumb_start = 23;
-            for (int f = 0; f < 5; f++)
-            {
-                int cur_index = thumb_start + (f * 4);
-                // hierarchy tree scaling (local scale balancing)
-                LVecBase3 nextJoint_scale = hand->GetJointData(cur_index)->Get3DModelStandardPoseScale();
-                nextJoint_scale[0] *= 1.0f / modified_offset_ratio;
-                hand->GetJointData(cur_index)->Get3DModel()->SetScale(nextJoint_scale);
-            }
+        // width and thickness ratios are applied only in left palm
+        if (hand_side == HAND_INDEX_LEFT)
+        {
+            modified_scale[1] *= hand->GetJointData(palm_index)->GetScalingRatio_Width();
+            modified_scale[2] *= hand->GetJointData(palm_index)->GetScalingRatio_Thickness();
         }
+        set_joint_scale(hand, palm_index, modified_scale);
 
-        // Finger bone
-        for (int f = 0; f < 3; f++)
+        for (int f = 0; f < HandTopology::FINGER_COUNT; f++)
         {
-            for (int j = 0; j < 3; j++)
-            {
-                const int i = 1 + (hand_side * 22) + (f * 4) + j;
+            const int cur_index = HandTopology::get_joint_index(hand_side, f, 0);
+            // hierarchy tree scaling (local scale balancing)
+            LVecBase3 nextJoint_scale = hand->GetJointData(cur_index)->Get3DModelStandardPoseScale();
+            nextJoint_scale[0] *= 1.0f / modified_offset_ratio;
+            set_joint_scale(hand, cur_index, nextJoint_scale);
+        }
+    }
+
+    // Finger bone
+    for (int f = 0; f < 3; f++)
+    {
+        for (int j = 0; j < 3; j++)
+        {
+            const int i = HandTopology::get_joint_index(hand_side, f, j);
 
-                LVecBase3 origin_scale = hand->GetJointData(i)->Get3DModel()->GetScale();
+            // scale set by the palm or the previous bone above
+            LVecBase3 origin_scale = applied_joint_scales_[i];
 
-                float modified_offset_ratio = hand->GetJointData(i)->GetScalingRatio_Offset();
+            float modified_offset_ratio = hand->GetJointData(i)->GetScalingRatio_Offset();
 
-                LVecBase3 modified_scale = LVecBase3(origin_scale[0] * modified_offset_ratio,
-                    origin_scale[1],
-                    origin_scale[2]);
-                hand->GetJointData(i)->Get3DModel()->SetScale(modified_scale);
+            LVecBase3 modified_scale = LVecBase3(origin_scale[0] * modified_offset_ratio,
+                origin_scale[1],
+                origin_scale[2]);
+            set_joint_scale(hand, i, modified_scale);
 
-                // hierarchy tree scaling (local scale balancing)
-                if (j != 2)
-                {
-                    LVecBase3 nextJoint_scale = hand->GetJointData(i + 1)->Get3DModelStandardPoseScale();
-                    nextJoint_scale[0] *= 1.0f / modified_offset_ratio;
-                    hand->GetJointData(i + 1)->Get3DModel()->SetScale(nextJoint_scale);
+            // hierarchy tree scaling (local scale balancing)
+            if (j != 2)
+            {
+                LVecBase3 nextJoint_scale = hand->GetJointData(i + 1)->Get3DModelStandardPoseScale();
+                nextJoint_scale[0] *= 1.0f / modified_offset_ratio;
+                set_joint_scale(hand, i + 1, nextJoint_scale);
 
-                    if (f == 2)
-                    {
-                        hand->GetJointData(i + 1 + 4)->Get3DModel()->SetScale(nextJoint_scale);
-                        hand->GetJointData(i + 1 + 8)->Get3DModel()->SetScale(nextJoint_scale);
-                    }
+                if (f == 2)
+                {
+                    set_joint_scale(hand, i + 1 + 4, nextJoint_scale);
+                    set_joint_scale(hand, i + 1 + 8, nextJoint_scale);
                 }
             }
         }
@@ -310,34 +252,33 @@ void HandManager::render_hand_mocap(Hand* hand, crsf::TAvatarMemoryObject* amo)
         return;
 
     auto crhand = hand->get_hand();
+    auto& joint_write_cache = hand->get_joint_write_cache();
 
-    auto world = crsf::TGraphicRenderEngine::GetInstance()->GetWorld();
+    const HandMoCAPMode hand_mocap_mode = hand_mocap_mode_.load(std::memory_order_acquire);
 
-    if ((hand_mocap_mode_ & HAND_MOCAP_MODE_LEFT) != 0)
-        render_hand_mocap_side(crhand, amo, HAND_INDEX_LEFT);
+    if ((hand_mocap_mode & HAND_MOCAP_MODE_LEFT) != 0)
+        render_hand_mocap_side(crhand, joint_write_cache, amo, HAND_INDEX_LEFT);
 
-    if ((hand_mocap_mode_ & HAND_MOCAP_MODE_RIGHT) != 0)
-        render_hand_mocap_side(crhand, amo, HAND_INDEX_RIGHT);
+    if ((hand_mocap_mode & HAND_MOCAP_MODE_RIGHT) != 0)
+        render_hand_mocap_side(crhand, joint_write_cache, amo, HAND_INDEX_RIGHT);
 
+    // wrists follow trackers instead of device memory, so latency probe cannot find its markers
     render_hand_mocap_tracker(crhand);
 
     auto dest_amo = hand->get_avatar_memory_object();
     if (dest_amo)
     {
-        auto dest_poses = dest_amo->GetAvatarMemory();
+        CRHANDS_PROFILE_STAGE(PROFILE_STAGE_POSE_PUBLISH);
 
-        const unsigned int joint_number = crhand->GetJointNumber();
+        auto& dest_poses = hand->get_dest_pose_buffer();
+        dest_poses = dest_amo->GetAvatarMemory();
 
-        // Loop all joint
-        for (unsigned int i = 0; i < joint_number; i++)
-        {
-            crsf::TWorldObject* joint_model = crhand->GetJointData(i)->Get3DModel();
-            if (joint_model)
-                dest_poses[i].MakePosQuat(joint_model->GetPosition(world), joint_model->GetQuaternion(world));
-        }
+        // world poses of all joints in one pass
+        hand->update_kinematics().write_poses(dest_poses);
 
         dest_amo->SetAvatarMemory(dest_poses);
         dest_amo->UpdateAvatarMemoryObject();
+        get_latency_probe().mark(LATENCY_STAGE_PUBLISH);
     }
 }
 
@@ -346,6 +287,8 @@ void HandManager::render_hand_mocap_tracker(crsf::TCRHand* crhand)
     if (!crhand)
         return;
 
+    CRHANDS_PROFILE_STAGE(PROFILE_STAGE_TRACKER);
+
     if (!app_.dsm_->HasMemoryObject<crsf::TPointMemoryObject>("OpenVRPoint"))
         return;
 
@@ -354,64 +297,27 @@ void HandManager::render_hand_mocap_tracker(crsf::TCRHand* crhand)
 
     auto world = crsf::TGraphicRenderEngine::GetInstance()->GetWorld();
 
-    // left
-    auto hand_21 = crhand->GetJointData(21);
-    if (tracker_indices_[HAND_INDEX_LEFT] == -1)
-    {
-        hand_21->Get3DModel()->SetPosition(LVecBase3(100), world);
-        hand_21->SetPosition(LVecBase3(100));
-    }
-    else
+    for (int side = 0; side < HandTopology::SIDE_COUNT; ++side)
     {
-        auto tracker_pos = points[tracker_indices_[HAND_INDEX_LEFT]].m_Pose.GetPosition();
-        auto tracker_quat = points[tracker_indices_[HAND_INDEX_LEFT]].m_Pose.GetQuaternion();
-
-        LQuaternionf a, b, ba;
-        a.set_from_axis_angle(90, LVecBase3(0, 0, 1));
-        b.set_from_axis_angle(90, LVecBase3(0, 1, 0));
-        ba = b * a;
-        tracker_quat = ba * tracker_quat;
-
-        hand_21->Get3DModel()->SetPosition(tracker_pos, world);
-        hand_21->SetPosition(tracker_pos);
-        hand_21->Get3DModel()->SetHPR(tracker_quat.get_hpr(), world);
-
-        LQuaternionf c, d, dc;
-        c.set_from_axis_angle(90, LVecBase3(0, 0, 1));
-        d.set_from_axis_angle(90, LVecBase3(1, 0, 0));
-        dc = d * c;
-        tracker_quat = dc * tracker_quat;
-        hand_21->SetOrientation(tracker_quat);
-    }
+        const int wrist_index = HandTopology::get_wrist_index(side);
+        auto wrist = crhand->GetJointData(wrist_index);
+        if (tracker_indices_[side] == -1)
+        {
+            wrist->Get3DModel()->SetPosition(LVecBase3(100), world);
+            wrist->SetPosition(LVecBase3(100));
+        }
+        else
+        {
+            auto tracker_pos = points[tracker_indices_[side]].m_Pose.GetPosition();
+            auto tracker_quat = points[tracker_indices_[side]].m_Pose.GetQuaternion();
 
-    // right
-    auto hand_43 = crhand->GetJointData(43);
-    if (tracker_indices_[HAND_INDEX_RIGHT] == -1)
-    {
-        hand_43->Get3DModel()->SetPosition(LVecBase3(100), world);
-        hand_43->SetPosition(LVecBase3(100));
-    }
-    else
-    {
-        auto tracker_pos = points[tracker_indices_[HAND_INDEX_RIGHT]].m_Pose.GetPosition();
-        auto tracker_quat = points[tracker_indices_[HAND_INDEX_RIGHT]].m_Pose.GetQuaternion();
-
-        LQuaternionf a, b, c, cba;
-        a.set_from_axis_angle(90, LVecBase3(0, 0, 1));
-        b.set_from_axis_angle(180, LVecBase3(1, 0, 0));
-        c.set_from_axis_angle(-90, LVecBase3(0, 1, 0));
-        cba = c * b * a;
-        tracker_quat = cba * tracker_quat;
-
-        hand_43->Get3DModel()->SetPosition(tracker_pos, world);
-        hand_43->SetPosition(tracker_pos);
-        hand_43->Get3DModel()->SetHPR(tracker_quat.get_hpr(), world);
-
-        LQuaternionf d, e, ed;
-        d.set_from_axis_angle(-90, LVecBase3(0, 0, 1));
-        e.set_from_axis_angle(-90, LVecBase3(1, 0, 0));
-        ed = e * d;
-        tracker_quat = ed * tracker_quat;
-        hand_43->SetOrientation(tracker_quat);
+            tracker_quat = retarget_hand_mocap_tracker_to_model(tracker_quat, side);
+
+            wrist->Get3DModel()->SetPosition(tracker_pos, world);
+            wrist->SetPosition(tracker_pos);
+            wrist->Get3DModel()->SetHPR(tracker_quat.get_hpr(), world);
+
+            wrist->SetOrientation(retarget_hand_mocap_model_to_joint(tracker_quat, side));
+        }
     }
 }
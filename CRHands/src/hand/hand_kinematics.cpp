@@ -0,0 +1,100 @@
+/**
+* Coexistence Reality Software Framework (CRSF)
+* Copyright (c) Center of Human-centered Interaction for Coexistence. All rights reserved.
+* See the LICENSE.md file for more details.
+*/
+
+#include "hand_kinematics.hpp"
+
+#include <algorithm>
+
+#include <crsf/CRModel/TCRHand.h>
+#include <crsf/CRModel/TWorldObject.h>
+#include <crsf/System/TPose.h>
+
+#include "hand/hand_topology.hpp"
+#include "util/rigid_transform.hpp"
+
+void HandKinematics::bind(crsf::TCRHand* hand)
+{
+    hand_ = hand;
+
+    const int joint_count = hand ? (std::min)(static_cast<int>(hand->GetJointNumber()), static_cast<int>(HandTopology::JOINT_COUNT)) : 0;
+
+    models_.assign(joint_count, nullptr);
+    model_parents_.assign(joint_count, nullptr);
+    for (int k = 0; k < joint_count; ++k)
+    {
+        models_[k] = hand->GetJointData(k)->Get3DModel();
+        if (models_[k])
+            model_parents_[k] = models_[k]->GetParent();
+    }
+
+    std::vector<int> parents(joint_count, -1);
+    is_local_.assign(joint_count, false);
+    for (int k = 0; k < joint_count; ++k)
+    {
+        const int parent = hand_topology.get_joint(k).parent;
+        if (!models_[k] || parent < 0 || parent >= joint_count || !models_[parent])
+            continue;
+
+        // local transform is usable only if scene graph follows topology
+        if (models_[k]->GetParent() != models_[parent])
+            continue;
+
+        parents[k] = parent;
+        is_local_[k] = true;
+    }
+
+    forward_kinematics_.set_parents(parents);
+}
+
+bool HandKinematics::is_bound(crsf::TCRHand* hand) const
+{
+    if (hand_ != hand)
+        return false;
+
+    const int joint_count = hand ? (std::min)(static_cast<int>(hand->GetJointNumber()), static_cast<int>(HandTopology::JOINT_COUNT)) : 0;
+    if (joint_count != get_joint_count())
+        return false;
+
+    // joint tree depends on models and their parents
+    for (int k = 0; k < joint_count; ++k)
+    {
+        const crsf::TWorldObject* model = hand->GetJointData(k)->Get3DModel();
+        if (model != models_[k] || (model && model->GetParent() != model_parents_[k]))
+            return false;
+    }
+
+    return true;
+}
+
+void HandKinematics::update(crsf::TWorldObject* world)
+{
+    const int joint_count = get_joint_count();
+    for (int k = 0; k < joint_count; ++k)
+    {
+        if (!models_[k])
+            continue;
+
+        forward_kinematics_.set_local(k, is_local_[k] ? models_[k]->GetMatrix() : models_[k]->GetMatrix(world));
+    }
+
+    forward_kinematics_.update();
+}
+
+LQuaternionf HandKinematics::get_quaternion(int joint) const
+{
+    // joint scale is not uniform, so children may have shear.
+    return RigidTransform::get_rotation(forward_kinematics_.get_world(joint));
+}
+
+void HandKinematics::write_poses(std::vector<crsf::TPose>& poses) const
+{
+    const int joint_count = (std::min)(get_joint_count(), static_cast<int>(poses.size()));
+    for (int k = 0; k < joint_count; ++k)
+    {
+        if (models_[k])
+            poses[k].MakePosQuat(get_position(k), get_quaternion(k));
+    }
+}
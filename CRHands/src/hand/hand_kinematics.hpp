@@ -0,0 +1,74 @@
+/**
+* Coexistence Reality Software Framework (CRSF)
+* Copyright (c) Center of Human-centered Interaction for Coexistence. All rights reserved.
+* See the LICENSE.md file for more details.
+*/
+
+#pragma once
+
+#include <vector>
+
+#include "util/forward_kinematics.hpp"
+
+namespace crsf {
+class TCRHand;
+class TWorldObject;
+class TPose;
+}
+
+/**
+ * World poses of joint models of a hand in one forward pass over HandTopology.
+ *
+ * Joints whose model is a child of the model of topology parent are composed from local transform.
+ * The others (roots, wrists, and joints of a rig with another hierarchy) read world transform from scene graph.
+ */
+class HandKinematics
+{
+public:
+    /** Build joint tree of @a hand. */
+    void bind(crsf::TCRHand* hand);
+
+    /** False if @a hand is another hand, or its joint models are replaced or reparented since bind(). */
+    bool is_bound(crsf::TCRHand* hand) const;
+
+    /** Read local transforms from joint models and compute world transforms relative to @a world. */
+    void update(crsf::TWorldObject* world);
+
+    int get_joint_count() const;
+
+    /** False if the joint does not have 3D model. */
+    bool has_joint(int joint) const;
+
+    LVecBase3 get_position(int joint) const;
+
+    /** Rotation without scale and shear, decomposed as Panda decompose_matrix (Z-up right-handed). */
+    LQuaternionf get_quaternion(int joint) const;
+
+    /** Write world poses of joints which have 3D model to @a poses. */
+    void write_poses(std::vector<crsf::TPose>& poses) const;
+
+private:
+    crsf::TCRHand* hand_ = nullptr;
+
+    std::vector<crsf::TWorldObject*> models_;       ///< nullptr if the joint does not have 3D model
+    std::vector<crsf::TWorldObject*> model_parents_;  ///< scene graph parents of models at bind
+    std::vector<bool> is_local_;                    ///< true if transform is relative to parent joint
+    ForwardKinematics forward_kinematics_;
+};
+
+// ************************************************************************************************
+
+inline int HandKinematics::get_joint_count() const
+{
+    return static_cast<int>(models_.size());
+}
+
+inline bool HandKinematics::has_joint(int joint) const
+{
+    return models_[joint] != nullptr;
+}
+
+inline LVecBase3 HandKinematics::get_position(int joint) const
+{
+    return forward_kinematics_.get_world(joint).get_row3(3);
+}
@@ -6,61 +6,49 @@
 
 #include "hand_leap.hpp"
 
+#include <algorithm>
+#include <chrono>
+
 #include <render_pipeline/rppanda/showbase/showbase.hpp>
 #include <render_pipeline/rpcore/globals.hpp>
 
 #include <crsf/CoexistenceInterface/TDynamicStageMemory.h>
 #include <crsf/CoexistenceInterface/TAvatarMemoryObject.h>
-#include <crsf/CREngine/TDynamicModuleManager.h>
 #include <crsf/CRModel/TWorld.h>
 #include <crsf/CRModel/TCharacter.h>
 #include <crsf/CRModel/TCRHand.h>
-#include <crsf/RealWorldInterface/TInterfaceManager.h>
 #include <crsf/RenderingEngine/TGraphicRenderEngine.h>
 #include <crsf/System/TPose.h>
 
-#include <leapmotion_interface.h>
-
 #include "hand/hand.hpp"
+#include "hand/hand_device_session.hpp"
+#include "hand/hand_retarget.hpp"
+#include "hand/hand_topology.hpp"
+#include "util/latency_probe.hpp"
+#include "util/stage_profiler.hpp"
 
-enum LeapMotionMode
+void render_hand_leap_local(Hand* hand, const HandDeviceSession& device_session, crsf::TAvatarMemoryObject* amo)
 {
-    LEAP_MOTION_MODE_FLOOR,
-    LEAP_MOTION_MODE_HMD
-};
-
-void render_hand_leap_local(Hand* hand, crsf::TAvatarMemoryObject* amo)
-{
-    static const double M_PI = std::acos(-1);
-
     if (!hand)
         return;
 
     auto crhand = hand->get_hand();
+    auto& joint_write_cache = hand->get_joint_write_cache();
 
     if (!(crhand->GetHandProperty().m_bRender3DModel && crhand->GetHandProperty().m_p3DModel))
         return;
 
-    auto leapmotion_interface = dynamic_cast<LeapMotionInterface*>(crsf::TInterfaceManager::GetInstance()->GetInputInterface("LeapMotion"));
-    LeapMotionMode leap_mode = LEAP_MOTION_MODE_FLOOR;
-    if (leapmotion_interface)
-    {
-        auto mode = leapmotion_interface->GetMode();
-        if (mode == "HMD")
-            leap_mode = LEAP_MOTION_MODE_HMD;
-        else if (mode == "floor")
-            leap_mode = LEAP_MOTION_MODE_FLOOR;
-    }
+    const auto devices = device_session.get_devices();
+    const LeapMotionMode leap_mode = devices->leap_mode;
 
     auto rendering_engine = crsf::TGraphicRenderEngine::GetInstance();
-    auto world = rendering_engine->GetWorld();
 
     // set matrix from user's origin to LEAP
     LMatrix4f origin_to_leap_mat = LMatrix4f::ident_mat();
     origin_to_leap_mat.set_translate_mat(crhand->GetHandProperty().m_vec3ZeroToSensor);
 
     // VR mode - leap local translation is 'HMD-to-LEAP'
-    if (crsf::TDynamicModuleManager::GetInstance()->IsModuleEnabled("openvr"))
+    if (devices->is_openvr_enabled)
     {
         // set orbit matrix (following camera)
         auto cam_matrix = rpcore::Globals::base->get_cam().get_mat(rpcore::Globals::render);
@@ -73,240 +61,119 @@ void render_hand_leap_local(Hand* hand, crsf::TAvatarMemoryObject* amo)
         hand->get_object()->SetMatrix(origin_to_leap_mat);
     }
 
-    std::vector<crsf::TPose> dest_poses;
-    auto dest_amo = hand->get_avatar_memory_object();
-    if (dest_amo)
-    {
-        dest_poses = dest_amo->GetAvatarMemory();
-    }
-
-    // # joint
-    const unsigned int joint_number = crhand->GetJointNumber();
+    // # joint (joints out of topology are not driven)
+    const unsigned int joint_number = (std::min)(static_cast<unsigned int>(crhand->GetJointNumber()), static_cast<unsigned int>(HandTopology::JOINT_COUNT));
 
-    // Loop all joint
-    for (unsigned int i = 0; i < joint_number; i++)
+    // stamp new sample and evaluate joints at display time
+    auto& pose_resampler = hand->get_pose_resampler();
+    const auto now = PoseResampler::Clock::now();
     {
-        // read joint TPose from AvatarMemory
-        const auto& get_avatar_pose = amo->GetAvatarMemory(i);
-        // read joint TAvatarHeader from AvatarMemory
-        const auto& get_avatar_header = amo->GetAvatarHeader(i);
+        CRHANDS_PROFILE_STAGE(PROFILE_STAGE_INPUT_READ);
 
-        // [position]
-        // 1. read joint position
-        LVecBase3 joint_position = get_avatar_pose.GetPosition();
+        for (unsigned int i = 0; i < joint_number; i++)
+        {
+            const auto& get_avatar_pose = amo->GetAvatarMemory(i);
+            pose_resampler.set_input(i, get_avatar_pose.GetQuaternion(), get_avatar_pose.GetPosition());
+        }
 
-        // 2. register hand joint position
-        crhand->GetJointData(i)->SetPosition(joint_position);
+        pose_resampler.commit_input(now);
+        if (!pose_resampler.evaluate(now))
+            return;
 
-        // [quaternion]
-        // 1. read joint quaternion
-        LQuaternionf joint_quaternion = get_avatar_pose.GetQuaternion();
+        // wrist jerk of sample as read and as rendered
+        if (joint_number == HandTopology::JOINT_COUNT)
+        {
+            LVecBase3 raw_wrists[HandTopology::SIDE_COUNT];
+            LVecBase3 resampled_wrists[HandTopology::SIDE_COUNT];
+            for (int side = 0; side < HandTopology::SIDE_COUNT; ++side)
+            {
+                const int wrist_index = HandTopology::get_wrist_index(side);
+                raw_wrists[side] = amo->GetAvatarMemory(wrist_index).GetPosition();
+                resampled_wrists[side] = pose_resampler.get_position(wrist_index);
+            }
 
-        // 2. register hand joint quaternion
-        crhand->GetJointData(i)->SetOrientation(joint_quaternion);
+            const double now_seconds = std::chrono::duration<double>(now.time_since_epoch()).count();
+            hand->get_jerk_meter(false).add(now_seconds, raw_wrists, HandTopology::SIDE_COUNT);
+            hand->get_jerk_meter(true).add(now_seconds, resampled_wrists, HandTopology::SIDE_COUNT);
 
-        // [pose update]
-        // update 3D model's pose
-        crsf::TWorldObject* joint_model = crhand->GetJointData(i)->Get3DModel();
-        if (joint_model)
-        {
-            LQuaternionf quat_result;
+            get_latency_probe().mark(LATENCY_STAGE_RETARGET, LatencyProbe::Markers{ resampled_wrists[HandTopology::SIDE_LEFT], resampled_wrists[HandTopology::SIDE_RIGHT] });
+        }
+    }
 
-            // left
-            if (i == 1) // thumb_1
-            {
-                // convert leap coordinate -> CRSF hand coordinate
-                if (leap_mode == LEAP_MOTION_MODE_HMD)
-                {
-                    LQuaternionf a, b, ba;
-                    a.set_from_axis_angle(90, LVecBase3(0, 1, 0));
-                    b.set_from_axis_angle(-90, LVecBase3(0, 0, 1));
-                    ba = b * a;
-                    quat_result = ba.conjugate() * joint_quaternion * ba;
-                }
-                else if (leap_mode == LEAP_MOTION_MODE_FLOOR)
-                {
-                    LQuaternionf a, b, ba;
-                    a.set_from_axis_angle(-90, LVecBase3(0, 0, 1));
-                    b.set_from_axis_angle(0, LVecBase3(0, 0, 1));
-                    ba = b * a;
-                    quat_result = ba.conjugate() * joint_quaternion * ba;
-                }
+    {
+        CRHANDS_PROFILE_STAGE(PROFILE_STAGE_RETARGET);
 
-                // multiply quaternion for thumb initial rotation
-                LQuaternionf c, d, e, edc;
-                c.set_from_axis_angle(1.406013982f * 180.0f / M_PI, LVecBase3(-1, 0, 0));
-                d.set_from_axis_angle(0.453798839f * 180.0f / M_PI, LVecBase3(0, 0, -1));
-                e.set_from_axis_angle(0.905946589f * 180.0f / M_PI, LVecBase3(0, 1, 0));
-                edc = e * d * c;
-                LQuaternionf f;
-                f.set_from_axis_angle(-45, LVecBase3(0, 1, 0));
-                edc = f * edc;
-                quat_result = quat_result * edc;
-
-                // set hpr
-                LVecBase3 hpr = quat_result.get_hpr();
-                joint_model->SetHPR(hpr);
-            }
-            else if (i >= 2 && i <= 20)
-            {
-                // convert leap coordinate -> CRSF hand coordinate
-                if (leap_mode == LEAP_MOTION_MODE_HMD)
-                {
-                    LQuaternionf a, b, ba;
-                    a.set_from_axis_angle(90, LVecBase3(0, 1, 0));
-                    b.set_from_axis_angle(-90, LVecBase3(0, 0, 1));
-                    ba = b * a;
-                    quat_result = ba.conjugate() * joint_quaternion * ba;
-                }
-                else if (leap_mode == LEAP_MOTION_MODE_FLOOR)
-                {
-                    LQuaternionf a, b, ba;
-                    a.set_from_axis_angle(-90, LVecBase3(0, 0, 1));
-                    b.set_from_axis_angle(0, LVecBase3(0, 0, 1));
-                    ba = b * a;
-                    quat_result = ba.conjugate() * joint_quaternion * ba;
-                }
+        // Loop all joint
+        for (unsigned int i = 0; i < joint_number; i++)
+        {
+            // [position]
+            // 1. read joint position
+            LVecBase3 joint_position = pose_resampler.get_position(i);
 
-                // set hpr
-                LVecBase3 hpr = quat_result.get_hpr();
-                joint_model->SetHPR(hpr);
-            }
-            else if (i == 21) // root(wrist)
-            {
-                const auto& parent = crhand->Get3DModel()->GetParent();
-                if (parent)
-                {
-                    // set position
-                    joint_model->SetPosition(joint_position, parent);
+            // 2. register hand joint position
+            crhand->GetJointData(i)->SetPosition(joint_position);
 
-                    // rotate hand model to LEAP base
-                    if (leap_mode == LEAP_MOTION_MODE_HMD)
-                    {
-                        LQuaternionf a, b, ba;
-                        a.set_from_axis_angle(-90, LVecBase3(0, 1, 0));
-                        b.set_from_axis_angle(-90, LVecBase3(1, 0, 0));
-                        ba = b * a;
-                        quat_result = ba * joint_quaternion;
-                    }
-                    else if (leap_mode == LEAP_MOTION_MODE_FLOOR)
-                    {
-                        LQuaternionf a, b, ba;
-                        a.set_from_axis_angle(90, LVecBase3(0, 0, 1));
-                        b.set_from_axis_angle(0, LVecBase3(1, 0, 0));
-                        ba = b * a;
-                        quat_result = ba * joint_quaternion;
-                    }
+            // [quaternion]
+            // 1. read joint quaternion
+            LQuaternionf joint_quaternion = pose_resampler.get_quaternion(i);
 
-                    // set hpr
-                    LVecBase3 hpr = quat_result.get_hpr();
-                    joint_model->SetHPR(hpr);
-                }
-            }
+            // 2. register hand joint quaternion
+            crhand->GetJointData(i)->SetOrientation(joint_quaternion);
 
-            // right
-            else if (i == 23) // thumb_1
+            // [pose update]
+            // update 3D model's pose
+            crsf::TWorldObject* joint_model = crhand->GetJointData(i)->Get3DModel();
+            if (joint_model)
             {
-                // convert leap coordinate -> CRSF hand coordinate
-                if (leap_mode == LEAP_MOTION_MODE_HMD)
-                {
-                    LQuaternionf a, b, ba;
-                    a.set_from_axis_angle(90, LVecBase3(0, 1, 0));
-                    b.set_from_axis_angle(-90, LVecBase3(0, 0, 1));
-                    ba = b * a;
-                    quat_result = ba.conjugate() * joint_quaternion * ba;
-                }
-                else if (leap_mode == LEAP_MOTION_MODE_FLOOR)
-                {
-                    LQuaternionf a, b, ba;
-                    a.set_from_axis_angle(-90, LVecBase3(0, 0, 1));
-                    b.set_from_axis_angle(180, LVecBase3(0, 1, 0));
-                    ba = b * a;
-                    quat_result = ba.conjugate() * joint_quaternion * ba;
-                }
+                const auto& joint = hand_topology.get_joint(i);
 
-                // multiply quaternion for thumb initial rotation
-                LQuaternionf c, d, e, edc;
-                c.set_from_axis_angle(-1.406013982f * 180.0f / M_PI, LVecBase3(1, 0, 0));
-                d.set_from_axis_angle(0.453798839f * 180.0f / M_PI, LVecBase3(0, 0, -1));
-                e.set_from_axis_angle(0.905946589f * 180.0f / M_PI, LVecBase3(0, 1, 0));
-                edc = e * d * c;
-                LQuaternionf f;
-                f.set_from_axis_angle(-45, LVecBase3(0, 1, 0));
-                edc = f * edc;
-                quat_result = quat_result * edc;
-
-                // set hpr
-                LVecBase3 hpr = quat_result.get_hpr();
-                joint_model->SetHPR(hpr);
-            }
-            else if (i >= 24 && i <= 42)
-            {
-                // convert leap coordinate -> CRSF hand coordinate
-                if (leap_mode == LEAP_MOTION_MODE_HMD)
+                // fingers: convert leap coordinate -> CRSF hand coordinate
+                // (thumb_1 also multiplies quaternion for thumb initial rotation)
+                if (joint.kind == HandTopology::JOINT_KIND_FINGER)
                 {
-                    LQuaternionf a, b, ba;
-                    a.set_from_axis_angle(90, LVecBase3(0, 1, 0));
-                    b.set_from_axis_angle(-90, LVecBase3(0, 0, 1));
-                    ba = b * a;
-                    quat_result = ba.conjugate() * joint_quaternion * ba;
+                    const bool is_thumb_base = joint.finger == HandTopology::FINGER_THUMB && joint.segment == 0;
+                    LQuaternionf quat_result = retarget_leap_joint(joint_quaternion, leap_mode, joint.side, is_thumb_base);
+
+                    // set hpr
+                    if (joint_write_cache.update_rotation(i, quat_result))
+                        joint_model->SetHPR(quat_result.get_hpr());
                 }
-                else if (leap_mode == LEAP_MOTION_MODE_FLOOR)
+                else if (joint.kind == HandTopology::JOINT_KIND_WRIST)
                 {
-                    LQuaternionf a, b, ba;
-                    a.set_from_axis_angle(-90, LVecBase3(0, 0, 1));
-                    b.set_from_axis_angle(180, LVecBase3(0, 1, 0));
-                    ba = b * a;
-                    quat_result = ba.conjugate() * joint_quaternion * ba;
-                }
+                    const auto& parent = crhand->Get3DModel()->GetParent();
+                    if (parent)
+                    {
+                        // set position
+                        joint_model->SetPosition(joint_position, parent);
 
-                // set hpr
-                LVecBase3 hpr = quat_result.get_hpr();
-                joint_model->SetHPR(hpr);
-            }
-            else if (i == 43) // root(wrist)
-            {
-                const auto& parent = crhand->Get3DModel()->GetParent();
-                if (parent)
-                {
-                    // set position
-                    joint_model->SetPosition(joint_position, parent);
+                        // rotate hand model to LEAP base
+                        LQuaternionf quat_result = retarget_leap_wrist(joint_quaternion, leap_mode, joint.side);
 
-                    // rotate hand model to LEAP base
-                    if (leap_mode == LEAP_MOTION_MODE_HMD)
-                    {
-                        LQuaternionf a, b, ba;
-                        a.set_from_axis_angle(-90, LVecBase3(0, 1, 0));
-                        b.set_from_axis_angle(90, LVecBase3(1, 0, 0));
-                        ba = b * a;
-                        quat_result = ba * joint_quaternion;
+                        // set hpr
+                        if (joint_write_cache.update_rotation(i, quat_result))
+                            joint_model->SetHPR(quat_result.get_hpr());
                     }
-                    else if (leap_mode == LEAP_MOTION_MODE_FLOOR)
-                    {
-                        LQuaternionf a, b, ba;
-                        a.set_from_axis_angle(90, LVecBase3(0, 0, 1));
-                        b.set_from_axis_angle(180, LVecBase3(1, 0, 0));
-                        ba = b * a;
-                        quat_result = ba * joint_quaternion;
-                    }
-
-                    // set hpr
-                    LVecBase3 hpr = quat_result.get_hpr();
-                    joint_model->SetHPR(hpr);
                 }
             }
-
-            if (dest_amo)
-            {
-                dest_poses[i].MakePosition(joint_model->GetPosition(world));
-                dest_poses[i].SetQuaternion(joint_model->GetQuaternion(world));
-            }
         }
     }
+    if (get_latency_probe().is_pulse_in_flight())
+        get_latency_probe().mark_scene_write(hand->get_wrist_markers());
 
+    auto dest_amo = hand->get_avatar_memory_object();
     if (dest_amo)
     {
+        CRHANDS_PROFILE_STAGE(PROFILE_STAGE_POSE_PUBLISH);
+
+        // copy into reused buffer keeps its capacity
+        auto& dest_poses = hand->get_dest_pose_buffer();
+        dest_poses = dest_amo->GetAvatarMemory();
+
+        // world poses of all joints in one pass
+        hand->update_kinematics().write_poses(dest_poses);
+
         dest_amo->SetAvatarMemory(dest_poses);
         dest_amo->UpdateAvatarMemoryObject();
+        get_latency_probe().mark(LATENCY_STAGE_PUBLISH);
     }
 }
@@ -9,5 +9,6 @@ class TAvatarMemoryObject;
 }
 
 class Hand;
+class HandDeviceSession;
 
-void render_hand_leap_local(Hand* hand, crsf::TAvatarMemoryObject* amo);
+void render_hand_leap_local(Hand* hand, const HandDeviceSession& device_session, crsf::TAvatarMemoryObject* amo);
@@ -6,6 +6,9 @@
 
 #include "hand_manager.hpp"
 
+#include <algorithm>
+#include <cmath>
+
 #include <spdlog/logger.h>
 
 #include <crsf/RenderingEngine/TGraphicRenderEngine.h>
@@ -25,10 +28,36 @@
 #include <hand_mocap_module.h>
 #include <hand_mocap_interface.h>
 
+#include "hand/grasp_detection.hpp"
+#include "hand/hand_topology.hpp"
 #include "main.hpp"
+#include "object/jewelry.hpp"
+#include "object/twisty_puzzle.hpp"
+#include "util/latency_probe.hpp"
+#include "util/performance_monitor.hpp"
+#include "util/rigid_transform.hpp"
+#include "util/stage_profiler.hpp"
 
 extern spdlog::logger* global_logger;
 
+namespace {
+
+// wrist of hand side which the interactor is attached to, or nullptr
+crsf::TWorldObject* find_parent_wrist(crsf::THandPhysicsInteractor* interactor)
+{
+	switch (hand_topology.get_side(interactor->GetConnectedJointTag()))
+	{
+	case HandTopology::SIDE_LEFT:
+		return interactor->GetParentHandModel()->Get3DModel_LeftWrist();
+	case HandTopology::SIDE_RIGHT:
+		return interactor->GetParentHandModel()->Get3DModel_RightWrist();
+	default:
+		return nullptr;
+	}
+}
+
+}
+
 bool HandManager::object_collision_event(const std::shared_ptr<crsf::TCRModel>& my_model, const std::shared_ptr<crsf::TCRModel>& evented_model)
 {
     // if my model collided with physics interactor,
@@ -69,9 +98,16 @@ bool HandManager::object_update_event(const std::shared_ptr<crsf::TCRModel>& my_
 
 	crsf::TWorld* world = crsf::TGraphicRenderEngine::GetInstance()->GetWorld();
 
+	// object owned by other node follows the received state, and local grasp waits as a claim
+	const int networked_object_id = find_networked_object_id(my_model.get());
+	if (follow_remote_owner(my_model.get(), networked_object_id))
+	{
+		queue_grasp_claim(my_model.get(), networked_object_id);
+		return false;
+	}
+
     // get contactinformation
 	auto my_physics_model = my_model->GetPhysicsModel();
-	auto my_model_contact_info = my_model->GetPhysicsModel()->GetContactInfo();
 
     // init grasp state
 	bool old_grasp_state = my_physics_model->GetIsGrasped();
@@ -81,129 +117,121 @@ bool HandManager::object_update_event(const std::shared_ptr<crsf::TCRModel>& my_
     Hand_MoCAPInterface::FingerMask vibration_mask[2] = { Hand_MoCAPInterface::FingerMask::FINGER_NONE, Hand_MoCAPInterface::FingerMask::FINGER_NONE };
 
     // current contacted physics particle
-    std::vector<crsf::TCRModel*> current_contacted_physics_interactor;
+    FrameVector<crsf::THandPhysicsInteractor*> current_contacted_physics_interactor{ FrameAllocator<crsf::THandPhysicsInteractor*>(step_arena_) };
 
-    // traverse contacted model
-    for (const auto& contacted_model : my_model_contact_info->GetContactedModel())
     {
-        if (contacted_model->GetModelGroup() == crsf::EMODEL_GROUP_HANDPHYSICSINTERACTOR)
+        CRHANDS_PROFILE_STAGE(PROFILE_STAGE_CONTACT);
+
+        // traverse contacted model
+        contact_view_.assign(my_model.get());
+        for (const auto& contact : contact_view_)
         {
-            // set & get physics interactor information
-            current_contacted_physics_interactor.push_back(contacted_model.get());
-            auto intr = hand_->FindPhysicsInteractor(contacted_model);
-            if (!intr)
-                return false;
-            auto tag = intr->GetConnectedJointTag();
-            intr->SetIsTouched(true);
-
-            // vibration bit masking
-            switch (tag)
+            if (contact.kind == ContactView::CONTACT_KIND_HAND_INTERACTOR)
             {
-            case crsf::LEFT__MIDDLE_4:
-                vibration_mask[Hand_MoCAPInterface::HAND_LEFT] |= Hand_MoCAPInterface::FingerMask::FINGER_MIDDLE;
-                break;
-            case crsf::LEFT__INDEX_4:
-                vibration_mask[Hand_MoCAPInterface::HAND_LEFT] |= Hand_MoCAPInterface::FingerMask::FINGER_INDEX;
-                break;
-            case crsf::LEFT__THUMB_4:
-                vibration_mask[Hand_MoCAPInterface::HAND_LEFT] |= Hand_MoCAPInterface::FingerMask::FINGER_THUMB;
-                break;
-            case crsf::RIGHT__MIDDLE_4:
-                vibration_mask[Hand_MoCAPInterface::HAND_RIGHT] |= Hand_MoCAPInterface::FingerMask::FINGER_MIDDLE;
-                break;
-            case crsf::RIGHT__INDEX_4:
-                vibration_mask[Hand_MoCAPInterface::HAND_RIGHT] |= Hand_MoCAPInterface::FingerMask::FINGER_INDEX;
-                break;
-            case crsf::RIGHT__THUMB_4:
-                vibration_mask[Hand_MoCAPInterface::HAND_RIGHT] |= Hand_MoCAPInterface::FingerMask::FINGER_THUMB;
-                break;
+                // set & get physics interactor information
+                auto intr = contact.interactor;
+                if (intr->GetParentHandModel() != hand_)
+                    return false;
+                current_contacted_physics_interactor.push_back(intr);
+                auto tag = intr->GetConnectedJointTag();
+                intr->SetIsTouched(true);
+
+                // vibration bit masking
+                int haptic_finger = -1;
+                switch (tag)
+                {
+                case crsf::LEFT__MIDDLE_4:
+                    vibration_mask[Hand_MoCAPInterface::HAND_LEFT] |= Hand_MoCAPInterface::FingerMask::FINGER_MIDDLE;
+                    haptic_finger = HapticRenderer::FINGER_MIDDLE;
+                    break;
+                case crsf::LEFT__INDEX_4:
+                    vibration_mask[Hand_MoCAPInterface::HAND_LEFT] |= Hand_MoCAPInterface::FingerMask::FINGER_INDEX;
+                    haptic_finger = HapticRenderer::FINGER_INDEX;
+                    break;
+                case crsf::LEFT__THUMB_4:
+                    vibration_mask[Hand_MoCAPInterface::HAND_LEFT] |= Hand_MoCAPInterface::FingerMask::FINGER_THUMB;
+                    haptic_finger = HapticRenderer::FINGER_THUMB;
+                    break;
+                case crsf::RIGHT__MIDDLE_4:
+                    vibration_mask[Hand_MoCAPInterface::HAND_RIGHT] |= Hand_MoCAPInterface::FingerMask::FINGER_MIDDLE;
+                    haptic_finger = HapticRenderer::FINGER_MIDDLE;
+                    break;
+                case crsf::RIGHT__INDEX_4:
+                    vibration_mask[Hand_MoCAPInterface::HAND_RIGHT] |= Hand_MoCAPInterface::FingerMask::FINGER_INDEX;
+                    haptic_finger = HapticRenderer::FINGER_INDEX;
+                    break;
+                case crsf::RIGHT__THUMB_4:
+                    vibration_mask[Hand_MoCAPInterface::HAND_RIGHT] |= Hand_MoCAPInterface::FingerMask::FINGER_THUMB;
+                    haptic_finger = HapticRenderer::FINGER_THUMB;
+                    break;
+                }
+
+                const int side = hand_topology.get_side(tag);
+                const int haptic_hand = side == HandTopology::SIDE_LEFT ? Hand_MoCAPInterface::HAND_LEFT : Hand_MoCAPInterface::HAND_RIGHT;
+                const int force_finger = (side >= 0 && hand_topology.get_joint(tag).is_tip) ? hand_topology.get_joint(tag).finger : -1;
+
+                // penetration depth is distance from tracked fingertip to interactor blocked by object
+                if ((haptic_renderer_ && haptic_finger >= 0) || (force_feedback_controller_ && force_finger >= 0))
+                {
+                    const LVecBase3 joint_position = hand_state_.get_local_hand(hand_, world).get_position(tag);
+                    const float depth = (joint_position - intr->GetPosition(world)).length();
+
+                    if (haptic_finger >= 0)
+                    {
+                        float& step_depth = step_finger_depths_[haptic_hand][haptic_finger];
+                        step_depth = (std::max)(step_depth, depth);
+                    }
+
+                    if (force_finger >= 0)
+                    {
+                        float& step_depth = step_force_depths_[haptic_hand][force_finger];
+                        step_depth = (std::max)(step_depth, depth);
+                    }
+                }
             }
         }
     }
 
+	// vibration of all objects is sent once after physics step
+	step_hand_mocap_vibrations_[Hand_MoCAPInterface::HAND_LEFT] |= vibration_mask[Hand_MoCAPInterface::HAND_LEFT];
+	step_hand_mocap_vibrations_[Hand_MoCAPInterface::HAND_RIGHT] |= vibration_mask[Hand_MoCAPInterface::HAND_RIGHT];
+
 	// no physics particle collision - return
 	if (current_contacted_physics_interactor.empty())
 	{
+		if (old_grasp_state)
+			release_grasp_ownership(networked_object_id);
+
 		my_physics_model->SetPhysicsType(crsf::EPHYX_TYPE_RIGIDBODY_ACTIVE);
 		hand_->SetIsTouched(false);
 		return false;
 	}
 
-    if (interface_hand_mocap_)
-    {
-        for (auto hand_index : { Hand_MoCAPInterface::HAND_LEFT, Hand_MoCAPInterface::HAND_RIGHT })
-        {
-            if (vibration_mask[hand_index] != last_hand_mocap_vibrations_[hand_index])
-            {
-                interface_hand_mocap_->SetVibration(hand_index, vibration_mask[hand_index]);
-                last_hand_mocap_vibrations_[hand_index] = vibration_mask[hand_index];
-            }
-        }
-    }
+    if (app_.performance_monitor_)
+        app_.performance_monitor_->add_touched_body(static_cast<uint32_t>(current_contacted_physics_interactor.size()));
+
+	CRHANDS_PROFILE_STAGE(PROFILE_STAGE_GRASP);
 
 	// test grasp kinematic feasibility
-	LMatrix4f hand_to_world;
-	int contacted_interactor_size = current_contacted_physics_interactor.size();
-	crsf::THandPhysicsInteractor* intr1;
-	crsf::THandPhysicsInteractor* intr2;
-	LVecBase3 dir1, dir2;
-	int joint1, joint2;
-	for (int i = 0; i < contacted_interactor_size; i++)
+	RigidTransform hand_to_world;
+	const int grasping_side = find_grasping_side(current_contacted_physics_interactor.data(), current_contacted_physics_interactor.size());
+	if (grasping_side >= 0)
 	{
-		intr1 = hand_->FindPhysicsInteractor(current_contacted_physics_interactor[i]);
-		if (!intr1)
-			return false;
-		dir1 = intr1->GetPenetrationDirection();
-		joint1 = intr1->GetConnectedJointTag();
-
-		for (int j = i; j < contacted_interactor_size; j++)
-		{
-			intr2 = hand_->FindPhysicsInteractor(current_contacted_physics_interactor[j]);
-			if (!intr2)
-				return false;
-			dir2 = intr2->GetPenetrationDirection();
-			joint2 = intr2->GetConnectedJointTag();
-
-			float cosangle = dir1.dot(dir2);
-			if (cosangle < -0.7
-				&& joint1 >= 0 && joint1 <= 21 && joint2 >= 0 && joint2 <= 21)
-			{
-				my_physics_model->SetIsGrasped(true);
-				hand_to_world = hand_->Get3DModel_LeftWrist()->GetMatrix(world);
-
-				break;
-			}
-			if (cosangle < -0.7
-				&& joint1 >= 22 && joint1 <= 43 && joint2 >= 22 && joint2 <= 43)
-			{
-				my_physics_model->SetIsGrasped(true);
-				hand_to_world = hand_->Get3DModel_RightWrist()->GetMatrix(world);
-
-				break;
-			}
-		}
+		my_physics_model->SetIsGrasped(true);
+		hand_to_world = hand_state_.get_wrist_transform(grasping_side == HandTopology::SIDE_LEFT ? hand_->Get3DModel_LeftWrist() : hand_->Get3DModel_RightWrist(), world);
 	}
 
+	get_latency_probe().mark(LATENCY_STAGE_GRASP);
+
 	// init relative transform hand <-> object
 	if (!old_grasp_state && my_physics_model->GetIsGrasped())
 	{
-		LVecBase3f scale;
-		LVecBase3f shear;
-		LVecBase3f hpr;
-		LVecBase3f translate;
-		decompose_matrix(hand_to_world, scale, shear, hpr, translate);
-
-		LQuaternionf quat;
-		quat.set_hpr(hpr);
-
-		LMatrix4f rot_mat;
-		quat.extract_to_matrix(rot_mat);
-		rot_mat.set_row(3, translate);
-
-		my_model->SetFixedRelativeTransform(my_model->GetMatrix(world) * invert(rot_mat));
+		my_model->SetFixedRelativeTransform(my_model->GetMatrix(world) * hand_to_world.get_inverse().get_matrix());
+		request_grasp_ownership(networked_object_id);
 	}
 	else if (old_grasp_state && !my_physics_model->GetIsGrasped())
 	{
+		release_grasp_ownership(networked_object_id);
 		my_physics_model->SetPhysicsType(crsf::EPHYX_TYPE_RIGIDBODY_ACTIVE);
 		hand_->SetIsTouched(false);
 	}
@@ -215,20 +243,7 @@ bool HandManager::object_update_event(const std::shared_ptr<crsf::TCRModel>& my_
 
 		LMatrix4f fixed_pose = my_model->GetFixedRelativeTransform();
 
-		LVecBase3f scale;
-		LVecBase3f shear;
-		LVecBase3f hpr;
-		LVecBase3f translate;
-		decompose_matrix(hand_to_world, scale, shear, hpr, translate);
-
-		LQuaternionf quat;
-		quat.set_hpr(hpr);
-
-		LMatrix4f rot_mat;
-		quat.extract_to_matrix(rot_mat);
-		rot_mat.set_row(3, translate);
-
-		auto new_mat = fixed_pose * rot_mat;
+		auto new_mat = fixed_pose * hand_to_world.get_matrix();
 
 		my_model->SetMatrix(new_mat, world, crsf::EMODEL_SETMODE_ONLY_PHYSICS);
 	}
@@ -244,38 +259,38 @@ bool HandManager::object_update_event(const std::shared_ptr<crsf::TCRModel>& my_
 
 bool HandManager::grouped_object_update_event_each(const std::shared_ptr<crsf::TCRModel>& my_model)
 {
+	CRHANDS_PROFILE_STAGE(PROFILE_STAGE_CONTACT);
+
 	my_model->contacted_hand_pointer.clear();
 	my_model->is_contacted = false;
-	for (auto & contacted_model : my_model->GetPhysicsModel()->GetContactInfo()->GetContactedModel())
+	uint32_t contact_count = 0;
+	contact_view_.assign(my_model.get());
+	for (const auto& contact : contact_view_)
 	{
-		auto interactor = std::dynamic_pointer_cast<crsf::THandPhysicsInteractor>(contacted_model);
+		auto interactor = contact.interactor;
 		if (!interactor)
 			continue;
 
-		auto interactor_joint_tag = interactor->GetConnectedJointTag();
-		crsf::TWorldObject* parent_hand_model = nullptr;
-		if (interactor_joint_tag >= 0 && interactor_joint_tag <= 21)
-			parent_hand_model = interactor->GetParentHandModel()->Get3DModel_LeftWrist();
-		else if (interactor_joint_tag >= 22 && interactor_joint_tag <= 43)
-			parent_hand_model = interactor->GetParentHandModel()->Get3DModel_RightWrist();
-		my_model->contacted_hand_pointer.push_back(parent_hand_model);
-
-		for (int i = 0; i < my_model->contacted_hand_pointer.size() - 1; i++)
-		{
-			if (my_model->contacted_hand_pointer[i] == parent_hand_model)
-			{
-				my_model->contacted_hand_pointer.pop_back();
-			}
-		}
+		crsf::TWorldObject* parent_hand_model = find_parent_wrist(interactor);
+		auto& contacted_hand_pointer = my_model->contacted_hand_pointer;
+		if (std::find(contacted_hand_pointer.begin(), contacted_hand_pointer.end(), parent_hand_model) == contacted_hand_pointer.end())
+			contacted_hand_pointer.push_back(parent_hand_model);
 
 		my_model->is_contacted = true;
-		my_model->contacted_physics_particle.push_back(interactor.get());
+		my_model->contacted_physics_particle.push_back(interactor);
+		++contact_count;
 	}
+
+	if (my_model->is_contacted && app_.performance_monitor_)
+		app_.performance_monitor_->add_touched_body(contact_count);
+
 	return false;
 }
 
 bool HandManager::grouped_object_update_event(const std::shared_ptr<crsf::TCRModel>& my_model)
 {
+	CRHANDS_PROFILE_STAGE(PROFILE_STAGE_GRASP);
+
 	auto world = crsf::TGraphicRenderEngine::GetInstance()->GetWorld();
 
 	auto grouped_object_base = dynamic_cast<crsf::TGroupedObjectsBase*>(my_model.get());
@@ -287,15 +302,15 @@ bool HandManager::grouped_object_update_event(const std::shared_ptr<crsf::TCRMod
 	}
 
 	// first, check each object's contacted state
-	std::vector<crsf::TCRModel*> contacted_children;
+	FrameVector<crsf::TCRModel*> contacted_children{ FrameAllocator<crsf::TCRModel*>(step_arena_) };
 
-	for (int i = 0; i < grouped_object_base->GetChildren().size(); i++)
+	for (std::size_t i = 0; i < grouped_object_base->GetChildren().size(); i++)
 	{
 		auto sub_group = dynamic_cast<crsf::TGroupedObjects*>(grouped_object_base->GetChild(i));
 
 		if (sub_group)
 		{
-			for (int j = 0; j < sub_group->GetChildren().size(); j++)
+			for (std::size_t j = 0; j < sub_group->GetChildren().size(); j++)
 			{
 				auto child_model = dynamic_cast<crsf::TCRModel*>(sub_group->GetChild(j));
 
@@ -308,36 +323,12 @@ bool HandManager::grouped_object_update_event(const std::shared_ptr<crsf::TCRMod
 		}
 	}
 
-	// distinguish Contacted Hand
-	int number_of_hand = 2;
-	if (grouped_object_base->is_multi_user_connect)
-		number_of_hand = 4;
-
-	std::vector<crsf::TCRModel*> *contacted_hand = new std::vector<crsf::TCRModel*>[number_of_hand];
-
-	for (int i = 0; i < contacted_children.size(); i++)
-	{
-		for (int j = 0; j < contacted_children[i]->contacted_hand_pointer.size(); j++)
-		{
-			if (hand_pointer_[0] == contacted_children[i]->contacted_hand_pointer[j]) // right hand
-			{
-				contacted_hand[0].push_back(contacted_children[i]);
-			}
-
-			if (hand_pointer_[1] == contacted_children[i]->contacted_hand_pointer[j]) // left hand
-			{
-				contacted_hand[1].push_back(contacted_children[i]);
-			}
-
-			if (grouped_object_base->is_multi_user_connect)
-			{
-				// TBA, multi-user is not considered yet.
-			}
-		}
-	}
+	// distinguish contacted hand by hand ID
+	auto contacted_hand = make_frame_vectors<crsf::TCRModel*, HandRegistry::MAX_HAND_COUNT>(step_arena_);
+	const HandRegistry::HandMask contacted_hand_mask = collect_contacted_hands(hand_registry_, contacted_children.data(), contacted_children.size(), contacted_hand.data());
 
 	// determine grasping
-	std::map<crsf::TWorldObject*, bool> hand_grasped;
+	HandRegistry::HandMask grasped_hand_mask = 0;
 
 	if (grouped_object_base->is_multi_mesh_group)
 	{
@@ -345,59 +336,35 @@ bool HandManager::grouped_object_update_event(const std::shared_ptr<crsf::TCRMod
 	}
 	else
 	{
-		for (int n = 0; n < number_of_hand; n++)
+		for (HandRegistry::HandMask mask = contacted_hand_mask; mask;)
 		{
-			hand_grasped[hand_pointer_[n]] = false;
+			const int n = HandRegistry::pop_hand(mask);
+			if (!is_grasping(contacted_hand[n].data(), contacted_hand[n].size()))
+				continue;
 
-			for (int i = 0; i < contacted_hand[n].size(); i++)
+			auto hand_pointer = hand_registry_.get_wrist(n);
+			if (!grouped_object_base->primary_grasped_hand_pointer)
 			{
-				for (int j = 0; j < contacted_hand[n][i]->contacted_physics_particle.size(); j++)
+				grouped_object_base->primary_grasped_hand_pointer = hand_pointer;
+				grouped_object_base->primary_grasped_hand_number = n;
+			}
+			else
+			{
+				if (grouped_object_base->primary_grasped_hand_pointer != hand_pointer)
 				{
-					for (int k = j; k < contacted_hand[n][i]->contacted_physics_particle.size(); k++)
-					{
-						auto object_1_contact_hand = contacted_hand[n][i]->contacted_physics_particle[j];
-						auto object_2_contact_hand = contacted_hand[n][i]->contacted_physics_particle[k];
-
-						LVecBase3 direction_1 = object_1_contact_hand->GetPenetrationDirection();
-						LVecBase3 direction_2 = object_2_contact_hand->GetPenetrationDirection();
-
-						float cos_angle = direction_1.dot(direction_2);
-
-						if (cos_angle < -0.7)
-						{
-							if (!grouped_object_base->primary_grasped_hand_pointer)
-							{
-								grouped_object_base->primary_grasped_hand_pointer = hand_pointer_[n];
-								grouped_object_base->primary_grasped_hand_number = n;
-							}
-							else
-							{
-								if (grouped_object_base->primary_grasped_hand_pointer != hand_pointer_[n])
-								{
-									grouped_object_base->secondary_grasped_hand_pointer = hand_pointer_[n];
-									grouped_object_base->secondary_grasped_hand_number = n;
-								}
-							}
-
-							hand_grasped[hand_pointer_[n]] = true;
-							goto out1;
-						}
-					}
+					grouped_object_base->secondary_grasped_hand_pointer = hand_pointer;
+					grouped_object_base->secondary_grasped_hand_number = n;
 				}
 			}
-		out1:;
+
+			grasped_hand_mask |= HandRegistry::to_mask(n);
 		}
 	}
 
+	get_latency_probe().mark(LATENCY_STAGE_GRASP);
+
 	// counting grasped hand
-	int grasped_count = 0;
-	for (int i = 0; i < number_of_hand; i++)
-	{
-		if (hand_grasped[hand_pointer_[i]])
-		{
-			grasped_count++;
-		}
-	}
+	const int grasped_count = HandRegistry::count_hands(grasped_hand_mask);
 
 	// two hand grasped case
 	if (grasped_count >= 2)
@@ -406,7 +373,12 @@ bool HandManager::grouped_object_update_event(const std::shared_ptr<crsf::TCRMod
 		{
 			if (grouped_object_base->is_group_changeable) // grouping
 			{
-				//grouped_object_base->grouped_objects_grouping(contacted_hand);
+				// layer grasped by secondary hand rotates
+				if (auto twisty_puzzle = dynamic_cast<TwistyPuzzle*>(grouped_object_base))
+				{
+					const auto& secondary_contacted = contacted_hand[grouped_object_base->secondary_grasped_hand_number];
+					twisty_puzzle->regroup(secondary_contacted.data(), secondary_contacted.size());
+				}
 			}
 
 			if (grouped_object_base->grouped_object_data[0].axis_on_object != LVecBase3(-1) ||
@@ -425,13 +397,14 @@ bool HandManager::grouped_object_update_event(const std::shared_ptr<crsf::TCRMod
 			grouped_object_base->grasped_hand[1] = (crsf::TWorldObject*)grouped_object_base->secondary_grasped_hand_pointer;
 
 			int sub_group_0 = 0, sub_group_1 = 0;
-			for (int i = 0; i < contacted_hand[primary_hand_number].size(); i++)
+			for (std::size_t i = 0; i < contacted_hand[primary_hand_number].size(); i++)
 			{
-				if (grouped_object_base->sub_group[0] == std::dynamic_pointer_cast<crsf::TGroupedObjects>(contacted_hand[primary_hand_number][i]->GetParent()->shared_from_this()))
+				const crsf::TWorldObject* parent = contacted_hand[primary_hand_number][i]->GetParent();
+				if (parent == grouped_object_base->sub_group[0].get())
 				{
 					sub_group_0++;
 				}
-				else if (grouped_object_base->sub_group[1] == std::dynamic_pointer_cast<crsf::TGroupedObjects>(contacted_hand[primary_hand_number][i]->GetParent()->shared_from_this()))
+				else if (parent == grouped_object_base->sub_group[1].get())
 				{
 					sub_group_1++;
 				}
@@ -459,18 +432,13 @@ bool HandManager::grouped_object_update_event(const std::shared_ptr<crsf::TCRMod
 
 				for (int i = 0; i < 2; i++)
 				{
-					for (int j = 0; j < grouped_object_base->sub_group[i]->GetChildren().size(); j++)
+					for (std::size_t j = 0; j < grouped_object_base->sub_group[i]->GetChildren().size(); j++)
 					{
-						auto model = std::dynamic_pointer_cast<crsf::TCRModel>(grouped_object_base->sub_group[i]->GetChild(i)->shared_from_this());
-						for (int k = 0; k < model->contacted_physics_particle.size(); k++)
+						auto model = static_cast<crsf::TCRModel*>(grouped_object_base->sub_group[i]->GetChild(j));
+						for (std::size_t k = 0; k < model->contacted_physics_particle.size(); k++)
 						{
 							auto interactor = model->contacted_physics_particle[k];
-							auto interactor_joint_tag = interactor->GetConnectedJointTag();
-							crsf::TWorldObject* parent_hand_model = nullptr;
-							if (interactor_joint_tag >= 0 && interactor_joint_tag <= 21)
-								parent_hand_model = interactor->GetParentHandModel()->Get3DModel_LeftWrist();
-							else if (interactor_joint_tag >= 22 && interactor_joint_tag <= 43)
-								parent_hand_model = interactor->GetParentHandModel()->Get3DModel_RightWrist();
+							crsf::TWorldObject* parent_hand_model = find_parent_wrist(interactor);
 
 							if (parent_hand_model == (crsf::TWorldObject*)grouped_object_base->primary_grasped_hand_pointer)
 							{
@@ -501,37 +469,31 @@ bool HandManager::grouped_object_update_event(const std::shared_ptr<crsf::TCRMod
 			if (grouped_object_base->manipulated_object != grouped_object_base->grasped_object[1])
 			{
 				auto primary_hand = (crsf::TWorldObject*)grouped_object_base->primary_grasped_hand_pointer;
-				LMatrix4f world_to_hand = primary_hand->GetMatrix(world);
-				LMatrix4f world_to_group = grouped_object_base->GetMatrix(world);
 
-				LMatrix4f transform_coordinate = LMatrix4f::ident_mat();
-				transform_coordinate.set_row(3, grouped_object_base->grasped_object_data[0].pivot_on_object);
+				// pivot transform is pure translation, so its inverse only shifts translation row
 				LVecBase3 pivot_translation = grouped_object_base->grasped_object_data[0].pivot_on_object_in_group
 					- grouped_object_base->grasped_object_data[0].pivot_on_object;
-				LMatrix4f pivot_transform = LMatrix4f::ident_mat();
-				pivot_transform.set_row(3, pivot_translation);
 				LMatrix4f sub_group_to_sub_group_relative_transform = grouped_object_base->grasped_object[0]->GetMatrix();
-				sub_group_to_sub_group_relative_transform = sub_group_to_sub_group_relative_transform * invert(pivot_transform);
+				sub_group_to_sub_group_relative_transform.set_row(3, sub_group_to_sub_group_relative_transform.get_row3(3) - pivot_translation);
 
-				LMatrix4f hand_to_group = sub_group_to_sub_group_relative_transform * world_to_group * invert(world_to_hand);
+				// hand model has scale, so get relative matrix from scene graph instead of inverting world matrix
+				LMatrix4f hand_to_group = sub_group_to_sub_group_relative_transform * grouped_object_base->GetMatrix(primary_hand);
 
 				grouped_object_base->SetMatrix(hand_to_group);
 
-				grouped_object_base->grasped_object[1]->SetMatrix(invert(grouped_object_base->grasped_object[0]->GetMatrix()));
+				// sub group matrix is hinge rotation (rigid)
+				grouped_object_base->grasped_object[1]->SetMatrix(RigidTransform::from_matrix(grouped_object_base->grasped_object[0]->GetMatrix()).get_inverse().get_matrix());
 				grouped_object_base->grasped_object[0]->SetMatrix(LMatrix4f::ident_mat());
 			}
 
 			grouped_object_base->manipulated_object = grouped_object_base->grasped_object[1];
 
+			const bool is_grasp_started = grouped_object_base->first_time;
 			if (grouped_object_base->first_time)
 			{
 				for (int i = 0; i < 2; i++)
 				{
-					LMatrix4f world_to_hand = grouped_object_base->grasped_hand[i]->GetMatrix(world);
-					LMatrix4f world_to_sub_group = grouped_object_base->grasped_object[i]->GetMatrix(world);
-
-					grouped_object_base->fixed_relative_transform[i] = world_to_sub_group;
-					grouped_object_base->fixed_relative_transform[i] = grouped_object_base->fixed_relative_transform[i] * invert(world_to_hand);
+					grouped_object_base->fixed_relative_transform[i] = grouped_object_base->grasped_object[i]->GetMatrix(grouped_object_base->grasped_hand[i]);
 				}
 
 				grouped_object_base->first_time = false;
@@ -539,20 +501,25 @@ bool HandManager::grouped_object_update_event(const std::shared_ptr<crsf::TCRMod
 
 			for (int i = 0; i < 2; i++)
 			{
-				LMatrix4f world_to_hand = grouped_object_base->grasped_hand[i]->GetMatrix(world);
+				LMatrix4f world_to_hand = hand_state_.get_wrist_matrix(grouped_object_base->grasped_hand[i], world);
 
 				grouped_object_base->current_hand_global_pose[i] = grouped_object_base->fixed_relative_transform[i];
 				grouped_object_base->current_hand_global_pose[i] = grouped_object_base->current_hand_global_pose[i] * world_to_hand;
 			}
 
-			// TBA, 
-			// TODO : constrained object control algorithm
+			update_hinge_constraint(grouped_object_base, is_grasp_started);
 
 		}
 	}
 	else
 	{
 		grouped_object_base->first_time = true;
+
+		// secondary hand released, so next two hand grasp sets up hinge (and layer) again
+		grouped_object_base->release_object = true;
+
+		if (auto twisty_puzzle = dynamic_cast<TwistyPuzzle*>(grouped_object_base))
+			twisty_puzzle->finish_twist();
 	}
 
 	if (grasped_count >= 1)
@@ -560,26 +527,19 @@ bool HandManager::grouped_object_update_event(const std::shared_ptr<crsf::TCRMod
 		crsf::TWorldObject* primary_hand;
 		if (grasped_count == 1)
 		{
-			for (int i = 0; i < number_of_hand; i++)
-			{
-				if (hand_grasped[hand_pointer_[i]])
-				{
-					primary_hand = hand_pointer_[i];
-					grouped_object_base->primary_grasped_hand_pointer = primary_hand;
-					grouped_object_base->primary_grasped_hand_number = i;
+			HandRegistry::HandMask mask = grasped_hand_mask;
+			const int hand_id = HandRegistry::pop_hand(mask);
 
-					break;
-				}
-			}
+			primary_hand = hand_registry_.get_wrist(hand_id);
+			grouped_object_base->primary_grasped_hand_pointer = primary_hand;
+			grouped_object_base->primary_grasped_hand_number = hand_id;
 		}
 		else
 		{
 			primary_hand = (crsf::TWorldObject*)grouped_object_base->primary_grasped_hand_pointer;
 		}
 
-		LMatrix4f world_to_hand = primary_hand->GetMatrix(world);
-		LMatrix4f world_to_cube = grouped_object_base->GetMatrix(world);
-		LMatrix4f hand_to_cube = world_to_cube * invert(world_to_hand);
+		LMatrix4f hand_to_cube = grouped_object_base->GetMatrix(primary_hand);
 
 		primary_hand->AddWorldObject(grouped_object_base);
 		grouped_object_base->SetMatrix(hand_to_cube);
@@ -588,21 +548,56 @@ bool HandManager::grouped_object_update_event(const std::shared_ptr<crsf::TCRMod
 	{
 		world->AddWorldObject(grouped_object_base);
 
-		auto right_hand = hand_pointer_[0];
-		auto left_hand = hand_pointer_[1];
-
-		if (grouped_object_base->is_multi_user_connect)
-		{
-			// TBA, multi-user is not considered yet.
-		}
-
 		grouped_object_base->primary_grasped_hand_pointer = nullptr;
 		grouped_object_base->secondary_grasped_hand_pointer = nullptr;
 
 		grouped_object_base->release_object = true;
 	}
 
-	delete[] contacted_hand;
-
 	return false;
 }
+
+void HandManager::update_hinge_constraint(crsf::TGroupedObjectsBase* grouped_object_base, bool is_grasp_started)
+{
+	auto jewelry = dynamic_cast<Jewelry*>(grouped_object_base);
+	auto twisty_puzzle = dynamic_cast<TwistyPuzzle*>(grouped_object_base);
+	if (!jewelry && !twisty_puzzle)
+		return;
+
+	auto world = crsf::TGraphicRenderEngine::GetInstance()->GetWorld();
+	auto& hinge_solver = jewelry ? jewelry->get_hinge_solver() : twisty_puzzle->get_hinge_solver();
+	const auto& data = grouped_object_base->grasped_object_data[1];
+
+	// rotation which secondary hand wants to give to grasped_object[1], in grasped_object[0] space
+	const LQuaternionf primary_quat = RigidTransform::from_matrix(grouped_object_base->grasped_object[0]->GetMatrix(world)).get_quat();
+	const LQuaternionf secondary_quat = RigidTransform::from_matrix(grouped_object_base->current_hand_global_pose[1]).get_quat();
+	const LQuaternionf relative_quat = secondary_quat * primary_quat.conjugate();
+
+	if (is_grasp_started)
+	{
+		float start_angle = grouped_object_base->object_angle;
+		float direction = 1.0f;
+
+		if (jewelry)
+		{
+			// positive angle opens sub_group[0] and negative angle opens sub_group[1]
+			start_angle = (data.limit_angle[1] <= 0 ? -1.0f : 1.0f) * std::abs(start_angle);
+		}
+		else if (grouped_object_base->grasped_object[1] != grouped_object_base->sub_group[TwistyPuzzle::LAYER_GROUP])
+		{
+			// hand holds the rest of puzzle, so layer turns opposite
+			direction = -1.0f;
+		}
+
+		hinge_solver.begin(relative_quat, data.axis_on_object, start_angle, direction);
+	}
+
+	float angle = hinge_solver.solve(relative_quat);
+	if (data.has_limit_angle)
+		angle = (std::max)(data.limit_angle[0], (std::min)(angle, data.limit_angle[1]));
+
+	if (jewelry)
+		jewelry->set_hinge_rotation(angle, grouped_object_base->grasped_object[1] == grouped_object_base->sub_group[1] ? 1 : 0);
+	else
+		twisty_puzzle->set_layer_rotation(angle);
+}
@@ -6,6 +6,10 @@
 
 #include "hand_manager.hpp"
 
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+
 #include <spdlog/logger.h>
 
 #include <render_pipeline/rppanda/showbase/showbase.hpp>
@@ -50,27 +54,71 @@
 #include "hand/hand.hpp"
 #include "main.hpp"
 #include "user.hpp"
+#include "util/latency_probe.hpp"
+#include "util/stage_profiler.hpp"
 
 extern spdlog::logger* global_logger;
 
-HandManager::HandManager(MainApp& app, const boost::property_tree::ptree& props) : app_(app), props_(props)
+namespace {
+
+Hand_MoCAPInterface::FingerMask to_finger_mask(uint32_t finger_bits)
+{
+    unsigned int mask = Hand_MoCAPInterface::FINGER_NONE;
+    if (finger_bits & (1u << HapticRenderer::FINGER_THUMB))
+        mask |= Hand_MoCAPInterface::FINGER_THUMB;
+    if (finger_bits & (1u << HapticRenderer::FINGER_INDEX))
+        mask |= Hand_MoCAPInterface::FINGER_INDEX;
+    if (finger_bits & (1u << HapticRenderer::FINGER_MIDDLE))
+        mask |= Hand_MoCAPInterface::FINGER_MIDDLE;
+    return static_cast<Hand_MoCAPInterface::FingerMask>(mask);
+}
+
+}
+
+HandManager::HandManager(MainApp& app, const boost::property_tree::ptree& props) : app_(app), props_(props),
+    step_arena_(props.get("subsystem.step_arena_size", 64 * 1024))
 {
     for (auto&& index: tracker_indices_)
         index = -1;
 
     last_hand_mocap_vibrations_[Hand_MoCAPInterface::HAND_LEFT] = Hand_MoCAPInterface::FINGER_NONE;
     last_hand_mocap_vibrations_[Hand_MoCAPInterface::HAND_RIGHT] = Hand_MoCAPInterface::FINGER_NONE;
+    step_hand_mocap_vibrations_[Hand_MoCAPInterface::HAND_LEFT] = Hand_MoCAPInterface::FINGER_NONE;
+    step_hand_mocap_vibrations_[Hand_MoCAPInterface::HAND_RIGHT] = Hand_MoCAPInterface::FINGER_NONE;
+
+    scale_drift_threshold_ = props_.get("subsystem.scale_drift_threshold", 0.002f);
+    invalidate_hand_scale(HAND_INDEX_LEFT);
+    invalidate_hand_scale(HAND_INDEX_RIGHT);
 
     find_trackers();
     setup_hand();
     setup_hand_event();
+    setup_grasp_ownership();
+
+    // scratch and hand poses of listeners are released once per physics step
+    crsf::TPhysicsManager::GetInstance()->AddTask([this](void) {
+        step_arena_.reset();
+        hand_state_.invalidate();
+
+        // interactor particles of this step follow hand models written before it.
+        // main thread has checked wrists of the scene write, so scene graph is not read here.
+        get_latency_probe().mark_if_scene_has_pulse(LATENCY_STAGE_PHYSICS);
+        return false;
+    }, "reset_step_state");
 }
 
-HandManager::~HandManager() = default;
+HandManager::~HandManager()
+{
+    release_force_feedback();
+}
 
 void HandManager::find_trackers()
 {
-    auto plugin_manager = app_.rendering_engine_->GetRenderPipeline()->get_plugin_mgr();
+    // no render pipeline in headless mode
+    if (!app_.pipeline_)
+        return;
+
+    auto plugin_manager = app_.pipeline_->get_plugin_mgr();
     if (!plugin_manager->is_plugin_enabled("openvr"))
         return;
 
@@ -107,67 +155,202 @@ void HandManager::setup_hand_event(void)
 {
     // calibration
     accept("1", [this](const Event*) {
-        if (interface_hand_mocap_)
+        if (device_session_->get_hand_mocap())
         {
             hand_->InitScalingParameter();
 
-            interface_hand_mocap_->FingerInit(Hand_MoCAPInterface::HAND_LEFT);
-            interface_hand_mocap_->FingerInit(Hand_MoCAPInterface::HAND_RIGHT);
+            calibrate_hand_mocap(HAND_INDEX_LEFT);
+            calibrate_hand_mocap(HAND_INDEX_RIGHT);
 
             is_hand_mocap_calibration_ = true;
         }
 
-        if (interface_unist_mocap_)
+        if (auto interface_unist_mocap = device_session_->get_unist_mocap())
         {
-            interface_unist_mocap_->Calibration();
+            interface_unist_mocap->Calibration();
+
+            invalidate_hand_scale(HAND_INDEX_LEFT);
+            invalidate_hand_scale(HAND_INDEX_RIGHT);
+            reset_joint_write_cache();
         }
     });
 }
 
-void HandManager::setup_hand(void)
+void HandManager::flush_hand_mocap_vibration()
 {
-    auto interface_manager = crsf::TInterfaceManager::GetInstance();
+    CRHANDS_PROFILE_STAGE(PROFILE_STAGE_HAPTICS);
 
-	// init CHIC mocap setting
-    // get hand mocap module interface instance
-    interface_hand_mocap_ = dynamic_cast<Hand_MoCAPInterface*>(interface_manager->GetInputInterface("Hand_MoCAP"));
-    if (interface_hand_mocap_)
+    if (haptic_renderer_)
     {
-        std::string mode = interface_hand_mocap_->GetMoCAPMode();
-        if (mode == "both")
+        const auto now = std::chrono::steady_clock::now();
+        const float dt = std::chrono::duration<float>(now - last_haptic_flush_time_).count();
+        last_haptic_flush_time_ = now;
+
+        for (int hand = 0; hand < HapticRenderer::HAND_COUNT; ++hand)
         {
-            hand_mocap_mode_ = HAND_MOCAP_MODE_BOTH;
+            for (int finger = 0; finger < HapticRenderer::FINGER_COUNT; ++finger)
+            {
+                const float depth = step_finger_depths_[hand][finger];
+
+                // first contact step has no previous depth, so its velocity is 0 instead of depth / dt
+                const float last_depth = last_finger_depths_[hand][finger] > 0.0f ? last_finger_depths_[hand][finger] : depth;
+                const float velocity = dt > 0.0f ? (depth - last_depth) / dt : 0.0f;
+                haptic_renderer_->set_contact(hand, finger, depth, velocity);
+
+                last_finger_depths_[hand][finger] = depth;
+                step_finger_depths_[hand][finger] = 0.0f;
+            }
         }
-        else if (mode == "left")
+    }
+
+    for (auto hand_index : { Hand_MoCAPInterface::HAND_LEFT, Hand_MoCAPInterface::HAND_RIGHT })
+    {
+        const unsigned int mask = step_hand_mocap_vibrations_[hand_index];
+        if (mask != last_hand_mocap_vibrations_[hand_index])
         {
-            hand_mocap_mode_ = HAND_MOCAP_MODE_LEFT;
+            // haptic renderer owns the glove output if enabled
+            if (haptic_output_queue_ && !haptic_renderer_)
+                haptic_output_queue_->submit(hand_index, mask);
+            last_hand_mocap_vibrations_[hand_index] = mask;
         }
-        else if (mode == "right")
+
+        step_hand_mocap_vibrations_[hand_index] = Hand_MoCAPInterface::FINGER_NONE;
+    }
+}
+
+void HandManager::calibrate_hand_mocap(HandIndex hand_index)
+{
+    auto interface_hand_mocap = device_session_->get_hand_mocap();
+    if (!interface_hand_mocap)
+        return;
+
+    interface_hand_mocap->FingerInit(hand_index == HAND_INDEX_LEFT ? Hand_MoCAPInterface::HAND_LEFT : Hand_MoCAPInterface::HAND_RIGHT);
+
+    invalidate_hand_scale(hand_index);
+    reset_joint_write_cache();
+}
+
+void HandManager::invalidate_hand_scale(HandIndex hand_index)
+{
+    is_scale_dirty_[hand_index] = true;
+
+    // calibration can reset model scales, so apply all scales of the side again
+    const int side_begin = hand_index * HandTopology::SIDE_JOINT_COUNT;
+    for (int k = side_begin; k < side_begin + HandTopology::SIDE_JOINT_COUNT; ++k)
+        applied_joint_scales_[k] = LVecBase3(0);
+}
+
+bool HandManager::is_hand_scale_dirty(HandIndex hand_index, const ScaleSegmentLengths& segment_lengths) const
+{
+    if (is_scale_dirty_[hand_index])
+        return true;
+
+    for (size_t k = 0, k_end = segment_lengths.size(); k < k_end; ++k)
+    {
+        if (std::abs(segment_lengths[k] - scaled_segment_lengths_[hand_index][k]) > scale_drift_threshold_)
+            return true;
+    }
+
+    return false;
+}
+
+void HandManager::set_joint_scale(crsf::TCRHand* hand, int joint_index, const LVecBase3& scale)
+{
+    auto& applied_scale = applied_joint_scales_[joint_index];
+    if (applied_scale == scale)
+        return;
+
+    hand->GetJointData(joint_index)->Get3DModel()->SetScale(scale);
+    applied_scale = scale;
+}
+
+void HandManager::setup_hand(void)
+{
+    device_session_ = std::make_unique<HandDeviceSession>(props_.get("subsystem.unistmocap", false));
+
+	// init CHIC mocap setting
+    if (device_session_->get_hand_mocap())
+    {
+        // serial and BLE writes of vibration run out of physics step and haptic loop
+        const auto haptic_min_interval = std::chrono::milliseconds(props_.get("subsystem.haptic_min_interval", 20));
+        haptic_output_queue_ = std::make_unique<HapticOutputQueue>([this](int channel, HapticOutputQueue::Mask mask) {
+            if (auto interface_hand_mocap = device_session_->get_hand_mocap())
+                interface_hand_mocap->SetVibration(channel == Hand_MoCAPInterface::HAND_LEFT ? Hand_MoCAPInterface::HAND_LEFT : Hand_MoCAPInterface::HAND_RIGHT,
+                    static_cast<Hand_MoCAPInterface::FingerMask>(mask));
+        }, haptic_min_interval);
+
+        // worker does not call into the interface while the session swaps it
+        device_session_->set_refresh_hooks([this] { haptic_output_queue_->pause(); }, [this] { haptic_output_queue_->resume(); });
+
+        if (props_.get("subsystem.haptic_rendering", false))
         {
-            hand_mocap_mode_ = HAND_MOCAP_MODE_RIGHT;
-            swap_trackers();
+            // intensity is sent as pulses at loop rate, and glove takes one write per min interval
+            HapticRenderer::Parameters params;
+            params.period = std::chrono::microseconds(1000000 / (std::max)(1, props_.get("subsystem.haptic_rendering_rate", 1000)));
+            if (params.period < haptic_min_interval)
+            {
+                global_logger->info("Haptic rendering rate is limited to {} Hz by haptic_min_interval.", 1000 / (std::max)(1, static_cast<int>(haptic_min_interval.count())));
+                params.period = haptic_min_interval;
+            }
+            params.max_depth = props_.get("subsystem.haptic_max_depth", params.max_depth);
+            haptic_renderer_ = std::make_unique<HapticRenderer>([this](int hand, uint32_t finger_bits) {
+                haptic_output_queue_->submit(hand == Hand_MoCAPInterface::HAND_LEFT ? Hand_MoCAPInterface::HAND_LEFT : Hand_MoCAPInterface::HAND_RIGHT,
+                    to_finger_mask(finger_bits));
+            }, params);
+            last_haptic_flush_time_ = std::chrono::steady_clock::now();
         }
+
+        crsf::TPhysicsManager::GetInstance()->AddTask([this](void) {
+            flush_hand_mocap_vibration();
+            return false;
+        }, "flush_hand_mocap_vibration");
+
+        if (device_session_->get_hand_mocap_mode_name() == "right")
+            swap_trackers();
     }
 
+    update_device_modes();
+
+    // modes follow interfaces when modules are enabled or disabled
+    accept(HandDeviceSession::REFRESHED_EVENT_NAME, [this](const Event*) { update_device_modes(); });
+
     // init UNIST mocap setting
-    if (props_.get("subsystem.unistmocap", false))
+    if (device_session_->get_unist_mocap())
+        setup_force_feedback();
+}
+
+void HandManager::update_device_modes()
+{
+    const auto devices = device_session_->get_devices();
+
+    // CHIC mocap
+    HandMoCAPMode hand_mocap_mode = HAND_MOCAP_MODE_NONE;
+    if (devices->hand_mocap)
     {
-        interface_unist_mocap_ = dynamic_cast<Kinesthetic_HandMoCAPInterface*>(interface_manager->GetInputInterface("KinestheticHandMoCAP"));
+        const std::string& mode = devices->hand_mocap_mode_name;
+        if (mode == "both")
+            hand_mocap_mode = HAND_MOCAP_MODE_BOTH;
+        else if (mode == "left")
+            hand_mocap_mode = HAND_MOCAP_MODE_LEFT;
+        else if (mode == "right")
+            hand_mocap_mode = HAND_MOCAP_MODE_RIGHT;
+    }
+    hand_mocap_mode_.store(hand_mocap_mode, std::memory_order_release);
 
-        if (interface_unist_mocap_)
-        {
-            // version
-            if (interface_unist_mocap_->GetVersion() == "old")
-                unist_mocap_joint_number_ = 26;
-            else if (interface_unist_mocap_->GetVersion() == "new")
-                unist_mocap_joint_number_ = 28;
-
-            // mode
-            if (props_.get("subsystem.unistmocap_mode", "") == "left")
-                unist_mocap_mode_ = "left";
-            else if (props_.get("subsystem.unistmocap_mode", "") == "right")
-                unist_mocap_mode_ = "right";
-        }
+    // UNIST mocap
+    if (auto interface_unist_mocap = devices->unist_mocap)
+    {
+        // version
+        if (interface_unist_mocap->GetVersion() == "old")
+            unist_mocap_joint_number_.store(26, std::memory_order_release);
+        else if (interface_unist_mocap->GetVersion() == "new")
+            unist_mocap_joint_number_.store(28, std::memory_order_release);
+
+        // mode
+        if (props_.get("subsystem.unistmocap_mode", "") == "left")
+            unist_mocap_side_.store(HAND_INDEX_LEFT, std::memory_order_release);
+        else if (props_.get("subsystem.unistmocap_mode", "") == "right")
+            unist_mocap_side_.store(HAND_INDEX_RIGHT, std::memory_order_release);
     }
 }
 
@@ -187,7 +370,7 @@ void HandManager::setup_hand(User* user)
     // update hand property
     auto hand_prop = crhand->GetHandProperty();
     // VR mode - leap local translation is 'HMD-to-LEAP'
-    if (crsf::TDynamicModuleManager::GetInstance()->IsModuleEnabled("openvr"))
+    if (device_session_->is_openvr_enabled())
     {
         hand_prop.m_vec3ZeroToSensor[0] = app_.m_property.get("hand.HMD_to_LEAP_x", 0.0f);
         hand_prop.m_vec3ZeroToSensor[1] = app_.m_property.get("hand.HMD_to_LEAP_y", 0.0f);
@@ -206,8 +389,7 @@ void HandManager::setup_hand(User* user)
         hand->setup_physics_interactor(particle_radius_);
 
     // grasp algorithm
-    hand_pointer_.push_back(hand_->Get3DModel_RightWrist());
-    hand_pointer_.push_back(hand_->Get3DModel_LeftWrist());
+    register_hand(hand, user->get_system_index());
 
     if (user->get_system_index() == app_.dsm_->GetSystemIndex())
     {
@@ -215,7 +397,7 @@ void HandManager::setup_hand(User* user)
         {
             if (app_.dsm_->HasMemoryObject<crsf::TAvatarMemoryObject>("Hands"))
             {
-                hand->set_render_method(app_.dsm_->GetAvatarMemoryObjectByName("Hands"), render_hand_leap_local);
+                hand->set_render_method(app_.dsm_->GetAvatarMemoryObjectByName("Hands"), [this](Hand* hand, crsf::TAvatarMemoryObject* amo) { render_hand_leap_local(hand, *device_session_, amo); });
             }
             else
             {
@@ -236,8 +418,8 @@ void HandManager::setup_hand(User* user)
         else if (app_.m_property.get("subsystem.unistmocap", false))
         {
             auto amo = crsf::TDynamicStageMemory::GetInstance()->GetAvatarMemoryObjectByName("KinestheticMoCAPHands");
-            crsf::TPhysicsManager::GetInstance()->AddTask([this, amo](void) {
-                render_unist_mocap(amo);
+            crsf::TPhysicsManager::GetInstance()->AddTask([this, hand, amo](void) {
+                render_unist_mocap(hand, amo);
                 return false;
             }, "render_unist_mocap");
         }
@@ -246,8 +428,36 @@ void HandManager::setup_hand(User* user)
     configure_hand(hand);
 }
 
+void HandManager::register_hand(Hand* hand, unsigned int system_index)
+{
+    auto crhand = hand->get_hand();
+
+    // right wrist first, so local hands keep ID 0 (right) and 1 (left)
+    for (auto wrist : { crhand->Get3DModel_RightWrist(), crhand->Get3DModel_LeftWrist() })
+    {
+        if (hand_registry_.register_hand(wrist, system_index) == HandRegistry::INVALID_HAND_ID)
+            global_logger->error("Too many hands are registered (max: {}).", HandRegistry::MAX_HAND_COUNT);
+    }
+}
+
+void HandManager::reset_joint_write_cache()
+{
+    if (app_.user_ && app_.user_->get_hand())
+        app_.user_->get_hand()->get_joint_write_cache().reset();
+}
+
 void HandManager::configure_hand(Hand* hand)
 {
+    hand->get_joint_write_cache().set_epsilons(
+        props_.get("subsystem.joint_write_angular_epsilon", 0.05f),
+        props_.get("subsystem.joint_write_linear_epsilon", 0.0001f));
+
+    // evaluate device samples at predicted display time, delayed to be bracketed by two samples (ms)
+    auto& pose_resampler = hand->get_pose_resampler();
+    pose_resampler.set_enabled(props_.get("subsystem.leap_interpolation", false));
+    pose_resampler.set_time_offset(std::chrono::duration_cast<PoseResampler::Clock::duration>(std::chrono::duration<float, std::milli>(
+        props_.get("subsystem.display_latency", 11.0f) - props_.get("subsystem.leap_interpolation_delay", 17.0f))));
+
     auto crhand = hand->get_hand();
     if (app_.physics_manager_)
     {
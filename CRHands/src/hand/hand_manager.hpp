@@ -7,10 +7,25 @@
 #pragma once
 
 #include <array>
+#include <atomic>
+#include <chrono>
 #include <memory>
+#include <unordered_map>
 
 #include <util/math.hpp>
 
+#include "hand/contact_view.hpp"
+#include "hand/force_feedback_controller.hpp"
+#include "hand/grasp_ownership.hpp"
+#include "hand/grasp_ownership_memory.hpp"
+#include "hand/hand_device_session.hpp"
+#include "hand/hand_registry.hpp"
+#include "hand/hand_state_snapshot.hpp"
+#include "hand/hand_topology.hpp"
+#include "util/frame_arena.hpp"
+#include "util/haptic_output_queue.hpp"
+#include "util/haptic_renderer.hpp"
+
 #include <boost/property_tree/ptree.hpp>
 
 #include <render_pipeline/rppanda/showbase/direct_object.hpp>
@@ -22,15 +37,17 @@ namespace crsf {
 	class TCharacter;
 	class TWorldObject;
 	class TCRModel;
+	class TGroupedObjectsBase;
+	class THandPhysicsInteractor;
+	class TPose;
 }
 
 class MainApp;
 class User;
 class Hand;
+class JointWriteCache;
 
 class OpenVRModule;
-class Hand_MoCAPInterface;
-class Kinesthetic_HandMoCAPInterface;
 
 class HandManager : public rppanda::DirectObject
 {
@@ -64,12 +81,42 @@ public:
     void setup_hand_event(void);
     void configure_hand(Hand* hand);
 
+    /** Parse modes of device interfaces. Called again after device session is refreshed. */
+    void update_device_modes();
+
+    /** Write all joints of local hand next frame. Call after joints are written without the cache. */
+    void reset_joint_write_cache();
+
+    // interfaces of hand devices
+    const HandDeviceSession& get_device_session() const;
+
+    /** nullptr if subsystem.haptic_rendering is off. */
+    const HapticRenderer* get_haptic_renderer() const;
+
+    /** Vibration mask sent to CHIC mocap in last physics step. */
+    unsigned int get_hand_mocap_vibration(int hand_index) const;
+
+    /** nullptr if UNIST mocap or subsystem.unistmocap_force_feedback is off. */
+    ForceFeedbackController* get_force_feedback_controller() const;
+
+    /** Scratch memory of listeners, which is reset every physics step. */
+    const FrameArena& get_step_arena() const;
+
+    // hand registry for grasp arbitration
+    void register_hand(Hand* hand, unsigned int system_index);
+    const HandRegistry& get_hand_registry() const;
+
+    // grasp ownership over network
+    void setup_grasp_ownership();
+    int register_networked_object(crsf::TCRModel* model);
+
 	// CHIC mocap
 	void render_hand_mocap(Hand* hand, crsf::TAvatarMemoryObject *amo);
+	void calibrate_hand_mocap(HandIndex hand_index);
 
 	// UNIST mocap
-	void render_unist_mocap(crsf::TAvatarMemoryObject *amo);
-	LQuaternionf rotate_unist_to_crsf(const LQuaternionf& quat);
+	void render_unist_mocap(Hand* hand, crsf::TAvatarMemoryObject *amo);
+	void setup_force_feedback();
 
 	// VIVE
 	void find_trackers();
@@ -84,36 +131,80 @@ public:
 	bool grouped_object_update_event(const std::shared_ptr<crsf::TCRModel>& my_model);
 
 private:
-    void render_hand_mocap_side(crsf::TCRHand* hand, crsf::TAvatarMemoryObject* amo, HandIndex hand_side);
+    // lengths of 3 bones of thumb, index and middle fingers
+    using ScaleSegmentLengths = std::array<float, 9>;
+
+    static constexpr int HAND_JOINT_COUNT = HandTopology::JOINT_COUNT;
+
+    void render_hand_mocap_side(crsf::TCRHand* hand, JointWriteCache& joint_write_cache, crsf::TAvatarMemoryObject* amo, HandIndex hand_side);
     void render_hand_mocap_tracker(crsf::TCRHand* hand);
+    void update_hand_mocap_scale(crsf::TCRHand* hand, HandIndex hand_side, const ScaleSegmentLengths& segment_lengths);
+
+	/** Rotate grasped_object[1] about hinge axis following relative motion of two grasping hands. */
+	void update_hinge_constraint(crsf::TGroupedObjectsBase* grouped_object_base, bool is_grasp_started);
+
+    // scaling
+    void invalidate_hand_scale(HandIndex hand_index);
+    bool is_hand_scale_dirty(HandIndex hand_index, const ScaleSegmentLengths& segment_lengths) const;
+    void set_joint_scale(crsf::TCRHand* hand, int joint_index, const LVecBase3& scale);
+
+    // haptics
+    void flush_hand_mocap_vibration();
+    void flush_force_feedback();
+    void publish_force_feedback();
+    void release_force_feedback();
+    void write_force_feedback(const ForceFeedbackController::Command& command);
+
+    // grasp ownership
+    int find_networked_object_id(const crsf::TCRModel* model) const;
+    void request_grasp_ownership(int object_id);
+    void release_grasp_ownership(int object_id);
+    bool follow_remote_owner(crsf::TCRModel* model, int object_id);
+    void queue_grasp_claim(crsf::TCRModel* model, int object_id);
+    void sync_grasp_ownership();
 
 	MainApp& app_;
 
 	const boost::property_tree::ptree& props_;
 
-	const double M_PI = std::acos(-1);
-
 	// hand model
 	crsf::TCRHand* hand_ = nullptr;
 	crsf::TWorldObject* hand_object_ = nullptr;
 	crsf::TCharacter* hand_character_ = nullptr;
 
-	// CHIC mocap
-	Hand_MoCAPInterface* interface_hand_mocap_ = nullptr;
+	// interfaces of hand devices
+	std::unique_ptr<HandDeviceSession> device_session_;
 
+	// CHIC mocap
 	bool is_hand_mocap_calibration_ = false;
 
-    HandMoCAPMode hand_mocap_mode_ = HAND_MOCAP_MODE_NONE;
+    std::atomic<HandMoCAPMode> hand_mocap_mode_{ HAND_MOCAP_MODE_NONE };
 
 	unsigned int last_hand_mocap_vibrations_[2];
+	unsigned int step_hand_mocap_vibrations_[2];       ///< ORed over all objects in current physics step
+	std::unique_ptr<HapticOutputQueue> haptic_output_queue_;
+
+	// vibration intensity from penetration depth
+	std::unique_ptr<HapticRenderer> haptic_renderer_;
+	std::array<std::array<float, HapticRenderer::FINGER_COUNT>, HapticRenderer::HAND_COUNT> step_finger_depths_ = {};
+	std::array<std::array<float, HapticRenderer::FINGER_COUNT>, HapticRenderer::HAND_COUNT> last_finger_depths_ = {};
+	std::chrono::steady_clock::time_point last_haptic_flush_time_;
 
 	// UNIST mocap
-	Kinesthetic_HandMoCAPInterface* interface_unist_mocap_ = nullptr;
-	int unist_mocap_joint_number_ = 28;
+	std::atomic<int> unist_mocap_joint_number_{ 28 };
 
 	float hand_mocap_data_[28];
 
-	std::string unist_mocap_mode_ = "right";
+	std::atomic<int> unist_mocap_side_{ HAND_INDEX_RIGHT };     ///< HAND_INDEX_LEFT or HAND_INDEX_RIGHT
+
+	// kinesthetic force feedback (controller is declared after members used by its thread)
+	ForceFeedbackController::FingerValues step_force_depths_ = {};
+	std::string force_feedback_memory_name_;
+	std::vector<crsf::TPose> force_feedback_poses_;
+	bool force_feedback_memory_error_ = false;
+	std::chrono::steady_clock::duration force_feedback_publish_interval_ = std::chrono::milliseconds(10);
+	std::chrono::steady_clock::time_point last_force_feedback_publish_time_;
+	std::unique_ptr<ForceFeedbackController> force_feedback_controller_;
 
 	// VIVE
 	std::shared_ptr<OpenVRModule> module_open_vr_ = nullptr;
@@ -123,11 +214,39 @@ private:
 
 	std::array<int, 2> tracker_indices_;
 
+	// scaling
+	std::array<bool, HAND_INDEX_COUNT> is_scale_dirty_;
+	std::array<ScaleSegmentLengths, HAND_INDEX_COUNT> scaled_segment_lengths_;
+	std::array<LVecBase3, HAND_JOINT_COUNT> applied_joint_scales_;     ///< zero if not applied yet
+	float scale_drift_threshold_;
+
 	// physics particle
 	float particle_radius_ = 0.0025f;
 
+	// contacts of current listener, reused every step
+	ContactView contact_view_;
+
+	// scratch of listeners in physics step. FrameVector on it should not live over a step.
+	FrameArena step_arena_;
+
+	// hand poses shared by listeners in physics step
+	HandStateSnapshot hand_state_;
+
 	// grasp algorithm
-	std::vector<crsf::TWorldObject*> hand_pointer_;
+	HandRegistry hand_registry_;
+
+	// grasp ownership over network
+	std::unique_ptr<GraspOwnership> grasp_ownership_;
+	std::string grasp_ownership_memory_prefix_;
+	unsigned int grasp_ownership_max_system_index_ = 8;
+	std::chrono::steady_clock::time_point grasp_ownership_start_time_;
+	bool grasp_ownership_memory_error_ = false;
+
+	std::vector<crsf::TCRModel*> networked_objects_;
+	std::unordered_map<const crsf::TCRModel*, int> networked_object_ids_;
+	GraspOwnershipMemory grasp_ownership_memory_;
+	std::vector<GraspOwnership::ObjectState> grasp_ownership_states_;
+	std::vector<crsf::TPose> grasp_ownership_poses_;
 };
 
 inline crsf::TCRHand* HandManager::get_hand() const
@@ -144,3 +263,33 @@ inline crsf::TCharacter* HandManager::get_hand_character() const
 {
 	return hand_character_;
 }
+
+inline const HandDeviceSession& HandManager::get_device_session() const
+{
+	return *device_session_;
+}
+
+inline const HapticRenderer* HandManager::get_haptic_renderer() const
+{
+	return haptic_renderer_.get();
+}
+
+inline unsigned int HandManager::get_hand_mocap_vibration(int hand_index) const
+{
+	return last_hand_mocap_vibrations_[hand_index];
+}
+
+inline ForceFeedbackController* HandManager::get_force_feedback_controller() const
+{
+	return force_feedback_controller_.get();
+}
+
+inline const FrameArena& HandManager::get_step_arena() const
+{
+	return step_arena_;
+}
+
+inline const HandRegistry& HandManager::get_hand_registry() const
+{
+	return hand_registry_;
+}
@@ -0,0 +1,184 @@
+/**
+* Coexistence Reality Software Framework (CRSF)
+* Copyright (c) Center of Human-centered Interaction for Coexistence. All rights reserved.
+* See the LICENSE.md file for more details.
+*/
+
+#include "hand_manager.hpp"
+
+#include <spdlog/logger.h>
+
+#include <crsf/CoexistenceInterface/TDynamicStageMemory.h>
+#include <crsf/CoexistenceInterface/TAvatarMemoryObject.h>
+#include <crsf/CREngine/TPhysicsManager.h>
+#include <crsf/CRModel/TCRModel.h>
+#include <crsf/CRModel/THandPhysicsInteractor.h>
+#include <crsf/CRModel/TPhysicsModel.h>
+#include <crsf/CRModel/TWorld.h>
+#include <crsf/RenderingEngine/TGraphicRenderEngine.h>
+#include <crsf/System/TPose.h>
+
+#include "hand/grasp_detection.hpp"
+#include "main.hpp"
+
+extern spdlog::logger* global_logger;
+
+void HandManager::setup_grasp_ownership()
+{
+    if (!props_.get("network.grasp_ownership", false))
+        return;
+
+    grasp_ownership_ = std::make_unique<GraspOwnership>(app_.dsm_->GetSystemIndex());
+    grasp_ownership_memory_prefix_ = props_.get("network.grasp_ownership_memory", std::string("GraspOwnership"));
+    grasp_ownership_max_system_index_ = props_.get("network.grasp_ownership_max_system_index", 8u);
+    grasp_ownership_start_time_ = std::chrono::steady_clock::now();
+
+    grasp_ownership_memory_.set_object_count(0, grasp_ownership_max_system_index_);
+
+    crsf::TPhysicsManager::GetInstance()->AddTask([this](void) {
+        sync_grasp_ownership();
+        return false;
+    }, "sync_grasp_ownership");
+}
+
+int HandManager::register_networked_object(crsf::TCRModel* model)
+{
+    if (!grasp_ownership_)
+        return -1;
+
+    const int object_id = static_cast<int>(networked_objects_.size());
+    networked_objects_.push_back(model);
+    networked_object_ids_[model] = object_id;
+    grasp_ownership_states_.push_back(GraspOwnership::ObjectState{ LVecBase3f(0), LQuaternionf::ident_quat() });
+
+    grasp_ownership_->set_object_count(object_id + 1);
+    grasp_ownership_memory_.set_object_count(object_id + 1, grasp_ownership_max_system_index_);
+
+    return object_id;
+}
+
+int HandManager::find_networked_object_id(const crsf::TCRModel* model) const
+{
+    if (!grasp_ownership_)
+        return -1;
+
+    auto found = networked_object_ids_.find(model);
+    if (found == networked_object_ids_.end())
+        return -1;
+    return found->second;
+}
+
+void HandManager::request_grasp_ownership(int object_id)
+{
+    if (object_id != -1)
+        grasp_ownership_->request(object_id);
+}
+
+void HandManager::release_grasp_ownership(int object_id)
+{
+    if (object_id != -1)
+        grasp_ownership_->release(object_id);
+}
+
+void HandManager::queue_grasp_claim(crsf::TCRModel* model, int object_id)
+{
+    // local grasp is tested as usual, but the object is not moved until the claim wins
+    FrameVector<crsf::THandPhysicsInteractor*> interactors{ FrameAllocator<crsf::THandPhysicsInteractor*>(step_arena_) };
+    contact_view_.assign(model);
+    for (const auto& contact : contact_view_)
+    {
+        if (contact.kind == ContactView::CONTACT_KIND_HAND_INTERACTOR && contact.interactor->GetParentHandModel() == hand_)
+            interactors.push_back(contact.interactor);
+    }
+
+    // grasp transform is initialized again when the claim wins
+    model->GetPhysicsModel()->SetIsGrasped(false);
+
+    if (find_grasping_side(interactors.data(), interactors.size()) >= 0)
+        request_grasp_ownership(object_id);
+    else
+        release_grasp_ownership(object_id);
+}
+
+bool HandManager::follow_remote_owner(crsf::TCRModel* model, int object_id)
+{
+    if (object_id == -1 || !grasp_ownership_->is_remote_owned(object_id))
+        return false;
+
+    const double now = std::chrono::duration<double>(std::chrono::steady_clock::now() - grasp_ownership_start_time_).count();
+
+    GraspOwnership::ObjectState state;
+    if (!grasp_ownership_->get_remote_state(object_id, now, state))
+        return true;
+
+    LMatrix4f mat;
+    state.quat.extract_to_matrix(mat);
+    mat.set_row(3, state.pos);
+
+    model->GetPhysicsModel()->SetPhysicsType(crsf::EPHYX_TYPE_RIGIDBODY_PASSIVE);
+    model->SetMatrix(mat, crsf::TGraphicRenderEngine::GetInstance()->GetWorld(), crsf::EMODEL_SETMODE_ONLY_PHYSICS);
+
+    return true;
+}
+
+void HandManager::sync_grasp_ownership()
+{
+    auto dsm = app_.dsm_;
+    const unsigned int local_system_index = dsm->GetSystemIndex();
+    const int object_count = grasp_ownership_->get_object_count();
+    const double now = std::chrono::duration<double>(std::chrono::steady_clock::now() - grasp_ownership_start_time_).count();
+
+    // receive claims and states of remote nodes
+    for (unsigned int system_index = 1; system_index <= grasp_ownership_max_system_index_; ++system_index)
+    {
+        if (system_index == local_system_index)
+            continue;
+
+        const std::string name = grasp_ownership_memory_prefix_ + std::to_string(system_index);
+        if (!dsm->HasMemoryObject<crsf::TAvatarMemoryObject>(name))
+        {
+            grasp_ownership_->remove_remote_node(system_index);
+            continue;
+        }
+
+        grasp_ownership_memory_.read(*grasp_ownership_, system_index, dsm->GetAvatarMemoryObjectByName(name)->GetAvatarMemory(), now);
+    }
+
+    // publish claims of local node and states of owned objects
+    const std::string local_name = grasp_ownership_memory_prefix_ + std::to_string(local_system_index);
+    if (!dsm->HasMemoryObject<crsf::TAvatarMemoryObject>(local_name))
+    {
+        if (!grasp_ownership_memory_error_)
+            global_logger->error("Failed to get AvatarMemoryObject of grasp ownership: {}", local_name);
+        grasp_ownership_memory_error_ = true;
+        return;
+    }
+
+    auto local_amo = dsm->GetAvatarMemoryObjectByName(local_name);
+    if (grasp_ownership_poses_.empty())
+        grasp_ownership_poses_ = local_amo->GetAvatarMemory();
+
+    const int pose_count = GraspOwnershipMemory::get_pose_count(object_count);
+    if (static_cast<int>(grasp_ownership_poses_.size()) < pose_count)
+    {
+        if (!grasp_ownership_memory_error_)
+            global_logger->error("AvatarMemoryObject {} needs {} joints for {} objects.", local_name, pose_count, object_count);
+        grasp_ownership_memory_error_ = true;
+        return;
+    }
+
+    auto world = crsf::TGraphicRenderEngine::GetInstance()->GetWorld();
+
+    // only states of owned objects are published
+    for (int k = 0; k < object_count; ++k)
+    {
+        if (grasp_ownership_->is_local_authority(k))
+            grasp_ownership_states_[k] = GraspOwnership::ObjectState{ networked_objects_[k]->GetPosition(world), networked_objects_[k]->GetQuaternion(world) };
+    }
+
+    if (!grasp_ownership_memory_.write(*grasp_ownership_, grasp_ownership_states_, grasp_ownership_poses_))
+        return;
+
+    local_amo->SetAvatarMemory(grasp_ownership_poses_);
+    local_amo->UpdateAvatarMemoryObject();
+}
@@ -0,0 +1,81 @@
+/**
+* Coexistence Reality Software Framework (CRSF)
+* Copyright (c) Center of Human-centered Interaction for Coexistence. All rights reserved.
+* See the LICENSE.md file for more details.
+*/
+
+#include "hand_registry.hpp"
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+int HandRegistry::register_hand(crsf::TWorldObject* wrist, unsigned int system_index)
+{
+    const int existing_id = find_hand_id(wrist);
+    if (existing_id != INVALID_HAND_ID)
+        return existing_id;
+
+    if (~registered_mask_ == 0)
+        return INVALID_HAND_ID;
+
+    // reuse lowest free ID
+    HandMask free_mask = ~registered_mask_;
+    const int hand_id = pop_hand(free_mask);
+
+    if (hand_id >= static_cast<int>(entries_.size()))
+        entries_.resize(hand_id + 1);
+
+    entries_[hand_id].wrist = wrist;
+    entries_[hand_id].system_index = system_index;
+    wrist_to_id_[wrist] = hand_id;
+    registered_mask_ |= to_mask(hand_id);
+
+    return hand_id;
+}
+
+void HandRegistry::unregister_user(unsigned int system_index)
+{
+    HandMask mask = registered_mask_;
+    while (mask)
+    {
+        const int hand_id = pop_hand(mask);
+        auto& entry = entries_[hand_id];
+        if (entry.system_index != system_index)
+            continue;
+
+        wrist_to_id_.erase(entry.wrist);
+        entry = Entry();
+        registered_mask_ &= ~to_mask(hand_id);
+    }
+}
+
+int HandRegistry::find_hand_id(const crsf::TWorldObject* wrist) const
+{
+    auto found = wrist_to_id_.find(wrist);
+    if (found == wrist_to_id_.end())
+        return INVALID_HAND_ID;
+    return found->second;
+}
+
+int HandRegistry::pop_hand(HandMask& mask)
+{
+#if defined(_MSC_VER)
+    unsigned long index;
+    _BitScanForward64(&index, mask);
+    const int hand_id = static_cast<int>(index);
+#else
+    const int hand_id = __builtin_ctzll(mask);
+#endif
+
+    mask &= mask - 1;
+    return hand_id;
+}
+
+int HandRegistry::count_hands(HandMask mask)
+{
+    int count = 0;
+    for (; mask; mask &= mask - 1)
+        ++count;
+    return count;
+}
@@ -0,0 +1,85 @@
+/**
+* Coexistence Reality Software Framework (CRSF)
+* Copyright (c) Center of Human-centered Interaction for Coexistence. All rights reserved.
+* See the LICENSE.md file for more details.
+*/
+
+#pragma once
+
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+namespace crsf {
+class TWorldObject;
+}
+
+/**
+ * Registry of wrist models of all hands (local and remote users).
+ *
+ * Each wrist gets a compact hand ID in [0, MAX_HAND_COUNT), so grasp arbitration
+ * can use arrays indexed by ID and a bitmask per object instead of pointer comparisons.
+ * IDs of unregistered hands are reused.
+ */
+class HandRegistry
+{
+public:
+    using HandMask = uint64_t;
+
+    static constexpr int MAX_HAND_COUNT = 64;
+    static constexpr int INVALID_HAND_ID = -1;
+
+public:
+    /** @return hand ID, or INVALID_HAND_ID if the registry is full. */
+    int register_hand(crsf::TWorldObject* wrist, unsigned int system_index);
+
+    /** Remove all hands of the user. */
+    void unregister_user(unsigned int system_index);
+
+    int find_hand_id(const crsf::TWorldObject* wrist) const;
+
+    crsf::TWorldObject* get_wrist(int hand_id) const;
+    unsigned int get_system_index(int hand_id) const;
+
+    HandMask get_registered_mask() const;
+
+    static HandMask to_mask(int hand_id);
+
+    /** Remove lowest hand in @a mask and return its ID. @a mask should not be zero. */
+    static int pop_hand(HandMask& mask);
+
+    static int count_hands(HandMask mask);
+
+private:
+    struct Entry
+    {
+        crsf::TWorldObject* wrist = nullptr;
+        unsigned int system_index = 0;
+    };
+
+    std::vector<Entry> entries_;
+    std::unordered_map<const crsf::TWorldObject*, int> wrist_to_id_;
+    HandMask registered_mask_ = 0;
+};
+
+// ************************************************************************************************
+
+inline crsf::TWorldObject* HandRegistry::get_wrist(int hand_id) const
+{
+    return entries_[hand_id].wrist;
+}
+
+inline unsigned int HandRegistry::get_system_index(int hand_id) const
+{
+    return entries_[hand_id].system_index;
+}
+
+inline HandRegistry::HandMask HandRegistry::get_registered_mask() const
+{
+    return registered_mask_;
+}
+
+inline HandRegistry::HandMask HandRegistry::to_mask(int hand_id)
+{
+    return HandMask(1) << hand_id;
+}
@@ -0,0 +1,181 @@
+/**
+* Coexistence Reality Software Framework (CRSF)
+* Copyright (c) Center of Human-centered Interaction for Coexistence. All rights reserved.
+* See the LICENSE.md file for more details.
+*/
+
+#include "hand_retarget.hpp"
+
+#include <cmath>
+
+namespace {
+
+const float RAD_TO_DEG = 180.0f / static_cast<float>(std::acos(-1.0));
+
+LQuaternionf axis_angle(float angle, const LVecBase3& axis)
+{
+    LQuaternionf quat;
+    quat.set_from_axis_angle(angle, axis);
+    return quat;
+}
+
+// initial rotation of thumb base joint
+LQuaternionf make_thumb_rotation(float angle_x, const LVecBase3& axis_x, float angle_z, float angle_y)
+{
+    LQuaternionf c = axis_angle(angle_x * RAD_TO_DEG, axis_x);
+    LQuaternionf d = axis_angle(angle_z * RAD_TO_DEG, LVecBase3(0, 0, -1));
+    LQuaternionf e = axis_angle(angle_y * RAD_TO_DEG, LVecBase3(0, 1, 0));
+    return axis_angle(-45, LVecBase3(0, 1, 0)) * (e * d * c);
+}
+
+struct RetargetTables
+{
+    RetargetTables();
+
+    // CHIC mocap: result = conjugate(k) * q * k
+    LQuaternionf hand_mocap_joint[2];
+    LQuaternionf hand_mocap_left_thumb_joint;
+    LQuaternionf hand_mocap_thumb[2];
+    LQuaternionf hand_mocap_tracker_to_model[2];
+    LQuaternionf hand_mocap_model_to_joint[2];
+
+    // Leap Motion: [mode][hand_side]
+    LQuaternionf leap_joint[2][2];
+    LQuaternionf leap_wrist[2][2];
+    LQuaternionf leap_thumb[2];
+
+    // UNIST mocap
+    LQuaternionf unist_to_panda;
+    LQuaternionf unist_joint;
+    LQuaternionf unist_thumb[2];
+    LQuaternionf unist_tracker[2];
+};
+
+RetargetTables::RetargetTables()
+{
+    // CHIC mocap
+    {
+        const LQuaternionf left_flip = axis_angle(180, LVecBase3(1, 0, 0));
+
+        hand_mocap_joint[0] = left_flip * (axis_angle(90, LVecBase3(0, 0, -1)) * axis_angle(90, LVecBase3(0, 1, 0)));
+        hand_mocap_left_thumb_joint = left_flip * (axis_angle(-90, LVecBase3(0, 0, 1)) * axis_angle(-90, LVecBase3(0, -1, 0)));
+        hand_mocap_joint[1] = axis_angle(-90, LVecBase3(0, 0, 1)) * axis_angle(90, LVecBase3(0, 1, 0));
+
+        hand_mocap_thumb[0] = make_thumb_rotation(1.39323033616515f, LVecBase3(-1, 0, 0), 0.533031068419669f, 0.907932313878427f);
+        hand_mocap_thumb[1] = make_thumb_rotation(-1.39323033616515f, LVecBase3(1, 0, 0), 0.533031068419669f, 0.907932313878427f);
+
+        hand_mocap_tracker_to_model[0] = axis_angle(90, LVecBase3(0, 1, 0)) * axis_angle(90, LVecBase3(0, 0, 1));
+        hand_mocap_tracker_to_model[1] = axis_angle(-90, LVecBase3(0, 1, 0)) * axis_angle(180, LVecBase3(1, 0, 0)) * axis_angle(90, LVecBase3(0, 0, 1));
+
+        hand_mocap_model_to_joint[0] = axis_angle(90, LVecBase3(1, 0, 0)) * axis_angle(90, LVecBase3(0, 0, 1));
+        hand_mocap_model_to_joint[1] = axis_angle(-90, LVecBase3(1, 0, 0)) * axis_angle(-90, LVecBase3(0, 0, 1));
+    }
+
+    // Leap Motion
+    {
+        const LQuaternionf hmd_joint = axis_angle(-90, LVecBase3(0, 0, 1)) * axis_angle(90, LVecBase3(0, 1, 0));
+        leap_joint[LEAP_MOTION_MODE_HMD][0] = hmd_joint;
+        leap_joint[LEAP_MOTION_MODE_HMD][1] = hmd_joint;
+        leap_joint[LEAP_MOTION_MODE_FLOOR][0] = axis_angle(0, LVecBase3(0, 0, 1)) * axis_angle(-90, LVecBase3(0, 0, 1));
+        leap_joint[LEAP_MOTION_MODE_FLOOR][1] = axis_angle(180, LVecBase3(0, 1, 0)) * axis_angle(-90, LVecBase3(0, 0, 1));
+
+        leap_wrist[LEAP_MOTION_MODE_HMD][0] = axis_angle(-90, LVecBase3(1, 0, 0)) * axis_angle(-90, LVecBase3(0, 1, 0));
+        leap_wrist[LEAP_MOTION_MODE_HMD][1] = axis_angle(90, LVecBase3(1, 0, 0)) * axis_angle(-90, LVecBase3(0, 1, 0));
+        leap_wrist[LEAP_MOTION_MODE_FLOOR][0] = axis_angle(0, LVecBase3(1, 0, 0)) * axis_angle(90, LVecBase3(0, 0, 1));
+        leap_wrist[LEAP_MOTION_MODE_FLOOR][1] = axis_angle(180, LVecBase3(1, 0, 0)) * axis_angle(90, LVecBase3(0, 0, 1));
+
+        leap_thumb[0] = make_thumb_rotation(1.406013982f, LVecBase3(-1, 0, 0), 0.453798839f, 0.905946589f);
+        leap_thumb[1] = make_thumb_rotation(-1.406013982f, LVecBase3(1, 0, 0), 0.453798839f, 0.905946589f);
+    }
+
+    // UNIST mocap
+    {
+        // unist coord -> panda coord, and then panda coord -> leap hand origin pose
+        unist_to_panda = axis_angle(90, LVecBase3(0, 1, 0)) * axis_angle(180, LVecBase3(1, 0, 0));
+        const LQuaternionf panda_to_hand = axis_angle(-90, LVecBase3(0, 0, 1)) * axis_angle(90, LVecBase3(0, 1, 0));
+        unist_joint = unist_to_panda * panda_to_hand;
+
+        unist_thumb[0] = make_thumb_rotation(1.806013982f, LVecBase3(-1, 0, 0), 0.453798839f, 0.905946589f);
+        unist_thumb[1] = make_thumb_rotation(-1.806013982f, LVecBase3(1, 0, 0), 0.453798839f, 0.905946589f);
+
+        unist_tracker[0] = axis_angle(-270, LVecBase3(0, 1, 0));
+        unist_tracker[1] = axis_angle(90, LVecBase3(0, 1, 0));
+    }
+}
+
+const RetargetTables& get_tables()
+{
+    static const RetargetTables tables;
+    return tables;
+}
+
+LQuaternionf change_basis(const LQuaternionf& quat, const LQuaternionf& basis)
+{
+    return basis.conjugate() * quat * basis;
+}
+
+}
+
+LQuaternionf retarget_hand_mocap_joint(const LQuaternionf& sensor_quat, int hand_side, bool is_thumb_base)
+{
+    const auto& tables = get_tables();
+
+    if (hand_side == 0 && is_thumb_base)
+        return change_basis(sensor_quat, tables.hand_mocap_left_thumb_joint) * tables.hand_mocap_thumb[0];
+
+    LQuaternionf quat_result = change_basis(sensor_quat, tables.hand_mocap_joint[hand_side]);
+    if (is_thumb_base)
+        quat_result = quat_result * tables.hand_mocap_thumb[hand_side];
+
+    return quat_result;
+}
+
+LQuaternionf retarget_hand_mocap_tracker_to_model(const LQuaternionf& tracker_quat, int hand_side)
+{
+    return get_tables().hand_mocap_tracker_to_model[hand_side] * tracker_quat;
+}
+
+LQuaternionf retarget_hand_mocap_model_to_joint(const LQuaternionf& model_quat, int hand_side)
+{
+    return get_tables().hand_mocap_model_to_joint[hand_side] * model_quat;
+}
+
+LQuaternionf retarget_leap_joint(const LQuaternionf& leap_quat, LeapMotionMode mode, int hand_side, bool is_thumb_base)
+{
+    const auto& tables = get_tables();
+
+    LQuaternionf quat_result = change_basis(leap_quat, tables.leap_joint[mode][hand_side]);
+
+    // multiply quaternion for thumb initial rotation
+    if (is_thumb_base)
+        quat_result = quat_result * tables.leap_thumb[hand_side];
+
+    return quat_result;
+}
+
+LQuaternionf retarget_leap_wrist(const LQuaternionf& leap_quat, LeapMotionMode mode, int hand_side)
+{
+    // rotate hand model to LEAP base
+    return get_tables().leap_wrist[mode][hand_side] * leap_quat;
+}
+
+LQuaternionf retarget_unist_joint(const LQuaternionf& unist_quat, int hand_side)
+{
+    const auto& tables = get_tables();
+
+    // hand origin pose is only known when mode is left or right
+    if (hand_side < 0)
+        return change_basis(unist_quat, tables.unist_to_panda);
+
+    return change_basis(unist_quat, tables.unist_joint);
+}
+
+LQuaternionf retarget_unist_thumb(const LQuaternionf& quat, int hand_side)
+{
+    return quat * get_tables().unist_thumb[hand_side];
+}
+
+LQuaternionf retarget_unist_tracker(const LQuaternionf& tracker_quat, int hand_side)
+{
+    return get_tables().unist_tracker[hand_side] * tracker_quat;
+}
@@ -0,0 +1,37 @@
+/**
+* Coexistence Reality Software Framework (CRSF)
+* Copyright (c) Center of Human-centered Interaction for Coexistence. All rights reserved.
+* See the LICENSE.md file for more details.
+*/
+
+#pragma once
+
+#include <luse.h>
+
+// Retargeting from device coordinates to CRSF hand model coordinates.
+//
+// These functions only depend on Panda3D linmath, so they can run without CRSF SDK and devices.
+// Constant rotations are built once instead of calling set_from_axis_angle per joint per frame.
+//
+// hand_side: 0 = left, 1 = right
+
+enum LeapMotionMode
+{
+    LEAP_MOTION_MODE_FLOOR,
+    LEAP_MOTION_MODE_HMD
+};
+
+// CHIC mocap
+LQuaternionf retarget_hand_mocap_joint(const LQuaternionf& sensor_quat, int hand_side, bool is_thumb_base);
+LQuaternionf retarget_hand_mocap_tracker_to_model(const LQuaternionf& tracker_quat, int hand_side);
+LQuaternionf retarget_hand_mocap_model_to_joint(const LQuaternionf& model_quat, int hand_side);
+
+// Leap Motion
+LQuaternionf retarget_leap_joint(const LQuaternionf& leap_quat, LeapMotionMode mode, int hand_side, bool is_thumb_base);
+LQuaternionf retarget_leap_wrist(const LQuaternionf& leap_quat, LeapMotionMode mode, int hand_side);
+
+// UNIST mocap
+// hand_side < 0 if mode is neither left nor right, then only unist -> panda basis is applied
+LQuaternionf retarget_unist_joint(const LQuaternionf& unist_quat, int hand_side);
+LQuaternionf retarget_unist_thumb(const LQuaternionf& quat, int hand_side);
+LQuaternionf retarget_unist_tracker(const LQuaternionf& tracker_quat, int hand_side);
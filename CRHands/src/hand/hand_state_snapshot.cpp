@@ -0,0 +1,49 @@
+/**
+* Coexistence Reality Software Framework (CRSF)
+* Copyright (c) Center of Human-centered Interaction for Coexistence. All rights reserved.
+* See the LICENSE.md file for more details.
+*/
+
+#include "hand_state_snapshot.hpp"
+
+#include <crsf/CRModel/TWorldObject.h>
+
+void HandStateSnapshot::invalidate()
+{
+    wrist_states_.clear();
+    is_local_hand_valid_ = false;
+}
+
+const HandKinematics& HandStateSnapshot::get_local_hand(crsf::TCRHand* hand, crsf::TWorldObject* world)
+{
+    if (!local_hand_.is_bound(hand))
+    {
+        local_hand_.bind(hand);
+        is_local_hand_valid_ = false;
+    }
+
+    if (!is_local_hand_valid_)
+    {
+        local_hand_.update(world);
+        is_local_hand_valid_ = true;
+    }
+
+    return local_hand_;
+}
+
+const HandStateSnapshot::WristState& HandStateSnapshot::get_wrist_state(crsf::TWorldObject* wrist, crsf::TWorldObject* world)
+{
+    for (const auto& state: wrist_states_)
+    {
+        if (state.wrist == wrist)
+            return state;
+    }
+
+    WristState state;
+    state.wrist = wrist;
+    state.matrix = wrist->GetMatrix(world);
+    state.transform = RigidTransform::from_matrix(state.matrix);
+    wrist_states_.push_back(state);
+
+    return wrist_states_.back();
+}
@@ -0,0 +1,66 @@
+/**
+* Coexistence Reality Software Framework (CRSF)
+* Copyright (c) Center of Human-centered Interaction for Coexistence. All rights reserved.
+* See the LICENSE.md file for more details.
+*/
+
+#pragma once
+
+#include <vector>
+
+#include "hand/hand_kinematics.hpp"
+#include "util/rigid_transform.hpp"
+
+namespace crsf {
+class TCRHand;
+class TWorldObject;
+}
+
+/**
+ * World poses of hands in current physics step.
+ *
+ * Hands do not move while listeners run, so each pose is read from scene graph at first use
+ * in a step and shared by all listeners until invalidate() is called for next step.
+ */
+class HandStateSnapshot
+{
+public:
+    /** Start new step. */
+    void invalidate();
+
+    /** Joint poses (wrists and fingertips) of the local hand. */
+    const HandKinematics& get_local_hand(crsf::TCRHand* hand, crsf::TWorldObject* world);
+
+    /** World matrix of @a wrist with scale. @a wrist can be a wrist of any user. */
+    LMatrix4f get_wrist_matrix(crsf::TWorldObject* wrist, crsf::TWorldObject* world);
+
+    /** World pose of @a wrist without scale. */
+    RigidTransform get_wrist_transform(crsf::TWorldObject* wrist, crsf::TWorldObject* world);
+
+private:
+    struct WristState
+    {
+        const crsf::TWorldObject* wrist;
+        LMatrix4f matrix;
+        RigidTransform transform;
+    };
+
+    const WristState& get_wrist_state(crsf::TWorldObject* wrist, crsf::TWorldObject* world);
+
+    std::vector<WristState> wrist_states_;      ///< a few hands, so linear search
+
+    bool is_local_hand_valid_ = false;
+    HandKinematics local_hand_;
+};
+
+// ************************************************************************************************
+
+inline LMatrix4f HandStateSnapshot::get_wrist_matrix(crsf::TWorldObject* wrist, crsf::TWorldObject* world)
+{
+    return get_wrist_state(wrist, world).matrix;
+}
+
+inline RigidTransform HandStateSnapshot::get_wrist_transform(crsf::TWorldObject* wrist, crsf::TWorldObject* world)
+{
+    return get_wrist_state(wrist, world).transform;
+}
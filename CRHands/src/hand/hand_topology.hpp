@@ -0,0 +1,144 @@
+/**
+* Coexistence Reality Software Framework (CRSF)
+* Copyright (c) Center of Human-centered Interaction for Coexistence. All rights reserved.
+* See the LICENSE.md file for more details.
+*/
+
+#pragma once
+
+/**
+ * Joint layout of CRSF hand model, built at compile time.
+ *
+ * Each hand side has SIDE_JOINT_COUNT joints:
+ *   [0]                          root of the side, not driven by devices
+ *   [1 + finger * 4 + segment]   finger joints from thumb to pinky, segment 3 is tip
+ *   [21]                         wrist
+ * and right side follows left side.
+ *
+ * Paths over joints should use this table instead of index arithmetic,
+ * so a rig with another joint count only needs to change the constants here.
+ */
+class HandTopology
+{
+public:
+    enum Side
+    {
+        SIDE_LEFT = 0,
+        SIDE_RIGHT,
+
+        SIDE_COUNT,
+    };
+
+    enum Finger
+    {
+        FINGER_THUMB = 0,
+        FINGER_INDEX,
+        FINGER_MIDDLE,
+        FINGER_RING,
+        FINGER_PINKY,
+
+        FINGER_COUNT,
+    };
+
+    enum JointKind
+    {
+        JOINT_KIND_ROOT = 0,
+        JOINT_KIND_FINGER,
+        JOINT_KIND_WRIST,
+    };
+
+    struct Joint
+    {
+        int side;
+        JointKind kind;
+        int finger;         ///< -1 if not finger joint
+        int segment;        ///< -1 if not finger joint
+        int parent;         ///< -1 if parent is not driven
+        bool is_tip;
+        int mirror;         ///< same joint in other side
+    };
+
+    static constexpr int SEGMENT_COUNT = 4;
+    static constexpr int TIP_SEGMENT = SEGMENT_COUNT - 1;
+    static constexpr int FINGER_OFFSET = 1;
+    static constexpr int WRIST_OFFSET = FINGER_OFFSET + FINGER_COUNT * SEGMENT_COUNT;
+    static constexpr int SIDE_JOINT_COUNT = WRIST_OFFSET + 1;
+    static constexpr int JOINT_COUNT = SIDE_COUNT * SIDE_JOINT_COUNT;
+
+public:
+    constexpr HandTopology();
+
+    static constexpr int get_joint_index(int side, int finger, int segment);
+    static constexpr int get_wrist_index(int side);
+    static constexpr bool is_valid_joint(int index);
+
+    /** @a index should be valid joint. */
+    constexpr const Joint& get_joint(int index) const;
+
+    /** -1 if @a index is not valid joint (ex, joint tag of interactor is not set). */
+    constexpr int get_side(int index) const;
+
+private:
+    static constexpr Joint make_joint(int index);
+
+    Joint joints_[JOINT_COUNT];
+};
+
+// ************************************************************************************************
+
+inline constexpr HandTopology::HandTopology() : joints_{}
+{
+    for (int k = 0; k < JOINT_COUNT; ++k)
+        joints_[k] = make_joint(k);
+}
+
+inline constexpr int HandTopology::get_joint_index(int side, int finger, int segment)
+{
+    return side * SIDE_JOINT_COUNT + FINGER_OFFSET + finger * SEGMENT_COUNT + segment;
+}
+
+inline constexpr int HandTopology::get_wrist_index(int side)
+{
+    return side * SIDE_JOINT_COUNT + WRIST_OFFSET;
+}
+
+inline constexpr bool HandTopology::is_valid_joint(int index)
+{
+    return 0 <= index && index < JOINT_COUNT;
+}
+
+inline constexpr const HandTopology::Joint& HandTopology::get_joint(int index) const
+{
+    return joints_[index];
+}
+
+inline constexpr int HandTopology::get_side(int index) const
+{
+    return is_valid_joint(index) ? joints_[index].side : -1;
+}
+
+inline constexpr HandTopology::Joint HandTopology::make_joint(int index)
+{
+    const int side = index / SIDE_JOINT_COUNT;
+    const int side_index = index % SIDE_JOINT_COUNT;
+    const int mirror = (SIDE_COUNT - 1 - side) * SIDE_JOINT_COUNT + side_index;
+
+    if (side_index == WRIST_OFFSET)
+        return Joint{ side, JOINT_KIND_WRIST, -1, -1, -1, false, mirror };
+
+    if (side_index < FINGER_OFFSET)
+        return Joint{ side, JOINT_KIND_ROOT, -1, -1, -1, false, mirror };
+
+    const int finger = (side_index - FINGER_OFFSET) / SEGMENT_COUNT;
+    const int segment = (side_index - FINGER_OFFSET) % SEGMENT_COUNT;
+    const int parent = segment == 0 ? get_wrist_index(side) : index - 1;
+
+    return Joint{ side, JOINT_KIND_FINGER, finger, segment, parent, segment == TIP_SEGMENT, mirror };
+}
+
+constexpr HandTopology hand_topology;
+
+static_assert(HandTopology::JOINT_COUNT == 44, "CRSF hand model has 44 joints.");
+static_assert(hand_topology.get_joint(HandTopology::get_wrist_index(HandTopology::SIDE_RIGHT)).kind == HandTopology::JOINT_KIND_WRIST, "Wrist should be last joint of side.");
+static_assert(hand_topology.get_joint(20).is_tip && hand_topology.get_joint(20).finger == HandTopology::FINGER_PINKY, "Pinky tip of left side.");
+static_assert(hand_topology.get_joint(23).mirror == 1, "Mirror of right thumb base is left thumb base.");
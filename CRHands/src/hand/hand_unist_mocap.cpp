@@ -25,16 +25,27 @@
 
 #include <kinesthethic_hand_mocap_interface.h>
 
+#include "hand/hand.hpp"
+#include "hand/hand_retarget.hpp"
+#include "hand/hand_topology.hpp"
+#include "util/stage_profiler.hpp"
+
 #if _MSC_VER > 1900
 #include <rpplugins/openvr/plugin.hpp>
 #else
 #include <openvr_plugin.hpp>
 #endif
 
-void HandManager::render_unist_mocap(crsf::TAvatarMemoryObject *amo)
+void HandManager::render_unist_mocap(Hand* hand, crsf::TAvatarMemoryObject *amo)
 {
+	auto& joint_write_cache = hand->get_joint_write_cache();
+
 	crsf::TWorld* virtual_world = crsf::TGraphicRenderEngine::GetInstance()->GetWorld();
 
+	// mode can be changed by main thread when devices are refreshed
+	const int unist_side = unist_mocap_side_.load(std::memory_order_acquire);
+	const int unist_joint_number = unist_mocap_joint_number_.load(std::memory_order_acquire);
+
     int tracker_index[HAND_INDEX_COUNT];
 
     tracker_index[HAND_INDEX_LEFT] = tracker_indices_[HAND_INDEX_LEFT];
@@ -43,7 +54,9 @@ void HandManager::render_unist_mocap(crsf::TAvatarMemoryObject *amo)
 	// set wrist pose using tracker pose
 	if (module_open_vr_)
 	{
-		if (unist_mocap_mode_ == "left")
+		CRHANDS_PROFILE_STAGE(PROFILE_STAGE_TRACKER);
+
+		if (unist_side == HAND_INDEX_LEFT)
 		{
 			auto tracker_pos = module_open_vr_->GetDevicePosition(tracker_index[HAND_INDEX_LEFT]);
 			auto tracker_quat = module_open_vr_->GetDeviceOrientation(tracker_index[HAND_INDEX_LEFT]);
@@ -55,9 +68,7 @@ void HandManager::render_unist_mocap(crsf::TAvatarMemoryObject *amo)
                 find_trackers();
 			}
 
-			LQuaternionf a;
-			a.set_from_axis_angle(-270, LVecBase3(0, 1, 0));
-			tracker_quat = a * tracker_quat;
+			tracker_quat = retarget_unist_tracker(tracker_quat, HAND_INDEX_LEFT);
 
 			hand_->GetJointData(crsf::RIGHT__WRIST)->Get3DModel()->SetPosition(LVecBase3(100), virtual_world);
 			hand_->GetJointData(crsf::RIGHT__WRIST)->SetPosition(LVecBase3(100));
@@ -66,7 +77,7 @@ void HandManager::render_unist_mocap(crsf::TAvatarMemoryObject *amo)
 			hand_->GetJointData(crsf::LEFT__WRIST)->SetPosition(tracker_pos);
 			hand_->GetJointData(crsf::LEFT__WRIST)->Get3DModel()->SetHPR(tracker_quat.get_hpr(), virtual_world);
 		}
-		else if (unist_mocap_mode_ == "right")
+		else if (unist_side == HAND_INDEX_RIGHT)
 		{
 			auto tracker_pos = module_open_vr_->GetDevicePosition(tracker_index[HAND_INDEX_RIGHT]);
 			auto tracker_quat = module_open_vr_->GetDeviceOrientation(tracker_index[HAND_INDEX_RIGHT]);
@@ -78,9 +89,7 @@ void HandManager::render_unist_mocap(crsf::TAvatarMemoryObject *amo)
 				find_trackers();
 			}
 
-			LQuaternionf a;
-			a.set_from_axis_angle(90, LVecBase3(0, 1, 0));
-			tracker_quat = a * tracker_quat;
+			tracker_quat = retarget_unist_tracker(tracker_quat, HAND_INDEX_RIGHT);
 
 			hand_->GetJointData(crsf::LEFT__WRIST)->Get3DModel()->SetPosition(LVecBase3(100), virtual_world);
 			hand_->GetJointData(crsf::LEFT__WRIST)->SetPosition(LVecBase3(100));
@@ -95,14 +104,21 @@ void HandManager::render_unist_mocap(crsf::TAvatarMemoryObject *amo)
 	if (hand_)
 	{
 		// read data from AvatarMemory 
-		for (int i = 0; i < unist_mocap_joint_number_; i++)
 		{
-			hand_mocap_data_[i] = amo->GetAvatarMemory().at(i).GetPosition()[0];
+			CRHANDS_PROFILE_STAGE(PROFILE_STAGE_INPUT_READ);
+
+			const auto& poses = amo->GetAvatarMemory();
+			for (int i = 0; i < unist_joint_number; i++)
+			{
+				hand_mocap_data_[i] = poses.at(i).GetPosition()[0];
+			}
 		}
 
 		// thumb, index, middle = 3 fingers
 		for (int i = 0; i < 3; i++)
 		{
+			CRHANDS_PROFILE_STAGE(PROFILE_STAGE_RETARGET);
+
 			// reference protocol
 			int start_index = 2 + i * 5;
 
@@ -149,46 +165,26 @@ void HandManager::render_unist_mocap(crsf::TAvatarMemoryObject *amo)
 					quat_result = b_ * a_;
 				}
 				// rotate unist hand -> crsf hand
-				quat_result = rotate_unist_to_crsf(quat_result);
+				quat_result = retarget_unist_joint(quat_result, unist_side);
 
 				// thumb case
 				if (i == 0)
 				{
 					// multiply quaternion for thumb rotation
-					if (unist_mocap_mode_ == "left")
-					{
-						LQuaternionf c, d, e, edc;
-						c.set_from_axis_angle(1.806013982f * 180.0f / M_PI, LVecBase3(-1, 0, 0));
-						d.set_from_axis_angle(0.453798839f * 180.0f / M_PI, LVecBase3(0, 0, -1));
-						e.set_from_axis_angle(0.905946589f * 180.0f / M_PI, LVecBase3(0, 1, 0));
-						edc = e * d * c;
-						LQuaternionf f;
-						f.set_from_axis_angle(-45, LVecBase3(0, 1, 0));
-						edc = f * edc;
-						quat_result = quat_result * edc;
-					}
-					else if (unist_mocap_mode_ == "right")
-					{
-						LQuaternionf c, d, e, edc;
-						c.set_from_axis_angle(-1.806013982f * 180.0f / M_PI, LVecBase3(1, 0, 0));
-						d.set_from_axis_angle(0.453798839f * 180.0f / M_PI, LVecBase3(0, 0, -1));
-						e.set_from_axis_angle(0.905946589f * 180.0f / M_PI, LVecBase3(0, 1, 0));
-						edc = e * d * c;
-						LQuaternionf f;
-						f.set_from_axis_angle(-45, LVecBase3(0, 1, 0));
-						edc = f * edc;
-						quat_result = quat_result * edc;
-					}
+					if (unist_side == HAND_INDEX_LEFT)
+						quat_result = retarget_unist_thumb(quat_result, HAND_INDEX_LEFT);
+					else if (unist_side == HAND_INDEX_RIGHT)
+						quat_result = retarget_unist_thumb(quat_result, HAND_INDEX_RIGHT);
 				}
 
 				// set hpr
-				LVecBase3 hpr = quat_result.get_hpr();
 				int model_index;
-				if (unist_mocap_mode_ == "left")
+				if (unist_side == HAND_INDEX_LEFT)
 					model_index = crsf::LEFT__THUMB_2 + i * 4;
-				else if (unist_mocap_mode_ == "right")
+				else if (unist_side == HAND_INDEX_RIGHT)
 					model_index = crsf::RIGHT__THUMB_2 + i * 4;
-				hand_->GetJointData(model_index)->Get3DModel()->SetHPR(hpr);
+				if (joint_write_cache.update_rotation(model_index, quat_result))
+					hand_->GetJointData(model_index)->Get3DModel()->SetHPR(quat_result.get_hpr());
 			}
 
 			// 2nd joint = intermediate phalanges
@@ -214,16 +210,16 @@ void HandManager::render_unist_mocap(crsf::TAvatarMemoryObject *amo)
 				// calculate quaternion for hand model
 				quat_result.set_from_axis_angle(pip, LVecBase3(0, 0, 1));
 				// rotate unist hand -> crsf hand
-				quat_result = rotate_unist_to_crsf(quat_result);
+				quat_result = retarget_unist_joint(quat_result, unist_side);
 
 				// set hpr
-				LVecBase3 hpr = quat_result.get_hpr();
 				int model_index;
-				if (unist_mocap_mode_ == "left")
+				if (unist_side == HAND_INDEX_LEFT)
 					model_index = crsf::LEFT__THUMB_3 + i * 4;
-				else if (unist_mocap_mode_ == "right")
+				else if (unist_side == HAND_INDEX_RIGHT)
 					model_index = crsf::RIGHT__THUMB_3 + i * 4;
-				hand_->GetJointData(model_index)->Get3DModel()->SetHPR(hpr);
+				if (joint_write_cache.update_rotation(model_index, quat_result))
+					hand_->GetJointData(model_index)->Get3DModel()->SetHPR(quat_result.get_hpr());
 			}
 
 			// 3rd joint = distal phalanges
@@ -249,24 +245,37 @@ void HandManager::render_unist_mocap(crsf::TAvatarMemoryObject *amo)
 				// calculate quaternion for hand model
 				quat_result.set_from_axis_angle(dip, LVecBase3(0, 0, 1));
 				// rotate unist hand -> crsf hand
-				quat_result = rotate_unist_to_crsf(quat_result);
+				quat_result = retarget_unist_joint(quat_result, unist_side);
 
 				// set hpr
-				LVecBase3 hpr = quat_result.get_hpr();
 				int model_index;
-				if (unist_mocap_mode_ == "left")
+				if (unist_side == HAND_INDEX_LEFT)
 					model_index = crsf::LEFT__THUMB_4 + i * 4;
-				else if (unist_mocap_mode_ == "right")
+				else if (unist_side == HAND_INDEX_RIGHT)
 					model_index = crsf::RIGHT__THUMB_4 + i * 4;
-				hand_->GetJointData(model_index)->Get3DModel()->SetHPR(hpr);
+				if (joint_write_cache.update_rotation(model_index, quat_result))
+					hand_->GetJointData(model_index)->Get3DModel()->SetHPR(quat_result.get_hpr());
 			}
+		}
+
+		// do hand model scaling using input data
+		if (props_.get("subsystem.unistmocap_scale", false))
+		{
+			CRHANDS_PROFILE_STAGE(PROFILE_STAGE_SCALE);
+
+			int h = 1;
+			if (unist_side == HAND_INDEX_LEFT)
+				h = 0;
+			else if (unist_side == HAND_INDEX_RIGHT)
+				h = 1;
+			const HandIndex hand_index = static_cast<HandIndex>(h);
 
-			// do hand model scaling using input data
-			if (props_.get("subsystem.unistmocap_scale", false))
+			ScaleSegmentLengths segment_lengths;
+			for (int i = 0; i < 3; i++)
 			{
 				// get finger length
 				float offset = hand_mocap_data_[23 + i] / 1000.0f;
-				float dist[3];
+				float* dist = segment_lengths.data() + i * 3;
 
 				if (i == 0) // thumb
 				{
@@ -286,85 +295,60 @@ void HandManager::render_unist_mocap(crsf::TAvatarMemoryObject *amo)
 					dist[1] = offset * 0.3;
 					dist[2] = offset * 0.2;
 				}
+			}
 
-				// do scaling following hand model hierarchy
-				int h;
-				if (unist_mocap_mode_ == "left")
-					h = 0;
-				else if (unist_mocap_mode_ == "right")
-					h = 1;
-				int f = i;
-				for (int j = 0; j < 3; j++)
+			// scaling is updated only after calibration or when the lengths are changed
+			if (is_hand_scale_dirty(hand_index, segment_lengths))
+			{
+				for (int i = 0; i < 3; i++)
 				{
-					int index = 1 + (h * 22) + (f * 4) + j;
-
-					LVecBase3 origin_scale;
-					if (j == 0) // 1st joint = proximal phalanges
-						origin_scale = hand_->GetJointData(index)->Get3DModelStandardPoseScale();
-					else
-						origin_scale = hand_->GetJointData(index)->Get3DModel()->GetScale();
-					hand_->GetJointData(index)->SetSensorOffset(dist[j]);
-					float modified_offset_ratio = hand_->GetJointData(index)->GetScalingRatio_Offset();
-					//std::cout << "index[" << index << "]: " << modified_offset_ratio << std::endl;
-
-					LVecBase3 modified_scale = LVecBase3(origin_scale[0] * modified_offset_ratio,
-						origin_scale[1],
-						origin_scale[2]);
-					hand_->GetJointData(index)->Get3DModel()->SetScale(modified_scale);
-
-					if (f == 2) // in middle case, ring and pinky follows middle finger's scale 
-					{
-						hand_->GetJointData(index + 4)->Get3DModel()->SetScale(modified_scale);
-						hand_->GetJointData(index + 8)->Get3DModel()->SetScale(modified_scale);
-					}
+					const float* dist = segment_lengths.data() + i * 3;
 
-					// hierarchy tree scaling (local scale balancing)
-					if (j != 2)
+					// do scaling following hand model hierarchy
+					int f = i;
+					for (int j = 0; j < 3; j++)
 					{
-						LVecBase3 nextJoint_scale = hand_->GetJointData(index + 1)->Get3DModelStandardPoseScale();
-						nextJoint_scale[0] *= 1.0f / modified_offset_ratio;
-						hand_->GetJointData(index + 1)->Get3DModel()->SetScale(nextJoint_scale);
+						int index = HandTopology::get_joint_index(h, f, j);
+
+						LVecBase3 origin_scale;
+						if (j == 0) // 1st joint = proximal phalanges
+							origin_scale = hand_->GetJointData(index)->Get3DModelStandardPoseScale();
+						else
+							origin_scale = applied_joint_scales_[index];
+						hand_->GetJointData(index)->SetSensorOffset(dist[j]);
+						float modified_offset_ratio = hand_->GetJointData(index)->GetScalingRatio_Offset();
+						//std::cout << "index[" << index << "]: " << modified_offset_ratio << std::endl;
+
+						LVecBase3 modified_scale = LVecBase3(origin_scale[0] * modified_offset_ratio,
+							origin_scale[1],
+							origin_scale[2]);
+						set_joint_scale(hand_, index, modified_scale);
+
+						if (f == HandTopology::FINGER_MIDDLE) // in middle case, ring and pinky follows middle finger's scale 
+						{
+							set_joint_scale(hand_, HandTopology::get_joint_index(h, HandTopology::FINGER_RING, j), modified_scale);
+							set_joint_scale(hand_, HandTopology::get_joint_index(h, HandTopology::FINGER_PINKY, j), modified_scale);
+						}
 
-						if (f == 2) // in middle case, ring and pinky follows middle finger's scale 
+						// hierarchy tree scaling (local scale balancing)
+						if (j != 2)
 						{
-							hand_->GetJointData(index + 1 + 4)->Get3DModel()->SetScale(nextJoint_scale);
-							hand_->GetJointData(index + 1 + 8)->Get3DModel()->SetScale(nextJoint_scale);
+							LVecBase3 nextJoint_scale = hand_->GetJointData(index + 1)->Get3DModelStandardPoseScale();
+							nextJoint_scale[0] *= 1.0f / modified_offset_ratio;
+							set_joint_scale(hand_, index + 1, nextJoint_scale);
+
+							if (f == HandTopology::FINGER_MIDDLE) // in middle case, ring and pinky follows middle finger's scale 
+							{
+								set_joint_scale(hand_, HandTopology::get_joint_index(h, HandTopology::FINGER_RING, j + 1), nextJoint_scale);
+								set_joint_scale(hand_, HandTopology::get_joint_index(h, HandTopology::FINGER_PINKY, j + 1), nextJoint_scale);
+							}
 						}
 					}
 				}
+
+				scaled_segment_lengths_[hand_index] = segment_lengths;
+				is_scale_dirty_[hand_index] = false;
 			}
 		}
 	}
 }
-
-LQuaternionf HandManager::rotate_unist_to_crsf(const LQuaternionf& quat)
-{
-	LQuaternionf result;
-
-	// rotate unist coord -> panda coord
-	LQuaternionf a, b, ba;
-	a.set_from_axis_angle(180, LVecBase3(1, 0, 0));
-	b.set_from_axis_angle(90, LVecBase3(0, 1, 0));
-	ba = b * a;
-	result = ba.conjugate() * quat * ba;
-
-	// rotate to leap hand origin pose
-	if (unist_mocap_mode_ == "left")
-	{
-		LQuaternionf c, d, dc;
-		c.set_from_axis_angle(90, LVecBase3(0, 1, 0));
-		d.set_from_axis_angle(-90, LVecBase3(0, 0, 1));
-		dc = d * c;
-		result = dc.conjugate() * result * dc;
-	}
-	else if (unist_mocap_mode_ == "right")
-	{
-		LQuaternionf c, d, dc;
-		c.set_from_axis_angle(90, LVecBase3(0, 1, 0));
-		d.set_from_axis_angle(-90, LVecBase3(0, 0, 1));
-		dc = d * c;
-		result = dc.conjugate() * result * dc;
-	}
-
-	return result;
-}
\ No newline at end of file
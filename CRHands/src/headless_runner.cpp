@@ -0,0 +1,108 @@
+#include "headless_runner.hpp"
+
+#include <boost/property_tree/xml_parser.hpp>
+
+#include <spdlog/logger.h>
+
+#include <clockObject.h>
+
+#include <render_pipeline/rppanda/showbase/showbase.hpp>
+#include <render_pipeline/rpcore/globals.hpp>
+
+#include <crsf/CREngine/TPhysicsManager.h>
+
+#include "latency_pulse_source.hpp"
+#include "main.hpp"
+#include "performance_suite.hpp"
+
+extern spdlog::logger* global_logger;
+
+HeadlessRunner::Settings HeadlessRunner::load_settings(const std::string& system_config_path)
+{
+    Settings settings;
+
+    boost::property_tree::ptree tree;
+    try
+    {
+        boost::property_tree::read_xml(system_config_path, tree);
+    }
+    catch (const boost::property_tree::ptree_error&)
+    {
+        // global_logger may not be ready, and no configuration is not headless
+        return settings;
+    }
+
+    settings.is_enabled = tree.get("system.headless.enabled", settings.is_enabled);
+    settings.step_rate = tree.get("system.headless.step_rate", settings.step_rate);
+    settings.max_steps = tree.get("system.headless.max_steps", settings.max_steps);
+    settings.exit_on_benchmark_finished = tree.get("system.headless.exit_on_benchmark_finished", settings.exit_on_benchmark_finished);
+    settings.exit_on_latency_probe_finished = tree.get("system.headless.exit_on_latency_probe_finished", settings.exit_on_latency_probe_finished);
+
+    return settings;
+}
+
+HeadlessRunner::HeadlessRunner(MainApp& app, const Settings& settings, double physics_rate) :
+    app_(app), settings_(settings), physics_rate_(physics_rate), start_time_(std::chrono::steady_clock::now())
+{
+    // physics steps from the main task manager with frame time of this clock
+    auto clock = ClockObject::get_global_clock();
+    if (settings_.step_rate > 0.0)
+    {
+        // advance fixed time per frame, and wait to keep real time
+        clock->set_mode(ClockObject::M_forced);
+        clock->set_frame_rate(settings_.step_rate);
+    }
+    else
+    {
+        // one physics step per frame without waiting
+        clock->set_mode(ClockObject::M_non_real_time);
+        clock->set_frame_rate(physics_rate_);
+    }
+
+    // window may exist if display is not "window-type none", so stop drawing it
+    if (rpcore::Globals::base && rpcore::Globals::base->get_win())
+        rpcore::Globals::base->get_win()->set_active(false);
+
+    auto physics_manager = crsf::TPhysicsManager::GetInstance();
+    physics_manager->AddTask([this](void) {
+        step_count_.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }, "HeadlessRunner::count_step");
+
+    // benchmark starts physics by itself
+    if (!app_.performance_suite_ || !app_.performance_suite_->is_running())
+        physics_manager->Start();
+
+    add_task([this](rppanda::FunctionalTask*) {
+        update();
+        return AsyncTask::DS_cont;
+    }, "HeadlessRunner::update");
+
+    global_logger->info("Headless mode is started: physics rate {}, step rate {} (0 = as fast as possible), max steps {}",
+        physics_rate_, settings_.step_rate, settings_.max_steps);
+}
+
+HeadlessRunner::~HeadlessRunner() = default;
+
+void HeadlessRunner::update()
+{
+    if (is_exit_requested_)
+        return;
+
+    const uint64_t step_count = get_step_count();
+    const bool is_step_limited = settings_.max_steps > 0 && step_count >= settings_.max_steps;
+    const bool is_benchmark_finished = settings_.exit_on_benchmark_finished &&
+        app_.performance_suite_ && app_.performance_suite_->is_finished();
+    const bool is_latency_probe_finished = settings_.exit_on_latency_probe_finished &&
+        app_.latency_pulse_source_ && app_.latency_pulse_source_->is_finished();
+
+    if (!is_step_limited && !is_benchmark_finished && !is_latency_probe_finished)
+        return;
+
+    const double wall_time = std::chrono::duration<double>(std::chrono::steady_clock::now() - start_time_).count();
+    global_logger->info("Headless mode is finished: {} physics steps ({:.2f} seconds of simulation time) in {:.2f} seconds of wall time",
+        step_count, step_count / physics_rate_, wall_time);
+
+    is_exit_requested_ = true;
+    rpcore::Globals::base->user_exit();
+}
@@ -0,0 +1,59 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <string>
+
+#include <render_pipeline/rppanda/showbase/direct_object.hpp>
+
+class MainApp;
+
+/**
+ * Run physics and grasp without window, render pipeline and GUI.
+ *
+ * Selected by <headless> of SystemConfiguration.xml.
+ * Physics is stepped by the main task manager instead of its own thread (see MainApp::setup_physics),
+ * so it follows Panda clock driven by this runner:
+ * - step_rate = 0: time advances one physics step per frame without waiting (as fast as possible)
+ * - step_rate > 0: time is paced to real time at step_rate frames per second
+ * App exits after max_steps physics steps (0 = no limit) or when benchmark or latency probe is finished.
+ */
+class HeadlessRunner : public rppanda::DirectObject
+{
+public:
+    struct Settings
+    {
+        bool is_enabled = false;
+        double step_rate = 0.0;
+        uint64_t max_steps = 0;
+        bool exit_on_benchmark_finished = true;
+        bool exit_on_latency_probe_finished = true;
+    };
+
+    static Settings load_settings(const std::string& system_config_path);
+
+public:
+    HeadlessRunner(MainApp& app, const Settings& settings, double physics_rate);
+    ~HeadlessRunner() override;
+
+    uint64_t get_step_count() const;
+
+private:
+    void update();
+
+    MainApp& app_;
+    const Settings settings_;
+    const double physics_rate_;
+    const std::chrono::steady_clock::time_point start_time_;
+
+    std::atomic<uint64_t> step_count_{ 0 };
+    bool is_exit_requested_ = false;
+};
+
+// ************************************************************************************************
+
+inline uint64_t HeadlessRunner::get_step_count() const
+{
+    return step_count_.load(std::memory_order_relaxed);
+}
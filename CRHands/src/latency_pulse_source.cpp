@@ -0,0 +1,155 @@
+#include "latency_pulse_source.hpp"
+
+#include <boost/property_tree/json_parser.hpp>
+
+#include <spdlog/logger.h>
+
+#include <crsf/CoexistenceInterface/TAvatarMemoryObject.h>
+#include <crsf/System/TPose.h>
+
+#include "hand/hand.hpp"
+#include "hand/hand_topology.hpp"
+#include "main.hpp"
+#include "user.hpp"
+#include "util/latency_probe.hpp"
+#include "util/performance_report.hpp"
+
+extern spdlog::logger* global_logger;
+
+LatencyPulseSource::LatencyPulseSource(MainApp& app, const boost::property_tree::ptree& props) : app_(app)
+{
+    interval_ = std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+        std::chrono::duration<float, std::milli>(props.get("latency_probe.interval", 250.0f)));
+    step_ = props.get("latency_probe.step", 0.02f);
+    max_pulses_ = props.get("latency_probe.max_pulses", uint64_t(0));
+    report_path_ = props.get("latency_probe.report", std::string("crhands_latency.json"));
+
+    get_latency_probe().set_timeout(std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+        std::chrono::duration<float, std::milli>(props.get("latency_probe.timeout", 200.0f))));
+
+    add_task([this](rppanda::FunctionalTask*) {
+        update();
+        return AsyncTask::DS_cont;
+    }, "LatencyPulseSource::update");
+}
+
+LatencyPulseSource::~LatencyPulseSource() = default;
+
+void LatencyPulseSource::start()
+{
+    if (is_running_)
+        return;
+
+    get_latency_probe().reset();
+    is_finished_ = false;
+    is_running_ = true;
+    next_pulse_time_ = std::chrono::steady_clock::now() + interval_;
+
+    global_logger->info("Latency probe is started: interval {} ms, step {} m, max pulses {} (0 = no limit)",
+        std::chrono::duration<double, std::milli>(interval_).count(), step_, max_pulses_);
+}
+
+void LatencyPulseSource::stop()
+{
+    is_running_ = false;
+}
+
+void LatencyPulseSource::update()
+{
+    if (!is_running_)
+        return;
+
+    auto& probe = get_latency_probe();
+    const auto now = std::chrono::steady_clock::now();
+
+    if (probe.update(now) && max_pulses_ > 0 && probe.get_pulse_count() >= max_pulses_)
+    {
+        is_running_ = false;
+        is_finished_ = true;
+        write_report();
+        return;
+    }
+
+    if (probe.is_pulse_in_flight() || now < next_pulse_time_)
+        return;
+
+    next_pulse_time_ = now + interval_;
+    if (!inject_pulse())
+    {
+        global_logger->error("Latency probe is stopped: local hand has no device memory.");
+        is_running_ = false;
+    }
+}
+
+bool LatencyPulseSource::inject_pulse()
+{
+    if (!app_.user_ || !app_.user_->get_hand())
+        return false;
+
+    auto amo = app_.user_->get_hand()->get_source_memory_object();
+    if (!amo)
+        return false;
+
+    auto poses = amo->GetAvatarMemory();
+    if (static_cast<int>(poses.size()) < HandTopology::JOINT_COUNT)
+        return false;
+
+    // step forth and back, so hand does not drift if nothing else writes the memory
+    is_stepped_ = !is_stepped_;
+    const LVecBase3 offset(is_stepped_ ? step_ : -step_, 0.0f, 0.0f);
+    LatencyProbe::Markers markers;
+    for (int side = 0; side < HandTopology::SIDE_COUNT; ++side)
+    {
+        auto& pose = poses[HandTopology::get_wrist_index(side)];
+        pose.MakePosQuat(pose.GetPosition() + offset, pose.GetQuaternion());
+        markers[side] = pose.GetPosition();
+    }
+
+    // callback may run inside update, so pulse begins before it
+    get_latency_probe().begin_pulse(std::chrono::steady_clock::now(), markers);
+
+    amo->SetAvatarMemory(poses);
+    amo->UpdateAvatarMemoryObject();
+
+    return true;
+}
+
+void LatencyPulseSource::write_report() const
+{
+    auto& probe = get_latency_probe();
+    const std::string scenario = "latency_probe";
+
+    PerformanceReport report;
+    for (int k = 0; k < LATENCY_STAGE_COUNT; ++k)
+    {
+        const auto stage = static_cast<LatencyStage>(k);
+        const auto snapshot = probe.get_stage_histogram(stage).get_snapshot();
+        if (snapshot.count > 0)
+            report.add_metric(scenario, std::string("latency_us.") + get_latency_stage_name(stage), PerformanceReport::summarize(snapshot));
+    }
+
+    const auto end_to_end = probe.get_end_to_end_histogram().get_snapshot();
+    if (end_to_end.count > 0)
+        report.add_metric(scenario, "latency_us.End to End", PerformanceReport::summarize(end_to_end));
+
+    auto tree = report.to_ptree();
+    tree.put("pulses", probe.get_pulse_count());
+    for (int k = 0; k < LATENCY_STAGE_COUNT; ++k)
+    {
+        const auto stage = static_cast<LatencyStage>(k);
+        tree.put(std::string("missed.") + get_latency_stage_name(stage), probe.get_missed_count(stage));
+    }
+
+    try
+    {
+        boost::property_tree::write_json(report_path_, tree);
+    }
+    catch (const boost::property_tree::ptree_error& err)
+    {
+        global_logger->error("Failed to write latency report {}: {}", report_path_, err.what());
+        return;
+    }
+
+    global_logger->info("Latency probe is finished: {} pulses, end-to-end p50 {:.1f} us, p99 {:.1f} us, report is written to {}",
+        probe.get_pulse_count(), end_to_end.get_percentile_ns(0.50) / 1000.0, end_to_end.get_percentile_ns(0.99) / 1000.0, report_path_);
+}
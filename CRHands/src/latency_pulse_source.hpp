@@ -0,0 +1,71 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <string>
+
+#include <boost/property_tree/ptree.hpp>
+
+#include <render_pipeline/rppanda/showbase/direct_object.hpp>
+
+class MainApp;
+
+/**
+ * Fake input source of latency probe.
+ *
+ * Every latency_probe.interval ms, wrists of the device memory connected to the local hand
+ * are moved by latency_probe.step meters (alternating direction), and the memory is updated
+ * as if the device wrote a new sample. Stages of hand pipeline mark the pulse (see LatencyProbe).
+ * After latency_probe.max_pulses pulses (0 = no limit), the report is written to
+ * latency_probe.report as JSON of PerformanceReport (scenario "latency_probe").
+ *
+ * Retarget, scene write and physics stages are marked only when their wrists are the injected ones,
+ * so a pulse which a device module overwrote is counted as missed. Use a recorded or idle device
+ * (or headless mode) for stable results. Wrists of the CHIC mocap path follow trackers, so
+ * the probe covers the Leap path.
+ */
+class LatencyPulseSource : public rppanda::DirectObject
+{
+public:
+    LatencyPulseSource(MainApp& app, const boost::property_tree::ptree& props);
+    ~LatencyPulseSource() override;
+
+    void start();
+    void stop();
+
+    bool is_running() const;
+
+    /** Pulse count reached max_pulses and report is written. */
+    bool is_finished() const;
+
+    void write_report() const;
+
+private:
+    void update();
+    bool inject_pulse();
+
+    MainApp& app_;
+
+    std::chrono::steady_clock::duration interval_;
+    float step_;
+    uint64_t max_pulses_;
+    std::string report_path_;
+
+    bool is_running_ = false;
+    bool is_finished_ = false;
+
+    bool is_stepped_ = false;
+    std::chrono::steady_clock::time_point next_pulse_time_;
+};
+
+// ************************************************************************************************
+
+inline bool LatencyPulseSource::is_running() const
+{
+    return is_running_;
+}
+
+inline bool LatencyPulseSource::is_finished() const
+{
+    return is_finished_;
+}
@@ -4,6 +4,7 @@
 
 #include "hand/hand_manager.hpp"
 #include "object/jewelry.hpp"
+#include "object/soma_cube.hpp"
 
 #include <crsf/CREngine/TDynamicModuleManager.h>
 
@@ -13,6 +14,7 @@
 #include <crsf/RenderingEngine/TGraphicRenderEngine.h>
 #include <crsf/CRModel/TWorld.h>
 #include <crsf/CRModel/TCRHand.h>
+#include <crsf/CRModel/TCompound.h>
 #include <crsf/System/TCRProperty.h>
 
 #include <crsf/CREngine/TPhysicsManager.h>
@@ -20,18 +22,33 @@
 #include "hand/hand.hpp"
 #include "main_gui/main_gui.hpp"
 #include "local_user.hpp"
+#include "headless_runner.hpp"
+#include "latency_pulse_source.hpp"
+#include "performance_suite.hpp"
+#include "session_capture.hpp"
+#include "util/performance_monitor.hpp"
 
 CRSEEDLIB_MODULE_CREATOR(MainApp);
 
 spdlog::logger* global_logger = nullptr;
 
+namespace {
+
+constexpr int PHYSICS_STEP_RATE = 60;
+
+const char* const SYSTEM_CONFIGURATION_PATH = "config/SystemConfiguration.xml";
+
+}
+
 //////////////////////////////////////////////////////////////////////////
 MainApp::MainApp(void) : crsf::TDynamicModuleInterface(CRMODULE_ID_STRING)
 {
     global_logger = m_logger.get();
 
+    // headless mode keeps scene graph and physics, but does not use render pipeline
+    is_headless_ = HeadlessRunner::load_settings(SYSTEM_CONFIGURATION_PATH).is_enabled;
+
     rendering_engine_ = crsf::TGraphicRenderEngine::GetInstance();
-    pipeline_ = rendering_engine_->GetRenderPipeline();
     dsm_ = crsf::TDynamicStageMemory::GetInstance();
 
 	setup_physics();
@@ -41,6 +58,11 @@ MainApp::~MainApp() = default;
 
 void MainApp::OnLoad(void)
 {
+	if (is_headless_)
+		return;
+
+	pipeline_ = rendering_engine_->GetRenderPipeline();
+
 	rendering_engine_->SetWindowTitle(CRMODULE_ID_STRING);
 	/*if (!crsf::TDynamicModuleManager::GetInstance()->IsModuleEnabled("openvr"))
 	{
@@ -65,10 +87,17 @@ void MainApp::OnStart(void)
     user_ = std::make_unique<LocalUser>();
 
 	setup_event();
+	setup_performance_monitor();
 	setup_hand();
 	setup_scene();
+	setup_session_capture();
+	setup_performance_suite();
+	setup_latency_probe();
 
-    main_gui_ = std::make_unique<MainGUI>(*this);
+    if (is_headless_)
+        setup_headless_runner();
+    else
+        main_gui_ = std::make_unique<MainGUI>(*this);
 
 	/*do_method_later(1.0f, [this](rppanda::FunctionalTask* task) {
 		physics_manager_->Start();
@@ -84,8 +113,15 @@ void MainApp::OnExit(void)
 
 	physics_manager_->Exit();
 
+	headless_runner_.reset();
+	latency_pulse_source_.reset();
+	performance_suite_.reset();
+	session_capture_.reset();
+
 	hand_manager_.reset();
 
+    performance_monitor_.reset();
+
     user_.reset();
 }
 
@@ -118,12 +154,29 @@ void MainApp::setup_event()
 	});
 }
 
+void MainApp::setup_performance_monitor()
+{
+    performance_monitor_ = std::make_unique<PerformanceMonitor>();
+
+    add_task([this](rppanda::FunctionalTask*) {
+        performance_monitor_->record_frame();
+        return AsyncTask::DS_cont;
+    }, "MainApp::record_frame_performance");
+
+    physics_manager_->AddTask([this](void) {
+        performance_monitor_->record_physics_step();
+        return false;
+    }, "MainApp::record_physics_performance");
+}
+
 void MainApp::setup_physics()
 {
 	physics_manager_ = crsf::TPhysicsManager::GetInstance();
 	physics_manager_->Init(crsf::EPHYX_ENGINE_BULLET);
 	physics_manager_->SetGravity(LVecBase3(0.0f, 0.0f, -0.98f));
-	physics_manager_->SetInternalStep_FPS(60, true, false);
+	// headless mode steps physics from the main task manager without its own thread,
+	// so HeadlessRunner can advance it as fast as possible or at fixed rate
+	physics_manager_->SetInternalStep_FPS(PHYSICS_STEP_RATE, !is_headless_, false);
 }
 
 void MainApp::setup_hand()
@@ -132,6 +185,45 @@ void MainApp::setup_hand()
     hand_manager_->setup_hand(user_.get());
 }
 
+void MainApp::setup_session_capture()
+{
+    session_capture_ = std::make_unique<SessionCapture>(*this, m_property);
+
+    // interactable bodies
+    if (soma_cube_)
+    {
+        for (const auto& piece: soma_cube_->get_pieces())
+            session_capture_->add_body(piece.get());
+    }
+
+    if (jewelry_)
+    {
+        session_capture_->add_body(dynamic_cast<crsf::TCRModel*>(jewelry_->GetChild(0)->GetChild(0)));
+        session_capture_->add_body(dynamic_cast<crsf::TCRModel*>(jewelry_->GetChild(1)->GetChild(0)));
+    }
+}
+
+void MainApp::setup_performance_suite()
+{
+    performance_suite_ = std::make_unique<PerformanceSuite>(*this, m_property);
+
+    if (m_property.get("benchmark.run", false))
+        performance_suite_->start();
+}
+
+void MainApp::setup_latency_probe()
+{
+    latency_pulse_source_ = std::make_unique<LatencyPulseSource>(*this, m_property);
+
+    if (m_property.get("latency_probe.run", false))
+        latency_pulse_source_->start();
+}
+
+void MainApp::setup_headless_runner()
+{
+    headless_runner_ = std::make_unique<HeadlessRunner>(*this, HeadlessRunner::load_settings(SYSTEM_CONFIGURATION_PATH), PHYSICS_STEP_RATE);
+}
+
 void MainApp::setup_scene()
 {
 	if (m_property.get("object.create.ground", false))
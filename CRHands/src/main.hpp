@@ -18,6 +18,13 @@ class TDynamicStageMemory;
 class User;
 class HandManager;
 class Jewelry;
+class TwistyPuzzle;
+class SomaCube;
+class PerformanceMonitor;
+class SessionCapture;
+class PerformanceSuite;
+class LatencyPulseSource;
+class HeadlessRunner;
 
 class MainApp: public crsf::TDynamicModuleInterface, public rppanda::DirectObject
 {
@@ -30,8 +37,13 @@ public:
 	void OnExit(void) override;
 
 	void setup_event();
+	void setup_performance_monitor();
 	void setup_physics();
 	void setup_hand();
+	void setup_session_capture();
+	void setup_performance_suite();
+	void setup_latency_probe();
+	void setup_headless_runner();
 
 	void setup_scene();
 	void setup_ground();
@@ -46,7 +58,7 @@ private:
     friend class MainGUI;
 
     crsf::TGraphicRenderEngine* rendering_engine_;
-    rpcore::RenderPipeline* pipeline_;
+    rpcore::RenderPipeline* pipeline_ = nullptr;
     crsf::TDynamicStageMemory* dsm_;
     crsf::TPhysicsManager* physics_manager_ = nullptr;
 
@@ -57,6 +69,21 @@ private:
 
     std::unique_ptr<User> user_;
 
+    std::unique_ptr<PerformanceMonitor> performance_monitor_;
+
+    friend class SessionCapture;
+    std::unique_ptr<SessionCapture> session_capture_;
+
+    friend class PerformanceSuite;
+    std::unique_ptr<PerformanceSuite> performance_suite_;
+
+    friend class LatencyPulseSource;
+    std::unique_ptr<LatencyPulseSource> latency_pulse_source_;
+
+    friend class HeadlessRunner;
+    bool is_headless_ = false;
+    std::unique_ptr<HeadlessRunner> headless_runner_;
+
 	// [OBJECTS]
 	// base object
 	std::shared_ptr<crsf::TCube> ground_ = nullptr;
@@ -65,8 +92,11 @@ private:
 	std::shared_ptr<crsf::TWorldObject> table_compound_ = nullptr;
 
 	// soma cube
-	std::vector<std::shared_ptr<crsf::TCube>> cubes_;
+	std::unique_ptr<SomaCube> soma_cube_;
 
 	// jewelry
 	std::shared_ptr<Jewelry> jewelry_ = nullptr;
+
+	// twisty puzzle
+	std::shared_ptr<TwistyPuzzle> twisty_puzzle_ = nullptr;
 };
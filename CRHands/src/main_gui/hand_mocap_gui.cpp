@@ -2,13 +2,14 @@
 
 #include <imgui.h>
 
-#include <crsf/RealWorldInterface/TInterfaceManager.h>
-
 #include "hand_mocap_interface.h"
 
+#include "hand/hand_manager.hpp"
+#include "main.hpp"
+
 void MainGUI::setup_hand_mocap()
 {
-    auto hand_mocap_interface = dynamic_cast<Hand_MoCAPInterface*>(crsf::TInterfaceManager::GetInstance()->GetInputInterface("Hand_MoCAP"));
+    auto hand_mocap_interface = app_.hand_manager_->get_device_session().get_hand_mocap();
     if (!hand_mocap_interface)
         return;
 
@@ -24,14 +25,15 @@ void MainGUI::setup_hand_mocap()
 
 void MainGUI::ui_hand_mocap()
 {
-    auto hand_mocap_interface = dynamic_cast<Hand_MoCAPInterface*>(crsf::TInterfaceManager::GetInstance()->GetInputInterface("Hand_MoCAP"));
+    const auto devices = app_.hand_manager_->get_device_session().get_devices();
+    auto hand_mocap_interface = devices->hand_mocap;
     if (!hand_mocap_interface)
         return;
 
     if (!ImGui::CollapsingHeader("Hand MoCAP"))
         return;
 
-    ImGui::LabelText("Mode", hand_mocap_interface->GetMoCAPMode().c_str());
+    ImGui::LabelText("Mode", devices->hand_mocap_mode_name.c_str());
 
     for (auto hand_index : { Hand_MoCAPInterface::HAND_LEFT, Hand_MoCAPInterface::HAND_RIGHT })
     {
@@ -48,7 +50,7 @@ void MainGUI::ui_hand_mocap()
 
         if (ImGui::Button("Calibration"))
         {
-            hand_mocap_interface->FingerInit(hand_index);
+            app_.hand_manager_->calibrate_hand_mocap(hand_index == Hand_MoCAPInterface::HAND_LEFT ? HandManager::HAND_INDEX_LEFT : HandManager::HAND_INDEX_RIGHT);
         }
 
         ImGui::TextUnformatted("Vibration:");
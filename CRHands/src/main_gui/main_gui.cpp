@@ -4,6 +4,8 @@
 
 #include <imgui.h>
 
+#include <throw_event.h>
+
 #include <fmt/format.h>
 
 #include <render_pipeline/rppanda/showbase/showbase.hpp>
@@ -39,7 +41,19 @@ void MainGUI::on_imgui_new_frame()
     if (ImGui::Button("Swap Trackers"))
         app_.hand_manager_->swap_trackers();
 
+    ImGui::SameLine();
+
+    // interfaces are looked up again after modules are changed
+    if (ImGui::Button("Refresh Devices"))
+        throw_event(HandDeviceSession::REFRESH_EVENT_NAME);
+
     ui_hand_mocap();
 
+    ui_performance();
+
+    ui_soma_cube();
+
+    ui_session();
+
     ImGui::End();
 }
\ No newline at end of file
@@ -1,7 +1,12 @@
 #pragma once
 
+#include <vector>
+
 #include <render_pipeline/rppanda/showbase/direct_object.hpp>
 
+#include "hand/force_feedback_controller.hpp"
+#include "util/performance_monitor.hpp"
+
 class MainApp;
 
 class MainGUI : public rppanda::DirectObject
@@ -14,6 +19,12 @@ public:
     void setup_hand_mocap();
     void ui_hand_mocap();
 
+    void ui_performance();
+
+    void ui_soma_cube();
+
+    void ui_session();
+
 private:
     void on_imgui_new_frame();
 
@@ -27,4 +38,16 @@ private:
         bool middle = false;
     };
     HandMocapStatus hand_mocap_status_[2];
+
+    // reused every frame to avoid allocation in GUI
+    std::vector<PerformanceMonitor::FrameSample> frame_samples_;
+    std::vector<PerformanceMonitor::PhysicsSample> physics_samples_;
+    std::vector<float> plot_values_;
+    int performance_dump_seconds_ = 10;
+
+    // last force command, kept while controller has no new command
+    ForceFeedbackController::Command force_feedback_command_ = {};
+
+    char session_path_[256] = "session.crhs";
+    int session_verify_step_ = 0;
 };
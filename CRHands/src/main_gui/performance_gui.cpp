@@ -0,0 +1,245 @@
+#include "main_gui.hpp"
+
+#include <algorithm>
+
+#include <imgui.h>
+
+#include <fmt/format.h>
+
+#include "hand/hand.hpp"
+#include "hand/hand_manager.hpp"
+#include "latency_pulse_source.hpp"
+#include "main.hpp"
+#include "performance_suite.hpp"
+#include "user.hpp"
+#include "util/allocation_counter.hpp"
+#include "util/latency_probe.hpp"
+#include "util/stage_profiler.hpp"
+
+namespace {
+
+constexpr std::size_t PLOT_SAMPLE_COUNT = 300;
+
+}
+
+void MainGUI::ui_performance()
+{
+    const auto& monitor = app_.performance_monitor_;
+    if (!monitor)
+        return;
+
+    if (!ImGui::CollapsingHeader("Performance"))
+        return;
+
+    // frame
+    monitor->get_frame_samples().copy_latest(frame_samples_, PLOT_SAMPLE_COUNT);
+    if (!frame_samples_.empty())
+    {
+        plot_values_.clear();
+        for (const auto& sample: frame_samples_)
+            plot_values_.push_back(sample.frame_ms);
+
+        const auto& last = frame_samples_.back();
+        const std::string overlay = fmt::format("{:.2f} ms", last.frame_ms);
+        ImGui::PlotLines("Frame (ms)", plot_values_.data(), static_cast<int>(plot_values_.size()), 0, overlay.c_str(), 0.0f, FLT_MAX, ImVec2(0, 60));
+
+        if (AllocationCountScope::is_available())
+            ImGui::Text("Allocations per frame: %u", last.allocation_count);
+    }
+
+    // physics
+    monitor->get_physics_samples().copy_latest(physics_samples_, PLOT_SAMPLE_COUNT);
+    if (!physics_samples_.empty())
+    {
+        plot_values_.clear();
+        for (const auto& sample: physics_samples_)
+            plot_values_.push_back(sample.step_ms);
+
+        const auto& last = physics_samples_.back();
+        const std::string overlay = fmt::format("{:.2f} ms", last.step_ms);
+        ImGui::PlotLines("Physics Step (ms)", plot_values_.data(), static_cast<int>(plot_values_.size()), 0, overlay.c_str(), 0.0f, FLT_MAX, ImVec2(0, 60));
+
+        ImGui::Text("Touched bodies: %u, Contacts: %u", last.touched_body_count, last.contact_count);
+    }
+
+    // joint writes skipped by change detection
+    if (app_.user_ && app_.user_->get_hand())
+    {
+        auto& joint_write_cache = app_.user_->get_hand()->get_joint_write_cache();
+        const uint64_t written = joint_write_cache.get_written_count();
+        const uint64_t skipped = joint_write_cache.get_skipped_count();
+        const uint64_t total = written + skipped;
+
+        ImGui::Text("Joint writes: %llu written, %llu skipped (%.1f %%)",
+            static_cast<unsigned long long>(written), static_cast<unsigned long long>(skipped),
+            total == 0 ? 0.0 : 100.0 * skipped / total);
+
+        ImGui::SameLine();
+        if (ImGui::Button("Reset Joint Writes"))
+            joint_write_cache.reset_counters();
+
+        // sensor samples resampled at display time
+        auto hand = app_.user_->get_hand();
+        auto& pose_resampler = hand->get_pose_resampler();
+        if (pose_resampler.get_sample_count() > 0)
+        {
+            const double sample_interval = pose_resampler.get_sample_interval();
+            ImGui::Text("Hand samples: %llu (%.1f Hz), interpolation %s",
+                static_cast<unsigned long long>(pose_resampler.get_sample_count()),
+                sample_interval > 0.0 ? 1.0 / sample_interval : 0.0,
+                pose_resampler.is_enabled() ? "on" : "off");
+
+            ImGui::Text("Wrist RMS jerk: %.1f raw, %.1f rendered",
+                hand->get_jerk_meter(false).get_rms_jerk(), hand->get_jerk_meter(true).get_rms_jerk());
+
+            ImGui::SameLine();
+            if (ImGui::Button("Reset Jerk"))
+            {
+                hand->get_jerk_meter(false).reset();
+                hand->get_jerk_meter(true).reset();
+            }
+        }
+    }
+
+    // haptic rendering loop
+    if (auto haptic_renderer = app_.hand_manager_->get_haptic_renderer())
+    {
+        const auto lateness = haptic_renderer->get_lateness_histogram().get_snapshot();
+
+        ImGui::Text("Haptic loop: %llu ticks, %llu commands, %llu deadline misses",
+            static_cast<unsigned long long>(haptic_renderer->get_tick_count()),
+            static_cast<unsigned long long>(haptic_renderer->get_command_count()),
+            static_cast<unsigned long long>(haptic_renderer->get_deadline_miss_count()));
+        ImGui::Text("Haptic lateness: p50 %.1f us, p99 %.1f us, max %.1f us",
+            lateness.get_percentile_ns(0.50) / 1000.0, lateness.get_percentile_ns(0.99) / 1000.0, lateness.max_ns / 1000.0);
+    }
+
+    // kinesthetic force-feedback loop
+    if (auto force_feedback_controller = app_.hand_manager_->get_force_feedback_controller())
+    {
+        force_feedback_controller->read_command(force_feedback_command_);
+
+        const auto jitter = force_feedback_controller->get_jitter_histogram().get_snapshot();
+
+        ImGui::Text("Force feedback loop: %llu ticks, %llu deadline misses",
+            static_cast<unsigned long long>(force_feedback_controller->get_tick_count()),
+            static_cast<unsigned long long>(force_feedback_controller->get_deadline_miss_count()));
+        ImGui::Text("Force feedback jitter: p50 %.1f us, p99 %.1f us, max %.1f us",
+            jitter.get_percentile_ns(0.50) / 1000.0, jitter.get_percentile_ns(0.99) / 1000.0, jitter.max_ns / 1000.0);
+        for (int hand = 0; hand < ForceFeedbackController::HAND_COUNT; ++hand)
+        {
+            const auto& resistances = force_feedback_command_.resistances[hand];
+            ImGui::Text("%s resistance: %.2f %.2f %.2f %.2f %.2f", hand == 0 ? "Left" : "Right",
+                resistances[0], resistances[1], resistances[2], resistances[3], resistances[4]);
+        }
+    }
+
+    // scratch memory of listeners
+    {
+        const auto& step_arena = app_.hand_manager_->get_step_arena();
+        ImGui::Text("Step arena: peak %.1f / %.1f KiB, %llu overflows",
+            step_arena.get_peak_size() / 1024.0, step_arena.get_capacity() / 1024.0,
+            static_cast<unsigned long long>(step_arena.get_overflow_count()));
+    }
+
+    // hand pipeline stages
+    ImGui::Columns(4, "performance_stage_columns");
+    ImGui::TextUnformatted("Stage");        ImGui::NextColumn();
+    ImGui::TextUnformatted("p50 (us)");     ImGui::NextColumn();
+    ImGui::TextUnformatted("p95 (us)");     ImGui::NextColumn();
+    ImGui::TextUnformatted("p99 (us)");     ImGui::NextColumn();
+    ImGui::Separator();
+    for (int k = 0; k < PROFILE_STAGE_COUNT; ++k)
+    {
+        const auto stage = static_cast<ProfileStage>(k);
+        const auto snapshot = get_stage_histogram(stage).get_snapshot();
+
+        ImGui::TextUnformatted(get_profile_stage_name(stage));                      ImGui::NextColumn();
+        ImGui::Text("%.1f", snapshot.get_percentile_ns(0.50) / 1000.0);             ImGui::NextColumn();
+        ImGui::Text("%.1f", snapshot.get_percentile_ns(0.95) / 1000.0);             ImGui::NextColumn();
+        ImGui::Text("%.1f", snapshot.get_percentile_ns(0.99) / 1000.0);             ImGui::NextColumn();
+    }
+    ImGui::Columns(1);
+
+    if (ImGui::Button("Reset Stages"))
+    {
+        for (int k = 0; k < PROFILE_STAGE_COUNT; ++k)
+            get_stage_histogram(static_cast<ProfileStage>(k)).reset();
+    }
+
+    // dump
+    ImGui::InputInt("Seconds", &performance_dump_seconds_);
+    performance_dump_seconds_ = (std::max)(performance_dump_seconds_, 1);
+
+    if (ImGui::Button("Dump CSV"))
+        monitor->dump_csv_async(fmt::format("crhands_performance_{:.0f}.csv", monitor->get_time()), performance_dump_seconds_);
+
+    // benchmark of recorded sessions
+    if (const auto& suite = app_.performance_suite_)
+    {
+        if (suite->is_running())
+        {
+            ImGui::Text("Benchmark: scenario %s (%d / %d)", suite->get_scenarios()[suite->get_scenario_index()].name.c_str(),
+                static_cast<int>(suite->get_scenario_index() + 1), static_cast<int>(suite->get_scenarios().size()));
+        }
+        else if (!suite->get_scenarios().empty())
+        {
+            if (ImGui::Button("Run Benchmark"))
+                suite->start();
+
+            if (suite->is_finished())
+            {
+                ImGui::SameLine();
+                ImGui::Text("Last result: %s", suite->is_passed() ? "passed" : "failed");
+            }
+        }
+    }
+
+    // end-to-end latency of synthetic input pulses
+    if (const auto& pulse_source = app_.latency_pulse_source_)
+    {
+        auto& probe = get_latency_probe();
+
+        if (pulse_source->is_running())
+        {
+            if (ImGui::Button("Stop Latency Probe"))
+                pulse_source->stop();
+        }
+        else
+        {
+            if (ImGui::Button("Run Latency Probe"))
+                pulse_source->start();
+        }
+
+        ImGui::SameLine();
+        ImGui::Text("%llu pulses", static_cast<unsigned long long>(probe.get_pulse_count()));
+
+        if (probe.get_pulse_count() > 0)
+        {
+            ImGui::SameLine();
+            if (ImGui::Button("Write Latency Report"))
+                pulse_source->write_report();
+
+            ImGui::Columns(5, "performance_latency_columns");
+            ImGui::TextUnformatted("Latency");      ImGui::NextColumn();
+            ImGui::TextUnformatted("p50 (us)");     ImGui::NextColumn();
+            ImGui::TextUnformatted("p99 (us)");     ImGui::NextColumn();
+            ImGui::TextUnformatted("max (us)");     ImGui::NextColumn();
+            ImGui::TextUnformatted("missed");       ImGui::NextColumn();
+            ImGui::Separator();
+            for (int k = 0; k <= LATENCY_STAGE_COUNT; ++k)
+            {
+                const auto stage = static_cast<LatencyStage>(k);
+                const bool is_end_to_end = k == LATENCY_STAGE_COUNT;
+                const auto snapshot = (is_end_to_end ? probe.get_end_to_end_histogram() : probe.get_stage_histogram(stage)).get_snapshot();
+
+                ImGui::TextUnformatted(is_end_to_end ? "End to End" : get_latency_stage_name(stage));   ImGui::NextColumn();
+                ImGui::Text("%.1f", snapshot.get_percentile_ns(0.50) / 1000.0);                         ImGui::NextColumn();
+                ImGui::Text("%.1f", snapshot.get_percentile_ns(0.99) / 1000.0);                         ImGui::NextColumn();
+                ImGui::Text("%.1f", snapshot.max_ns / 1000.0);                                          ImGui::NextColumn();
+                ImGui::Text("%llu", is_end_to_end ? 0ull : static_cast<unsigned long long>(probe.get_missed_count(stage)));   ImGui::NextColumn();
+            }
+            ImGui::Columns(1);
+        }
+    }
+}
@@ -0,0 +1,67 @@
+#include "main_gui.hpp"
+
+#include <imgui.h>
+
+#include "main.hpp"
+#include "session_capture.hpp"
+
+void MainGUI::ui_session()
+{
+    const auto& session_capture = app_.session_capture_;
+    if (!session_capture)
+        return;
+
+    if (!ImGui::CollapsingHeader("Session Capture"))
+        return;
+
+    ImGui::InputText("Path", session_path_, sizeof(session_path_));
+
+    switch (session_capture->get_mode())
+    {
+    case SessionCapture::MODE_RECORDING:
+    {
+        const auto writer = session_capture->get_writer();
+        ImGui::Text("Recording: %llu steps, %.1f KiB",
+            static_cast<unsigned long long>(writer->get_step_count()), writer->get_file_size() / 1024.0);
+        if (ImGui::Button("Stop"))
+            session_capture->stop();
+        break;
+    }
+
+    case SessionCapture::MODE_VERIFYING:
+        ImGui::Text("Verifying: step %llu from keyframe %llu",
+            static_cast<unsigned long long>(session_capture->get_step_index()),
+            static_cast<unsigned long long>(session_capture->get_keyframe_step()));
+        if (ImGui::Button("Stop"))
+            session_capture->stop();
+        break;
+
+    default:
+        if (ImGui::Button("Record"))
+            session_capture->start_recording(session_path_);
+
+        ImGui::InputInt("Step", &session_verify_step_);
+        if (session_verify_step_ < 0)
+            session_verify_step_ = 0;
+
+        ImGui::SameLine();
+        if (ImGui::Button("Verify"))
+            session_capture->start_verification(session_path_, static_cast<uint64_t>(session_verify_step_));
+        break;
+    }
+
+    // result of last verification
+    const auto& verifier = session_capture->get_verifier();
+    if (verifier.has_divergence())
+    {
+        const auto& divergence = verifier.get_divergence();
+        ImGui::Text("Diverged at step %llu: body %u, position %.4f m, angle %.2f deg%s",
+            static_cast<unsigned long long>(divergence.step), divergence.body_id,
+            divergence.position_error, divergence.angle_error, divergence.is_grasp_mismatch ? ", grasp" : "");
+    }
+    else if (verifier.get_checked_step_count() > 0)
+    {
+        ImGui::Text("No divergence in %llu steps (max position error %.5f m)",
+            static_cast<unsigned long long>(verifier.get_checked_step_count()), verifier.get_max_position_error());
+    }
+}
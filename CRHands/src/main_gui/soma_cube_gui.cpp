@@ -0,0 +1,52 @@
+#include "main_gui.hpp"
+
+#include <imgui.h>
+
+#include "main.hpp"
+#include "object/soma_cube.hpp"
+
+void MainGUI::ui_soma_cube()
+{
+    const auto& soma_cube = app_.soma_cube_;
+    if (!soma_cube)
+        return;
+
+    if (!ImGui::CollapsingHeader("Soma Cube"))
+        return;
+
+    ImGui::Text("Snapped pieces: %d / %d", soma_cube->get_snapped_count(), SomaSolver::PIECE_COUNT);
+    ImGui::Text("Assembled: %s", soma_cube->is_assembled() ? "yes" : "no");
+
+    const auto hint = soma_cube->get_hint();
+    if (hint.piece >= 0)
+    {
+        ImGui::Text("Hint: piece %s ->", SomaSolver::get_piece_name(hint.piece));
+        ImGui::SameLine();
+
+        // cells of hint as layers from bottom (z = 0)
+        for (int z = 0; z < 3; ++z)
+        {
+            char layer[12];
+            int index = 0;
+            for (int y = 2; y >= 0; --y)
+            {
+                for (int x = 0; x < 3; ++x)
+                    layer[index++] = (hint.cells >> SomaSolver::to_cell(x, y, z)) & 1 ? '#' : '.';
+                layer[index++] = y > 0 ? '/' : '\0';
+            }
+            ImGui::Text("%s", layer);
+            if (z < 2)
+                ImGui::SameLine();
+        }
+    }
+    else if (!soma_cube->is_assembled())
+    {
+        ImGui::Text("Hint: none");
+    }
+
+    ImGui::Text("Last search nodes: %d%s", soma_cube->get_solver().get_last_node_count(),
+        soma_cube->get_solver().is_last_search_stopped() ? " (stopped)" : "");
+
+    if (ImGui::Button("Reset Pieces"))
+        app_.reset_cubes_position();
+}
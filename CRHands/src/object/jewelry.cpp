@@ -133,10 +133,15 @@ void Jewelry::initialize_grouped_objects(double scale, const LVecBase3& pos)
 }
 
 void Jewelry::set_hinge_rotation(float angle)
+{
+	set_hinge_rotation(angle, angle >= 0 ? 0 : 1);
+}
+
+void Jewelry::set_hinge_rotation(float angle, int moving_group)
 {
 	LMatrix4f matrix;
 
-	if (angle >= 0)
+	if (moving_group == 0)
 	{
 		matrix = calculate_rotation_matrix(&grouped_object_data[0], angle);
 		sub_group[0]->SetMatrix(matrix);
@@ -4,6 +4,8 @@
 
 #include <crsf/CRModel/TGroupedObjectsBase.h>
 
+#include "util/hinge_solver.hpp"
+
 class Jewelry : public crsf::TGroupedObjectsBase
 {
 public:
@@ -12,5 +14,21 @@ public:
 
 	void initialize_grouped_objects(double scale, const LVecBase3& pos);
 
+	/** Open sub_group[0] by positive angle, or sub_group[1] by negative angle. */
 	void set_hinge_rotation(float angle);
-};
\ No newline at end of file
+
+	/** Rotate sub_group[@a moving_group] only, so closed hinge (0) keeps the moving part. */
+	void set_hinge_rotation(float angle, int moving_group);
+
+	HingeSolver& get_hinge_solver();
+
+private:
+	HingeSolver hinge_solver_;
+};
+
+// ************************************************************************************************
+
+inline HingeSolver& Jewelry::get_hinge_solver()
+{
+	return hinge_solver_;
+}
\ No newline at end of file
@@ -1,6 +1,11 @@
+#include "soma_cube.hpp"
+
 #include "main.hpp"
 
 #include "hand/hand_manager.hpp"
+#include "util/rigid_transform.hpp"
+
+#include <spdlog/logger.h>
 
 #include <render_pipeline/rpcore/util/rpmaterial.hpp>
 
@@ -13,6 +18,9 @@
 #include <crsf/CRModel/TPhysicsModel.h>
 #include <crsf/CRModel/TCRModel.h>
 #include <crsf/CRModel/TCube.h>
+#include <crsf/CRModel/TCompound.h>
+
+extern spdlog::logger* global_logger;
 
 void MainApp::setup_cubes()
 {
@@ -22,56 +30,177 @@ void MainApp::setup_cubes()
 	float init_position_y = m_property.get("object.cubes.init_position_y", 0.0f);
 	float init_position_z = m_property.get("object.cubes.init_position_z", 0.0f);
 	float halfExtent = m_property.get("object.cubes.halfExtent", 0.0f);
-	float count = m_property.get("object.cubes.count", 1);
+	LVecBase3 target_origin(
+		m_property.get("object.cubes.target_position_x", 0.0f),
+		m_property.get("object.cubes.target_position_y", 0.0f),
+		m_property.get("object.cubes.target_position_z", 0.0f));
 
-	for (int i = 0; i < count; i++)
+	const float cell_size = halfExtent * 2.0f;
+
+	soma_cube_ = std::make_unique<SomaCube>(target_origin, cell_size);
+	soma_cube_->set_tolerance(m_property.get("object.cubes.snap_tolerance", 0.2f));
+
+	for (int i = 0; i < SomaSolver::PIECE_COUNT; i++)
 	{
-		// cube instance
-		crsf::TCube::Parameters params;
-		params.m_strName = "cubes_" + std::to_string(i);
-		params.m_vec3Origin = LVecBase3(init_position_x + (i / 12) * 0.2, init_position_y, init_position_z + (i % 12) * 0.1);
-		params.m_vec3HalfExtent = LVecBase3(halfExtent);
-		auto cube = crsf::CreateObject<crsf::TCube>(params);
-		cube->SetHeight(i);
+		const std::string piece_name = "soma_piece_" + std::to_string(i);
 
-		cube->DisableTestBounding();
+		// graphic and physics models of unit cubes
+		auto compound_graphic = crsf::CreateObject<crsf::TWorldObject>(piece_name + "_graphic");
+		world->AddWorldObject(compound_graphic);
+		auto compound_physics = crsf::CreateObject<crsf::TWorldObject>(piece_name + "_physics");
+		world->AddWorldObject(compound_physics);
 
-		// graphic
-		auto graphic_model = cube->CreateGraphicModel();
-		rpcore::RPMaterial mat(graphic_model->GetMaterial());
-		mat.set_roughness(1.0f);
-		mat.set_base_color(LColorf((rand() % 100 + 1) * 0.01f, (rand() % 100 + 1) * 0.01f, (rand() % 100 + 1) * 0.01f, 1));
-		graphic_model->SetMaterial(mat.get_material());
+		const LColorf color((rand() % 100 + 1) * 0.01f, (rand() % 100 + 1) * 0.01f, (rand() % 100 + 1) * 0.01f, 1);
+		const auto& cells = SomaSolver::get_piece_cells(i);
+		for (int k = 0, k_end = static_cast<int>(cells.size()); k < k_end; k++)
+		{
+			const LVecBase3 cell_position = LVecBase3(cells[k].x, cells[k].y, cells[k].z) * cell_size;
+
+			auto graphic_cube = crsf::CreateObject<crsf::TCube>(piece_name + "_graphic_cube_" + std::to_string(k), cell_position, LVecBase3(halfExtent));
+			auto graphic_model = graphic_cube->CreateGraphicModel();
+			rpcore::RPMaterial mat(graphic_model->GetMaterial());
+			mat.set_roughness(1.0f);
+			mat.set_base_color(color);
+			graphic_model->SetMaterial(mat.get_material());
+			compound_graphic->AddWorldObject(graphic_cube);
+
+			auto physics_cube = crsf::CreateObject<crsf::TCube>(piece_name + "_physics_cube_" + std::to_string(k), cell_position, LVecBase3(halfExtent));
+			physics_cube->CreateGraphicModel();
+			compound_physics->AddWorldObject(physics_cube);
+		}
 
-		world->AddWorldObject(cube);
+		// create compound
+		auto compound = crsf::CreateObject<crsf::TCompound>(piece_name,
+			compound_graphic.get(), compound_physics.get(), crsf::ECOMPOUND_MODEL);
+		world->AddWorldObject(compound);
+		compound->SetPosition(LVecBase3(init_position_x + i * cell_size * 4, init_position_y, init_position_z));
 
 		// physics
 		crsf::TPhysicsModel::Parameters phyx_params;
 		phyx_params.m_fMass = 10.0f;
 		phyx_params.m_fFriction = 10.0f;
 		phyx_params.m_bHandInteractable = true;
-		auto physics_model = cube->CreatePhysicsModel(phyx_params);
-		physics_manager_->AddModel(cube);
+		auto physics_model = compound->CreatePhysicsModel(phyx_params);
+		physics_manager_->AddModel(compound);
 
 		// add listener
 		physics_model->AttachCollisionListener(std::bind(&HandManager::object_collision_event, hand_manager_.get(), std::placeholders::_1, std::placeholders::_2), "soma_cube_collision_" + std::to_string(i));
 		physics_model->AttachSeparationListener(std::bind(&HandManager::object_separation_event, hand_manager_.get(), std::placeholders::_1, std::placeholders::_2), "soma_cube_separation_" + std::to_string(i));
 		physics_model->AttachUpdateListener(std::bind(&HandManager::object_update_event, hand_manager_.get(), std::placeholders::_1), "soma_cube_update_" + std::to_string(i));
+		hand_manager_->register_networked_object(compound.get());
 
 		//
-		cubes_.push_back(cube);
+		soma_cube_->add_piece(compound);
 	}
+
+	physics_manager_->AddTask([this](void) {
+		const bool was_assembled = soma_cube_->is_assembled();
+		soma_cube_->update();
+		if (!was_assembled && soma_cube_->is_assembled())
+			global_logger->info("Soma cube is assembled.");
+		return false;
+	}, "MainApp::update_soma_cube");
 }
 
 void MainApp::reset_cubes_position()
 {
-	float count = m_property.get("object.cubes.count", 1);
+	if (soma_cube_)
+		soma_cube_->reset();
+}
+
+// ************************************************************************************************
+
+SomaCube::SomaCube(const LVecBase3& target_origin, float cell_size) : target_origin_(target_origin), cell_size_(cell_size)
+{
+}
+
+void SomaCube::add_piece(const std::shared_ptr<crsf::TCompound>& piece)
+{
+	auto world = crsf::TGraphicRenderEngine::GetInstance()->GetWorld();
+
+	pieces_.push_back(piece);
+	origin_matrices_.push_back(piece->GetMatrix(world));
+}
+
+void SomaCube::update()
+{
+	auto world = crsf::TGraphicRenderEngine::GetInstance()->GetWorld();
+
+	SomaSolver::Solution snapped_cells = {};
+	SomaSolver::CellMask occupied = 0;
+	int cell_count = 0;
+	int snapped_count = 0;
 
-	for (int i = 0; i < count; i++)
+	LVecBase3 positions[SomaSolver::MAX_PIECE_CELL_COUNT];
+	for (int piece = 0, piece_end = static_cast<int>(pieces_.size()); piece < piece_end; ++piece)
 	{
-		if (!cubes_.empty())
+		// unit cube centers in cell unit of target
+		const RigidTransform piece_to_world = RigidTransform::from_object(pieces_[piece].get(), world);
+		const auto& cells = SomaSolver::get_piece_cells(piece);
+		const int count = static_cast<int>(cells.size());
+		for (int k = 0; k < count; ++k)
 		{
-			cubes_[i]->Reset_to_Origin();
+			const LVecBase3 local(cells[k].x * cell_size_, cells[k].y * cell_size_, cells[k].z * cell_size_);
+			positions[k] = (piece_to_world.xform_point(local) - target_origin_) / cell_size_;
 		}
+
+		snapped_cells[piece] = SomaSolver::snap_to_cells(positions, count, tolerance_);
+		if (snapped_cells[piece] == 0)
+			continue;
+
+		occupied |= snapped_cells[piece];
+		cell_count += count;
+		++snapped_count;
 	}
-}
\ No newline at end of file
+
+	snapped_count_ = snapped_count;
+	is_assembled_ = occupied == SomaSolver::FULL_MASK && cell_count == SomaSolver::CELL_COUNT;
+
+	if (snapped_cells != snapped_cells_)
+	{
+		snapped_cells_ = snapped_cells;
+		update_hint();
+	}
+}
+
+void SomaCube::reset()
+{
+	auto world = crsf::TGraphicRenderEngine::GetInstance()->GetWorld();
+
+	auto physics_manager = crsf::TPhysicsManager::GetInstance();
+
+	for (size_t k = 0, k_end = pieces_.size(); k < k_end; ++k)
+	{
+		pieces_[k]->SetMatrix(origin_matrices_[k], world);
+		physics_manager->SetLinearVelocity(pieces_[k].get(), LVecBase3(0));
+		physics_manager->SetAngularVelocity(pieces_[k].get(), LVecBase3(0));
+	}
+}
+
+void SomaCube::update_hint()
+{
+	hint_ = SomaSolver::Placement{ -1, 0 };
+
+	if (is_assembled_)
+		return;
+
+	// keep last hint if snapped pieces are still on the hinted solution
+	bool is_hint_valid = hinted_cells_[0] != 0;
+	for (int piece = 0; piece < SomaSolver::PIECE_COUNT && is_hint_valid; ++piece)
+		is_hint_valid = snapped_cells_[piece] == 0 || snapped_cells_[piece] == hinted_cells_[piece];
+
+	if (!is_hint_valid && !solver_.solve(snapped_cells_, hinted_cells_))
+	{
+		hinted_cells_ = {};
+		return;
+	}
+
+	for (int piece = 0; piece < SomaSolver::PIECE_COUNT; ++piece)
+	{
+		if (snapped_cells_[piece] == 0)
+		{
+			hint_ = SomaSolver::Placement{ piece, hinted_cells_[piece] };
+			return;
+		}
+	}
+}
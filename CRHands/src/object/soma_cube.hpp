@@ -0,0 +1,112 @@
+#pragma once
+
+#include <memory>
+#include <vector>
+
+#include <luse.h>
+
+#include "object/soma_solver.hpp"
+
+namespace crsf {
+class TCompound;
+}
+
+/**
+ * Soma pieces and 3x3x3 target.
+ *
+ * Every physics step, unit cubes of each piece are snapped to the target voxel grid.
+ * Completed assembly is a few mask operations, and hint is searched again only when
+ * snapped pieces are changed.
+ */
+class SomaCube
+{
+public:
+    /**
+     * @param target_origin     world position of center of cell (0, 0, 0).
+     * @param cell_size         edge length of unit cube.
+     */
+    SomaCube(const LVecBase3& target_origin, float cell_size);
+
+    void add_piece(const std::shared_ptr<crsf::TCompound>& piece);
+
+    /** Snap pieces to target grid. Call once per physics step. */
+    void update();
+
+    /** Move pieces to their initial poses. */
+    void reset();
+
+    const std::vector<std::shared_ptr<crsf::TCompound>>& get_pieces() const;
+
+    /** Cells of each piece in target, or 0 if the piece is not snapped. */
+    const SomaSolver::Solution& get_snapped_cells() const;
+
+    int get_snapped_count() const;
+    bool is_assembled() const;
+
+    /** Next piece and its cells, which completes target with snapped pieces. piece is -1 if none. */
+    const SomaSolver::Placement& get_hint() const;
+
+    const SomaSolver& get_solver() const;
+
+    float get_tolerance() const;
+    void set_tolerance(float tolerance);
+
+private:
+    void update_hint();
+
+    LVecBase3 target_origin_;
+    float cell_size_;
+    float tolerance_ = 0.2f;
+
+    std::vector<std::shared_ptr<crsf::TCompound>> pieces_;
+    std::vector<LMatrix4f> origin_matrices_;
+
+    SomaSolver solver_;
+    SomaSolver::Solution snapped_cells_ = {};
+    SomaSolver::Solution hinted_cells_ = {};
+    SomaSolver::Placement hint_ = { -1, 0 };
+    int snapped_count_ = 0;
+    bool is_assembled_ = false;
+};
+
+// ************************************************************************************************
+
+inline const std::vector<std::shared_ptr<crsf::TCompound>>& SomaCube::get_pieces() const
+{
+    return pieces_;
+}
+
+inline const SomaSolver::Solution& SomaCube::get_snapped_cells() const
+{
+    return snapped_cells_;
+}
+
+inline int SomaCube::get_snapped_count() const
+{
+    return snapped_count_;
+}
+
+inline bool SomaCube::is_assembled() const
+{
+    return is_assembled_;
+}
+
+inline const SomaSolver::Placement& SomaCube::get_hint() const
+{
+    return hint_;
+}
+
+inline const SomaSolver& SomaCube::get_solver() const
+{
+    return solver_;
+}
+
+inline float SomaCube::get_tolerance() const
+{
+    return tolerance_;
+}
+
+inline void SomaCube::set_tolerance(float tolerance)
+{
+    tolerance_ = tolerance;
+}
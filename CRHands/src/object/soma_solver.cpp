@@ -0,0 +1,210 @@
+#include "soma_solver.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+namespace {
+
+using Cell = SomaSolver::Cell;
+using CellMask = SomaSolver::CellMask;
+
+const std::vector<Cell> piece_cells[SomaSolver::PIECE_COUNT] = {
+    { { 0, 0, 0 }, { 1, 0, 0 }, { 0, 1, 0 } },                  // V
+    { { 0, 0, 0 }, { 1, 0, 0 }, { 2, 0, 0 }, { 0, 1, 0 } },     // L
+    { { 0, 0, 0 }, { 1, 0, 0 }, { 2, 0, 0 }, { 1, 1, 0 } },     // T
+    { { 0, 0, 0 }, { 1, 0, 0 }, { 1, 1, 0 }, { 2, 1, 0 } },     // Z
+    { { 0, 0, 0 }, { 1, 0, 0 }, { 0, 1, 0 }, { 0, 1, 1 } },     // A (right screw)
+    { { 0, 0, 0 }, { 1, 0, 0 }, { 0, 1, 0 }, { 1, 0, 1 } },     // B (left screw)
+    { { 0, 0, 0 }, { 1, 0, 0 }, { 0, 1, 0 }, { 0, 0, 1 } },     // P (branch)
+};
+
+const char* const piece_names[SomaSolver::PIECE_COUNT] = { "V", "L", "T", "Z", "A", "B", "P" };
+
+int find_lowest_cell(CellMask cells)
+{
+    int index = 0;
+    while (((cells >> index) & 1) == 0)
+        ++index;
+    return index;
+}
+
+// 24 proper rotations as signed axis permutations
+std::vector<std::array<int, 6>> make_rotations()
+{
+    const int permutations[6][3] = { { 0, 1, 2 }, { 1, 2, 0 }, { 2, 0, 1 }, { 0, 2, 1 }, { 2, 1, 0 }, { 1, 0, 2 } };
+
+    std::vector<std::array<int, 6>> rotations;
+    for (int p = 0; p < 6; ++p)
+    {
+        // odd permutations need odd number of flips to keep determinant +1
+        const int parity = p < 3 ? 0 : 1;
+        for (int flips = 0; flips < 8; ++flips)
+        {
+            const int flip_count = (flips & 1) + ((flips >> 1) & 1) + ((flips >> 2) & 1);
+            if (flip_count % 2 != parity)
+                continue;
+
+            rotations.push_back({
+                permutations[p][0], permutations[p][1], permutations[p][2],
+                (flips & 1) ? -1 : 1, (flips & 2) ? -1 : 1, (flips & 4) ? -1 : 1 });
+        }
+    }
+    return rotations;
+}
+
+}
+
+SomaSolver::SomaSolver()
+{
+    const auto rotations = make_rotations();
+
+    for (int piece = 0; piece < PIECE_COUNT; ++piece)
+    {
+        std::vector<CellMask> piece_placements;
+        for (const auto& rotation: rotations)
+        {
+            std::vector<Cell> cells;
+            int min[3] = { 3, 3, 3 };
+            for (const auto& cell: piece_cells[piece])
+            {
+                const int source[3] = { cell.x, cell.y, cell.z };
+                Cell rotated;
+                int* rotated_axis[3] = { &rotated.x, &rotated.y, &rotated.z };
+                for (int axis = 0; axis < 3; ++axis)
+                {
+                    *rotated_axis[axis] = source[rotation[axis]] * rotation[3 + axis];
+                    min[axis] = (std::min)(min[axis], *rotated_axis[axis]);
+                }
+                cells.push_back(rotated);
+            }
+
+            for (int tz = -min[2]; tz < 3 - min[2]; ++tz)
+            {
+                for (int ty = -min[1]; ty < 3 - min[1]; ++ty)
+                {
+                    for (int tx = -min[0]; tx < 3 - min[0]; ++tx)
+                    {
+                        CellMask mask = 0;
+                        bool is_inside = true;
+                        for (const auto& cell: cells)
+                        {
+                            const int x = cell.x + tx;
+                            const int y = cell.y + ty;
+                            const int z = cell.z + tz;
+                            if (x > 2 || y > 2 || z > 2)
+                            {
+                                is_inside = false;
+                                break;
+                            }
+                            mask |= CellMask(1) << to_cell(x, y, z);
+                        }
+
+                        if (is_inside && std::find(piece_placements.begin(), piece_placements.end(), mask) == piece_placements.end())
+                            piece_placements.push_back(mask);
+                    }
+                }
+            }
+        }
+
+        for (auto mask: piece_placements)
+            placements_[find_lowest_cell(mask)].push_back(Placement{ piece, mask });
+    }
+}
+
+const std::vector<SomaSolver::Cell>& SomaSolver::get_piece_cells(int piece)
+{
+    return piece_cells[piece];
+}
+
+const char* SomaSolver::get_piece_name(int piece)
+{
+    return piece_names[piece];
+}
+
+bool SomaSolver::solve(const Solution& placed, Solution& solution, int max_node_count)
+{
+    node_count_ = 0;
+    max_node_count_ = max_node_count;
+    is_stopped_ = false;
+    solution_ = placed;
+
+    CellMask occupied = 0;
+    unsigned int used_pieces = 0;
+    for (int piece = 0; piece < PIECE_COUNT; ++piece)
+    {
+        if (placed[piece] == 0)
+            continue;
+
+        // overlapped pieces cannot be completed
+        if (occupied & placed[piece])
+            return false;
+
+        occupied |= placed[piece];
+        used_pieces |= 1u << piece;
+    }
+
+    if (!search(occupied, used_pieces))
+        return false;
+
+    solution = solution_;
+    return true;
+}
+
+bool SomaSolver::search(CellMask occupied, unsigned int used_pieces)
+{
+    if (occupied == FULL_MASK)
+        return true;
+
+    if (++node_count_ > max_node_count_)
+    {
+        is_stopped_ = true;
+        return false;
+    }
+
+    const int cell = find_lowest_cell(~occupied & FULL_MASK);
+    for (const auto& placement: placements_[cell])
+    {
+        if ((used_pieces >> placement.piece) & 1)
+            continue;
+
+        if (placement.cells & occupied)
+            continue;
+
+        solution_[placement.piece] = placement.cells;
+        if (search(occupied | placement.cells, used_pieces | (1u << placement.piece)))
+            return true;
+
+        if (is_stopped_)
+            break;
+    }
+
+    return false;
+}
+
+SomaSolver::CellMask SomaSolver::snap_to_cells(const LVecBase3* positions, int count, float tolerance)
+{
+    CellMask mask = 0;
+    for (int k = 0; k < count; ++k)
+    {
+        int index[3];
+        for (int axis = 0; axis < 3; ++axis)
+        {
+            const float rounded = std::round(positions[k][axis]);
+            if (std::abs(positions[k][axis] - rounded) > tolerance || rounded < 0 || rounded > 2)
+                return 0;
+            index[axis] = static_cast<int>(rounded);
+        }
+        mask |= CellMask(1) << to_cell(index[0], index[1], index[2]);
+    }
+
+    // two cubes in same cell means the piece is not aligned to grid
+    return count_cells(mask) == count ? mask : 0;
+}
+
+int SomaSolver::count_cells(CellMask cells)
+{
+    int count = 0;
+    for (; cells; cells &= cells - 1)
+        ++count;
+    return count;
+}
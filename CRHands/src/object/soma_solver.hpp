@@ -0,0 +1,104 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <vector>
+
+#include <luse.h>
+
+/**
+ * Placements and exact cover search of soma cube.
+ *
+ * Cell index = x + 3 * y + 9 * z (x, y, z in [0, 2]), so a placement of a piece
+ * in 3x3x3 target is a 27 bit mask.
+ *
+ * Placements are grouped by their lowest cell. Search always fills the lowest empty
+ * cell, so candidates of a node are one list and overlap test is one AND.
+ */
+class SomaSolver
+{
+public:
+    static constexpr int PIECE_COUNT = 7;
+    static constexpr int CELL_COUNT = 27;
+    static constexpr int MAX_PIECE_CELL_COUNT = 4;
+
+    using CellMask = uint32_t;
+    static constexpr CellMask FULL_MASK = (CellMask(1) << CELL_COUNT) - 1;
+
+    struct Cell
+    {
+        int x;
+        int y;
+        int z;
+    };
+
+    struct Placement
+    {
+        int piece;
+        CellMask cells;
+    };
+
+    using Solution = std::array<CellMask, PIECE_COUNT>;
+
+public:
+    SomaSolver();
+
+    /** Unit cubes of @a piece in piece space. */
+    static const std::vector<Cell>& get_piece_cells(int piece);
+
+    static const char* get_piece_name(int piece);
+
+    /**
+     * Fill empty cells with pieces which are not placed.
+     *
+     * @param placed        cells of each piece, or 0 if the piece is not placed yet.
+     * @param solution      cells of all pieces if found.
+     * @param max_node_count    search stops when this many nodes are visited.
+     * @return  false if there is no solution or search is stopped.
+     */
+    bool solve(const Solution& placed, Solution& solution, int max_node_count = 50000);
+
+    /** Visited nodes of last solve(). */
+    int get_last_node_count() const;
+
+    /** True if last solve() is stopped by max_node_count. */
+    bool is_last_search_stopped() const;
+
+    /**
+     * Snap positions (in cell unit, cell center at integer) to cells.
+     *
+     * @return  mask of cells, or 0 if a position is off grid by more than @a tolerance or outside of target.
+     */
+    static CellMask snap_to_cells(const LVecBase3* positions, int count, float tolerance);
+
+    static int to_cell(int x, int y, int z);
+    static int count_cells(CellMask cells);
+
+private:
+    bool search(CellMask occupied, unsigned int used_pieces);
+
+    // placements grouped by lowest cell
+    std::array<std::vector<Placement>, CELL_COUNT> placements_;
+
+    Solution solution_;
+    int node_count_ = 0;
+    int max_node_count_ = 0;
+    bool is_stopped_ = false;
+};
+
+// ************************************************************************************************
+
+inline int SomaSolver::get_last_node_count() const
+{
+    return node_count_;
+}
+
+inline bool SomaSolver::is_last_search_stopped() const
+{
+    return is_stopped_;
+}
+
+inline int SomaSolver::to_cell(int x, int y, int z)
+{
+    return x + 3 * y + 9 * z;
+}
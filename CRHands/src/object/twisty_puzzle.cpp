@@ -1,3 +1,9 @@
+#include "twisty_puzzle.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+
 #include "main.hpp"
 
 #include "hand/hand_manager.hpp"
@@ -13,10 +19,224 @@
 #include <crsf/CRModel/TPhysicsModel.h>
 #include <crsf/CRModel/TCRModel.h>
 #include <crsf/CRModel/TCube.h>
+#include <crsf/CRModel/TGroupedObjects.h>
+
+#include <crsf/Utility/TOpenFrameworksMath.h>
 
 void MainApp::setup_twisty_puzzle()
 {
 	auto world = rendering_engine_->GetWorld();
 
-	
-}
\ No newline at end of file
+	twisty_puzzle_ = std::make_shared<TwistyPuzzle>("twisty_puzzle_");
+	world->AddWorldObject(twisty_puzzle_);
+
+	LVecBase3 init_position(
+		m_property.get("object.twisty_puzzle.init_position_x", 0.0f),
+		m_property.get("object.twisty_puzzle.init_position_y", 0.0f),
+		m_property.get("object.twisty_puzzle.init_position_z", 1.0f));
+	float cubie_half_extent = m_property.get("object.twisty_puzzle.cubie_half_extent", 0.02f);
+
+	twisty_puzzle_->initialize_grouped_objects(1.0, init_position, cubie_half_extent);
+
+	twisty_puzzle_->attach_collision_listener_each(std::bind(&HandManager::object_collision_event, hand_manager_.get(), std::placeholders::_1, std::placeholders::_2));
+	twisty_puzzle_->attach_inside_listener_each(std::bind(&HandManager::object_collision_event, hand_manager_.get(), std::placeholders::_1, std::placeholders::_2));
+	twisty_puzzle_->attach_update_listener_each(std::bind(&HandManager::grouped_object_update_event_each, hand_manager_.get(), std::placeholders::_1));
+	twisty_puzzle_->attach_update_listener(std::bind(&HandManager::grouped_object_update_event, hand_manager_.get(), std::placeholders::_1));
+}
+
+TwistyPuzzle::TwistyPuzzle(const std::string& name) : TGroupedObjectsBase(name)
+{
+	is_group_changeable = true;
+	is_multi_mesh_group = false;
+}
+
+TwistyPuzzle::~TwistyPuzzle()
+{
+
+}
+
+void TwistyPuzzle::initialize_grouped_objects(double scale, const LVecBase3& pos, float cubie_half_extent)
+{
+	TGroupedObjectsBase::initialize_grouped_objects(scale, pos);
+
+	cubie_half_extent_ = cubie_half_extent;
+
+	for (int cubie = 0; cubie < TwistyPuzzleState::CUBIE_COUNT; ++cubie)
+	{
+		int x, y, z;
+		TwistyPuzzleState::to_coordinates(cubie, x, y, z);
+
+		// cubie instance
+		crsf::TCube::Parameters params;
+		params.m_strName = "twisty_puzzle_cubie_" + std::to_string(cubie);
+		params.m_vec3Origin = LVecBase3(0);
+		params.m_vec3HalfExtent = LVecBase3(cubie_half_extent * 0.98f);
+		auto cube = crsf::CreateObject<crsf::TCube>(params);
+
+		cube->DisableTestBounding();
+
+		// graphic
+		auto graphic_model = cube->CreateGraphicModel();
+		rpcore::RPMaterial mat(graphic_model->GetMaterial());
+		mat.set_roughness(1.0f);
+		mat.set_base_color(LColorf(0.3f + 0.3f * x, 0.3f + 0.3f * y, 0.3f + 0.3f * z, 1));
+		graphic_model->SetMaterial(mat.get_material());
+
+		sub_group[REST_GROUP]->AddWorldObject(cube);
+		cube->SetPosition(LVecBase3(x - 1, y - 1, z - 1) * (2.0f * cubie_half_extent));
+
+		// physics
+		crsf::TPhysicsModel::Parameters phyx_params;
+		phyx_params.m_fMass = sub_group[REST_GROUP]->mass;
+		phyx_params.m_fFriction = sub_group[REST_GROUP]->friction;
+		phyx_params.m_bHandInteractable = sub_group[REST_GROUP]->hand_interactive;
+		cube->CreatePhysicsModel(phyx_params);
+		crsf::TPhysicsManager::GetInstance()->AddModel(cube);
+
+		cubie_ids_[cube.get()] = cubie;
+		cubies_.push_back(cube);
+	}
+}
+
+bool TwistyPuzzle::regroup(crsf::TCRModel* const* contacted_children, std::size_t count)
+{
+	// layer is rotating
+	if (active_layer_ != TwistyPuzzleState::INVALID_LAYER)
+		return false;
+
+	TwistyPuzzleState::Bitboard contacted_cubies = 0;
+	for (std::size_t k = 0; k < count; ++k)
+	{
+		const int cubie = find_cubie(contacted_children[k]);
+		if (cubie != -1)
+			contacted_cubies |= TwistyPuzzleState::Bitboard(1) << cubie;
+	}
+
+	const int layer = state_.find_layer(contacted_cubies);
+	if (layer == TwistyPuzzleState::INVALID_LAYER)
+		return false;
+
+	// move only cubies whose group is changed
+	const TwistyPuzzleState::Bitboard layer_cubies = state_.get_layer_cubies(layer);
+	for (auto cubies = layer_cubies & ~layer_group_cubies_; cubies;)
+		move_cubie(TwistyPuzzleState::pop_bit(cubies), LAYER_GROUP);
+	for (auto cubies = layer_group_cubies_ & ~layer_cubies; cubies;)
+		move_cubie(TwistyPuzzleState::pop_bit(cubies), REST_GROUP);
+	layer_group_cubies_ = layer_cubies;
+
+	// only rotating layer is simulated
+	for (int cubie = 0; cubie < TwistyPuzzleState::CUBIE_COUNT; ++cubie)
+	{
+		const bool is_layer = ((layer_cubies >> cubie) & 1) != 0;
+		cubies_[cubie]->GetPhysicsModel()->SetPhysicsType(is_layer ? crsf::EPHYX_TYPE_RIGIDBODY_ACTIVE : crsf::EPHYX_TYPE_RIGIDBODY_PASSIVE);
+	}
+
+	// hinge about layer axis through puzzle center (in REST_GROUP space)
+	LVecBase3 axis(0);
+	axis[TwistyPuzzleState::get_layer_axis(layer)] = 1;
+	for (int i = 0; i < 2; i++)
+	{
+		grouped_object_data[i].object = sub_group[i];
+		grouped_object_data[i].axis_on_object = axis;
+		grouped_object_data[i].pivot_on_object = LVecBase3(0);
+		grouped_object_data[i].pivot_on_object_in_group = LVecBase3(0);
+		grouped_object_data[i].has_limit_angle = false;
+	}
+
+	active_layer_ = layer;
+	object_angle = 0;
+	manipulated_object = sub_group[LAYER_GROUP];
+
+	return true;
+}
+
+void TwistyPuzzle::finish_twist()
+{
+	if (active_layer_ == TwistyPuzzleState::INVALID_LAYER)
+		return;
+
+	// snap to quarter turn
+	const int quarter_turns = static_cast<int>(std::round(object_angle / 90.0f));
+	set_layer_rotation(quarter_turns * 90.0f);
+
+	// put cubies back and read their cells from geometry
+	auto rest_group = sub_group[REST_GROUP].get();
+	std::array<int, TwistyPuzzleState::CUBIE_COUNT> measured_positions;
+	for (auto cubies = layer_group_cubies_; cubies;)
+	{
+		const int cubie = TwistyPuzzleState::pop_bit(cubies);
+		move_cubie(cubie, REST_GROUP);
+
+		const LVecBase3 pos = cubies_[cubie]->GetPosition(rest_group) / (2.0f * cubie_half_extent_);
+		int coords[3];
+		for (int k = 0; k < 3; ++k)
+			coords[k] = (std::min)((std::max)(static_cast<int>(std::round(pos[k])) + 1, 0), 2);
+		measured_positions[cubie] = TwistyPuzzleState::to_position(coords[0], coords[1], coords[2]);
+	}
+	sub_group[LAYER_GROUP]->SetMatrix(sub_group[REST_GROUP]->GetMatrix());
+
+	// twist whose result matches geometry, so the state follows the rendered puzzle
+	// regardless of hinge direction
+	TwistyPuzzleState twisted = state_;
+	bool is_matched = false;
+	for (int turn = 0; turn < 4 && !is_matched; ++turn)
+	{
+		if (turn > 0)
+			twisted.twist(active_layer_, 1);
+
+		is_matched = true;
+		for (auto cubies = layer_group_cubies_; cubies && is_matched;)
+		{
+			const int cubie = TwistyPuzzleState::pop_bit(cubies);
+			is_matched = twisted.get_cubie_position(cubie) == measured_positions[cubie];
+		}
+	}
+
+	if (is_matched)
+	{
+		state_ = twisted;
+	}
+	else
+	{
+		// counterclockwise about +axis
+		state_.twist(active_layer_, quarter_turns);
+	}
+
+	for (auto&& cubie: cubies_)
+		cubie->GetPhysicsModel()->SetPhysicsType(crsf::EPHYX_TYPE_RIGIDBODY_ACTIVE);
+
+	layer_group_cubies_ = 0;
+	active_layer_ = TwistyPuzzleState::INVALID_LAYER;
+	object_angle = 0;
+}
+
+void TwistyPuzzle::set_layer_rotation(float angle)
+{
+	if (active_layer_ == TwistyPuzzleState::INVALID_LAYER)
+		return;
+
+	// rotate about pivot in REST_GROUP space, and then follow REST_GROUP
+	LMatrix4f matrix = calculate_rotation_matrix(&grouped_object_data[LAYER_GROUP], angle);
+	sub_group[LAYER_GROUP]->SetMatrix(matrix * sub_group[REST_GROUP]->GetMatrix());
+
+	object_angle = angle;
+}
+
+void TwistyPuzzle::move_cubie(int cubie, int group)
+{
+	auto& cube = cubies_[cubie];
+	auto target = sub_group[group];
+
+	// keep world transform while changing parent
+	const LMatrix4f matrix = cube->GetMatrix(target.get());
+	target->AddWorldObject(cube);
+	cube->SetMatrix(matrix);
+}
+
+int TwistyPuzzle::find_cubie(const crsf::TCRModel* model) const
+{
+	auto found = cubie_ids_.find(model);
+	if (found == cubie_ids_.end())
+		return -1;
+	return found->second;
+}
@@ -1,22 +1,73 @@
+#pragma once
+
 #include "main.hpp"
 
-#include "hand/hand_manager.hpp"
+#include <unordered_map>
+
+#include <crsf/CRModel/TGroupedObjectsBase.h>
+
+#include "object/twisty_puzzle_state.hpp"
+#include "util/hinge_solver.hpp"
+
+namespace crsf {
+class TCube;
+}
+
+class TwistyPuzzle : public crsf::TGroupedObjectsBase
+{
+public:
+	// sub_group[REST_GROUP] has sleeping cubies, and sub_group[LAYER_GROUP] has rotating layer
+	static constexpr int REST_GROUP = 0;
+	static constexpr int LAYER_GROUP = 1;
+
+public:
+	TwistyPuzzle(const std::string& name);
+	~TwistyPuzzle();
+
+	void initialize_grouped_objects(double scale, const LVecBase3& pos, float cubie_half_extent);
+
+	/** Move cubies of the layer touched by @a contacted_children into LAYER_GROUP. */
+	bool regroup(crsf::TCRModel* const* contacted_children, std::size_t count);
 
-#include <render_pipeline/rpcore/util/rpmaterial.hpp>
+	/** Snap rotating layer to nearest quarter turn and put its cubies back to REST_GROUP. */
+	void finish_twist();
 
-#include <crsf/RenderingEngine/TGraphicRenderEngine.h>
-#include <crsf/CRModel/TWorld.h>
+	void set_layer_rotation(float angle);
 
-#include <crsf/CREngine/TPhysicsManager.h>
+	int get_active_layer() const;
+	const TwistyPuzzleState& get_state() const;
 
-#include <crsf/CRModel/TGraphicModel.h>
-#include <crsf/CRModel/TPhysicsModel.h>
-#include <crsf/CRModel/TCRModel.h>
-#include <crsf/CRModel/TCube.h>
+	HingeSolver& get_hinge_solver();
 
-void Physics::setup_twisty_puzzle()
+private:
+	void move_cubie(int cubie, int group);
+	int find_cubie(const crsf::TCRModel* model) const;
+
+	float cubie_half_extent_ = 0.02f;
+
+	std::vector<std::shared_ptr<crsf::TCube>> cubies_;
+	std::unordered_map<const crsf::TCRModel*, int> cubie_ids_;
+
+	TwistyPuzzleState state_;
+	TwistyPuzzleState::Bitboard layer_group_cubies_ = 0;
+	int active_layer_ = TwistyPuzzleState::INVALID_LAYER;
+
+	HingeSolver hinge_solver_;
+};
+
+// ************************************************************************************************
+
+inline int TwistyPuzzle::get_active_layer() const
+{
+	return active_layer_;
+}
+
+inline const TwistyPuzzleState& TwistyPuzzle::get_state() const
 {
-	auto world = rendering_engine_->GetWorld();
+	return state_;
+}
 
-	
-}
\ No newline at end of file
+inline HingeSolver& TwistyPuzzle::get_hinge_solver()
+{
+	return hinge_solver_;
+}
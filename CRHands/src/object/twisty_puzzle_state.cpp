@@ -0,0 +1,123 @@
+#include "twisty_puzzle_state.hpp"
+
+namespace {
+
+// position index -> position index after counterclockwise quarter turn about each axis
+struct QuarterTurnTable
+{
+    QuarterTurnTable()
+    {
+        for (int position = 0; position < TwistyPuzzleState::CUBIE_COUNT; ++position)
+        {
+            int x, y, z;
+            TwistyPuzzleState::to_coordinates(position, x, y, z);
+
+            // rotate around center (1, 1, 1)
+            table[0][position] = TwistyPuzzleState::to_position(x, 2 - z, y);
+            table[1][position] = TwistyPuzzleState::to_position(z, y, 2 - x);
+            table[2][position] = TwistyPuzzleState::to_position(2 - y, x, z);
+        }
+    }
+
+    int table[3][TwistyPuzzleState::CUBIE_COUNT];
+};
+
+const QuarterTurnTable quarter_turn_table;
+
+int get_position_layer(int position, int axis)
+{
+    int coords[3];
+    TwistyPuzzleState::to_coordinates(position, coords[0], coords[1], coords[2]);
+    return axis * 3 + coords[axis];
+}
+
+}
+
+TwistyPuzzleState::TwistyPuzzleState()
+{
+    layer_cubies_.fill(0);
+    for (int cubie = 0; cubie < CUBIE_COUNT; ++cubie)
+    {
+        cubie_position_[cubie] = static_cast<uint8_t>(cubie);
+        position_cubie_[cubie] = static_cast<uint8_t>(cubie);
+        for (int axis = 0; axis < 3; ++axis)
+            layer_cubies_[get_position_layer(cubie, axis)] |= Bitboard(1) << cubie;
+    }
+}
+
+int TwistyPuzzleState::find_layer(Bitboard contacted_cubies) const
+{
+    int best_layer = INVALID_LAYER;
+    int best_count = 0;
+    for (int layer = 0; layer < LAYER_COUNT; ++layer)
+    {
+        const int count = count_bits(layer_cubies_[layer] & contacted_cubies);
+        const bool is_outer = get_layer_slice(layer) != 1;
+        if (count > best_count || (count == best_count && count > 0 && is_outer && get_layer_slice(best_layer) == 1))
+        {
+            best_layer = layer;
+            best_count = count;
+        }
+    }
+    return best_layer;
+}
+
+void TwistyPuzzleState::twist(int layer, int quarter_turns)
+{
+    const int axis = get_layer_axis(layer);
+    quarter_turns = ((quarter_turns % 4) + 4) % 4;
+
+    for (int turn = 0; turn < quarter_turns; ++turn)
+    {
+        // positions of a layer map onto the same layer, so update cubies in place
+        std::array<uint8_t, CUBIE_COUNT> new_position_cubie = position_cubie_;
+        for (Bitboard cubies = layer_cubies_[layer]; cubies;)
+        {
+            const int cubie = pop_bit(cubies);
+            const int old_position = cubie_position_[cubie];
+            const int new_position = quarter_turn_table.table[axis][old_position];
+
+            cubie_position_[cubie] = static_cast<uint8_t>(new_position);
+            new_position_cubie[new_position] = static_cast<uint8_t>(cubie);
+            update_layers(cubie, old_position, new_position);
+        }
+        position_cubie_ = new_position_cubie;
+    }
+}
+
+bool TwistyPuzzleState::is_solved() const
+{
+    for (int cubie = 0; cubie < CUBIE_COUNT; ++cubie)
+    {
+        if (cubie_position_[cubie] != cubie)
+            return false;
+    }
+    return true;
+}
+
+int TwistyPuzzleState::count_bits(Bitboard bits)
+{
+    int count = 0;
+    for (; bits; bits &= bits - 1)
+        ++count;
+    return count;
+}
+
+int TwistyPuzzleState::pop_bit(Bitboard& bits)
+{
+    int index = 0;
+    while (((bits >> index) & 1) == 0)
+        ++index;
+    bits &= bits - 1;
+    return index;
+}
+
+void TwistyPuzzleState::update_layers(int cubie, int old_position, int new_position)
+{
+    const Bitboard cubie_bit = Bitboard(1) << cubie;
+    for (int axis = 0; axis < 3; ++axis)
+    {
+        layer_cubies_[get_position_layer(old_position, axis)] &= ~cubie_bit;
+        layer_cubies_[get_position_layer(new_position, axis)] |= cubie_bit;
+    }
+}
@@ -0,0 +1,93 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+
+/**
+ * Cubie positions of 3x3x3 twisty puzzle as bitboards.
+ *
+ * Position index = x + 3 * y + 9 * z (x, y, z in [0, 2]).
+ * Layer index = axis * 3 + slice (axis: 0 = x, 1 = y, 2 = z).
+ *
+ * Each layer keeps a bitboard of cubies in it, so finding cubies of a layer
+ * and finding a layer from contacted cubies are a few bit operations.
+ */
+class TwistyPuzzleState
+{
+public:
+    static constexpr int CUBIE_COUNT = 27;
+    static constexpr int LAYER_COUNT = 9;
+    static constexpr int INVALID_LAYER = -1;
+
+    using Bitboard = uint32_t;
+
+public:
+    TwistyPuzzleState();
+
+    /** Bitboard of cubie IDs in @a layer. */
+    Bitboard get_layer_cubies(int layer) const;
+
+    int get_cubie_position(int cubie) const;
+    int get_position_cubie(int position) const;
+
+    /** Layer which has most of @a contacted_cubies. Outer layer wins on tie. */
+    int find_layer(Bitboard contacted_cubies) const;
+
+    /** Rotate @a layer by 90 degree * @a quarter_turns (counterclockwise about +axis). */
+    void twist(int layer, int quarter_turns);
+
+    bool is_solved() const;
+
+    static int get_layer_axis(int layer);
+    static int get_layer_slice(int layer);
+    static int to_position(int x, int y, int z);
+    static void to_coordinates(int position, int& x, int& y, int& z);
+    static int count_bits(Bitboard bits);
+    static int pop_bit(Bitboard& bits);
+
+private:
+    void update_layers(int cubie, int old_position, int new_position);
+
+    std::array<uint8_t, CUBIE_COUNT> cubie_position_;
+    std::array<uint8_t, CUBIE_COUNT> position_cubie_;
+    std::array<Bitboard, LAYER_COUNT> layer_cubies_;
+};
+
+// ************************************************************************************************
+
+inline TwistyPuzzleState::Bitboard TwistyPuzzleState::get_layer_cubies(int layer) const
+{
+    return layer_cubies_[layer];
+}
+
+inline int TwistyPuzzleState::get_cubie_position(int cubie) const
+{
+    return cubie_position_[cubie];
+}
+
+inline int TwistyPuzzleState::get_position_cubie(int position) const
+{
+    return position_cubie_[position];
+}
+
+inline int TwistyPuzzleState::get_layer_axis(int layer)
+{
+    return layer / 3;
+}
+
+inline int TwistyPuzzleState::get_layer_slice(int layer)
+{
+    return layer % 3;
+}
+
+inline int TwistyPuzzleState::to_position(int x, int y, int z)
+{
+    return x + 3 * y + 9 * z;
+}
+
+inline void TwistyPuzzleState::to_coordinates(int position, int& x, int& y, int& z)
+{
+    x = position % 3;
+    y = (position / 3) % 3;
+    z = position / 9;
+}
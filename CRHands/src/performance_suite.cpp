@@ -0,0 +1,239 @@
+#include "performance_suite.hpp"
+
+#include <algorithm>
+#include <fstream>
+
+#include <boost/property_tree/json_parser.hpp>
+
+#include <spdlog/logger.h>
+
+#include <crsf/CREngine/TPhysicsManager.h>
+
+#include "main.hpp"
+#include "session_capture.hpp"
+#include "util/allocation_counter.hpp"
+#include "util/performance_monitor.hpp"
+
+extern spdlog::logger* global_logger;
+
+PerformanceSuite::PerformanceSuite(MainApp& app, const boost::property_tree::ptree& props) : app_(app)
+{
+    report_path_ = props.get("benchmark.report", std::string("crhands_benchmark.json"));
+    baseline_path_ = props.get("benchmark.baseline", std::string(""));
+    thresholds_.min_relative = props.get("benchmark.min_relative", thresholds_.min_relative);
+    thresholds_.z_score = props.get("benchmark.z_score", thresholds_.z_score);
+
+    if (auto scenarios = props.get_child_optional("benchmark.scenarios"))
+    {
+        for (const auto& scenario: *scenarios)
+        {
+            if (scenario.first != "scenario")
+                continue;
+            scenarios_.push_back({ scenario.second.get("name", std::string("")), scenario.second.get("session", std::string("")) });
+        }
+    }
+
+    add_task([this](rppanda::FunctionalTask*) {
+        update();
+        return AsyncTask::DS_cont;
+    }, "PerformanceSuite::update");
+}
+
+PerformanceSuite::~PerformanceSuite() = default;
+
+void PerformanceSuite::start()
+{
+    if (is_running_)
+        return;
+
+    if (scenarios_.empty() || !app_.session_capture_ || !app_.performance_monitor_)
+    {
+        global_logger->error("Benchmark has no scenario to run.");
+        return;
+    }
+
+    report_ = PerformanceReport();
+    scenario_index_ = 0;
+    has_failed_scenario_ = false;
+    is_finished_ = false;
+    is_passed_ = false;
+    is_running_ = true;
+
+    crsf::TPhysicsManager::GetInstance()->Start();
+
+    start_next_scenario();
+}
+
+void PerformanceSuite::update()
+{
+    if (!is_running_)
+        return;
+
+    // ring buffers keep only the latest samples, so collect them every frame
+    collect_samples();
+
+    if (app_.session_capture_->get_mode() == SessionCapture::MODE_IDLE)
+        finish_scenario();
+}
+
+void PerformanceSuite::collect_samples()
+{
+    const auto& monitor = *app_.performance_monitor_;
+    dropped_sample_count_ += monitor.get_frame_samples().append_since(frame_samples_, frame_sample_index_);
+    dropped_sample_count_ += monitor.get_physics_samples().append_since(physics_samples_, physics_sample_index_);
+}
+
+void PerformanceSuite::start_next_scenario()
+{
+    for (; scenario_index_ < scenarios_.size(); ++scenario_index_)
+    {
+        if (start_scenario())
+            return;
+    }
+
+    finish();
+}
+
+bool PerformanceSuite::start_scenario()
+{
+    const auto& scenario = scenarios_[scenario_index_];
+    global_logger->info("Benchmark scenario {} ({} / {}) is started: {}", scenario.name, scenario_index_ + 1, scenarios_.size(), scenario.session_path);
+
+    for (int k = 0; k < PROFILE_STAGE_COUNT; ++k)
+        get_stage_histogram(static_cast<ProfileStage>(k)).reset();
+
+    frame_samples_.clear();
+    physics_samples_.clear();
+    frame_sample_index_ = app_.performance_monitor_->get_frame_samples().get_total_count();
+    physics_sample_index_ = app_.performance_monitor_->get_physics_samples().get_total_count();
+    dropped_sample_count_ = 0;
+
+    if (!app_.session_capture_->start_verification(scenario.session_path, 0, false))
+    {
+        global_logger->error("Benchmark scenario {} failed to start.", scenario.name);
+        has_failed_scenario_ = true;
+        return false;
+    }
+
+    return true;
+}
+
+void PerformanceSuite::finish_scenario()
+{
+    const auto& scenario = scenarios_[scenario_index_];
+
+    collect_samples();
+    if (dropped_sample_count_ > 0)
+        global_logger->warn("Benchmark scenario {} dropped {} samples which were overwritten before collecting.", scenario.name, dropped_sample_count_);
+
+    if (!frame_samples_.empty())
+    {
+        std::vector<double> frame_ms;
+        std::vector<double> allocations;
+        for (const auto& sample: frame_samples_)
+        {
+            frame_ms.push_back(sample.frame_ms);
+            allocations.push_back(sample.allocation_count);
+        }
+        report_.add_metric(scenario.name, "frame_ms", PerformanceReport::summarize(frame_ms));
+        if (AllocationCountScope::is_available())
+            report_.add_metric(scenario.name, "allocations_per_frame", PerformanceReport::summarize(allocations));
+    }
+
+    if (!physics_samples_.empty())
+    {
+        std::vector<double> step_ms;
+        for (const auto& sample: physics_samples_)
+            step_ms.push_back(sample.step_ms);
+        report_.add_metric(scenario.name, "physics_step_ms", PerformanceReport::summarize(step_ms));
+    }
+
+    for (int k = 0; k < PROFILE_STAGE_COUNT; ++k)
+    {
+        const auto stage = static_cast<ProfileStage>(k);
+        const auto snapshot = get_stage_histogram(stage).get_snapshot();
+        if (snapshot.count > 0)
+            report_.add_metric(scenario.name, std::string("stage_us.") + get_profile_stage_name(stage), PerformanceReport::summarize(snapshot));
+    }
+
+    ++scenario_index_;
+    start_next_scenario();
+}
+
+void PerformanceSuite::finish()
+{
+    is_running_ = false;
+    is_finished_ = true;
+
+    auto tree = report_.to_ptree();
+
+    std::vector<PerformanceReport::Regression> regressions;
+    std::vector<std::pair<std::string, std::string>> missing_metrics;
+    bool has_baseline = false;
+    if (!baseline_path_.empty())
+    {
+        try
+        {
+            boost::property_tree::ptree baseline_tree;
+            boost::property_tree::read_json(baseline_path_, baseline_tree);
+            const auto baseline = PerformanceReport::from_ptree(baseline_tree);
+            regressions = report_.compare(baseline, thresholds_);
+            missing_metrics = report_.find_missing(baseline);
+            has_baseline = true;
+        }
+        catch (const boost::property_tree::ptree_error& err)
+        {
+            global_logger->error("Failed to read benchmark baseline {}: {}", baseline_path_, err.what());
+        }
+    }
+
+    boost::property_tree::ptree regressions_tree;
+    for (const auto& regression: regressions)
+    {
+        boost::property_tree::ptree regression_tree;
+        regression_tree.put("scenario", regression.scenario);
+        regression_tree.put("metric", regression.metric);
+        regression_tree.put("baseline_mean", regression.baseline.mean);
+        regression_tree.put("current_mean", regression.current.mean);
+        regression_tree.put("relative", regression.relative);
+        regression_tree.put("z_score", regression.z_score);
+        regressions_tree.push_back(std::make_pair("", regression_tree));
+
+        global_logger->warn("Benchmark regression: {} {} {:.3f} -> {:.3f} (+{:.1f} %, z {:.1f})",
+            regression.scenario, regression.metric, regression.baseline.mean, regression.current.mean,
+            regression.relative * 100.0, regression.z_score);
+    }
+
+    // metrics without baseline are not compared, so they are listed to be recorded
+    boost::property_tree::ptree missing_tree;
+    for (const auto& missing: missing_metrics)
+    {
+        boost::property_tree::ptree missing_metric_tree;
+        missing_metric_tree.put("scenario", missing.first);
+        missing_metric_tree.put("metric", missing.second);
+        missing_tree.push_back(std::make_pair("", missing_metric_tree));
+    }
+    if (!missing_metrics.empty())
+        global_logger->warn("Benchmark baseline has no samples of {} metrics, which are not compared.", missing_metrics.size());
+
+    is_passed_ = !has_failed_scenario_ && regressions.empty();
+
+    tree.put("baseline", has_baseline ? baseline_path_ : std::string(""));
+    tree.put("min_relative", thresholds_.min_relative);
+    tree.put("z_score", thresholds_.z_score);
+    tree.put("passed", is_passed_);
+    tree.put_child("regressions", regressions_tree);
+    tree.put_child("missing_baseline", missing_tree);
+
+    try
+    {
+        boost::property_tree::write_json(report_path_, tree);
+    }
+    catch (const boost::property_tree::ptree_error& err)
+    {
+        global_logger->error("Failed to write benchmark report {}: {}", report_path_, err.what());
+    }
+
+    global_logger->info("Benchmark is finished ({}): {} regressions, report is written to {}",
+        is_passed_ ? "passed" : "failed", regressions.size(), report_path_);
+}
@@ -0,0 +1,107 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include <boost/property_tree/ptree.hpp>
+
+#include <render_pipeline/rppanda/showbase/direct_object.hpp>
+
+#include "util/performance_monitor.hpp"
+#include "util/performance_report.hpp"
+
+class MainApp;
+
+/**
+ * Replay a corpus of recorded sessions and compare timings with a baseline report.
+ *
+ * Each scenario (benchmark.scenarios.scenario) replays its session with SessionCapture
+ * from the first keyframe to the end, and collects frame and physics step times,
+ * allocations per frame and hand pipeline stage times.
+ * Report is written to benchmark.report as JSON, with regressions against benchmark.baseline.
+ *
+ * Scene objects should match the scene which recorded the sessions.
+ */
+class PerformanceSuite : public rppanda::DirectObject
+{
+public:
+    struct Scenario
+    {
+        std::string name;
+        std::string session_path;
+    };
+
+public:
+    PerformanceSuite(MainApp& app, const boost::property_tree::ptree& props);
+    ~PerformanceSuite() override;
+
+    void start();
+
+    bool is_running() const;
+    bool is_finished() const;
+
+    /** No regression and all scenarios are replayed. Valid after finished. */
+    bool is_passed() const;
+
+    const std::vector<Scenario>& get_scenarios() const;
+    size_t get_scenario_index() const;
+
+private:
+    void update();
+    void collect_samples();
+
+    void start_next_scenario();
+    bool start_scenario();
+    void finish_scenario();
+    void finish();
+
+    MainApp& app_;
+
+    std::vector<Scenario> scenarios_;
+    std::string report_path_;
+    std::string baseline_path_;
+    PerformanceReport::Thresholds thresholds_;
+
+    bool is_running_ = false;
+    bool is_finished_ = false;
+    bool is_passed_ = false;
+    bool has_failed_scenario_ = false;
+
+    size_t scenario_index_ = 0;
+
+    // all samples of current scenario, collected from ring buffers of monitor
+    std::vector<PerformanceMonitor::FrameSample> frame_samples_;
+    std::vector<PerformanceMonitor::PhysicsSample> physics_samples_;
+    uint64_t frame_sample_index_ = 0;
+    uint64_t physics_sample_index_ = 0;
+    uint64_t dropped_sample_count_ = 0;
+
+    PerformanceReport report_;
+};
+
+// ************************************************************************************************
+
+inline bool PerformanceSuite::is_running() const
+{
+    return is_running_;
+}
+
+inline bool PerformanceSuite::is_finished() const
+{
+    return is_finished_;
+}
+
+inline bool PerformanceSuite::is_passed() const
+{
+    return is_passed_;
+}
+
+inline const std::vector<PerformanceSuite::Scenario>& PerformanceSuite::get_scenarios() const
+{
+    return scenarios_;
+}
+
+inline size_t PerformanceSuite::get_scenario_index() const
+{
+    return scenario_index_;
+}
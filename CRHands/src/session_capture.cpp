@@ -0,0 +1,269 @@
+#include "session_capture.hpp"
+
+#include <algorithm>
+
+#include <spdlog/logger.h>
+
+#include <crsf/CREngine/TPhysicsManager.h>
+#include <crsf/CRModel/TCRHand.h>
+#include <crsf/CRModel/TCRModel.h>
+#include <crsf/CRModel/TPhysicsModel.h>
+#include <crsf/CRModel/TWorld.h>
+#include <crsf/RenderingEngine/TGraphicRenderEngine.h>
+
+#include <hand_mocap_interface.h>
+
+#include "hand/hand.hpp"
+#include "hand/hand_manager.hpp"
+#include "hand/hand_topology.hpp"
+#include "main.hpp"
+#include "user.hpp"
+
+extern spdlog::logger* global_logger;
+
+namespace {
+
+constexpr int HAND_JOINT_COUNT = HandTopology::JOINT_COUNT;
+
+}
+
+SessionCapture::SessionCapture(MainApp& app, const boost::property_tree::ptree& props) :
+    app_(app),
+    steps_per_chunk_(props.get("session.steps_per_chunk", 120u)),
+    verifier_(props.get("session.position_tolerance", 0.001f), props.get("session.angle_tolerance", 1.0f))
+{
+    // added after hand and haptic tasks, so this sees final input and commands of each step
+    crsf::TPhysicsManager::GetInstance()->AddTask([this](void) {
+        update();
+        return false;
+    }, "SessionCapture::update");
+}
+
+SessionCapture::~SessionCapture()
+{
+    stop();
+}
+
+void SessionCapture::add_body(crsf::TCRModel* model)
+{
+    if (model)
+        bodies_.push_back(model);
+}
+
+bool SessionCapture::start_recording(const std::string& path)
+{
+    stop();
+
+    writer_ = std::make_unique<SessionLogWriter>(path, steps_per_chunk_);
+    if (!writer_->is_open())
+    {
+        global_logger->error("Failed to open session log: {}", path);
+        writer_.reset();
+        return false;
+    }
+
+    step_index_ = 0;
+    start_time_ = std::chrono::steady_clock::now();
+    last_bodies_.clear();
+    mode_ = MODE_RECORDING;
+
+    global_logger->info("Session recording is started: {}", path);
+    return true;
+}
+
+bool SessionCapture::start_verification(const std::string& path, uint64_t step, bool is_stopped_at_divergence)
+{
+    stop();
+
+    reader_ = std::make_unique<SessionLogReader>(path);
+    if (!reader_->is_open())
+    {
+        global_logger->error("Failed to open session log: {}", path);
+        reader_.reset();
+        return false;
+    }
+
+    keyframe_step_ = reader_->find_keyframe(step);
+    if (!reader_->seek(keyframe_step_) || !reader_->read(step_))
+    {
+        global_logger->error("Failed to read keyframe {} of session log: {}", keyframe_step_, path);
+        reader_.reset();
+        return false;
+    }
+
+    // device input should not overwrite recorded joints
+    set_hand_render_suspended(true);
+
+    apply_bodies(step_.bodies);
+    apply_hand_joints(step_.hand_joints);
+
+    step_index_ = step_.index;
+    verifier_.reset();
+    is_stopped_at_divergence_ = is_stopped_at_divergence;
+    mode_ = MODE_VERIFYING;
+
+    global_logger->info("Session verification is started from keyframe {}: {}", keyframe_step_, path);
+    return true;
+}
+
+void SessionCapture::stop()
+{
+    if (writer_)
+    {
+        writer_->close();
+        global_logger->info("Session recording is stopped: {} steps, {} bytes", writer_->get_step_count(), writer_->get_file_size());
+        writer_.reset();
+    }
+
+    if (reader_)
+    {
+        reader_.reset();
+        set_hand_render_suspended(false);
+    }
+
+    mode_ = MODE_IDLE;
+}
+
+void SessionCapture::update()
+{
+    switch (mode_)
+    {
+    case MODE_RECORDING:
+        record_step();
+        break;
+    case MODE_VERIFYING:
+        verify_step();
+        break;
+    default:
+        break;
+    }
+}
+
+void SessionCapture::record_step()
+{
+    step_.index = step_index_++;
+    step_.time = std::chrono::duration<double>(std::chrono::steady_clock::now() - start_time_).count();
+
+    capture_hand_joints(step_.hand_joints);
+    capture_bodies(step_.bodies);
+
+    step_.grasp_events.clear();
+    for (size_t k = 0, k_end = (std::min)(step_.bodies.size(), last_bodies_.size()); k < k_end; ++k)
+    {
+        if (step_.bodies[k].is_grasped != last_bodies_[k].is_grasped)
+            step_.grasp_events.push_back({ step_.bodies[k].id, step_.bodies[k].is_grasped });
+    }
+
+    step_.vibration_masks[0] = app_.hand_manager_->get_hand_mocap_vibration(Hand_MoCAPInterface::HAND_LEFT);
+    step_.vibration_masks[1] = app_.hand_manager_->get_hand_mocap_vibration(Hand_MoCAPInterface::HAND_RIGHT);
+
+    writer_->write(step_);
+
+    last_bodies_ = step_.bodies;
+}
+
+void SessionCapture::verify_step()
+{
+    if (!reader_->read(step_))
+    {
+        global_logger->info("Session verification is finished {}: {} steps from keyframe {}, max position error {}",
+            verifier_.has_divergence() ? "with divergence" : "without divergence",
+            verifier_.get_checked_step_count(), keyframe_step_, verifier_.get_max_position_error());
+        stop();
+        return;
+    }
+
+    step_index_ = step_.index;
+
+    capture_bodies(simulated_bodies_);
+    if (!verifier_.check(step_, simulated_bodies_))
+    {
+        const auto& divergence = verifier_.get_divergence();
+        global_logger->warn("Session diverged at step {} (keyframe {}): body {}, position error {}, angle error {}{}",
+            divergence.step, keyframe_step_, divergence.body_id, divergence.position_error, divergence.angle_error,
+            divergence.is_grasp_mismatch ? ", grasp state mismatch" : "");
+
+        if (is_stopped_at_divergence_)
+        {
+            stop();
+            return;
+        }
+    }
+
+    apply_hand_joints(step_.hand_joints);
+}
+
+void SessionCapture::capture_hand_joints(std::vector<RigidTransform>& joints) const
+{
+    joints.clear();
+
+    auto hand = app_.hand_manager_->get_hand();
+    if (!hand)
+        return;
+
+    auto world = crsf::TGraphicRenderEngine::GetInstance()->GetWorld();
+    for (int k = 0; k < HAND_JOINT_COUNT; ++k)
+    {
+        auto joint_model = hand->GetJointData(k)->Get3DModel();
+        joints.emplace_back(joint_model->GetQuaternion(world), joint_model->GetPosition(world));
+    }
+}
+
+void SessionCapture::capture_bodies(std::vector<SessionBodyState>& bodies) const
+{
+    auto world = crsf::TGraphicRenderEngine::GetInstance()->GetWorld();
+    auto physics_manager = crsf::TPhysicsManager::GetInstance();
+
+    bodies.resize(bodies_.size());
+    for (size_t k = 0, k_end = bodies_.size(); k < k_end; ++k)
+    {
+        auto& body = bodies[k];
+        body.id = static_cast<uint32_t>(k);
+        body.is_grasped = bodies_[k]->GetPhysicsModel()->GetIsGrasped();
+        body.pose = RigidTransform::from_object(bodies_[k], world);
+        body.linear_velocity = physics_manager->GetLinearVelocity(bodies_[k]);
+        body.angular_velocity = physics_manager->GetAngularVelocity(bodies_[k]);
+    }
+}
+
+void SessionCapture::apply_hand_joints(const std::vector<RigidTransform>& joints)
+{
+    auto hand = app_.hand_manager_->get_hand();
+    if (!hand || static_cast<int>(joints.size()) < HAND_JOINT_COUNT)
+        return;
+
+    auto world = crsf::TGraphicRenderEngine::GetInstance()->GetWorld();
+    for (int k = 0; k < HAND_JOINT_COUNT; ++k)
+    {
+        // joints may be scaled, so set position and rotation instead of matrix
+        auto joint_model = hand->GetJointData(k)->Get3DModel();
+        joint_model->SetPosition(joints[k].get_pos(), world);
+        joint_model->SetHPR(joints[k].get_quat().get_hpr(), world);
+    }
+
+    // render paths should not skip joints moved here
+    app_.hand_manager_->reset_joint_write_cache();
+}
+
+void SessionCapture::set_hand_render_suspended(bool is_suspended)
+{
+    if (app_.user_ && app_.user_->get_hand())
+        app_.user_->get_hand()->set_render_suspended(is_suspended);
+}
+
+void SessionCapture::apply_bodies(const std::vector<SessionBodyState>& bodies)
+{
+    auto world = crsf::TGraphicRenderEngine::GetInstance()->GetWorld();
+    auto physics_manager = crsf::TPhysicsManager::GetInstance();
+
+    for (const auto& body: bodies)
+    {
+        if (body.id >= bodies_.size())
+            continue;
+
+        auto model = bodies_[body.id];
+        model->SetMatrix(body.pose.get_matrix(), world);
+        physics_manager->SetLinearVelocity(model, body.linear_velocity);
+        physics_manager->SetAngularVelocity(model, body.angular_velocity);
+    }
+}
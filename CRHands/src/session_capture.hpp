@@ -0,0 +1,118 @@
+#pragma once
+
+#include <chrono>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <boost/property_tree/ptree.hpp>
+
+#include "util/session_log.hpp"
+#include "util/session_verifier.hpp"
+
+namespace crsf {
+class TCRModel;
+}
+
+class MainApp;
+
+/**
+ * Record hand input, interactable bodies, grasp transitions and haptic commands per physics step,
+ * and verify determinism by re-simulating a recorded session from a keyframe.
+ *
+ * While verifying, render method of hand device is suspended and recorded hand joints are applied
+ * after hand tasks of each step, and simulated bodies are compared with recorded ones until the first divergent step.
+ */
+class SessionCapture
+{
+public:
+    enum Mode
+    {
+        MODE_IDLE,
+        MODE_RECORDING,
+        MODE_VERIFYING,
+    };
+
+public:
+    SessionCapture(MainApp& app, const boost::property_tree::ptree& props);
+    ~SessionCapture();
+
+    /** Body ID is the order of adding. */
+    void add_body(crsf::TCRModel* model);
+
+    bool start_recording(const std::string& path);
+
+    /**
+     * Restore keyframe at or before @a step and re-simulate from it.
+     *
+     * @param is_stopped_at_divergence  false to replay until the end (benchmark).
+     */
+    bool start_verification(const std::string& path, uint64_t step, bool is_stopped_at_divergence = true);
+
+    void stop();
+
+    Mode get_mode() const;
+    uint64_t get_step_index() const;
+    uint64_t get_keyframe_step() const;
+    const SessionLogWriter* get_writer() const;
+    const SessionVerifier& get_verifier() const;
+
+private:
+    void update();
+    void record_step();
+    void verify_step();
+
+    void capture_hand_joints(std::vector<RigidTransform>& joints) const;
+    void capture_bodies(std::vector<SessionBodyState>& bodies) const;
+    void apply_hand_joints(const std::vector<RigidTransform>& joints);
+    void set_hand_render_suspended(bool is_suspended);
+    void apply_bodies(const std::vector<SessionBodyState>& bodies);
+
+    MainApp& app_;
+
+    const uint32_t steps_per_chunk_;
+
+    std::vector<crsf::TCRModel*> bodies_;
+
+    Mode mode_ = MODE_IDLE;
+    bool is_stopped_at_divergence_ = true;
+    uint64_t step_index_ = 0;
+    uint64_t keyframe_step_ = 0;
+    std::chrono::steady_clock::time_point start_time_;
+
+    std::unique_ptr<SessionLogWriter> writer_;
+    std::unique_ptr<SessionLogReader> reader_;
+    SessionVerifier verifier_;
+
+    // reused every step
+    SessionStep step_;
+    std::vector<SessionBodyState> last_bodies_;
+    std::vector<SessionBodyState> simulated_bodies_;
+};
+
+// ************************************************************************************************
+
+inline SessionCapture::Mode SessionCapture::get_mode() const
+{
+    return mode_;
+}
+
+inline uint64_t SessionCapture::get_step_index() const
+{
+    return step_index_;
+}
+
+inline uint64_t SessionCapture::get_keyframe_step() const
+{
+    return keyframe_step_;
+}
+
+inline const SessionLogWriter* SessionCapture::get_writer() const
+{
+    return writer_.get();
+}
+
+inline const SessionVerifier& SessionCapture::get_verifier() const
+{
+    return verifier_;
+}
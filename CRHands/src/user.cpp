@@ -7,6 +7,7 @@
 #include <crsf/System/TCRProperty.h>
 
 #include "hand/hand.hpp"
+#include "hand/hand_topology.hpp"
 
 User::User(unsigned int system_index) : system_index_(system_index)
 {
@@ -44,7 +45,7 @@ Hand* User::make_hand()
 
     // set hand property
     crsf::TCRProperty hand_property;
-    hand_property.m_propAvatar.SetJointNumber(44);
+    hand_property.m_propAvatar.SetJointNumber(HandTopology::JOINT_COUNT);
     hand_property.m_propHand.m_strName = "Hand" + std::to_string(system_index_);
     hand_property.m_propHand.SetRenderMode(false, false, true);
 
@@ -0,0 +1,97 @@
+#include "allocation_counter.hpp"
+
+#include <cstdlib>
+#include <new>
+
+namespace {
+
+// constant initialized, so allocation functions can use them before thread startup finishes
+thread_local uint64_t thread_allocation_count = 0;
+thread_local int thread_scope_count = 0;
+
+}
+
+AllocationCountScope::AllocationCountScope() : start_count_(thread_allocation_count)
+{
+    ++thread_scope_count;
+}
+
+AllocationCountScope::~AllocationCountScope()
+{
+    --thread_scope_count;
+}
+
+uint64_t AllocationCountScope::get_count() const
+{
+    return thread_allocation_count - start_count_;
+}
+
+void AllocationCountScope::restart()
+{
+    start_count_ = thread_allocation_count;
+}
+
+#if defined(CRHANDS_COUNT_ALLOCATIONS)
+
+namespace {
+
+void* counted_malloc(std::size_t size)
+{
+    if (thread_scope_count > 0)
+        ++thread_allocation_count;
+
+    if (size == 0)
+        size = 1;
+
+    while (true)
+    {
+        if (void* ptr = std::malloc(size))
+            return ptr;
+
+        auto handler = std::get_new_handler();
+        if (!handler)
+            throw std::bad_alloc();
+        handler();
+    }
+}
+
+void* counted_malloc_nothrow(std::size_t size) noexcept
+{
+    try
+    {
+        return counted_malloc(size);
+    }
+    catch (...)
+    {
+        return nullptr;
+    }
+}
+
+}
+
+bool AllocationCountScope::is_available()
+{
+    return true;
+}
+
+// replace global allocation functions (aligned versions are not counted)
+void* operator new(std::size_t size) { return counted_malloc(size); }
+void* operator new[](std::size_t size) { return counted_malloc(size); }
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept { return counted_malloc_nothrow(size); }
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept { return counted_malloc_nothrow(size); }
+
+void operator delete(void* ptr) noexcept { std::free(ptr); }
+void operator delete[](void* ptr) noexcept { std::free(ptr); }
+void operator delete(void* ptr, std::size_t) noexcept { std::free(ptr); }
+void operator delete[](void* ptr, std::size_t) noexcept { std::free(ptr); }
+void operator delete(void* ptr, const std::nothrow_t&) noexcept { std::free(ptr); }
+void operator delete[](void* ptr, const std::nothrow_t&) noexcept { std::free(ptr); }
+
+#else
+
+bool AllocationCountScope::is_available()
+{
+    return false;
+}
+
+#endif
@@ -0,0 +1,33 @@
+#pragma once
+
+#include <cstdint>
+
+/**
+ * Count operator new calls of the current thread while the scope is alive.
+ *
+ * Counting needs allocation functions replaced by allocation_counter.cpp, which is compiled
+ * only when CRHANDS_COUNT_ALLOCATIONS is defined, because the replacement affects the whole process.
+ * Otherwise, counts are always 0. The replacement only forwards to malloc on threads without scope.
+ *
+ * A scope should be destroyed in the thread which created it. Scopes can overlap.
+ */
+class AllocationCountScope
+{
+public:
+    AllocationCountScope();
+    ~AllocationCountScope();
+
+    AllocationCountScope(const AllocationCountScope&) = delete;
+    AllocationCountScope& operator=(const AllocationCountScope&) = delete;
+
+    /** Allocations since this scope is created or restarted. */
+    uint64_t get_count() const;
+
+    void restart();
+
+    /** False if allocation functions are not replaced. */
+    static bool is_available();
+
+private:
+    uint64_t start_count_;
+};
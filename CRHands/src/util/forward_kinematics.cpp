@@ -0,0 +1,59 @@
+#include "forward_kinematics.hpp"
+
+void ForwardKinematics::set_parents(const std::vector<int>& parents)
+{
+    const int joint_count = static_cast<int>(parents.size());
+
+    slots_.assign(joint_count, -1);
+    parent_slots_.clear();
+
+    // add joints whose parent is already added, until no joint is added.
+    // invalid parent or cycle makes the joint a root.
+    std::vector<int> order;
+    order.reserve(joint_count);
+    for (bool is_added = true; is_added;)
+    {
+        is_added = false;
+        for (int joint = 0; joint < joint_count; ++joint)
+        {
+            if (slots_[joint] != -1)
+                continue;
+
+            const int parent = parents[joint];
+            const bool is_root = parent < 0 || parent >= joint_count || parent == joint;
+            if (!is_root && slots_[parent] == -1)
+                continue;
+
+            slots_[joint] = static_cast<int>(order.size());
+            parent_slots_.push_back(is_root ? -1 : slots_[parent]);
+            order.push_back(joint);
+            is_added = true;
+        }
+    }
+
+    for (int joint = 0; joint < joint_count; ++joint)
+    {
+        if (slots_[joint] != -1)
+            continue;
+
+        slots_[joint] = static_cast<int>(order.size());
+        parent_slots_.push_back(-1);
+        order.push_back(joint);
+    }
+
+    locals_.assign(joint_count, LMatrix4f::ident_mat());
+    worlds_.assign(joint_count, LMatrix4f::ident_mat());
+}
+
+void ForwardKinematics::update()
+{
+    const int slot_count = static_cast<int>(parent_slots_.size());
+    for (int slot = 0; slot < slot_count; ++slot)
+    {
+        const int parent_slot = parent_slots_[slot];
+        if (parent_slot < 0)
+            worlds_[slot] = locals_[slot];
+        else
+            worlds_[slot].multiply(locals_[slot], worlds_[parent_slot]);
+    }
+}
@@ -0,0 +1,54 @@
+#pragma once
+
+#include <vector>
+
+#include <luse.h>
+
+/**
+ * World transforms of a joint tree in one forward pass.
+ *
+ * Transforms are kept in flat arrays sorted so that a parent comes before its children,
+ * so each world transform is one product with the parent transform computed just before.
+ * Unlike asking world transform of each node to scene graph, shared ancestors are composed once.
+ *
+ * Matrices use the Panda3D row-vector convention: world = local * parent_world.
+ */
+class ForwardKinematics
+{
+public:
+    /** @param parents  parent of each joint, or -1 if world transform of the joint is given directly. */
+    void set_parents(const std::vector<int>& parents);
+
+    int get_joint_count() const;
+
+    /** Set transform relative to parent, or world transform if the joint has no parent. */
+    void set_local(int joint, const LMatrix4f& mat);
+
+    /** Compute world transforms of all joints. */
+    void update();
+
+    const LMatrix4f& get_world(int joint) const;
+
+private:
+    std::vector<int> slots_;            ///< joint -> slot in parent-first order
+    std::vector<int> parent_slots_;     ///< parent slot of each slot, or -1
+    std::vector<LMatrix4f> locals_;     ///< per slot
+    std::vector<LMatrix4f> worlds_;     ///< per slot
+};
+
+// ************************************************************************************************
+
+inline int ForwardKinematics::get_joint_count() const
+{
+    return static_cast<int>(slots_.size());
+}
+
+inline void ForwardKinematics::set_local(int joint, const LMatrix4f& mat)
+{
+    locals_[slots_[joint]] = mat;
+}
+
+inline const LMatrix4f& ForwardKinematics::get_world(int joint) const
+{
+    return worlds_[slots_[joint]];
+}
@@ -0,0 +1,43 @@
+#include "frame_arena.hpp"
+
+#include <new>
+
+FrameArena::FrameArena(std::size_t capacity) : capacity_(capacity), buffer_(new unsigned char[capacity])
+{
+    // overflow is rare, so keep some slots to avoid allocation at overflow
+    overflow_blocks_.reserve(16);
+}
+
+FrameArena::~FrameArena()
+{
+    reset();
+}
+
+void* FrameArena::allocate(std::size_t size, std::size_t alignment)
+{
+    const std::uintptr_t base = reinterpret_cast<std::uintptr_t>(buffer_.get());
+    const std::uintptr_t aligned = (base + offset_ + alignment - 1) & ~(static_cast<std::uintptr_t>(alignment) - 1);
+    const std::size_t new_offset = static_cast<std::size_t>(aligned - base) + size;
+
+    if (new_offset <= capacity_)
+    {
+        offset_ = new_offset;
+        if (offset_ > peak_size_.load(std::memory_order_relaxed))
+            peak_size_.store(offset_, std::memory_order_relaxed);
+        return reinterpret_cast<void*>(aligned);
+    }
+
+    overflow_count_.fetch_add(1, std::memory_order_relaxed);
+    void* block = ::operator new(size);
+    overflow_blocks_.push_back(block);
+    return block;
+}
+
+void FrameArena::reset()
+{
+    for (void* block: overflow_blocks_)
+        ::operator delete(block);
+    overflow_blocks_.clear();
+
+    offset_ = 0;
+}
@@ -0,0 +1,137 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <utility>
+#include <vector>
+
+/**
+ * Bump allocator for scratch memory of one frame (or physics step) in one thread.
+ *
+ * Deallocation does nothing, and reset() frees everything in O(1).
+ * If capacity is not enough, the request falls back to heap and the block is freed at reset,
+ * so capacity can be tuned with get_overflow_count() and get_peak_size().
+ * Only the peak size and the overflow count can be read from other threads.
+ */
+class FrameArena
+{
+public:
+    explicit FrameArena(std::size_t capacity);
+    ~FrameArena();
+
+    FrameArena(const FrameArena&) = delete;
+    FrameArena& operator=(const FrameArena&) = delete;
+
+    void* allocate(std::size_t size, std::size_t alignment);
+
+    void reset();
+
+    std::size_t get_capacity() const;
+    std::size_t get_used_size() const;
+    std::size_t get_peak_size() const;
+    uint64_t get_overflow_count() const;
+
+private:
+    const std::size_t capacity_;
+    std::unique_ptr<unsigned char[]> buffer_;
+    std::size_t offset_ = 0;
+    std::atomic<std::size_t> peak_size_{ 0 };
+
+    std::vector<void*> overflow_blocks_;
+    std::atomic<uint64_t> overflow_count_{ 0 };
+};
+
+/** Standard allocator using FrameArena. */
+template <typename T>
+class FrameAllocator
+{
+public:
+    using value_type = T;
+
+    explicit FrameAllocator(FrameArena& arena) noexcept : arena_(&arena)
+    {
+    }
+
+    template <typename U>
+    FrameAllocator(const FrameAllocator<U>& other) noexcept : arena_(other.get_arena())
+    {
+    }
+
+    T* allocate(std::size_t n)
+    {
+        return static_cast<T*>(arena_->allocate(n * sizeof(T), alignof(T)));
+    }
+
+    void deallocate(T*, std::size_t) noexcept
+    {
+    }
+
+    FrameArena* get_arena() const noexcept
+    {
+        return arena_;
+    }
+
+private:
+    FrameArena* arena_;
+};
+
+template <typename T, typename U>
+bool operator==(const FrameAllocator<T>& a, const FrameAllocator<U>& b) noexcept
+{
+    return a.get_arena() == b.get_arena();
+}
+
+template <typename T, typename U>
+bool operator!=(const FrameAllocator<T>& a, const FrameAllocator<U>& b) noexcept
+{
+    return !(a == b);
+}
+
+/** Vector of frame scratch. It should not live over reset() of its arena. */
+template <typename T>
+using FrameVector = std::vector<T, FrameAllocator<T>>;
+
+/** Array of @a N empty FrameVectors on @a arena (ex, lists per hand). */
+template <typename T, std::size_t N>
+std::array<FrameVector<T>, N> make_frame_vectors(FrameArena& arena);
+
+// ************************************************************************************************
+
+inline std::size_t FrameArena::get_capacity() const
+{
+    return capacity_;
+}
+
+inline std::size_t FrameArena::get_used_size() const
+{
+    return offset_;
+}
+
+inline std::size_t FrameArena::get_peak_size() const
+{
+    return peak_size_.load(std::memory_order_relaxed);
+}
+
+inline uint64_t FrameArena::get_overflow_count() const
+{
+    return overflow_count_.load(std::memory_order_relaxed);
+}
+
+namespace frame_arena_detail {
+
+template <typename T, std::size_t... Indices>
+std::array<FrameVector<T>, sizeof...(Indices)> make_frame_vectors(FrameArena& arena, std::index_sequence<Indices...>)
+{
+    return { { (static_cast<void>(Indices), FrameVector<T>(FrameAllocator<T>(arena)))... } };
+}
+
+}
+
+template <typename T, std::size_t N>
+inline std::array<FrameVector<T>, N> make_frame_vectors(FrameArena& arena)
+{
+    return frame_arena_detail::make_frame_vectors<T>(arena, std::make_index_sequence<N>());
+}
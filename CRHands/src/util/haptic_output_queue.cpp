@@ -0,0 +1,111 @@
+#include "haptic_output_queue.hpp"
+
+#include <algorithm>
+
+HapticOutputQueue::HapticOutputQueue(const Sink& sink, std::chrono::milliseconds min_interval) :
+    sink_(sink), min_interval_(min_interval)
+{
+    for (auto&& mask: pending_masks_)
+        mask.store(0, std::memory_order_relaxed);
+
+    thread_ = std::thread(&HapticOutputQueue::run, this);
+}
+
+HapticOutputQueue::~HapticOutputQueue()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        is_running_.store(false);
+    }
+    condition_.notify_one();
+
+    if (thread_.joinable())
+        thread_.join();
+}
+
+void HapticOutputQueue::submit(int channel, Mask mask)
+{
+    pending_masks_[channel].store(mask, std::memory_order_relaxed);
+    is_dirty_.store(true, std::memory_order_release);
+    submitted_count_.fetch_add(1, std::memory_order_relaxed);
+
+    // notify without lock. if the worker misses it, it wakes up after min_interval_.
+    condition_.notify_one();
+}
+
+void HapticOutputQueue::pause()
+{
+    is_paused_.store(true);
+
+    // wait for the sink call in progress
+    std::lock_guard<std::mutex> sink_lock(sink_mutex_);
+}
+
+void HapticOutputQueue::resume()
+{
+    is_resent_.store(true);
+    is_paused_.store(false);
+
+    is_dirty_.store(true, std::memory_order_release);
+    condition_.notify_one();
+}
+
+void HapticOutputQueue::run()
+{
+    using clock = std::chrono::steady_clock;
+
+    std::array<Mask, CHANNEL_COUNT> sent_masks = {};
+    std::array<clock::time_point, CHANNEL_COUNT> sent_times;
+    sent_times.fill(clock::time_point::min());
+
+    clock::duration wait_time = min_interval_;
+    bool has_deferred = false;
+
+    while (is_running_.load())
+    {
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            condition_.wait_for(lock, wait_time, [this, has_deferred] {
+                return !is_running_.load() || (!has_deferred && is_dirty_.load(std::memory_order_acquire));
+            });
+        }
+
+        if (!is_running_.load())
+            break;
+
+        is_dirty_.store(false, std::memory_order_relaxed);
+
+        const auto now = clock::now();
+        wait_time = min_interval_;
+        has_deferred = false;
+
+        std::lock_guard<std::mutex> sink_lock(sink_mutex_);
+        if (is_paused_.load())
+            continue;
+
+        const bool is_resent = is_resent_.exchange(false);
+        if (is_resent)
+            sent_times.fill(clock::time_point::min());
+
+        for (int channel = 0; channel < CHANNEL_COUNT; ++channel)
+        {
+            const Mask mask = pending_masks_[channel].load(std::memory_order_relaxed);
+            if (!is_resent && mask == sent_masks[channel])
+                continue;
+
+            const auto elapsed = now - sent_times[channel];
+            if (sent_times[channel] != clock::time_point::min() && elapsed < min_interval_)
+            {
+                // send newest mask when rate limit is over
+                wait_time = (std::min)(wait_time, min_interval_ - elapsed);
+                has_deferred = true;
+                continue;
+            }
+
+            sink_(channel, mask);
+            sent_masks[channel] = mask;
+            sent_times[channel] = now;
+            sent_count_.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+}
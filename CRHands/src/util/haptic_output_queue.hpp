@@ -0,0 +1,80 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <thread>
+
+/**
+ * Asynchronous output of haptic masks with rate limit.
+ *
+ * submit() only stores the newest mask of a channel and never blocks, so it can be called
+ * from physics step. A worker thread sends a mask to the sink when it differs from the last
+ * sent mask, and sends at most one mask per channel in @a min_interval. Masks submitted
+ * in between are coalesced to the newest one.
+ *
+ * pause() returns after a mask in sending is sent, and the sink is not called until resume(),
+ * so the sink can change its device in between.
+ */
+class HapticOutputQueue
+{
+public:
+    static constexpr int CHANNEL_COUNT = 2;
+
+    using Mask = uint32_t;
+    using Sink = std::function<void(int channel, Mask mask)>;
+
+public:
+    HapticOutputQueue(const Sink& sink, std::chrono::milliseconds min_interval);
+    ~HapticOutputQueue();
+
+    HapticOutputQueue(const HapticOutputQueue&) = delete;
+    HapticOutputQueue& operator=(const HapticOutputQueue&) = delete;
+
+    void submit(int channel, Mask mask);
+
+    /** Stop sending. Masks submitted while paused are kept and coalesced. */
+    void pause();
+
+    /** Send newest masks again, because the device may have been changed while paused. */
+    void resume();
+
+    uint64_t get_submitted_count() const;
+    uint64_t get_sent_count() const;
+
+private:
+    void run();
+
+    const Sink sink_;
+    const std::chrono::milliseconds min_interval_;
+
+    std::array<std::atomic<Mask>, CHANNEL_COUNT> pending_masks_;
+    std::atomic<bool> is_dirty_{ false };
+    std::atomic<bool> is_running_{ true };
+    std::atomic<bool> is_paused_{ false };
+    std::atomic<bool> is_resent_{ false };
+
+    std::atomic<uint64_t> submitted_count_{ 0 };
+    std::atomic<uint64_t> sent_count_{ 0 };
+
+    std::mutex mutex_;
+    std::mutex sink_mutex_;         ///< held by worker while it calls the sink
+    std::condition_variable condition_;
+    std::thread thread_;
+};
+
+// ************************************************************************************************
+
+inline uint64_t HapticOutputQueue::get_submitted_count() const
+{
+    return submitted_count_.load(std::memory_order_relaxed);
+}
+
+inline uint64_t HapticOutputQueue::get_sent_count() const
+{
+    return sent_count_.load(std::memory_order_relaxed);
+}
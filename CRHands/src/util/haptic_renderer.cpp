@@ -0,0 +1,124 @@
+#include "haptic_renderer.hpp"
+
+#include <algorithm>
+
+namespace {
+
+float saturate(float value)
+{
+    return (std::max)(0.0f, (std::min)(value, 1.0f));
+}
+
+}
+
+HapticRenderer::HapticRenderer(const Sink& sink, const Parameters& params) :
+    sink_(sink), params_(params),
+    onset_ticks_(params.period.count() > 0 && params.onset_duration.count() > 0 ?
+        (std::max)(1, static_cast<int>(params.onset_duration / params.period)) : 0)
+{
+    for (auto&& hand_depths: depths_)
+        for (auto&& depth: hand_depths)
+            depth.store(0.0f, std::memory_order_relaxed);
+
+    for (auto&& hand_velocities: velocities_)
+        for (auto&& velocity: hand_velocities)
+            velocity.store(0.0f, std::memory_order_relaxed);
+
+    thread_ = std::thread(&HapticRenderer::run, this);
+}
+
+HapticRenderer::~HapticRenderer()
+{
+    is_running_.store(false);
+    if (thread_.joinable())
+        thread_.join();
+}
+
+void HapticRenderer::set_contact(int hand, int finger, float depth, float velocity)
+{
+    depths_[hand][finger].store(depth, std::memory_order_relaxed);
+    velocities_[hand][finger].store(velocity, std::memory_order_relaxed);
+}
+
+void HapticRenderer::run()
+{
+    using clock = std::chrono::steady_clock;
+
+    auto deadline = clock::now();
+    while (is_running_.load(std::memory_order_relaxed))
+    {
+        const auto now = clock::now();
+        const auto lateness = std::chrono::duration_cast<std::chrono::nanoseconds>(now - deadline);
+        lateness_histogram_.record(lateness.count() > 0 ? static_cast<uint64_t>(lateness.count()) : 0);
+        if (lateness > params_.period)
+        {
+            deadline_miss_count_.fetch_add(1, std::memory_order_relaxed);
+
+            // do not burst to catch up missed ticks
+            deadline = now;
+        }
+
+        tick();
+        tick_count_.fetch_add(1, std::memory_order_relaxed);
+
+        deadline += params_.period;
+        std::this_thread::sleep_until(deadline);
+    }
+}
+
+void HapticRenderer::tick()
+{
+    for (int hand = 0; hand < HAND_COUNT; ++hand)
+    {
+        uint32_t bits = 0;
+        for (int finger = 0; finger < FINGER_COUNT; ++finger)
+        {
+            auto& state = finger_states_[hand][finger];
+            const float depth = depths_[hand][finger].load(std::memory_order_relaxed);
+            const bool is_contacted = depth > 0.0f;
+
+            // onset transient on new contact
+            if (is_contacted && !state.was_contacted)
+            {
+                state.onset_gain = 0.0f;
+                state.onset_remaining_ticks = onset_ticks_;
+            }
+            state.was_contacted = is_contacted;
+
+            // velocity is known from the second contact step, so gain follows its peak during onset
+            if (is_contacted && state.onset_remaining_ticks > 0)
+            {
+                const float velocity = velocities_[hand][finger].load(std::memory_order_relaxed);
+                state.onset_gain = (std::max)(state.onset_gain, saturate(velocity / params_.onset_velocity));
+            }
+
+            float intensity = is_contacted ? saturate(depth / params_.max_depth) : 0.0f;
+            if (state.onset_remaining_ticks > 0)
+            {
+                intensity = (std::max)(intensity, state.onset_gain);
+                --state.onset_remaining_ticks;
+            }
+
+            if (intensity <= 0.0f)
+            {
+                state.accumulator = 0.0f;
+                continue;
+            }
+
+            // pulse density of on state follows intensity
+            state.accumulator += intensity;
+            if (state.accumulator >= 0.5f)
+            {
+                bits |= 1u << finger;
+                state.accumulator -= 1.0f;
+            }
+        }
+
+        if (bits != sent_bits_[hand])
+        {
+            sink_(hand, bits);
+            sent_bits_[hand] = bits;
+            command_count_.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+}
@@ -0,0 +1,122 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <thread>
+
+#include "util/stage_profiler.hpp"
+
+/**
+ * Haptic rendering loop of vibration gloves on its own thread.
+ *
+ * Physics step publishes penetration depth and approach velocity of each finger.
+ * The loop runs at fixed rate (up to 1 kHz) and turns them to intensity in [0, 1]:
+ * depth gives sustained intensity, and new contact gives a short onset transient scaled by velocity.
+ * Gloves only have on/off per finger, so intensity is sent as pulse density (first order sigma-delta).
+ *
+ * Sink is called from the loop only when on/off bits of a hand are changed. It should not block,
+ * so device writes go through HapticOutputQueue.
+ */
+class HapticRenderer
+{
+public:
+    static constexpr int HAND_COUNT = 2;
+
+    enum Finger
+    {
+        FINGER_THUMB = 0,
+        FINGER_INDEX,
+        FINGER_MIDDLE,
+
+        FINGER_COUNT,
+    };
+
+    /** @param finger_bits  bit k is on/off of finger k. */
+    using Sink = std::function<void(int hand, uint32_t finger_bits)>;
+
+    struct Parameters
+    {
+        std::chrono::microseconds period = std::chrono::microseconds(1000);
+        float max_depth = 0.01f;                ///< meters, depth of full intensity
+        float onset_velocity = 0.2f;            ///< m/s, velocity of full onset transient
+        std::chrono::microseconds onset_duration = std::chrono::microseconds(15000);
+    };
+
+public:
+    HapticRenderer(const Sink& sink, const Parameters& params);
+    ~HapticRenderer();
+
+    HapticRenderer(const HapticRenderer&) = delete;
+    HapticRenderer& operator=(const HapticRenderer&) = delete;
+
+    /**
+     * Publish contact of a finger. Called from physics step, and never blocks.
+     * @param velocity  approach velocity. 0 at the first contact step.
+     */
+    void set_contact(int hand, int finger, float depth, float velocity);
+
+    uint64_t get_tick_count() const;
+    uint64_t get_command_count() const;
+
+    /** Ticks which started later than one period after their deadline. */
+    uint64_t get_deadline_miss_count() const;
+
+    /** Lateness of tick start from its deadline. */
+    const StageHistogram& get_lateness_histogram() const;
+
+private:
+    struct FingerState
+    {
+        float accumulator = 0.0f;
+        float onset_gain = 0.0f;
+        int onset_remaining_ticks = 0;
+        bool was_contacted = false;
+    };
+
+    void run();
+    void tick();
+
+    const Sink sink_;
+    const Parameters params_;
+    const int onset_ticks_;
+
+    std::array<std::array<std::atomic<float>, FINGER_COUNT>, HAND_COUNT> depths_;
+    std::array<std::array<std::atomic<float>, FINGER_COUNT>, HAND_COUNT> velocities_;
+
+    // used by loop thread only
+    std::array<std::array<FingerState, FINGER_COUNT>, HAND_COUNT> finger_states_;
+    std::array<uint32_t, HAND_COUNT> sent_bits_ = {};
+
+    std::atomic<uint64_t> tick_count_{ 0 };
+    std::atomic<uint64_t> command_count_{ 0 };
+    std::atomic<uint64_t> deadline_miss_count_{ 0 };
+    StageHistogram lateness_histogram_;
+
+    std::atomic<bool> is_running_{ true };
+    std::thread thread_;
+};
+
+// ************************************************************************************************
+
+inline uint64_t HapticRenderer::get_tick_count() const
+{
+    return tick_count_.load(std::memory_order_relaxed);
+}
+
+inline uint64_t HapticRenderer::get_command_count() const
+{
+    return command_count_.load(std::memory_order_relaxed);
+}
+
+inline uint64_t HapticRenderer::get_deadline_miss_count() const
+{
+    return deadline_miss_count_.load(std::memory_order_relaxed);
+}
+
+inline const StageHistogram& HapticRenderer::get_lateness_histogram() const
+{
+    return lateness_histogram_;
+}
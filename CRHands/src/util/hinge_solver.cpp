@@ -0,0 +1,44 @@
+#include "hinge_solver.hpp"
+
+#include <cmath>
+
+namespace {
+
+const float RAD_TO_DEG = 180.0f / static_cast<float>(std::acos(-1.0));
+
+float wrap_angle(float angle)
+{
+    while (angle > 180.0f)
+        angle -= 360.0f;
+    while (angle <= -180.0f)
+        angle += 360.0f;
+    return angle;
+}
+
+}
+
+float HingeSolver::get_twist_angle(const LQuaternionf& quat, const LVecBase3f& axis)
+{
+    // twist = (w, (v . axis) axis), so its angle is 2 * atan2(v . axis, w)
+    const float projection = quat.get_i() * axis[0] + quat.get_j() * axis[1] + quat.get_k() * axis[2];
+    return wrap_angle(2.0f * std::atan2(projection, quat.get_r()) * RAD_TO_DEG);
+}
+
+void HingeSolver::begin(const LQuaternionf& relative_quat, const LVecBase3f& axis, float angle, float direction)
+{
+    axis_ = axis.normalized();
+    start_angle_ = angle;
+    direction_ = direction;
+    last_twist_ = get_twist_angle(relative_quat, axis_);
+    accumulated_twist_ = 0.0f;
+}
+
+float HingeSolver::solve(const LQuaternionf& relative_quat)
+{
+    // accumulate small steps, so crossing +-180 degree does not jump
+    const float twist = get_twist_angle(relative_quat, axis_);
+    accumulated_twist_ += wrap_angle(twist - last_twist_);
+    last_twist_ = twist;
+
+    return start_angle_ + direction_ * accumulated_twist_;
+}
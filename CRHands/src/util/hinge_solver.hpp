@@ -0,0 +1,34 @@
+#pragma once
+
+#include <luse.h>
+
+/**
+ * Analytic single axis hinge.
+ *
+ * Relative rotation between two grasped parts is decomposed into swing and twist,
+ * and only the twist about the hinge axis is used. The hinge angle is
+ * (angle at grasp start) + direction * (twist change since grasp start).
+ */
+class HingeSolver
+{
+public:
+    /** Signed twist angle (degrees, (-180, 180]) of @a quat about unit @a axis. */
+    static float get_twist_angle(const LQuaternionf& quat, const LVecBase3f& axis);
+
+    /**
+     * @param relative_quat   rotation of moving part relative to fixed part.
+     * @param angle           current hinge angle.
+     * @param direction       1 if hinge angle increases with twist, otherwise -1.
+     */
+    void begin(const LQuaternionf& relative_quat, const LVecBase3f& axis, float angle, float direction);
+
+    /** Return unclamped hinge angle for @a relative_quat. */
+    float solve(const LQuaternionf& relative_quat);
+
+private:
+    LVecBase3f axis_ = LVecBase3f(1, 0, 0);
+    float start_angle_ = 0.0f;
+    float direction_ = 1.0f;
+    float last_twist_ = 0.0f;
+    float accumulated_twist_ = 0.0f;
+};
@@ -0,0 +1,58 @@
+#include "jerk_meter.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+void JerkMeter::add(double time, const LVecBase3f* points, int count)
+{
+    // reset is requested from GUI thread and done by writer
+    if (reset_requested_.exchange(false, std::memory_order_relaxed))
+    {
+        size_ = 0;
+        squared_sum_ = 0.0;
+        frame_count_.store(0, std::memory_order_relaxed);
+        rms_jerk_.store(0.0, std::memory_order_relaxed);
+    }
+
+    count = (std::min)(count, MAX_POINT_COUNT);
+
+    // skip frame with same time (no time to differentiate)
+    if (size_ > 0 && time <= frames_[size_ - 1].time)
+        return;
+
+    if (size_ == static_cast<int>(frames_.size()))
+    {
+        std::rotate(frames_.begin(), frames_.begin() + 1, frames_.end());
+        --size_;
+    }
+
+    Frame& frame = frames_[size_++];
+    frame.time = time;
+    for (int k = 0; k < MAX_POINT_COUNT; ++k)
+        frame.points[k] = k < count ? points[k] : LVecBase3f::zero();
+
+    if (size_ < static_cast<int>(frames_.size()))
+        return;
+
+    // p0 .. p3 -> v1 .. v3 -> a1, a2 -> jerk (equals (p3 - 3 p2 + 3 p1 - p0) / dt^3 if dt is uniform)
+    const double dt1 = frames_[1].time - frames_[0].time;
+    const double dt2 = frames_[2].time - frames_[1].time;
+    const double dt3 = frames_[3].time - frames_[2].time;
+
+    double squared_jerk = 0.0;
+    for (int k = 0; k < count; ++k)
+    {
+        const LVecBase3f v1 = (frames_[1].points[k] - frames_[0].points[k]) / static_cast<float>(dt1);
+        const LVecBase3f v2 = (frames_[2].points[k] - frames_[1].points[k]) / static_cast<float>(dt2);
+        const LVecBase3f v3 = (frames_[3].points[k] - frames_[2].points[k]) / static_cast<float>(dt3);
+        const LVecBase3f a1 = (v2 - v1) / static_cast<float>((dt1 + dt2) * 0.5);
+        const LVecBase3f a2 = (v3 - v2) / static_cast<float>((dt2 + dt3) * 0.5);
+        const LVecBase3f jerk = (a2 - a1) / static_cast<float>((dt1 + 2.0 * dt2 + dt3) * 0.25);
+        squared_jerk += jerk.length_squared();
+    }
+
+    squared_sum_ += squared_jerk;
+    const uint64_t frame_count = frame_count_.load(std::memory_order_relaxed) + 1;
+    frame_count_.store(frame_count, std::memory_order_relaxed);
+    rms_jerk_.store(std::sqrt(squared_sum_ / frame_count), std::memory_order_relaxed);
+}
@@ -0,0 +1,63 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+
+#include <luse.h>
+
+/**
+ * RMS jerk (third time derivative) of points shown frame by frame.
+ *
+ * Judder of rendered hand (repeated or skipped sensor samples) appears as large jerk,
+ * so this compares how smooth a render path is on the same motion.
+ * Jerk is finite difference of last four frames and is summed over points of a frame.
+ */
+class JerkMeter
+{
+public:
+    static constexpr int MAX_POINT_COUNT = 2;
+
+public:
+    /** @param time  seconds. @param count  up to MAX_POINT_COUNT. */
+    void add(double time, const LVecBase3f* points, int count);
+
+    /** RMS of jerk since last reset, in unit of points per second^3. */
+    double get_rms_jerk() const;
+    uint64_t get_frame_count() const;
+
+    void reset();
+
+private:
+    struct Frame
+    {
+        double time;
+        std::array<LVecBase3f, MAX_POINT_COUNT> points;
+    };
+
+    std::array<Frame, 4> frames_;
+    int size_ = 0;
+
+    double squared_sum_ = 0.0;
+
+    std::atomic<double> rms_jerk_{ 0.0 };
+    std::atomic<uint64_t> frame_count_{ 0 };
+    std::atomic<bool> reset_requested_{ false };
+};
+
+// ************************************************************************************************
+
+inline double JerkMeter::get_rms_jerk() const
+{
+    return rms_jerk_.load(std::memory_order_relaxed);
+}
+
+inline uint64_t JerkMeter::get_frame_count() const
+{
+    return frame_count_.load(std::memory_order_relaxed);
+}
+
+inline void JerkMeter::reset()
+{
+    reset_requested_.store(true, std::memory_order_relaxed);
+}
@@ -0,0 +1,58 @@
+#include "joint_write_cache.hpp"
+
+#include <cmath>
+
+JointWriteCache::JointWriteCache()
+{
+    set_epsilons(0.05f, 0.0001f);
+    reset();
+}
+
+void JointWriteCache::set_epsilons(float angular_epsilon, float linear_epsilon)
+{
+    // angle between q1 and q2 = 2 * acos(|dot(q1, q2)|)
+    const float half_angle_rad = angular_epsilon * 0.5f * static_cast<float>(std::acos(-1.0)) / 180.0f;
+    min_rotation_dot_ = std::cos(half_angle_rad);
+    linear_epsilon_squared_ = linear_epsilon * linear_epsilon;
+}
+
+bool JointWriteCache::update_rotation(int joint_index, const LQuaternionf& quat)
+{
+    if (has_rotation_[joint_index] && std::abs(rotations_[joint_index].dot(quat)) >= min_rotation_dot_)
+        return count(false);
+
+    rotations_[joint_index] = quat;
+    has_rotation_[joint_index] = true;
+    return count(true);
+}
+
+bool JointWriteCache::update_position(int joint_index, const LVecBase3f& pos)
+{
+    if (has_position_[joint_index] && (positions_[joint_index] - pos).length_squared() <= linear_epsilon_squared_)
+        return count(false);
+
+    positions_[joint_index] = pos;
+    has_position_[joint_index] = true;
+    return count(true);
+}
+
+void JointWriteCache::reset()
+{
+    has_rotation_.fill(false);
+    has_position_.fill(false);
+}
+
+void JointWriteCache::reset_counters()
+{
+    written_count_.store(0, std::memory_order_relaxed);
+    skipped_count_.store(0, std::memory_order_relaxed);
+}
+
+bool JointWriteCache::count(bool written)
+{
+    if (written)
+        written_count_.fetch_add(1, std::memory_order_relaxed);
+    else
+        skipped_count_.fetch_add(1, std::memory_order_relaxed);
+    return written;
+}
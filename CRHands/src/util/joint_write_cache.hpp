@@ -0,0 +1,69 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+
+#include <luse.h>
+
+/**
+ * Last written rotation and position of hand joints.
+ *
+ * Render paths ask this cache before writing a joint to scene graph,
+ * and the write is skipped if the joint moved less than epsilon (sensor noise).
+ * Written and skipped counts are kept; the effect on frame time is not measured.
+ *
+ * Only writes relative to the parent of the joint may use this cache. A write in world space
+ * (or relative to another node) depends on ancestors, which can move while the value stays the same.
+ * Call reset() whenever joints are written without this cache (calibration, session replay).
+ */
+class JointWriteCache
+{
+public:
+    static constexpr int JOINT_COUNT = 44;
+
+public:
+    JointWriteCache();
+
+    /** @param angular_epsilon  degrees. @param linear_epsilon  meters. */
+    void set_epsilons(float angular_epsilon, float linear_epsilon);
+
+    /** Return true and store @a quat (relative to parent) if it differs from last written rotation of @a joint_index. */
+    bool update_rotation(int joint_index, const LQuaternionf& quat);
+
+    /** Return true and store @a pos (relative to parent) if it differs from last written position of @a joint_index. */
+    bool update_position(int joint_index, const LVecBase3f& pos);
+
+    /** Forget last written values, so next updates are always written. */
+    void reset();
+
+    uint64_t get_written_count() const;
+    uint64_t get_skipped_count() const;
+    void reset_counters();
+
+private:
+    bool count(bool written);
+
+    float min_rotation_dot_;
+    float linear_epsilon_squared_;
+
+    std::array<LQuaternionf, JOINT_COUNT> rotations_;
+    std::array<LVecBase3f, JOINT_COUNT> positions_;
+    std::array<bool, JOINT_COUNT> has_rotation_;
+    std::array<bool, JOINT_COUNT> has_position_;
+
+    std::atomic<uint64_t> written_count_{ 0 };
+    std::atomic<uint64_t> skipped_count_{ 0 };
+};
+
+// ************************************************************************************************
+
+inline uint64_t JointWriteCache::get_written_count() const
+{
+    return written_count_.load(std::memory_order_relaxed);
+}
+
+inline uint64_t JointWriteCache::get_skipped_count() const
+{
+    return skipped_count_.load(std::memory_order_relaxed);
+}
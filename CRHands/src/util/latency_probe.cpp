@@ -0,0 +1,158 @@
+#include "latency_probe.hpp"
+
+#include <algorithm>
+
+namespace {
+
+const char* const latency_stage_names[LATENCY_STAGE_COUNT] = {
+    "Callback",
+    "Retarget",
+    "Scene Write",
+    "Publish",
+    "Physics",
+    "Grasp",
+};
+
+// stage which should be marked before each stage (-1 = injection)
+const int previous_latency_stages[LATENCY_STAGE_COUNT] = {
+    -1,
+    LATENCY_STAGE_CALLBACK,
+    LATENCY_STAGE_RETARGET,
+    LATENCY_STAGE_SCENE_WRITE,
+    LATENCY_STAGE_SCENE_WRITE,
+    LATENCY_STAGE_PHYSICS,
+};
+
+LatencyProbe latency_probe;
+
+}
+
+const char* get_latency_stage_name(LatencyStage stage)
+{
+    return latency_stage_names[stage];
+}
+
+LatencyProbe& get_latency_probe()
+{
+    return latency_probe;
+}
+
+// ************************************************************************************************
+
+bool LatencyProbe::begin_pulse(Clock::time_point now, const Markers& markers)
+{
+    if (is_pulse_in_flight())
+        return false;
+
+    for (auto&& mark: marks_)
+        mark.store(UNMARKED, std::memory_order_relaxed);
+    inject_time_ = now;
+    markers_ = markers;
+    is_pulse_in_scene_.store(false, std::memory_order_relaxed);
+
+    is_in_flight_.store(true, std::memory_order_release);
+    return true;
+}
+
+void LatencyProbe::mark(LatencyStage stage)
+{
+    if (!is_pulse_in_flight())
+        return;
+
+    const int previous = previous_latency_stages[stage];
+    if (previous >= 0 && marks_[previous].load(std::memory_order_acquire) == UNMARKED)
+        return;
+
+    // first handling wins
+    int64_t expected = UNMARKED;
+    marks_[stage].compare_exchange_strong(expected, get_elapsed_ns(Clock::now()), std::memory_order_acq_rel);
+}
+
+void LatencyProbe::mark(LatencyStage stage, const Markers& markers)
+{
+    if (is_pulse_markers(markers))
+        mark(stage);
+}
+
+void LatencyProbe::mark_scene_write(const Markers& markers)
+{
+    const bool is_pulse_in_scene = is_pulse_markers(markers);
+    is_pulse_in_scene_.store(is_pulse_in_scene, std::memory_order_release);
+
+    if (is_pulse_in_scene)
+        mark(LATENCY_STAGE_SCENE_WRITE);
+}
+
+void LatencyProbe::mark_if_scene_has_pulse(LatencyStage stage)
+{
+    if (is_pulse_in_scene_.load(std::memory_order_acquire))
+        mark(stage);
+}
+
+bool LatencyProbe::is_pulse_markers(const Markers& markers) const
+{
+    // markers are written before in-flight flag
+    if (!is_pulse_in_flight())
+        return false;
+
+    for (size_t k = 0; k < markers.size(); ++k)
+    {
+        if (!markers[k].almost_equal(markers_[k], MARKER_TOLERANCE))
+            return false;
+    }
+
+    return true;
+}
+
+bool LatencyProbe::update(Clock::time_point now)
+{
+    if (!is_pulse_in_flight())
+        return false;
+
+    std::array<int64_t, LATENCY_STAGE_COUNT> marks;
+    bool is_all_marked = true;
+    for (int k = 0; k < LATENCY_STAGE_COUNT; ++k)
+    {
+        marks[k] = marks_[k].load(std::memory_order_acquire);
+        is_all_marked = is_all_marked && marks[k] != UNMARKED;
+    }
+
+    if (!is_all_marked && now - inject_time_ < timeout_)
+        return false;
+
+    is_in_flight_.store(false, std::memory_order_release);
+
+    int64_t last_mark = UNMARKED;
+    for (int k = 0; k < LATENCY_STAGE_COUNT; ++k)
+    {
+        if (marks[k] == UNMARKED)
+        {
+            missed_counts_[k].fetch_add(1, std::memory_order_relaxed);
+            continue;
+        }
+
+        const int previous = previous_latency_stages[k];
+        const int64_t previous_mark = previous >= 0 ? marks[previous] : 0;
+        stage_histograms_[k].record(static_cast<uint64_t>((std::max)(marks[k] - previous_mark, int64_t(0))));
+
+        last_mark = (std::max)(last_mark, marks[k]);
+    }
+
+    if (last_mark != UNMARKED)
+        end_to_end_histogram_.record(static_cast<uint64_t>(last_mark));
+
+    pulse_count_.fetch_add(1, std::memory_order_relaxed);
+
+    return true;
+}
+
+void LatencyProbe::reset()
+{
+    for (auto&& histogram: stage_histograms_)
+        histogram.reset();
+    end_to_end_histogram_.reset();
+
+    pulse_count_.store(0, std::memory_order_relaxed);
+    for (auto&& count: missed_counts_)
+        count.store(0, std::memory_order_relaxed);
+}
@@ -0,0 +1,144 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+
+#include <luse.h>
+
+#include "util/stage_profiler.hpp"
+
+// End-to-end latency of a synthetic input pulse through hand pipeline.
+//
+// A pulse source injects a marked pose step into the device memory of the hand (begin_pulse),
+// and each stage marks the time it first handles the pulse. A stage is marked only after
+// its previous stage, so a stage running before the pulse arrives is not counted.
+// Stages which see wrist poses pass them as markers, and are marked only if they match the injected
+// wrists, so a stage running without the pulse (or after a device overwrote it) is not counted.
+// Scene write keeps whether the scene has the pulse, so physics step is marked by it
+// without reading scene graph from physics thread.
+// The pulse finishes when all stages are marked or timeout expires, and time from
+// previous stage (per stage) and from injection to last stage (end-to-end) is recorded
+// to lock-free histograms, which can be read from any thread.
+
+enum LatencyStage
+{
+    LATENCY_STAGE_CALLBACK = 0,     ///< device memory callback of hand with the pulse (from injection)
+    LATENCY_STAGE_RETARGET,         ///< device poses are converted to joint poses
+    LATENCY_STAGE_SCENE_WRITE,      ///< joint models are written to scene graph
+    LATENCY_STAGE_PUBLISH,          ///< UpdateAvatarMemoryObject of published poses (from scene write)
+    LATENCY_STAGE_PHYSICS,          ///< first physics step while wrists in scene (followed by particles) have the pulse
+    LATENCY_STAGE_GRASP,            ///< first grasp decision (from physics step)
+
+    LATENCY_STAGE_COUNT,
+};
+
+const char* get_latency_stage_name(LatencyStage stage);
+
+class LatencyProbe
+{
+public:
+    using Clock = std::chrono::steady_clock;
+
+    /** Wrist positions of left and right, in device space (parent of hand model). */
+    using Markers = std::array<LVecBase3f, 2>;
+
+    static constexpr float MARKER_TOLERANCE = 0.0001f;
+
+public:
+    void set_timeout(Clock::duration timeout);
+
+    /** Start a pulse injected at @a now with wrists at @a markers. Return false if a pulse is in flight. */
+    bool begin_pulse(Clock::time_point now, const Markers& markers);
+    bool is_pulse_in_flight() const;
+
+    /** Mark @a stage of the pulse in flight at now. */
+    void mark(LatencyStage stage);
+
+    /** Mark @a stage if @a markers (wrists which the stage sees) are the injected ones. */
+    void mark(LatencyStage stage, const Markers& markers);
+
+    /** Mark scene write if @a markers (wrists written to scene) are the injected ones, and keep whether scene has the pulse. */
+    void mark_scene_write(const Markers& markers);
+
+    /** Mark @a stage if wrists of last scene write are the injected ones. For stages which run on the scene from other threads. */
+    void mark_if_scene_has_pulse(LatencyStage stage);
+
+    /** Finish the pulse if all stages are marked or it timed out. Return true if finished. */
+    bool update(Clock::time_point now);
+
+    /** Time from previous stage. */
+    StageHistogram& get_stage_histogram(LatencyStage stage);
+
+    /** Time from injection to last marked stage. */
+    StageHistogram& get_end_to_end_histogram();
+
+    uint64_t get_pulse_count() const;
+
+    /** Pulses which finished without @a stage marked. */
+    uint64_t get_missed_count(LatencyStage stage) const;
+
+    void reset();
+
+private:
+    static constexpr int64_t UNMARKED = -1;
+
+    int64_t get_elapsed_ns(Clock::time_point time) const;
+    bool is_pulse_markers(const Markers& markers) const;
+
+    Clock::duration timeout_ = std::chrono::milliseconds(200);
+    Clock::time_point inject_time_;
+    Markers markers_;
+
+    std::atomic<bool> is_in_flight_{ false };
+    std::atomic<bool> is_pulse_in_scene_{ false };
+
+    // time from injection (ns)
+    std::array<std::atomic<int64_t>, LATENCY_STAGE_COUNT> marks_ = {};
+
+    std::array<StageHistogram, LATENCY_STAGE_COUNT> stage_histograms_;
+    StageHistogram end_to_end_histogram_;
+
+    std::atomic<uint64_t> pulse_count_{ 0 };
+    std::array<std::atomic<uint64_t>, LATENCY_STAGE_COUNT> missed_counts_ = {};
+};
+
+LatencyProbe& get_latency_probe();
+
+// ************************************************************************************************
+
+inline void LatencyProbe::set_timeout(Clock::duration timeout)
+{
+    timeout_ = timeout;
+}
+
+inline bool LatencyProbe::is_pulse_in_flight() const
+{
+    return is_in_flight_.load(std::memory_order_acquire);
+}
+
+inline StageHistogram& LatencyProbe::get_stage_histogram(LatencyStage stage)
+{
+    return stage_histograms_[stage];
+}
+
+inline StageHistogram& LatencyProbe::get_end_to_end_histogram()
+{
+    return end_to_end_histogram_;
+}
+
+inline uint64_t LatencyProbe::get_pulse_count() const
+{
+    return pulse_count_.load(std::memory_order_relaxed);
+}
+
+inline uint64_t LatencyProbe::get_missed_count(LatencyStage stage) const
+{
+    return missed_counts_[stage].load(std::memory_order_relaxed);
+}
+
+inline int64_t LatencyProbe::get_elapsed_ns(Clock::time_point time) const
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(time - inject_time_).count();
+}
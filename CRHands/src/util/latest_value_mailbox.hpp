@@ -0,0 +1,65 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <type_traits>
+
+/**
+ * Lock-free mailbox of newest value for one writer thread and one reader thread (triple buffer).
+ *
+ * Writer and reader never wait for each other. Reader always gets a complete value,
+ * and values written between two reads are dropped except the newest one.
+ */
+template <typename T>
+class LatestValueMailbox
+{
+    static_assert(std::is_trivially_copyable<T>::value, "Value should be trivially copyable.");
+
+public:
+    LatestValueMailbox();
+
+    void write(const T& value);
+
+    /** Copy newest value to @a out. @return false if nothing is written since last read. */
+    bool read(T& out);
+
+private:
+    static constexpr uint8_t INDEX_MASK = 0x3;
+    static constexpr uint8_t NEW_FLAG = 0x4;
+
+    std::array<T, 3> buffers_;
+
+    // index of buffer shared between writer and reader, and flag of new value
+    std::atomic<uint8_t> middle_{ 1 };
+
+    uint8_t write_index_ = 0;
+    uint8_t read_index_ = 2;
+};
+
+// ************************************************************************************************
+
+template <typename T>
+LatestValueMailbox<T>::LatestValueMailbox() : buffers_{}
+{
+}
+
+template <typename T>
+void LatestValueMailbox<T>::write(const T& value)
+{
+    buffers_[write_index_] = value;
+    const uint8_t old_middle = middle_.exchange(static_cast<uint8_t>(write_index_ | NEW_FLAG), std::memory_order_acq_rel);
+    write_index_ = old_middle & INDEX_MASK;
+}
+
+template <typename T>
+bool LatestValueMailbox<T>::read(T& out)
+{
+    if ((middle_.load(std::memory_order_relaxed) & NEW_FLAG) == 0)
+        return false;
+
+    const uint8_t old_middle = middle_.exchange(read_index_, std::memory_order_acq_rel);
+    read_index_ = old_middle & INDEX_MASK;
+    out = buffers_[read_index_];
+    return true;
+}
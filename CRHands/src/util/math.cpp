@@ -1,5 +1,7 @@
 #include "math.hpp"
 
+#include <cmath>
+
 LVecBase3 rotate_pos_by_quat(const LVecBase3& pos, const LQuaternionf& quat)
 {
 	LQuaternionf m_quat = quat;
@@ -25,4 +27,32 @@ float dist_two_vector(const LVecBase3& v1, const LVecBase3& v2)
 	float dist = (float)sqrt(vx * vx + vy * vy + vz * vz);
 
 	return dist;
-}
\ No newline at end of file
+}
+
+LQuaternionf slerp_quat(const LQuaternionf& from, const LQuaternionf& to, float t)
+{
+	// q and -q are same rotation, so take shorter arc
+	float cos_angle = from.dot(to);
+	LQuaternionf target = to;
+	if (cos_angle < 0.0f)
+	{
+		cos_angle = -cos_angle;
+		target = -to;
+	}
+
+	float from_weight = 1.0f - t;
+	float to_weight = t;
+
+	// linear interpolation is enough for close rotations and avoids division by sin(0)
+	if (cos_angle < 0.9995f)
+	{
+		const float angle = std::acos(cos_angle);
+		const float inv_sin_angle = 1.0f / std::sin(angle);
+		from_weight = std::sin((1.0f - t) * angle) * inv_sin_angle;
+		to_weight = std::sin(t * angle) * inv_sin_angle;
+	}
+
+	LQuaternionf result = from * from_weight + target * to_weight;
+	result.normalize();
+	return result;
+}
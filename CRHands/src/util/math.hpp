@@ -3,4 +3,7 @@
 #include <luse.h>
 
 LVecBase3 rotate_pos_by_quat(const LVecBase3& pos, const LQuaternionf& quat);
-float dist_two_vector(const LVecBase3& v1, const LVecBase3& v2);
\ No newline at end of file
+float dist_two_vector(const LVecBase3& v1, const LVecBase3& v2);
+
+/** Spherical interpolation along shorter arc. @param t  [0, 1] */
+LQuaternionf slerp_quat(const LQuaternionf& from, const LQuaternionf& to, float t);
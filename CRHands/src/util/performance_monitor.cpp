@@ -0,0 +1,94 @@
+#include "performance_monitor.hpp"
+
+#include <fstream>
+#include <thread>
+#include <vector>
+
+#include <spdlog/logger.h>
+
+extern spdlog::logger* global_logger;
+
+PerformanceMonitor::PerformanceMonitor() : start_time_(std::chrono::steady_clock::now())
+{
+}
+
+double PerformanceMonitor::get_time() const
+{
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start_time_).count();
+}
+
+void PerformanceMonitor::record_frame()
+{
+    const double now = get_time();
+
+    if (last_frame_time_ >= 0.0)
+    {
+        FrameSample sample;
+        sample.time = now;
+        sample.frame_ms = static_cast<float>((now - last_frame_time_) * 1000.0);
+        sample.allocation_count = static_cast<uint32_t>(frame_allocation_scope_.get_count());
+        frame_samples_.push(sample);
+    }
+
+    last_frame_time_ = now;
+    frame_allocation_scope_.restart();
+}
+
+void PerformanceMonitor::record_physics_step()
+{
+    const double now = get_time();
+
+    if (last_physics_step_time_ >= 0.0)
+    {
+        PhysicsSample sample;
+        sample.time = now;
+        sample.step_ms = static_cast<float>((now - last_physics_step_time_) * 1000.0);
+        sample.touched_body_count = step_touched_body_count_.exchange(0, std::memory_order_relaxed);
+        sample.contact_count = step_contact_count_.exchange(0, std::memory_order_relaxed);
+        physics_samples_.push(sample);
+    }
+
+    last_physics_step_time_ = now;
+}
+
+void PerformanceMonitor::add_touched_body(uint32_t contact_count)
+{
+    step_touched_body_count_.fetch_add(1, std::memory_order_relaxed);
+    step_contact_count_.fetch_add(contact_count, std::memory_order_relaxed);
+}
+
+void PerformanceMonitor::dump_csv_async(const std::string& file_path, double seconds) const
+{
+    const double begin_time = get_time() - seconds;
+
+    std::vector<FrameSample> frame_samples;
+    frame_samples_.copy_latest(frame_samples);
+
+    std::vector<PhysicsSample> physics_samples;
+    physics_samples_.copy_latest(physics_samples);
+
+    std::thread([file_path, begin_time, frame_samples = std::move(frame_samples), physics_samples = std::move(physics_samples)]() {
+        std::ofstream file(file_path);
+        if (!file)
+        {
+            global_logger->error("Failed to open performance CSV file: {}", file_path);
+            return;
+        }
+
+        file << "source,time_s,frame_ms,allocations,physics_step_ms,touched_bodies,contacts\n";
+
+        for (const auto& sample: frame_samples)
+        {
+            if (sample.time >= begin_time)
+                file << "frame," << sample.time << ',' << sample.frame_ms << ',' << sample.allocation_count << ",,,\n";
+        }
+
+        for (const auto& sample: physics_samples)
+        {
+            if (sample.time >= begin_time)
+                file << "physics," << sample.time << ",,," << sample.step_ms << ',' << sample.touched_body_count << ',' << sample.contact_count << '\n';
+        }
+
+        global_logger->info("Performance samples are written to {}", file_path);
+    }).detach();
+}
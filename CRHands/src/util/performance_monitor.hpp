@@ -0,0 +1,82 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <string>
+
+#include "util/allocation_counter.hpp"
+#include "util/sample_ring_buffer.hpp"
+
+/**
+ * Collect frame and physics step samples into ring buffers.
+ *
+ * Each buffer has one writer (render thread / physics thread), and GUI reads copies of them,
+ * so recording and reading never block each other.
+ */
+class PerformanceMonitor
+{
+public:
+    struct FrameSample
+    {
+        double time;
+        float frame_ms;
+        uint32_t allocation_count;      ///< operator new calls of render thread, if counting is available
+    };
+
+    struct PhysicsSample
+    {
+        double time;
+        float step_ms;
+        uint32_t touched_body_count;    ///< bodies touched by hand interactors, not all bodies awake in physics
+        uint32_t contact_count;
+    };
+
+    static constexpr std::size_t SAMPLE_CAPACITY = 8192;
+    using FrameSampleBuffer = SampleRingBuffer<FrameSample, SAMPLE_CAPACITY>;
+    using PhysicsSampleBuffer = SampleRingBuffer<PhysicsSample, SAMPLE_CAPACITY>;
+
+public:
+    PerformanceMonitor();
+
+    /** Seconds since this monitor is created. */
+    double get_time() const;
+
+    /** Call once per rendering frame, in the thread which created this monitor. */
+    void record_frame();
+
+    /** Call once per physics step. */
+    void record_physics_step();
+
+    /** Call from physics listeners when a body is touched by hand interactors. */
+    void add_touched_body(uint32_t contact_count);
+
+    const FrameSampleBuffer& get_frame_samples() const;
+    const PhysicsSampleBuffer& get_physics_samples() const;
+
+    /** Write samples of last @a seconds to CSV file in background thread. */
+    void dump_csv_async(const std::string& file_path, double seconds) const;
+
+private:
+    const std::chrono::steady_clock::time_point start_time_;
+
+    FrameSampleBuffer frame_samples_;
+    double last_frame_time_ = -1.0;
+    AllocationCountScope frame_allocation_scope_;
+
+    PhysicsSampleBuffer physics_samples_;
+    double last_physics_step_time_ = -1.0;
+    std::atomic<uint32_t> step_touched_body_count_{ 0 };
+    std::atomic<uint32_t> step_contact_count_{ 0 };
+};
+
+// ************************************************************************************************
+
+inline const PerformanceMonitor::FrameSampleBuffer& PerformanceMonitor::get_frame_samples() const
+{
+    return frame_samples_;
+}
+
+inline const PerformanceMonitor::PhysicsSampleBuffer& PerformanceMonitor::get_physics_samples() const
+{
+    return physics_samples_;
+}
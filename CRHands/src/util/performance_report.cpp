@@ -0,0 +1,204 @@
+#include "performance_report.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+namespace {
+
+using Path = boost::property_tree::ptree::path_type;
+
+// metric names can have '.', so paths use '/' separator
+Path make_path(const std::string& key)
+{
+    return Path(key, '/');
+}
+
+double get_percentile(const std::vector<double>& sorted_values, double ratio)
+{
+    if (sorted_values.empty())
+        return 0.0;
+    const size_t index = static_cast<size_t>(ratio * (sorted_values.size() - 1) + 0.5);
+    return sorted_values[index];
+}
+
+// midpoint of bucket in microseconds. last bucket with samples is limited by max, like percentiles.
+double get_bucket_midpoint_us(const StageHistogram::Snapshot& snapshot, int index)
+{
+    const uint64_t lower = StageHistogram::get_bucket_lower_bound(index);
+    const uint64_t upper = (std::min)(StageHistogram::get_bucket_upper_bound(index), (std::max)(snapshot.max_ns, lower));
+    return (lower + (upper - lower) * 0.5) / 1000.0;
+}
+
+}
+
+PerformanceReport::MetricSummary PerformanceReport::summarize(const StageHistogram::Snapshot& snapshot)
+{
+    MetricSummary summary;
+    summary.count = snapshot.count;
+    summary.mean = snapshot.get_mean_ns() / 1000.0;
+    summary.p50 = snapshot.get_percentile_ns(0.50) / 1000.0;
+    summary.p95 = snapshot.get_percentile_ns(0.95) / 1000.0;
+    summary.max = snapshot.max_ns / 1000.0;
+
+    // variance around mean of bucket midpoints, so that both use the same value for each sample
+    uint64_t bucket_total = 0;
+    double midpoint_sum = 0.0;
+    for (int k = 0; k < StageHistogram::BUCKET_COUNT; ++k)
+    {
+        midpoint_sum += get_bucket_midpoint_us(snapshot, k) * snapshot.buckets[k];
+        bucket_total += snapshot.buckets[k];
+    }
+
+    const double midpoint_mean = bucket_total > 0 ? midpoint_sum / bucket_total : 0.0;
+    double square_sum = 0.0;
+    for (int k = 0; k < StageHistogram::BUCKET_COUNT; ++k)
+    {
+        if (snapshot.buckets[k] == 0)
+            continue;
+        const double diff = get_bucket_midpoint_us(snapshot, k) - midpoint_mean;
+        square_sum += diff * diff * snapshot.buckets[k];
+    }
+    summary.stddev = bucket_total > 1 ? std::sqrt(square_sum / (bucket_total - 1)) : 0.0;
+
+    return summary;
+}
+
+PerformanceReport::MetricSummary PerformanceReport::summarize(std::vector<double>& values)
+{
+    MetricSummary summary;
+    if (values.empty())
+        return summary;
+
+    std::sort(values.begin(), values.end());
+
+    double sum = 0.0;
+    for (double value: values)
+        sum += value;
+
+    summary.count = values.size();
+    summary.mean = sum / values.size();
+
+    double square_sum = 0.0;
+    for (double value: values)
+        square_sum += (value - summary.mean) * (value - summary.mean);
+    summary.stddev = values.size() > 1 ? std::sqrt(square_sum / (values.size() - 1)) : 0.0;
+
+    summary.p50 = get_percentile(values, 0.50);
+    summary.p95 = get_percentile(values, 0.95);
+    summary.max = values.back();
+
+    return summary;
+}
+
+void PerformanceReport::add_metric(const std::string& scenario, const std::string& metric, const MetricSummary& summary)
+{
+    scenarios_[scenario][metric] = summary;
+}
+
+std::vector<PerformanceReport::Regression> PerformanceReport::compare(const PerformanceReport& baseline, const Thresholds& thresholds) const
+{
+    std::vector<Regression> regressions;
+
+    for (const auto& scenario: scenarios_)
+    {
+        auto baseline_scenario = baseline.scenarios_.find(scenario.first);
+        if (baseline_scenario == baseline.scenarios_.end())
+            continue;
+
+        for (const auto& metric: scenario.second)
+        {
+            auto baseline_metric = baseline_scenario->second.find(metric.first);
+            if (baseline_metric == baseline_scenario->second.end())
+                continue;
+
+            const MetricSummary& current = metric.second;
+            const MetricSummary& base = baseline_metric->second;
+            if (current.count == 0 || base.count == 0)
+                continue;
+
+            const double diff = current.mean - base.mean;
+            const double relative = base.mean > 0.0 ? diff / base.mean : (diff > 0.0 ? 1.0 : 0.0);
+
+            // Welch z-score of mean difference
+            const double standard_error = std::sqrt(current.stddev * current.stddev / current.count + base.stddev * base.stddev / base.count);
+            const double z_score = standard_error > 0.0 ? diff / standard_error : (diff > 0.0 ? HUGE_VAL : 0.0);
+
+            if (relative > thresholds.min_relative && z_score > thresholds.z_score)
+                regressions.push_back({ scenario.first, metric.first, base, current, relative, z_score });
+        }
+    }
+
+    return regressions;
+}
+
+std::vector<std::pair<std::string, std::string>> PerformanceReport::find_missing(const PerformanceReport& baseline) const
+{
+    std::vector<std::pair<std::string, std::string>> missing;
+
+    for (const auto& scenario: scenarios_)
+    {
+        auto baseline_scenario = baseline.scenarios_.find(scenario.first);
+        for (const auto& metric: scenario.second)
+        {
+            if (baseline_scenario == baseline.scenarios_.end())
+            {
+                missing.emplace_back(scenario.first, metric.first);
+                continue;
+            }
+
+            auto baseline_metric = baseline_scenario->second.find(metric.first);
+            if (baseline_metric == baseline_scenario->second.end() || baseline_metric->second.count == 0)
+                missing.emplace_back(scenario.first, metric.first);
+        }
+    }
+
+    return missing;
+}
+
+boost::property_tree::ptree PerformanceReport::to_ptree() const
+{
+    boost::property_tree::ptree tree;
+    for (const auto& scenario: scenarios_)
+    {
+        boost::property_tree::ptree scenario_tree;
+        for (const auto& metric: scenario.second)
+        {
+            boost::property_tree::ptree metric_tree;
+            metric_tree.put("count", metric.second.count);
+            metric_tree.put("mean", metric.second.mean);
+            metric_tree.put("stddev", metric.second.stddev);
+            metric_tree.put("p50", metric.second.p50);
+            metric_tree.put("p95", metric.second.p95);
+            metric_tree.put("max", metric.second.max);
+            scenario_tree.put_child(make_path(metric.first), metric_tree);
+        }
+        tree.put_child(make_path("scenarios/" + scenario.first), scenario_tree);
+    }
+    return tree;
+}
+
+PerformanceReport PerformanceReport::from_ptree(const boost::property_tree::ptree& tree)
+{
+    PerformanceReport report;
+
+    auto scenarios = tree.get_child_optional("scenarios");
+    if (!scenarios)
+        return report;
+
+    for (const auto& scenario: *scenarios)
+    {
+        for (const auto& metric: scenario.second)
+        {
+            MetricSummary summary;
+            summary.count = metric.second.get("count", uint64_t(0));
+            summary.mean = metric.second.get("mean", 0.0);
+            summary.stddev = metric.second.get("stddev", 0.0);
+            summary.p50 = metric.second.get("p50", 0.0);
+            summary.p95 = metric.second.get("p95", 0.0);
+            summary.max = metric.second.get("max", 0.0);
+            report.add_metric(scenario.first, metric.first, summary);
+        }
+    }
+
+    return report;
+}
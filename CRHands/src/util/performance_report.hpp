@@ -0,0 +1,80 @@
+#pragma once
+
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <boost/property_tree/ptree.hpp>
+
+#include "util/stage_profiler.hpp"
+
+/**
+ * Summary of benchmark metrics per scenario, and comparison with a baseline report.
+ *
+ * Report is JSON of boost property tree:
+ * { "scenarios": { <scenario>: { <metric>: { "count", "mean", "stddev", "p50", "p95", "max" } } } }
+ *
+ * A metric regresses when its mean is larger than the baseline by both
+ * relative ratio (min_relative) and Welch z-score (z_score), so noise of short runs and
+ * tiny differences of long runs are not reported.
+ */
+class PerformanceReport
+{
+public:
+    struct MetricSummary
+    {
+        uint64_t count = 0;
+        double mean = 0.0;
+        double stddev = 0.0;
+        double p50 = 0.0;
+        double p95 = 0.0;
+        double max = 0.0;
+    };
+
+    struct Thresholds
+    {
+        double min_relative = 0.05;
+        double z_score = 3.0;
+    };
+
+    struct Regression
+    {
+        std::string scenario;
+        std::string metric;
+        MetricSummary baseline;
+        MetricSummary current;
+        double relative;
+        double z_score;
+    };
+
+public:
+    /** Summarize stage histogram in microseconds. */
+    static MetricSummary summarize(const StageHistogram::Snapshot& snapshot);
+
+    /** @param values  sorted in place */
+    static MetricSummary summarize(std::vector<double>& values);
+
+    void add_metric(const std::string& scenario, const std::string& metric, const MetricSummary& summary);
+
+    /** Metrics missing in @a baseline are skipped. */
+    std::vector<Regression> compare(const PerformanceReport& baseline, const Thresholds& thresholds) const;
+
+    /** (scenario, metric) of this report which @a baseline does not have or has no sample of. */
+    std::vector<std::pair<std::string, std::string>> find_missing(const PerformanceReport& baseline) const;
+
+    boost::property_tree::ptree to_ptree() const;
+    static PerformanceReport from_ptree(const boost::property_tree::ptree& tree);
+
+    bool empty() const;
+
+private:
+    std::map<std::string, std::map<std::string, MetricSummary>> scenarios_;
+};
+
+// ************************************************************************************************
+
+inline bool PerformanceReport::empty() const
+{
+    return scenarios_.empty();
+}
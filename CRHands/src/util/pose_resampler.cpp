@@ -0,0 +1,93 @@
+#include "pose_resampler.hpp"
+
+#include <algorithm>
+
+#include "math.hpp"
+
+bool PoseResampler::commit_input(Clock::time_point time)
+{
+    const Clock::time_point last_input_time = last_input_time_;
+    last_input_time_ = time;
+
+    Clock::time_point stamp = time;
+    if (size_ > 0)
+    {
+        const Sample& newest = get_sample(0);
+        if (newest.quats == input_.quats && newest.positions == input_.positions)
+            return false;
+
+        // time between first sights of samples, smoothed
+        const double interval = std::chrono::duration<double>(time - newest_seen_time_).count();
+        const double old_interval = sample_interval_.load(std::memory_order_relaxed);
+        const double new_interval = old_interval == 0.0 ? interval : old_interval * 0.95 + interval * 0.05;
+        sample_interval_.store(new_interval, std::memory_order_relaxed);
+
+        // sample arrived after last read which did not see it
+        const Clock::time_point predicted = newest.time + std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(new_interval));
+        stamp = (std::min)((std::max)(predicted, (std::max)(last_input_time, newest.time)), time);
+    }
+
+    newest_ = (newest_ + 1) % SAMPLE_COUNT;
+    if (size_ < SAMPLE_COUNT)
+        ++size_;
+
+    Sample& sample = samples_[newest_];
+    sample.quats = input_.quats;
+    sample.positions = input_.positions;
+    sample.time = stamp;
+    newest_seen_time_ = time;
+
+    sample_count_.fetch_add(1, std::memory_order_relaxed);
+
+    return true;
+}
+
+bool PoseResampler::evaluate(Clock::time_point time)
+{
+    if (size_ == 0)
+        return false;
+
+    const Sample& newest = get_sample(0);
+    const Clock::time_point target = time + time_offset_;
+
+    if (!enabled_ || target >= newest.time)
+    {
+        output_.quats = newest.quats;
+        output_.positions = newest.positions;
+        return true;
+    }
+
+    // find samples bracketing target time (from newest)
+    int age = 1;
+    while (age < size_ && get_sample(age).time > target)
+        ++age;
+
+    if (age == size_)
+    {
+        const Sample& oldest = get_sample(size_ - 1);
+        output_.quats = oldest.quats;
+        output_.positions = oldest.positions;
+        return true;
+    }
+
+    const Sample& from = get_sample(age);
+    const Sample& to = get_sample(age - 1);
+
+    const float ratio = static_cast<float>(std::chrono::duration<double>(target - from.time).count() /
+        std::chrono::duration<double>(to.time - from.time).count());
+
+    for (int k = 0; k < JOINT_COUNT; ++k)
+    {
+        output_.quats[k] = slerp_quat(from.quats[k], to.quats[k], ratio);
+        output_.positions[k] = from.positions[k] + (to.positions[k] - from.positions[k]) * ratio;
+    }
+
+    return true;
+}
+
+void PoseResampler::reset()
+{
+    newest_ = 0;
+    size_ = 0;
+    sample_interval_.store(0.0, std::memory_order_relaxed);
+}
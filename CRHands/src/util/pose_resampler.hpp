@@ -0,0 +1,137 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+
+#include <luse.h>
+
+/**
+ * Timestamped joint poses of a sensor and evaluation of them at render time.
+ *
+ * Device memory does not carry sample time and is read whenever render callback fires,
+ * so a sample arrives between the previous read and the read where it is first seen to differ.
+ * First sight is quantized to render frames and gives beat judder, so a sample is stamped at
+ * the previous stamp plus mean sample interval, clamped to that arrival window.
+ * If sensor is faster than render, skipped samples are not recovered.
+ * Evaluation time is usually predicted display time minus a delay of about one sensor period,
+ * so that it is bracketed by two samples: rotation uses slerp and position uses lerp.
+ * Before the oldest or after the newest sample, the nearest sample is held (no extrapolation).
+ */
+class PoseResampler
+{
+public:
+    using Clock = std::chrono::steady_clock;
+
+    static constexpr int JOINT_COUNT = 44;
+    static constexpr int SAMPLE_COUNT = 4;
+
+public:
+    /** @param offset  evaluation time relative to now (display latency - interpolation delay). */
+    void set_time_offset(Clock::duration offset);
+    Clock::duration get_time_offset() const;
+
+    /** If disabled (default), evaluate() returns newest sample. */
+    void set_enabled(bool enabled);
+    bool is_enabled() const;
+
+    /** Set input pose of @a joint_index. Call commit_input() after all joints are set. */
+    void set_input(int joint_index, const LQuaternionf& quat, const LVecBase3f& pos);
+
+    /** Push input as new sample if it differs from newest sample. @a time is the time of this read. */
+    bool commit_input(Clock::time_point time);
+
+    /** Evaluate joint poses at @a time + time offset. Return false if there is no sample. */
+    bool evaluate(Clock::time_point time);
+
+    const LQuaternionf& get_quaternion(int joint_index) const;
+    const LVecBase3f& get_position(int joint_index) const;
+
+    /** Forget all samples (ex, tracking is lost). */
+    void reset();
+
+    uint64_t get_sample_count() const;
+
+    /** Mean interval between samples, zero if unknown. */
+    double get_sample_interval() const;
+
+private:
+    struct Sample
+    {
+        Clock::time_point time;
+        std::array<LQuaternionf, JOINT_COUNT> quats;
+        std::array<LVecBase3f, JOINT_COUNT> positions;
+    };
+
+    const Sample& get_sample(int age) const;
+
+    Clock::duration time_offset_ = Clock::duration::zero();
+    bool enabled_ = false;
+
+    Sample input_;
+    Sample output_;
+
+    std::array<Sample, SAMPLE_COUNT> samples_;
+    int newest_ = 0;
+    int size_ = 0;
+
+    Clock::time_point last_input_time_;
+    Clock::time_point newest_seen_time_;
+
+    std::atomic<uint64_t> sample_count_{ 0 };
+    std::atomic<double> sample_interval_{ 0.0 };
+};
+
+// ************************************************************************************************
+
+inline void PoseResampler::set_time_offset(Clock::duration offset)
+{
+    time_offset_ = offset;
+}
+
+inline PoseResampler::Clock::duration PoseResampler::get_time_offset() const
+{
+    return time_offset_;
+}
+
+inline void PoseResampler::set_enabled(bool enabled)
+{
+    enabled_ = enabled;
+}
+
+inline bool PoseResampler::is_enabled() const
+{
+    return enabled_;
+}
+
+inline void PoseResampler::set_input(int joint_index, const LQuaternionf& quat, const LVecBase3f& pos)
+{
+    input_.quats[joint_index] = quat;
+    input_.positions[joint_index] = pos;
+}
+
+inline const LQuaternionf& PoseResampler::get_quaternion(int joint_index) const
+{
+    return output_.quats[joint_index];
+}
+
+inline const LVecBase3f& PoseResampler::get_position(int joint_index) const
+{
+    return output_.positions[joint_index];
+}
+
+inline uint64_t PoseResampler::get_sample_count() const
+{
+    return sample_count_.load(std::memory_order_relaxed);
+}
+
+inline double PoseResampler::get_sample_interval() const
+{
+    return sample_interval_.load(std::memory_order_relaxed);
+}
+
+inline const PoseResampler::Sample& PoseResampler::get_sample(int age) const
+{
+    return samples_[(newest_ - age + SAMPLE_COUNT) % SAMPLE_COUNT];
+}
@@ -0,0 +1,33 @@
+#include "rigid_transform.hpp"
+
+#include <crsf/CRModel/TWorldObject.h>
+
+RigidTransform RigidTransform::from_object(crsf::TWorldObject* object, crsf::TWorldObject* other)
+{
+    return RigidTransform(object->GetQuaternion(other), object->GetPosition(other));
+}
+
+RigidTransform RigidTransform::from_matrix(const LMatrix4f& mat)
+{
+    return RigidTransform(get_rotation(mat), mat.get_row3(3));
+}
+
+LQuaternionf RigidTransform::get_rotation(const LMatrix4f& mat)
+{
+    // Panda composes scale * shear * rotation where forward (y) row has no shear (Z-up right-handed),
+    // so decompose_matrix (and GetQuaternion) takes heading and pitch from y, and roll from x orthogonal to y.
+    const LVecBase3 y = mat.get_row3(1).normalized();
+    LVecBase3 x = mat.get_row3(0);
+    x = (x - y * y.dot(x)).normalized();
+    const LVecBase3 z = x.cross(y);
+
+    LMatrix3f rot_mat;
+    rot_mat.set_row(0, x);
+    rot_mat.set_row(1, y);
+    rot_mat.set_row(2, z);
+
+    LQuaternionf quat;
+    quat.set_from_matrix(rot_mat);
+    quat.normalize();
+    return quat;
+}
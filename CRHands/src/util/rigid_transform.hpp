@@ -0,0 +1,104 @@
+#pragma once
+
+#include <luse.h>
+
+namespace crsf {
+class TWorldObject;
+}
+
+/**
+ * Rigid transform (unit quaternion + translation) using the Panda3D row-vector convention.
+ *
+ * `a * b` applies `a` first and then `b`, same as `LMatrix4f`.
+ * Compose and inverse are closed form, so grasp code does not need `decompose_matrix` or
+ * general 4x4 `invert`.
+ */
+class RigidTransform
+{
+public:
+    RigidTransform() = default;
+    RigidTransform(const LQuaternionf& quat, const LVecBase3& pos);
+
+    /** Get pose of @a object relative to @a other, without scale. */
+    static RigidTransform from_object(crsf::TWorldObject* object, crsf::TWorldObject* other);
+
+    /** Convert affine matrix, removing scale and shear as GetQuaternion does. */
+    static RigidTransform from_matrix(const LMatrix4f& mat);
+
+    /** Rotation of affine matrix without scale and shear, decomposed as Panda decompose_matrix (Z-up right-handed). */
+    static LQuaternionf get_rotation(const LMatrix4f& mat);
+
+    const LQuaternionf& get_quat() const;
+    const LVecBase3& get_pos() const;
+
+    void set_quat(const LQuaternionf& quat);
+    void set_pos(const LVecBase3& pos);
+
+    RigidTransform get_inverse() const;
+
+    LVecBase3 xform_point(const LVecBase3& point) const;
+    LVecBase3 xform_vec(const LVecBase3& vec) const;
+
+    LMatrix4f get_matrix() const;
+
+    RigidTransform operator*(const RigidTransform& other) const;
+
+private:
+    LQuaternionf quat_ = LQuaternionf::ident_quat();
+    LVecBase3 pos_ = LVecBase3(0);
+};
+
+// ************************************************************************************************
+
+inline RigidTransform::RigidTransform(const LQuaternionf& quat, const LVecBase3& pos) : quat_(quat), pos_(pos)
+{
+}
+
+inline const LQuaternionf& RigidTransform::get_quat() const
+{
+    return quat_;
+}
+
+inline const LVecBase3& RigidTransform::get_pos() const
+{
+    return pos_;
+}
+
+inline void RigidTransform::set_quat(const LQuaternionf& quat)
+{
+    quat_ = quat;
+}
+
+inline void RigidTransform::set_pos(const LVecBase3& pos)
+{
+    pos_ = pos;
+}
+
+inline RigidTransform RigidTransform::get_inverse() const
+{
+    const LQuaternionf inv_quat = quat_.conjugate();
+    return RigidTransform(inv_quat, -inv_quat.xform(pos_));
+}
+
+inline LVecBase3 RigidTransform::xform_point(const LVecBase3& point) const
+{
+    return quat_.xform(point) + pos_;
+}
+
+inline LVecBase3 RigidTransform::xform_vec(const LVecBase3& vec) const
+{
+    return quat_.xform(vec);
+}
+
+inline LMatrix4f RigidTransform::get_matrix() const
+{
+    LMatrix4f mat;
+    quat_.extract_to_matrix(mat);
+    mat.set_row(3, pos_);
+    return mat;
+}
+
+inline RigidTransform RigidTransform::operator*(const RigidTransform& other) const
+{
+    return RigidTransform(quat_ * other.quat_, other.quat_.xform(pos_) + other.pos_);
+}
@@ -0,0 +1,112 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <type_traits>
+#include <vector>
+
+/**
+ * Fixed size ring buffer for one writer thread and any number of reader threads.
+ *
+ * Writer never waits for readers. Reader copies the newest samples and drops samples
+ * which are overwritten while copying.
+ */
+template <typename T, std::size_t Capacity>
+class SampleRingBuffer
+{
+    static_assert((Capacity & (Capacity - 1)) == 0, "Capacity should be power of two.");
+    static_assert(std::is_trivially_copyable<T>::value, "Sample should be trivially copyable.");
+
+public:
+    static constexpr std::size_t capacity = Capacity;
+
+    void push(const T& sample);
+
+    /** Copy up to @a max_count newest samples (oldest first) to @a out. */
+    std::size_t copy_latest(std::vector<T>& out, std::size_t max_count = Capacity) const;
+
+    /**
+     * Append samples from @a next_index (total count when last read) to @a out, and advance it.
+     * Call often enough to read samples before they are overwritten.
+     *
+     * @return  the number of samples which are overwritten before reading.
+     */
+    uint64_t append_since(std::vector<T>& out, uint64_t& next_index) const;
+
+    uint64_t get_total_count() const;
+
+private:
+    std::array<T, Capacity> samples_;
+    std::atomic<uint64_t> write_index_{ 0 };
+};
+
+// ************************************************************************************************
+
+template <typename T, std::size_t Capacity>
+inline void SampleRingBuffer<T, Capacity>::push(const T& sample)
+{
+    const uint64_t index = write_index_.load(std::memory_order_relaxed);
+    samples_[index & (Capacity - 1)] = sample;
+    write_index_.store(index + 1, std::memory_order_release);
+}
+
+template <typename T, std::size_t Capacity>
+std::size_t SampleRingBuffer<T, Capacity>::copy_latest(std::vector<T>& out, std::size_t max_count) const
+{
+    out.clear();
+
+    const uint64_t end = write_index_.load(std::memory_order_acquire);
+    const uint64_t count = (std::min)(end, static_cast<uint64_t>((std::min)(max_count, Capacity)));
+    const uint64_t begin = end - count;
+
+    for (uint64_t k = begin; k < end; ++k)
+        out.push_back(samples_[k & (Capacity - 1)]);
+
+    // reads of samples above should not move below the reload of write index
+    std::atomic_thread_fence(std::memory_order_acquire);
+
+    // drop samples overwritten by writer during copy.
+    // writer may be writing sample of new_end, which overwrites sample of (new_end - Capacity).
+    const uint64_t new_end = write_index_.load(std::memory_order_relaxed);
+    if (new_end >= begin + Capacity)
+    {
+        const uint64_t overwritten = (std::min)(new_end - Capacity - begin + 1, count);
+        out.erase(out.begin(), out.begin() + static_cast<std::ptrdiff_t>(overwritten));
+    }
+
+    return out.size();
+}
+
+template <typename T, std::size_t Capacity>
+uint64_t SampleRingBuffer<T, Capacity>::append_since(std::vector<T>& out, uint64_t& next_index) const
+{
+    const uint64_t end = write_index_.load(std::memory_order_acquire);
+    uint64_t begin = (std::max)(next_index, end > Capacity ? end - Capacity : 0);
+    const std::size_t out_begin = out.size();
+
+    for (uint64_t k = begin; k < end; ++k)
+        out.push_back(samples_[k & (Capacity - 1)]);
+
+    std::atomic_thread_fence(std::memory_order_acquire);
+
+    // drop samples overwritten by writer during copy (see copy_latest)
+    const uint64_t new_end = write_index_.load(std::memory_order_relaxed);
+    if (new_end >= begin + Capacity)
+    {
+        const uint64_t overwritten = (std::min)(new_end - Capacity - begin + 1, end - begin);
+        out.erase(out.begin() + static_cast<std::ptrdiff_t>(out_begin), out.begin() + static_cast<std::ptrdiff_t>(out_begin + overwritten));
+        begin += overwritten;
+    }
+
+    const uint64_t dropped_count = begin - (std::min)(next_index, begin);
+    next_index = end;
+    return dropped_count;
+}
+
+template <typename T, std::size_t Capacity>
+inline uint64_t SampleRingBuffer<T, Capacity>::get_total_count() const
+{
+    return write_index_.load(std::memory_order_acquire);
+}
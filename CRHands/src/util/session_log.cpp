@@ -0,0 +1,476 @@
+#include "session_log.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+
+#include <compress_string.h>
+
+namespace {
+
+constexpr char FILE_MAGIC[4] = { 'C', 'R', 'H', 'S' };
+constexpr char INDEX_MAGIC[4] = { 'C', 'R', 'H', 'I' };
+constexpr uint32_t FILE_VERSION = 2;
+
+// magic, version, steps per chunk
+constexpr uint64_t FILE_HEADER_SIZE = 4 + 4 + 4;
+
+// first step, step count, raw size, compressed size, CRC-32 of compressed data
+constexpr uint64_t CHUNK_HEADER_SIZE = 8 + 4 + 4 + 4 + 4;
+
+// chunk count, chunks (first step, offset, step count)
+constexpr uint64_t INDEX_HEADER_SIZE = 4;
+constexpr uint64_t INDEX_ENTRY_SIZE = 8 + 8 + 4;
+
+// index offset, CRC-32 of index, magic
+constexpr uint64_t FILE_FOOTER_SIZE = 8 + 4 + 4;
+
+uint32_t compute_crc32(const std::string& data)
+{
+    static const auto table = []() {
+        std::array<uint32_t, 256> result;
+        for (uint32_t k = 0; k < 256; ++k)
+        {
+            uint32_t value = k;
+            for (int bit = 0; bit < 8; ++bit)
+                value = (value & 1) ? (0xEDB88320u ^ (value >> 1)) : (value >> 1);
+            result[k] = value;
+        }
+        return result;
+    }();
+
+    uint32_t crc = 0xFFFFFFFFu;
+    for (const char c: data)
+        crc = table[(crc ^ static_cast<uint8_t>(c)) & 0xFF] ^ (crc >> 8);
+    return crc ^ 0xFFFFFFFFu;
+}
+
+template <typename T>
+void put(std::string& out, const T& value)
+{
+    out.append(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+void put(std::string& out, const LVecBase3& vec)
+{
+    put(out, vec[0]);
+    put(out, vec[1]);
+    put(out, vec[2]);
+}
+
+void put(std::string& out, const RigidTransform& transform)
+{
+    put(out, transform.get_pos());
+    const LQuaternionf& quat = transform.get_quat();
+    put(out, quat.get_r());
+    put(out, quat.get_i());
+    put(out, quat.get_j());
+    put(out, quat.get_k());
+}
+
+class ByteReader
+{
+public:
+    ByteReader(const std::string& data, size_t offset) : data_(data), offset_(offset)
+    {
+    }
+
+    template <typename T>
+    bool get(T& value)
+    {
+        if (offset_ + sizeof(T) > data_.size())
+            return false;
+        std::memcpy(&value, data_.data() + offset_, sizeof(T));
+        offset_ += sizeof(T);
+        return true;
+    }
+
+    bool get(LVecBase3& vec)
+    {
+        return get(vec[0]) && get(vec[1]) && get(vec[2]);
+    }
+
+    bool get(RigidTransform& transform)
+    {
+        LVecBase3 pos;
+        float r, i, j, k;
+        if (!get(pos) || !get(r) || !get(i) || !get(j) || !get(k))
+            return false;
+        transform = RigidTransform(LQuaternionf(r, i, j, k), pos);
+        return true;
+    }
+
+    size_t get_offset() const
+    {
+        return offset_;
+    }
+
+private:
+    const std::string& data_;
+    size_t offset_;
+};
+
+void serialize_step(std::string& out, const SessionStep& step)
+{
+    put(out, step.index);
+    put(out, step.time);
+
+    put(out, static_cast<uint32_t>(step.hand_joints.size()));
+    for (const auto& joint: step.hand_joints)
+        put(out, joint);
+
+    put(out, static_cast<uint32_t>(step.bodies.size()));
+    for (const auto& body: step.bodies)
+    {
+        put(out, body.id);
+        put(out, static_cast<uint8_t>(body.is_grasped));
+        put(out, body.pose);
+        put(out, body.linear_velocity);
+        put(out, body.angular_velocity);
+    }
+
+    put(out, static_cast<uint32_t>(step.grasp_events.size()));
+    for (const auto& event: step.grasp_events)
+    {
+        put(out, event.body_id);
+        put(out, static_cast<uint8_t>(event.is_grasped));
+    }
+
+    put(out, step.vibration_masks[0]);
+    put(out, step.vibration_masks[1]);
+}
+
+bool deserialize_step(ByteReader& reader, SessionStep& step)
+{
+    uint32_t count = 0;
+    uint8_t flag = 0;
+
+    if (!reader.get(step.index) || !reader.get(step.time))
+        return false;
+
+    if (!reader.get(count))
+        return false;
+    step.hand_joints.resize(count);
+    for (auto& joint: step.hand_joints)
+    {
+        if (!reader.get(joint))
+            return false;
+    }
+
+    if (!reader.get(count))
+        return false;
+    step.bodies.resize(count);
+    for (auto& body: step.bodies)
+    {
+        if (!reader.get(body.id) || !reader.get(flag) || !reader.get(body.pose) ||
+            !reader.get(body.linear_velocity) || !reader.get(body.angular_velocity))
+            return false;
+        body.is_grasped = flag != 0;
+    }
+
+    if (!reader.get(count))
+        return false;
+    step.grasp_events.resize(count);
+    for (auto& event: step.grasp_events)
+    {
+        if (!reader.get(event.body_id) || !reader.get(flag))
+            return false;
+        event.is_grasped = flag != 0;
+    }
+
+    return reader.get(step.vibration_masks[0]) && reader.get(step.vibration_masks[1]);
+}
+
+}
+
+SessionLogWriter::SessionLogWriter(const std::string& path, uint32_t steps_per_chunk, int compression_level) :
+    file_(path, std::ios::binary | std::ios::trunc), steps_per_chunk_((std::max)(1u, steps_per_chunk)), compression_level_(compression_level)
+{
+    if (!file_)
+        return;
+
+    std::string header;
+    header.append(FILE_MAGIC, sizeof(FILE_MAGIC));
+    put(header, FILE_VERSION);
+    put(header, steps_per_chunk_);
+    file_.write(header.data(), header.size());
+    file_size_ = header.size();
+}
+
+SessionLogWriter::~SessionLogWriter()
+{
+    close();
+}
+
+void SessionLogWriter::write(const SessionStep& step)
+{
+    if (!file_.is_open())
+        return;
+
+    if (chunk_step_count_ == 0)
+        chunk_first_step_ = step.index;
+
+    serialize_step(chunk_buffer_, step);
+    ++chunk_step_count_;
+    ++step_count_;
+
+    if (chunk_step_count_ >= steps_per_chunk_)
+        flush_chunk();
+}
+
+void SessionLogWriter::close()
+{
+    if (!file_.is_open())
+        return;
+
+    flush_chunk();
+
+    const uint64_t index_offset = file_size_;
+
+    std::string index;
+    put(index, static_cast<uint32_t>(chunks_.size()));
+    for (const auto& chunk: chunks_)
+    {
+        put(index, chunk.first_step);
+        put(index, chunk.offset);
+        put(index, chunk.step_count);
+    }
+    const uint32_t index_crc = compute_crc32(index);
+    put(index, index_offset);
+    put(index, index_crc);
+    index.append(INDEX_MAGIC, sizeof(INDEX_MAGIC));
+
+    file_.write(index.data(), index.size());
+    file_size_ += index.size();
+    file_.close();
+}
+
+void SessionLogWriter::flush_chunk()
+{
+    if (chunk_step_count_ == 0)
+        return;
+
+    const std::string compressed = compress_string(chunk_buffer_, compression_level_);
+
+    std::string header;
+    put(header, chunk_first_step_);
+    put(header, chunk_step_count_);
+    put(header, static_cast<uint32_t>(chunk_buffer_.size()));
+    put(header, static_cast<uint32_t>(compressed.size()));
+    put(header, compute_crc32(compressed));
+
+    chunks_.push_back({ chunk_first_step_, file_size_, chunk_step_count_ });
+
+    file_.write(header.data(), header.size());
+    file_.write(compressed.data(), compressed.size());
+    file_.flush();
+    file_size_ += header.size() + compressed.size();
+
+    chunk_buffer_.clear();
+    chunk_step_count_ = 0;
+}
+
+// ************************************************************************************************
+
+SessionLogReader::SessionLogReader(const std::string& path) : file_(path, std::ios::binary)
+{
+    if (!file_)
+        return;
+
+    char magic[4];
+    uint32_t version = 0;
+    if (!file_.read(magic, sizeof(magic)) || std::memcmp(magic, FILE_MAGIC, sizeof(magic)) != 0 ||
+        !file_.read(reinterpret_cast<char*>(&version), sizeof(version)) || version != FILE_VERSION)
+    {
+        file_.close();
+        return;
+    }
+
+    if (!read_index())
+        scan_chunks();
+}
+
+uint64_t SessionLogReader::get_first_step() const
+{
+    return chunks_.empty() ? 0 : chunks_.front().first_step;
+}
+
+uint64_t SessionLogReader::get_last_step() const
+{
+    return chunks_.empty() ? 0 : chunks_.back().first_step + chunks_.back().step_count - 1;
+}
+
+uint64_t SessionLogReader::find_keyframe(uint64_t step) const
+{
+    auto found = std::upper_bound(chunks_.begin(), chunks_.end(), step, [](uint64_t value, const ChunkInfo& chunk) {
+        return value < chunk.first_step;
+    });
+    return found == chunks_.begin() ? get_first_step() : std::prev(found)->first_step;
+}
+
+bool SessionLogReader::seek(uint64_t step)
+{
+    auto found = std::upper_bound(chunks_.begin(), chunks_.end(), step, [](uint64_t value, const ChunkInfo& chunk) {
+        return value < chunk.first_step;
+    });
+    if (found == chunks_.begin())
+        return false;
+
+    const size_t chunk = static_cast<size_t>(std::distance(chunks_.begin(), found) - 1);
+    if (step >= chunks_[chunk].first_step + chunks_[chunk].step_count)
+        return false;
+
+    if (!load_chunk(chunk))
+        return false;
+
+    // skip steps before target in chunk
+    SessionStep skipped;
+    for (uint64_t k = chunks_[chunk].first_step; k < step; ++k)
+    {
+        if (!read(skipped))
+            return false;
+    }
+
+    return true;
+}
+
+bool SessionLogReader::read(SessionStep& step)
+{
+    if (!is_chunk_loaded_ || chunk_read_count_ >= chunks_[loaded_chunk_].step_count)
+    {
+        const size_t next_chunk = is_chunk_loaded_ ? loaded_chunk_ + 1 : 0;
+        if (next_chunk >= chunks_.size() || !load_chunk(next_chunk))
+            return false;
+    }
+
+    ByteReader reader(chunk_buffer_, chunk_read_offset_);
+    if (!deserialize_step(reader, step))
+        return false;
+
+    chunk_read_offset_ = reader.get_offset();
+    ++chunk_read_count_;
+    return true;
+}
+
+bool SessionLogReader::read_index()
+{
+    file_.clear();
+    file_.seekg(0, std::ios::end);
+    const uint64_t file_size = static_cast<uint64_t>(file_.tellg());
+    if (file_size < FILE_HEADER_SIZE + FILE_FOOTER_SIZE)
+        return false;
+
+    uint64_t index_offset = 0;
+    uint32_t index_crc = 0;
+    char magic[4];
+    file_.seekg(file_size - FILE_FOOTER_SIZE);
+    if (!file_.read(reinterpret_cast<char*>(&index_offset), sizeof(index_offset)) ||
+        !file_.read(reinterpret_cast<char*>(&index_crc), sizeof(index_crc)) ||
+        !file_.read(magic, sizeof(magic)) || std::memcmp(magic, INDEX_MAGIC, sizeof(magic)) != 0 ||
+        index_offset < FILE_HEADER_SIZE || index_offset + INDEX_HEADER_SIZE + FILE_FOOTER_SIZE > file_size)
+        return false;
+
+    std::string index(static_cast<size_t>(file_size - FILE_FOOTER_SIZE - index_offset), '\0');
+    file_.seekg(index_offset);
+    if (!file_.read(&index[0], index.size()))
+        return false;
+
+    // partially written or corrupted index is rebuilt by scanning
+    ByteReader reader(index, 0);
+    uint32_t count = 0;
+    if (!reader.get(count) || index.size() != INDEX_HEADER_SIZE + INDEX_ENTRY_SIZE * count || compute_crc32(index) != index_crc)
+        return false;
+
+    chunks_.resize(count);
+    for (auto& chunk: chunks_)
+    {
+        reader.get(chunk.first_step);
+        reader.get(chunk.offset);
+        reader.get(chunk.step_count);
+        if (chunk.offset < FILE_HEADER_SIZE || chunk.offset + CHUNK_HEADER_SIZE > index_offset)
+        {
+            chunks_.clear();
+            return false;
+        }
+    }
+
+    return true;
+}
+
+void SessionLogReader::scan_chunks()
+{
+    chunks_.clear();
+
+    file_.clear();
+    file_.seekg(0, std::ios::end);
+    const uint64_t file_size = static_cast<uint64_t>(file_.tellg());
+
+    uint64_t offset = FILE_HEADER_SIZE;
+    std::string header(CHUNK_HEADER_SIZE, '\0');
+    std::string compressed;
+    while (offset + CHUNK_HEADER_SIZE <= file_size)
+    {
+        file_.seekg(offset);
+        if (!file_.read(&header[0], header.size()))
+            break;
+
+        ByteReader reader(header, 0);
+        ChunkInfo chunk{ 0, offset, 0 };
+        uint32_t raw_size = 0;
+        uint32_t compressed_size = 0;
+        uint32_t compressed_crc = 0;
+        reader.get(chunk.first_step);
+        reader.get(chunk.step_count);
+        reader.get(raw_size);
+        reader.get(compressed_size);
+        reader.get(compressed_crc);
+
+        // stop at truncated chunk
+        const uint64_t next_offset = offset + CHUNK_HEADER_SIZE + compressed_size;
+        if (chunk.step_count == 0 || raw_size == 0 || compressed_size == 0 || next_offset > file_size)
+            break;
+
+        // stop at partially written chunk or index, which is not a chunk
+        compressed.resize(compressed_size);
+        if (!file_.read(&compressed[0], compressed.size()) || compute_crc32(compressed) != compressed_crc)
+            break;
+        if (!chunks_.empty() && chunk.first_step != chunks_.back().first_step + chunks_.back().step_count)
+            break;
+
+        chunks_.push_back(chunk);
+        offset = next_offset;
+    }
+}
+
+bool SessionLogReader::load_chunk(size_t chunk)
+{
+    is_chunk_loaded_ = false;
+
+    std::string header(CHUNK_HEADER_SIZE, '\0');
+    file_.clear();
+    file_.seekg(chunks_[chunk].offset);
+    if (!file_.read(&header[0], header.size()))
+        return false;
+
+    ByteReader reader(header, 8 + 4);
+    uint32_t raw_size = 0;
+    uint32_t compressed_size = 0;
+    uint32_t compressed_crc = 0;
+    reader.get(raw_size);
+    reader.get(compressed_size);
+    reader.get(compressed_crc);
+
+    std::string compressed(compressed_size, '\0');
+    if (!file_.read(&compressed[0], compressed.size()) || compute_crc32(compressed) != compressed_crc)
+        return false;
+
+    chunk_buffer_ = decompress_string(compressed);
+    if (chunk_buffer_.size() != raw_size)
+        return false;
+
+    loaded_chunk_ = chunk;
+    chunk_read_offset_ = 0;
+    chunk_read_count_ = 0;
+    is_chunk_loaded_ = true;
+    return true;
+}
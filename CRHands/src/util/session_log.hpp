@@ -0,0 +1,154 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "util/rigid_transform.hpp"
+
+// Session log of physics steps for replay and verification.
+//
+// File = header, chunks and index of chunks.
+// Each chunk has consecutive steps compressed by zlib, and each step has full state,
+// so the first step of every chunk is a keyframe to start re-simulation.
+// Chunk header has its first step, step count and checksum, so the index can be rebuilt by scanning
+// chunks if the app is stopped before writing the index. Index has its checksum too, and a partially
+// written index is ignored.
+
+struct SessionBodyState
+{
+    uint32_t id;
+    bool is_grasped;
+    RigidTransform pose;            ///< in world
+    LVecBase3 linear_velocity;      ///< m/s
+    LVecBase3 angular_velocity;     ///< rad/s
+};
+
+struct SessionGraspEvent
+{
+    uint32_t body_id;
+    bool is_grasped;                ///< true = grasp, false = release
+};
+
+struct SessionStep
+{
+    uint64_t index = 0;
+    double time = 0.0;                              ///< seconds from start of recording
+
+    std::vector<RigidTransform> hand_joints;        ///< hand input in world
+    std::vector<SessionBodyState> bodies;
+    std::vector<SessionGraspEvent> grasp_events;
+    std::array<uint32_t, 2> vibration_masks = {};   ///< haptic commands of left and right
+};
+
+class SessionLogWriter
+{
+public:
+    SessionLogWriter(const std::string& path, uint32_t steps_per_chunk = 120, int compression_level = 6);
+    ~SessionLogWriter();
+
+    SessionLogWriter(const SessionLogWriter&) = delete;
+    SessionLogWriter& operator=(const SessionLogWriter&) = delete;
+
+    bool is_open() const;
+
+    void write(const SessionStep& step);
+
+    /** Write remaining chunk and index. */
+    void close();
+
+    uint64_t get_step_count() const;
+    uint64_t get_file_size() const;
+
+private:
+    struct ChunkInfo
+    {
+        uint64_t first_step;
+        uint64_t offset;
+        uint32_t step_count;
+    };
+
+    void flush_chunk();
+
+    std::ofstream file_;
+    const uint32_t steps_per_chunk_;
+    const int compression_level_;
+
+    std::string chunk_buffer_;
+    uint64_t chunk_first_step_ = 0;
+    uint32_t chunk_step_count_ = 0;
+
+    std::vector<ChunkInfo> chunks_;
+    uint64_t step_count_ = 0;
+    uint64_t file_size_ = 0;
+};
+
+class SessionLogReader
+{
+public:
+    explicit SessionLogReader(const std::string& path);
+
+    bool is_open() const;
+
+    size_t get_chunk_count() const;
+    uint64_t get_first_step() const;
+    uint64_t get_last_step() const;
+
+    /** Nearest keyframe at or before @a step. */
+    uint64_t find_keyframe(uint64_t step) const;
+
+    /** Move to @a step, and next read() returns it. */
+    bool seek(uint64_t step);
+
+    bool read(SessionStep& step);
+
+private:
+    struct ChunkInfo
+    {
+        uint64_t first_step;
+        uint64_t offset;
+        uint32_t step_count;
+    };
+
+    bool read_index();
+    void scan_chunks();
+    bool load_chunk(size_t chunk);
+
+    std::ifstream file_;
+    std::vector<ChunkInfo> chunks_;
+
+    size_t loaded_chunk_ = 0;
+    std::string chunk_buffer_;
+    size_t chunk_read_offset_ = 0;
+    uint32_t chunk_read_count_ = 0;
+    bool is_chunk_loaded_ = false;
+};
+
+// ************************************************************************************************
+
+inline bool SessionLogWriter::is_open() const
+{
+    return file_.is_open();
+}
+
+inline uint64_t SessionLogWriter::get_step_count() const
+{
+    return step_count_;
+}
+
+inline uint64_t SessionLogWriter::get_file_size() const
+{
+    return file_size_;
+}
+
+inline bool SessionLogReader::is_open() const
+{
+    return file_.is_open() && !chunks_.empty();
+}
+
+inline size_t SessionLogReader::get_chunk_count() const
+{
+    return chunks_.size();
+}
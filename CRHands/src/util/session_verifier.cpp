@@ -0,0 +1,61 @@
+#include "session_verifier.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+namespace {
+
+const float RAD_TO_DEG = 180.0f / static_cast<float>(std::acos(-1.0));
+
+float get_angle_between(const LQuaternionf& a, const LQuaternionf& b)
+{
+    const float dot = (std::min)(std::abs(a.dot(b)), 1.0f);
+    return 2.0f * std::acos(dot) * RAD_TO_DEG;
+}
+
+}
+
+SessionVerifier::SessionVerifier(float position_tolerance, float angle_tolerance) :
+    position_tolerance_(position_tolerance), angle_tolerance_(angle_tolerance)
+{
+}
+
+void SessionVerifier::reset()
+{
+    has_divergence_ = false;
+    divergence_ = {};
+    checked_step_count_ = 0;
+    max_position_error_ = 0.0f;
+}
+
+bool SessionVerifier::check(const SessionStep& recorded, const std::vector<SessionBodyState>& simulated)
+{
+    if (has_divergence_)
+        return true;
+
+    ++checked_step_count_;
+
+    for (const auto& expected: recorded.bodies)
+    {
+        auto found = std::find_if(simulated.begin(), simulated.end(), [&expected](const SessionBodyState& body) {
+            return body.id == expected.id;
+        });
+        if (found == simulated.end())
+            continue;
+
+        const float position_error = (found->pose.get_pos() - expected.pose.get_pos()).length();
+        const float angle_error = get_angle_between(found->pose.get_quat(), expected.pose.get_quat());
+        const bool is_grasp_mismatch = found->is_grasped != expected.is_grasped;
+
+        max_position_error_ = (std::max)(max_position_error_, position_error);
+
+        if (position_error > position_tolerance_ || angle_error > angle_tolerance_ || is_grasp_mismatch)
+        {
+            has_divergence_ = true;
+            divergence_ = { recorded.index, expected.id, position_error, angle_error, is_grasp_mismatch };
+            return false;
+        }
+    }
+
+    return true;
+}
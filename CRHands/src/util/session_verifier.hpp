@@ -0,0 +1,77 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "util/session_log.hpp"
+
+/**
+ * Compare re-simulated body states with recorded session steps,
+ * and keep the first step where a body diverges beyond tolerance.
+ */
+class SessionVerifier
+{
+public:
+    struct Divergence
+    {
+        uint64_t step;
+        uint32_t body_id;
+        float position_error;       ///< meters
+        float angle_error;          ///< degrees
+        bool is_grasp_mismatch;
+    };
+
+public:
+    /**
+     * @param position_tolerance    meters
+     * @param angle_tolerance       degrees
+     */
+    SessionVerifier(float position_tolerance, float angle_tolerance);
+
+    void reset();
+
+    /**
+     * @param simulated     body states with the same IDs as recorded bodies.
+     * @return false if this step is the first divergent step.
+     */
+    bool check(const SessionStep& recorded, const std::vector<SessionBodyState>& simulated);
+
+    bool has_divergence() const;
+    const Divergence& get_divergence() const;
+
+    uint64_t get_checked_step_count() const;
+
+    /** Largest position error of checked steps. */
+    float get_max_position_error() const;
+
+private:
+    const float position_tolerance_;
+    const float angle_tolerance_;
+
+    bool has_divergence_ = false;
+    Divergence divergence_ = {};
+    uint64_t checked_step_count_ = 0;
+    float max_position_error_ = 0.0f;
+};
+
+// ************************************************************************************************
+
+inline bool SessionVerifier::has_divergence() const
+{
+    return has_divergence_;
+}
+
+inline const SessionVerifier::Divergence& SessionVerifier::get_divergence() const
+{
+    return divergence_;
+}
+
+inline uint64_t SessionVerifier::get_checked_step_count() const
+{
+    return checked_step_count_;
+}
+
+inline float SessionVerifier::get_max_position_error() const
+{
+    return max_position_error_;
+}
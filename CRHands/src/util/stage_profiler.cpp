@@ -0,0 +1,157 @@
+#include "stage_profiler.hpp"
+
+#include <algorithm>
+
+#if defined(CRHANDS_ENABLE_PROFILER)
+#include <pStatCollector.h>
+#endif
+
+namespace {
+
+const char* const stage_names[PROFILE_STAGE_COUNT] = {
+    "Input",
+    "Retarget",
+    "Scale",
+    "Tracker",
+    "Pose Publish",
+    "Contact",
+    "Grasp",
+    "Haptics",
+};
+
+std::array<StageHistogram, PROFILE_STAGE_COUNT> stage_histograms;
+
+int find_msb(uint64_t value)
+{
+    int msb = 0;
+    while (value >>= 1)
+        ++msb;
+    return msb;
+}
+
+}
+
+const char* get_profile_stage_name(ProfileStage stage)
+{
+    return stage_names[stage];
+}
+
+StageHistogram& get_stage_histogram(ProfileStage stage)
+{
+    return stage_histograms[stage];
+}
+
+#if defined(CRHANDS_ENABLE_PROFILER)
+PStatCollector& get_stage_collector(ProfileStage stage)
+{
+    static PStatCollector hand_collector("CRHands:Hand");
+    static PStatCollector collectors[PROFILE_STAGE_COUNT] = {
+        PStatCollector(hand_collector, stage_names[PROFILE_STAGE_INPUT_READ]),
+        PStatCollector(hand_collector, stage_names[PROFILE_STAGE_RETARGET]),
+        PStatCollector(hand_collector, stage_names[PROFILE_STAGE_SCALE]),
+        PStatCollector(hand_collector, stage_names[PROFILE_STAGE_TRACKER]),
+        PStatCollector(hand_collector, stage_names[PROFILE_STAGE_POSE_PUBLISH]),
+        PStatCollector(hand_collector, stage_names[PROFILE_STAGE_CONTACT]),
+        PStatCollector(hand_collector, stage_names[PROFILE_STAGE_GRASP]),
+        PStatCollector(hand_collector, stage_names[PROFILE_STAGE_HAPTICS]),
+    };
+    return collectors[stage];
+}
+#endif
+
+// ************************************************************************************************
+
+int StageHistogram::get_bucket_index(uint64_t ns)
+{
+    if (ns < (1ull << SUB_BUCKET_BITS))
+        return static_cast<int>(ns);
+
+    const int msb = find_msb(ns);
+    const int sub_bucket = static_cast<int>((ns >> (msb - SUB_BUCKET_BITS)) & ((1 << SUB_BUCKET_BITS) - 1));
+    const int index = ((msb - SUB_BUCKET_BITS + 1) << SUB_BUCKET_BITS) | sub_bucket;
+
+    return index < BUCKET_COUNT ? index : BUCKET_COUNT - 1;
+}
+
+uint64_t StageHistogram::get_bucket_lower_bound(int index)
+{
+    if (index < (1 << SUB_BUCKET_BITS))
+        return static_cast<uint64_t>(index);
+
+    const int msb = (index >> SUB_BUCKET_BITS) + SUB_BUCKET_BITS - 1;
+    const uint64_t sub_bucket = static_cast<uint64_t>(index & ((1 << SUB_BUCKET_BITS) - 1));
+
+    return (1ull << msb) | (sub_bucket << (msb - SUB_BUCKET_BITS));
+}
+
+uint64_t StageHistogram::get_bucket_upper_bound(int index)
+{
+    return index + 1 < BUCKET_COUNT ? get_bucket_lower_bound(index + 1) : UINT64_MAX;
+}
+
+void StageHistogram::record(uint64_t ns)
+{
+    buckets_[get_bucket_index(ns)].fetch_add(1, std::memory_order_relaxed);
+    count_.fetch_add(1, std::memory_order_relaxed);
+    total_ns_.fetch_add(ns, std::memory_order_relaxed);
+
+    uint64_t max_ns = max_ns_.load(std::memory_order_relaxed);
+    while (ns > max_ns && !max_ns_.compare_exchange_weak(max_ns, ns, std::memory_order_relaxed))
+    {
+    }
+}
+
+StageHistogram::Snapshot StageHistogram::get_snapshot() const
+{
+    Snapshot snapshot;
+    for (int k = 0; k < BUCKET_COUNT; ++k)
+        snapshot.buckets[k] = buckets_[k].load(std::memory_order_relaxed);
+    snapshot.count = count_.load(std::memory_order_relaxed);
+    snapshot.total_ns = total_ns_.load(std::memory_order_relaxed);
+    snapshot.max_ns = max_ns_.load(std::memory_order_relaxed);
+    return snapshot;
+}
+
+void StageHistogram::reset()
+{
+    for (auto&& bucket: buckets_)
+        bucket.store(0, std::memory_order_relaxed);
+    count_.store(0, std::memory_order_relaxed);
+    total_ns_.store(0, std::memory_order_relaxed);
+    max_ns_.store(0, std::memory_order_relaxed);
+}
+
+uint64_t StageHistogram::Snapshot::get_percentile_ns(double ratio) const
+{
+    uint64_t bucket_total = 0;
+    for (auto count: buckets)
+        bucket_total += count;
+
+    if (bucket_total == 0)
+        return 0;
+
+    const uint64_t target = static_cast<uint64_t>(ratio * (bucket_total - 1)) + 1;
+    uint64_t accumulated = 0;
+    for (int k = 0; k < BUCKET_COUNT; ++k)
+    {
+        if (accumulated + buckets[k] < target)
+        {
+            accumulated += buckets[k];
+            continue;
+        }
+
+        // samples are assumed to be spread evenly in the bucket, and none is above max
+        const uint64_t lower = get_bucket_lower_bound(k);
+        const uint64_t upper = (std::min)(get_bucket_upper_bound(k), (std::max)(max_ns, lower));
+        const double fraction = static_cast<double>(target - accumulated) / buckets[k];
+
+        return lower + static_cast<uint64_t>((upper - lower) * fraction);
+    }
+
+    return max_ns;
+}
+
+double StageHistogram::Snapshot::get_mean_ns() const
+{
+    return count == 0 ? 0.0 : static_cast<double>(total_ns) / count;
+}
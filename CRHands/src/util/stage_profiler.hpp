@@ -0,0 +1,117 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+
+#if defined(CRHANDS_ENABLE_PROFILER)
+#include <pStatTimer.h>
+#endif
+
+// Timers for hand pipeline stages.
+//
+// Each timer reports to a PStats collector and to a lock-free histogram per stage.
+// Histogram can be read from any thread while the app is running.
+// If CRHANDS_ENABLE_PROFILER is not defined, CRHANDS_PROFILE_STAGE is removed completely.
+
+enum ProfileStage
+{
+    PROFILE_STAGE_INPUT_READ = 0,
+    PROFILE_STAGE_RETARGET,
+    PROFILE_STAGE_SCALE,
+    PROFILE_STAGE_TRACKER,
+    PROFILE_STAGE_POSE_PUBLISH,
+    PROFILE_STAGE_CONTACT,
+    PROFILE_STAGE_GRASP,
+    PROFILE_STAGE_HAPTICS,
+
+    PROFILE_STAGE_COUNT,
+};
+
+const char* get_profile_stage_name(ProfileStage stage);
+
+class StageHistogram
+{
+public:
+    // bucket = (log2(ns) << SUB_BUCKET_BITS) | next SUB_BUCKET_BITS bits
+    static constexpr int SUB_BUCKET_BITS = 3;
+    static constexpr int BUCKET_COUNT = 40 << SUB_BUCKET_BITS;
+
+    struct Snapshot
+    {
+        std::array<uint64_t, BUCKET_COUNT> buckets;
+        uint64_t count = 0;
+        uint64_t total_ns = 0;
+        uint64_t max_ns = 0;
+
+        /**
+         * Interpolated linearly between bounds of the bucket which has the percentile.
+         * @param ratio  [0, 1]
+         */
+        uint64_t get_percentile_ns(double ratio) const;
+        double get_mean_ns() const;
+    };
+
+    void record(uint64_t ns);
+    Snapshot get_snapshot() const;
+    void reset();
+
+    static int get_bucket_index(uint64_t ns);
+    static uint64_t get_bucket_lower_bound(int index);
+
+    /** Exclusive upper bound, or UINT64_MAX for the last bucket. */
+    static uint64_t get_bucket_upper_bound(int index);
+
+private:
+    std::array<std::atomic<uint64_t>, BUCKET_COUNT> buckets_ = {};
+    std::atomic<uint64_t> count_{ 0 };
+    std::atomic<uint64_t> total_ns_{ 0 };
+    std::atomic<uint64_t> max_ns_{ 0 };
+};
+
+StageHistogram& get_stage_histogram(ProfileStage stage);
+
+#if defined(CRHANDS_ENABLE_PROFILER)
+
+class PStatCollector;
+
+PStatCollector& get_stage_collector(ProfileStage stage);
+
+class ScopedStageTimer
+{
+public:
+    explicit ScopedStageTimer(ProfileStage stage);
+    ~ScopedStageTimer();
+
+    ScopedStageTimer(const ScopedStageTimer&) = delete;
+    ScopedStageTimer& operator=(const ScopedStageTimer&) = delete;
+
+private:
+    const ProfileStage stage_;
+    const std::chrono::steady_clock::time_point start_;
+    PStatTimer pstat_timer_;
+};
+
+// ************************************************************************************************
+
+inline ScopedStageTimer::ScopedStageTimer(ProfileStage stage) :
+    stage_(stage), start_(std::chrono::steady_clock::now()), pstat_timer_(get_stage_collector(stage))
+{
+}
+
+inline ScopedStageTimer::~ScopedStageTimer()
+{
+    const auto elapsed = std::chrono::steady_clock::now() - start_;
+    get_stage_histogram(stage_).record(std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count());
+}
+
+#define CRHANDS_PROFILE_CONCAT_IMPL(a, b) a##b
+#define CRHANDS_PROFILE_CONCAT(a, b) CRHANDS_PROFILE_CONCAT_IMPL(a, b)
+#define CRHANDS_PROFILE_STAGE(stage) const ScopedStageTimer CRHANDS_PROFILE_CONCAT(crhands_stage_timer_, __LINE__)(stage)
+
+#else
+
+#define CRHANDS_PROFILE_STAGE(stage) ((void)0)
+
+#endif
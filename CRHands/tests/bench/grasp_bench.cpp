@@ -0,0 +1,67 @@
+#include <benchmark/benchmark.h>
+
+#include "hand/grasp_detection.hpp"
+#include "hand/hand_registry.hpp"
+#include "support/grouped_contacts.hpp"
+#include "util/frame_arena.hpp"
+
+namespace {
+
+// single object: opposing contacts of one side among interactors touching it
+// Arg: interactor count
+void BM_FindGraspingSide(benchmark::State& state)
+{
+    const int interactor_count = static_cast<int>(state.range(0));
+    const GroupedContacts contacts(1, 1, interactor_count, false);
+    const auto& interactors = contacts.get_interactors();
+
+    for (auto _ : state)
+        benchmark::DoNotOptimize(find_grasping_side(interactors.data(), interactors.size()));
+
+    state.SetItemsProcessed(state.iterations() * interactor_count);
+}
+BENCHMARK(BM_FindGraspingSide)->Arg(4)->Arg(16)->Arg(64);
+
+// one hand: opposing contacts among children touched by the hand
+// Args: child count, particles per child
+void BM_IsGrasping(benchmark::State& state)
+{
+    const GroupedContacts contacts(1, static_cast<int>(state.range(0)), static_cast<int>(state.range(1)), false);
+    const auto& children = contacts.get_children();
+
+    for (auto _ : state)
+        benchmark::DoNotOptimize(is_grasping(children.data(), children.size()));
+}
+BENCHMARK(BM_IsGrasping)->Args({ 1, 10 })->Args({ 8, 10 })->Args({ 27, 4 });
+
+// grouped object: children by contacted hand, and then grasp feasibility of each hand
+// Arg: hand count
+void BM_GroupedObjectEvaluation(benchmark::State& state)
+{
+    const int hand_count = static_cast<int>(state.range(0));
+    const GroupedContacts contacts(hand_count, 27, 4, true);
+    const auto& children = contacts.get_children();
+
+    FrameArena step_arena(64 * 1024);
+
+    for (auto _ : state)
+    {
+        // lists per hand live on the step arena, as in the grouped object listener
+        step_arena.reset();
+        auto contacted_hand = make_frame_vectors<crsf::TCRModel*, HandRegistry::MAX_HAND_COUNT>(step_arena);
+
+        const HandRegistry::HandMask contacted_hand_mask = collect_contacted_hands(contacts.get_hand_registry(), children.data(), children.size(), contacted_hand.data());
+
+        HandRegistry::HandMask grasped_hand_mask = 0;
+        for (HandRegistry::HandMask mask = contacted_hand_mask; mask;)
+        {
+            const int n = HandRegistry::pop_hand(mask);
+            if (is_grasping(contacted_hand[n].data(), contacted_hand[n].size()))
+                grasped_hand_mask |= HandRegistry::to_mask(n);
+        }
+        benchmark::DoNotOptimize(grasped_hand_mask);
+    }
+}
+BENCHMARK(BM_GroupedObjectEvaluation)->Arg(2)->Arg(8)->Arg(32);
+
+}
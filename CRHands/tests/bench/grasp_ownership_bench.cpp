@@ -0,0 +1,39 @@
+#include <benchmark/benchmark.h>
+
+#include "support/ownership_loopback.hpp"
+
+namespace {
+
+constexpr int NODE_COUNT = 4;
+constexpr int DELAY_STEPS = 3;
+
+// receive and publish step of all nodes while node 1 moves every object it owns
+void BM_GraspOwnershipSync(benchmark::State& state)
+{
+    const int object_count = static_cast<int>(state.range(0));
+
+    OwnershipLoopback loopback(NODE_COUNT, object_count, DELAY_STEPS);
+    auto& owner = loopback.get_node(1);
+    for (int k = 0; k < object_count; ++k)
+        owner.ownership.request(k);
+
+    for (int k = 0; k < 2 * DELAY_STEPS + 2; ++k)
+        loopback.step();
+
+    const uint64_t update_count = loopback.get_update_count();
+    for (auto _ : state)
+    {
+        for (auto&& object_state: owner.states)
+            object_state.pos[0] += 0.001f;
+
+        loopback.step();
+    }
+
+    const double updates = static_cast<double>(loopback.get_update_count() - update_count);
+    state.counters["bytes_per_update"] = static_cast<double>(loopback.get_bytes_per_update());
+    state.counters["updates_per_step"] = updates / static_cast<double>(state.iterations());
+    state.SetItemsProcessed(state.iterations() * object_count);
+}
+BENCHMARK(BM_GraspOwnershipSync)->Arg(1)->Arg(8)->Arg(64);
+
+}
@@ -0,0 +1,40 @@
+#include <chrono>
+#include <memory>
+
+#include <benchmark/benchmark.h>
+
+#include "util/haptic_output_queue.hpp"
+
+namespace {
+
+using namespace std::chrono_literals;
+
+std::unique_ptr<HapticOutputQueue> output_queue;
+
+void setup_output_queue(const benchmark::State&)
+{
+    // 20 ms is the default haptic_min_interval of glove
+    output_queue = std::make_unique<HapticOutputQueue>([](int, HapticOutputQueue::Mask mask) {
+        benchmark::DoNotOptimize(mask);
+    }, 20ms);
+}
+
+void teardown_output_queue(const benchmark::State&)
+{
+    output_queue.reset();
+}
+
+// submit of producers on both channels while the worker drains and sends
+void BM_HapticOutputQueueSubmit(benchmark::State& state)
+{
+    const int channel = state.thread_index() % HapticOutputQueue::CHANNEL_COUNT;
+    HapticOutputQueue::Mask mask = 0;
+
+    for (auto _ : state)
+        output_queue->submit(channel, ++mask);
+
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_HapticOutputQueueSubmit)->Setup(setup_output_queue)->Teardown(teardown_output_queue)->ThreadRange(1, 8)->UseRealTime();
+
+}
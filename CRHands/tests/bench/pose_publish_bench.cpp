@@ -0,0 +1,59 @@
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include <crsf/CoexistenceInterface/TAvatarMemoryObject.h>
+
+#include "hand/hand_kinematics.hpp"
+#include "hand/hand_topology.hpp"
+#include "support/hand_rig.hpp"
+
+namespace {
+
+// world poses of all joints written to avatar memory, as render paths publish after scene write
+void BM_PosePublish(benchmark::State& state)
+{
+    HandRig rig;
+    HandKinematics kinematics;
+    kinematics.bind(rig.get_hand());
+
+    crsf::TAvatarMemoryObject dest_amo(HandTopology::JOINT_COUNT);
+    std::vector<crsf::TPose> dest_poses = dest_amo.GetAvatarMemory();
+
+    for (auto _ : state)
+    {
+        kinematics.update(rig.get_world());
+        kinematics.write_poses(dest_poses);
+
+        dest_amo.SetAvatarMemory(dest_poses);
+        dest_amo.UpdateAvatarMemoryObject();
+    }
+
+    state.SetItemsProcessed(state.iterations() * HandTopology::JOINT_COUNT);
+}
+BENCHMARK(BM_PosePublish);
+
+// per-joint world matrix from scene graph, which pose publishing replaced
+void BM_PosePublishSceneGraph(benchmark::State& state)
+{
+    HandRig rig;
+    std::vector<crsf::TPose> dest_poses(HandTopology::JOINT_COUNT);
+
+    for (auto _ : state)
+    {
+        for (int k = 0; k < HandTopology::JOINT_COUNT; ++k)
+        {
+            const LMatrix4f mat = rig.get_joint_model(k)->GetMatrix(rig.get_world());
+
+            LQuaternionf quat;
+            quat.set_from_matrix(mat.get_upper_3());
+            dest_poses[k].MakePosQuat(mat.get_row3(3), quat);
+        }
+        benchmark::DoNotOptimize(dest_poses.data());
+    }
+
+    state.SetItemsProcessed(state.iterations() * HandTopology::JOINT_COUNT);
+}
+BENCHMARK(BM_PosePublishSceneGraph);
+
+}
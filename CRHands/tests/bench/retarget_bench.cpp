@@ -0,0 +1,154 @@
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include <crsf/CoexistenceInterface/TAvatarMemoryObject.h>
+
+#include "hand/hand_retarget.hpp"
+#include "hand/hand_topology.hpp"
+#include "support/hand_rig.hpp"
+#include "util/joint_write_cache.hpp"
+
+namespace {
+
+constexpr int FRAME_COUNT = 240;
+
+// avatar memory of each device frame
+std::vector<crsf::TAvatarMemoryObject> make_frames(std::size_t pose_count)
+{
+    std::vector<crsf::TAvatarMemoryObject> frames(FRAME_COUNT, crsf::TAvatarMemoryObject(pose_count));
+
+    std::vector<crsf::TPose> poses(pose_count);
+    for (int frame = 0; frame < FRAME_COUNT; ++frame)
+    {
+        make_device_poses(frame, poses);
+        frames[frame].SetAvatarMemory(poses);
+    }
+
+    return frames;
+}
+
+// Leap Motion: every joint of both sides
+void BM_RetargetLeap(benchmark::State& state)
+{
+    const auto frames = make_frames(HandTopology::JOINT_COUNT);
+    JointWriteCache joint_write_cache;
+
+    int frame = 0;
+    for (auto _ : state)
+    {
+        const auto& amo = frames[frame++ % FRAME_COUNT];
+        for (int i = 0; i < HandTopology::JOINT_COUNT; ++i)
+        {
+            const auto& joint = hand_topology.get_joint(i);
+            const auto& pose = amo.GetAvatarMemory(i);
+
+            LQuaternionf quat_result;
+            if (joint.kind == HandTopology::JOINT_KIND_FINGER)
+            {
+                const bool is_thumb_base = joint.finger == HandTopology::FINGER_THUMB && joint.segment == 0;
+                quat_result = retarget_leap_joint(pose.GetQuaternion(), LEAP_MOTION_MODE_HMD, joint.side, is_thumb_base);
+            }
+            else if (joint.kind == HandTopology::JOINT_KIND_WRIST)
+            {
+                benchmark::DoNotOptimize(joint_write_cache.update_position(i, pose.GetPosition()));
+                quat_result = retarget_leap_wrist(pose.GetQuaternion(), LEAP_MOTION_MODE_HMD, joint.side);
+            }
+            else
+            {
+                continue;
+            }
+
+            if (joint_write_cache.update_rotation(i, quat_result))
+                benchmark::DoNotOptimize(quat_result.get_hpr());
+        }
+    }
+
+    state.SetItemsProcessed(state.iterations() * HandTopology::JOINT_COUNT);
+}
+BENCHMARK(BM_RetargetLeap);
+
+// CHIC mocap: thumb, index, middle of both sides, and wrist trackers
+void BM_RetargetHandMocap(benchmark::State& state)
+{
+    const auto frames = make_frames(HandTopology::SIDE_COUNT * 12);
+    JointWriteCache joint_write_cache;
+
+    int frame = 0;
+    for (auto _ : state)
+    {
+        const auto& amo = frames[frame++ % FRAME_COUNT];
+        for (int hand_side = 0; hand_side < HandTopology::SIDE_COUNT; ++hand_side)
+        {
+            const LQuaternionf tracker_quat = amo.GetAvatarMemory(hand_side * 12).GetQuaternion();
+            benchmark::DoNotOptimize(retarget_hand_mocap_model_to_joint(retarget_hand_mocap_tracker_to_model(tracker_quat, hand_side), hand_side));
+
+            for (int f = 0; f < 3; ++f)
+            {
+                for (int j = 0; j < 4; ++j)
+                {
+                    const int index = hand_side * 12 + f * 4 + j;
+                    const int model_index = HandTopology::get_joint_index(hand_side, f, j);
+
+                    const LQuaternionf quat_result = retarget_hand_mocap_joint(amo.GetAvatarMemory(index).GetQuaternion(), hand_side, f == 0 && j == 0);
+                    if (j != 3 && joint_write_cache.update_rotation(model_index, quat_result))
+                        benchmark::DoNotOptimize(quat_result.get_hpr());
+                }
+            }
+        }
+    }
+
+    state.SetItemsProcessed(state.iterations() * HandTopology::SIDE_COUNT * 12);
+}
+BENCHMARK(BM_RetargetHandMocap);
+
+// UNIST mocap: thumb, index, middle of one side from joint angles
+// Arg: hand side, or -1 if mode is neither left nor right
+void BM_RetargetUnist(benchmark::State& state)
+{
+    const int hand_side = static_cast<int>(state.range(0));
+    const int model_side = hand_side < 0 ? HandTopology::SIDE_RIGHT : hand_side;
+    const auto frames = make_frames(17);
+    JointWriteCache joint_write_cache;
+
+    int frame = 0;
+    for (auto _ : state)
+    {
+        const auto& amo = frames[frame++ % FRAME_COUNT];
+        for (int i = 0; i < 3; ++i)
+        {
+            const int start_index = 2 + i * 5;
+            const float aa = amo.GetAvatarMemory(start_index).GetPosition()[1] * 1000.0f;
+            const float mcp = amo.GetAvatarMemory(start_index + 1).GetPosition()[1] * 1000.0f;
+
+            // 1st joint = proximal phalanges
+            LQuaternionf a, b;
+            a.set_from_axis_angle(aa, LVecBase3(0, 1, 0));
+            b.set_from_axis_angle(mcp, LVecBase3(0, 0, 1));
+
+            LQuaternionf quat_result = retarget_unist_joint(b * a, hand_side);
+            if (i == 0 && hand_side >= 0)
+                quat_result = retarget_unist_thumb(quat_result, hand_side);
+
+            const int model_index = HandTopology::get_joint_index(model_side, i, 0);
+            if (joint_write_cache.update_rotation(model_index, quat_result))
+                benchmark::DoNotOptimize(quat_result.get_hpr());
+
+            // 2nd, 3rd joint = intermediate, distal phalanges
+            for (int j = 1; j < 3; ++j)
+            {
+                LQuaternionf c;
+                c.set_from_axis_angle(amo.GetAvatarMemory(start_index + 1 + j).GetPosition()[1] * 1000.0f, LVecBase3(0, 0, 1));
+
+                const LQuaternionf joint_quat = retarget_unist_joint(c, hand_side);
+                if (joint_write_cache.update_rotation(model_index + j, joint_quat))
+                    benchmark::DoNotOptimize(joint_quat.get_hpr());
+            }
+        }
+    }
+
+    state.SetItemsProcessed(state.iterations() * 9);
+}
+BENCHMARK(BM_RetargetUnist)->Arg(HandTopology::SIDE_RIGHT)->Arg(-1);
+
+}
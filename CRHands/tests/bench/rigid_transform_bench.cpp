@@ -0,0 +1,69 @@
+#include <benchmark/benchmark.h>
+
+#include <compose_matrix.h>
+
+#include "util/rigid_transform.hpp"
+
+namespace {
+
+// wrist in world under scaled hand model, and grasped object in world
+struct GraspPoses
+{
+    GraspPoses()
+    {
+        LMatrix4f hand_to_world;
+        compose_matrix(hand_to_world, LVecBase3f(1.1f, 2.0f, 0.6f), LVecBase3f(0.0f), LVecBase3f(30.0f, -10.0f, 45.0f), LVecBase3f(0.3f, 0.0f, 0.8f), CS_zup_right);
+
+        LMatrix4f wrist_to_hand;
+        compose_matrix(wrist_to_hand, LVecBase3f(1.0f), LVecBase3f(0.0f), LVecBase3f(-60.0f, 20.0f, 5.0f), LVecBase3f(0.0f, 0.1f, 0.0f), CS_zup_right);
+        wrist_to_world = wrist_to_hand * hand_to_world;
+
+        compose_matrix(object_to_world, LVecBase3f(1.0f), LVecBase3f(0.0f), LVecBase3f(10.0f, 70.0f, -30.0f), LVecBase3f(0.4f, 0.5f, 0.9f), CS_zup_right);
+    }
+
+    LMatrix4f wrist_to_world;
+    LMatrix4f object_to_world;
+};
+
+// relative transform at grasp start and object pose, through decompose_matrix, HPR and general invert
+void BM_GraspTransformHpr(benchmark::State& state)
+{
+    const GraspPoses poses;
+    for (auto _ : state)
+    {
+        LVecBase3f scale;
+        LVecBase3f shear;
+        LVecBase3f hpr;
+        LVecBase3f translate;
+        decompose_matrix(poses.wrist_to_world, scale, shear, hpr, translate);
+
+        LQuaternionf quat;
+        quat.set_hpr(hpr);
+
+        LMatrix4f rot_mat;
+        quat.extract_to_matrix(rot_mat);
+        rot_mat.set_row(3, translate);
+
+        const LMatrix4f fixed = poses.object_to_world * invert(rot_mat);
+        LMatrix4f object = fixed * rot_mat;
+        benchmark::DoNotOptimize(object);
+    }
+}
+BENCHMARK(BM_GraspTransformHpr);
+
+// same transforms through RigidTransform with closed-form inverse
+void BM_GraspTransformRigid(benchmark::State& state)
+{
+    const GraspPoses poses;
+    for (auto _ : state)
+    {
+        const RigidTransform hand_to_world = RigidTransform::from_matrix(poses.wrist_to_world);
+
+        const LMatrix4f fixed = poses.object_to_world * hand_to_world.get_inverse().get_matrix();
+        LMatrix4f object = fixed * hand_to_world.get_matrix();
+        benchmark::DoNotOptimize(object);
+    }
+}
+BENCHMARK(BM_GraspTransformRigid);
+
+}
@@ -0,0 +1,63 @@
+#include <benchmark/benchmark.h>
+
+#include "object/soma_solver.hpp"
+
+namespace {
+
+// solution with the first @a placed_count pieces kept, as a user has placed them
+SomaSolver::Solution make_placed(SomaSolver& solver, int placed_count)
+{
+    SomaSolver::Solution empty{};
+    SomaSolver::Solution solution{};
+    solver.solve(empty, solution);
+
+    SomaSolver::Solution placed{};
+    for (int piece = 0; piece < placed_count; ++piece)
+        placed[piece] = solution[piece];
+    return placed;
+}
+
+// hint search from a partially assembled cube
+// Arg: count of placed pieces
+void BM_SomaSolve(benchmark::State& state)
+{
+    SomaSolver solver;
+    const SomaSolver::Solution placed = make_placed(solver, static_cast<int>(state.range(0)));
+
+    SomaSolver::Solution solution;
+    int node_count = 0;
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(solver.solve(placed, solution));
+        node_count += solver.get_last_node_count();
+    }
+
+    state.counters["nodes"] = benchmark::Counter(static_cast<double>(node_count), benchmark::Counter::kAvgIterations);
+}
+BENCHMARK(BM_SomaSolve)->Arg(0)->Arg(3)->Arg(5);
+
+// solver construction, which enumerates placements of all pieces
+void BM_SomaSolverPlacements(benchmark::State& state)
+{
+    for (auto _ : state)
+    {
+        SomaSolver solver;
+        benchmark::DoNotOptimize(&solver);
+    }
+}
+BENCHMARK(BM_SomaSolverPlacements);
+
+// cells of a piece from positions of its unit cubes, as assembly check snaps every piece
+void BM_SomaSnapToCells(benchmark::State& state)
+{
+    const LVecBase3 positions[SomaSolver::MAX_PIECE_CELL_COUNT] = {
+        LVecBase3(0.02f, 0.01f, -0.03f), LVecBase3(1.01f, 0.0f, 0.02f),
+        LVecBase3(1.0f, 0.98f, 0.0f), LVecBase3(0.99f, 1.02f, 1.01f),
+    };
+
+    for (auto _ : state)
+        benchmark::DoNotOptimize(SomaSolver::snap_to_cells(positions, SomaSolver::MAX_PIECE_CELL_COUNT, 0.2f));
+}
+BENCHMARK(BM_SomaSnapToCells);
+
+}
@@ -0,0 +1,54 @@
+#include <array>
+
+#include <benchmark/benchmark.h>
+
+#include "object/twisty_puzzle_state.hpp"
+
+namespace {
+
+// contacted cubies of a hand on a face: a face layer and a few cubies of its neighbor layers
+std::array<TwistyPuzzleState::Bitboard, TwistyPuzzleState::LAYER_COUNT> make_contacts(const TwistyPuzzleState& puzzle)
+{
+    std::array<TwistyPuzzleState::Bitboard, TwistyPuzzleState::LAYER_COUNT> contacts;
+    for (int layer = 0; layer < TwistyPuzzleState::LAYER_COUNT; ++layer)
+    {
+        const int next_layer = (layer + 3) % TwistyPuzzleState::LAYER_COUNT;
+        contacts[layer] = puzzle.get_layer_cubies(layer) | (puzzle.get_layer_cubies(next_layer) & 0x5);
+    }
+    return contacts;
+}
+
+// layer touched by secondary hand, as regroup looks up at two hand grasp
+void BM_TwistyPuzzleFindLayer(benchmark::State& state)
+{
+    const TwistyPuzzleState puzzle;
+    const auto contacts = make_contacts(puzzle);
+
+    int index = 0;
+    for (auto _ : state)
+    {
+        benchmark::DoNotOptimize(puzzle.find_layer(contacts[index]));
+        index = (index + 1) % TwistyPuzzleState::LAYER_COUNT;
+    }
+}
+BENCHMARK(BM_TwistyPuzzleFindLayer);
+
+// regroup and finish of one twist: find layer, and then turn it
+void BM_TwistyPuzzleTwist(benchmark::State& state)
+{
+    TwistyPuzzleState puzzle;
+    const auto contacts = make_contacts(puzzle);
+
+    int index = 0;
+    for (auto _ : state)
+    {
+        const int layer = puzzle.find_layer(contacts[index]);
+        if (layer != TwistyPuzzleState::INVALID_LAYER)
+            puzzle.twist(layer, 1 + index % 3);
+        benchmark::DoNotOptimize(puzzle.is_solved());
+        index = (index + 1) % TwistyPuzzleState::LAYER_COUNT;
+    }
+}
+BENCHMARK(BM_TwistyPuzzleTwist);
+
+}
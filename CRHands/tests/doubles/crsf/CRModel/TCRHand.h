@@ -0,0 +1,50 @@
+/**
+* Test double of CRSF TCRHand: joint data with 3D models and wrists of both sides.
+*/
+
+#pragma once
+
+#include <vector>
+
+#include <luse.h>
+
+#include <crsf/CRModel/TWorldObject.h>
+
+namespace crsf {
+
+class TJointData
+{
+public:
+    TWorldObject* Get3DModel() const { return model_; }
+    void Set3DModel(TWorldObject* model) { model_ = model; }
+
+    void SetPosition(const LVecBase3f& pos) { position_ = pos; }
+    void SetOrientation(const LQuaternionf& quat) { orientation_ = quat; }
+
+private:
+    TWorldObject* model_ = nullptr;
+    LVecBase3f position_ = LVecBase3f(0);
+    LQuaternionf orientation_ = LQuaternionf::ident_quat();
+};
+
+class TCRHand : public TWorldObject
+{
+public:
+    explicit TCRHand(int joint_number) : joint_data_(joint_number) {}
+
+    unsigned int GetJointNumber() const { return static_cast<unsigned int>(joint_data_.size()); }
+    TJointData* GetJointData(int index) { return &joint_data_[index]; }
+
+    TWorldObject* Get3DModel() { return this; }
+
+    TWorldObject* Get3DModel_LeftWrist() const { return left_wrist_; }
+    TWorldObject* Get3DModel_RightWrist() const { return right_wrist_; }
+    void Set3DModel_Wrists(TWorldObject* left_wrist, TWorldObject* right_wrist) { left_wrist_ = left_wrist; right_wrist_ = right_wrist; }
+
+private:
+    std::vector<TJointData> joint_data_;
+    TWorldObject* left_wrist_ = nullptr;
+    TWorldObject* right_wrist_ = nullptr;
+};
+
+}
@@ -0,0 +1,23 @@
+/**
+* Test double of CRSF TCRModel: contact state which physics listeners read.
+*/
+
+#pragma once
+
+#include <vector>
+
+#include <crsf/CRModel/TWorldObject.h>
+
+namespace crsf {
+
+class THandPhysicsInteractor;
+
+class TCRModel : public TWorldObject
+{
+public:
+    std::vector<THandPhysicsInteractor*> contacted_physics_particle;
+    std::vector<TWorldObject*> contacted_hand_pointer;
+    bool is_contacted = false;
+};
+
+}
@@ -0,0 +1,33 @@
+/**
+* Test double of CRSF THandPhysicsInteractor: a particle attached to a hand joint.
+*/
+
+#pragma once
+
+#include <luse.h>
+
+#include <crsf/CRModel/TCRModel.h>
+
+namespace crsf {
+
+class TCRHand;
+
+class THandPhysicsInteractor : public TCRModel
+{
+public:
+    const LVecBase3f& GetPenetrationDirection() const { return penetration_direction_; }
+    void SetPenetrationDirection(const LVecBase3f& direction) { penetration_direction_ = direction; }
+
+    int GetConnectedJointTag() const { return connected_joint_tag_; }
+    void SetConnectedJointTag(int tag) { connected_joint_tag_ = tag; }
+
+    TCRHand* GetParentHandModel() const { return parent_hand_model_; }
+    void SetParentHandModel(TCRHand* hand) { parent_hand_model_ = hand; }
+
+private:
+    LVecBase3f penetration_direction_ = LVecBase3f(0);
+    int connected_joint_tag_ = -1;
+    TCRHand* parent_hand_model_ = nullptr;
+};
+
+}
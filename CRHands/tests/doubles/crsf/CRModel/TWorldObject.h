@@ -0,0 +1,136 @@
+/**
+* Test double of CRSF TWorldObject: a scene graph node with a local matrix.
+*/
+
+#pragma once
+
+#include <vector>
+
+#include <luse.h>
+#include <compose_matrix.h>
+
+namespace crsf {
+
+class TWorldObject
+{
+public:
+    virtual ~TWorldObject() = default;
+
+    TWorldObject* GetParent() const { return parent_; }
+
+    /** Reparent @a child to this object, keeping its local matrix. */
+    void AddWorldObject(TWorldObject* child);
+
+    const LMatrix4f& GetMatrix() const { return matrix_; }
+
+    /** Matrix relative to @a other (world if nullptr). */
+    LMatrix4f GetMatrix(const TWorldObject* other) const;
+
+    void SetMatrix(const LMatrix4f& mat) { matrix_ = mat; }
+
+    LVecBase3f GetPosition(const TWorldObject* other) const { return GetMatrix(other).get_row3(3); }
+
+    /** Rotation relative to @a other, without scale and shear. */
+    LQuaternionf GetQuaternion(const TWorldObject* other) const;
+
+    void SetPosition(const LVecBase3f& pos) { matrix_.set_row(3, pos); }
+
+    /** Set position relative to @a other, keeping local rotation. */
+    void SetPosition(const LVecBase3f& pos, const TWorldObject* other);
+
+    void SetHPR(const LVecBase3f& hpr);
+
+private:
+    LMatrix4f get_world_matrix() const;
+
+private:
+    TWorldObject* parent_ = nullptr;
+    std::vector<TWorldObject*> children_;
+    LMatrix4f matrix_ = LMatrix4f::ident_mat();
+};
+
+// ************************************************************************************************
+
+inline void TWorldObject::AddWorldObject(TWorldObject* child)
+{
+    if (child->parent_)
+    {
+        auto& siblings = child->parent_->children_;
+        for (auto iter = siblings.begin(); iter != siblings.end(); ++iter)
+        {
+            if (*iter == child)
+            {
+                siblings.erase(iter);
+                break;
+            }
+        }
+    }
+
+    child->parent_ = this;
+    children_.push_back(child);
+}
+
+inline LMatrix4f TWorldObject::get_world_matrix() const
+{
+    // row-vector convention: world = local * parent_world
+    LMatrix4f world = matrix_;
+    for (const TWorldObject* node = parent_; node; node = node->parent_)
+        world = world * node->matrix_;
+    return world;
+}
+
+inline LMatrix4f TWorldObject::GetMatrix(const TWorldObject* other) const
+{
+    // compose up to ancestor without inversion
+    LMatrix4f mat = matrix_;
+    for (const TWorldObject* node = parent_; node; node = node->parent_)
+    {
+        if (node == other)
+            return mat;
+        mat = mat * node->matrix_;
+    }
+
+    if (!other)
+        return mat;
+
+    return mat * invert(other->get_world_matrix());
+}
+
+inline LQuaternionf TWorldObject::GetQuaternion(const TWorldObject* other) const
+{
+    // as NodePath::get_quat, through decomposed HPR
+    LVecBase3f scale;
+    LVecBase3f shear;
+    LVecBase3f hpr;
+    decompose_matrix(GetMatrix(other).get_upper_3(), scale, shear, hpr);
+
+    LQuaternionf quat;
+    quat.set_hpr(hpr);
+    return quat;
+}
+
+inline void TWorldObject::SetPosition(const LVecBase3f& pos, const TWorldObject* other)
+{
+    LMatrix4f other_to_parent = LMatrix4f::ident_mat();
+    if (other != parent_)
+    {
+        other_to_parent = other ? other->get_world_matrix() : LMatrix4f::ident_mat();
+        if (parent_)
+            other_to_parent = other_to_parent * invert(parent_->get_world_matrix());
+    }
+
+    matrix_.set_row(3, other_to_parent.xform_point(pos));
+}
+
+inline void TWorldObject::SetHPR(const LVecBase3f& hpr)
+{
+    LQuaternionf quat;
+    quat.set_hpr(hpr);
+
+    LMatrix4f rot_mat;
+    quat.extract_to_matrix(rot_mat);
+    rot_mat.set_row(3, matrix_.get_row3(3));
+    matrix_ = rot_mat;
+}
+
+}
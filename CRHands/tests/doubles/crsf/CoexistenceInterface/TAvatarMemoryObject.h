@@ -0,0 +1,33 @@
+/**
+* Test double of CRSF TAvatarMemoryObject: pose buffer shared through DSM.
+*/
+
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include <crsf/System/TPose.h>
+
+namespace crsf {
+
+class TAvatarMemoryObject
+{
+public:
+    explicit TAvatarMemoryObject(std::size_t pose_count) : poses_(pose_count) {}
+
+    const std::vector<TPose>& GetAvatarMemory() const { return poses_; }
+    const TPose& GetAvatarMemory(std::size_t index) const { return poses_.at(index); }
+
+    void SetAvatarMemory(const std::vector<TPose>& poses) { poses_ = poses; }
+
+    /** Count of published updates, instead of sending to other nodes. */
+    void UpdateAvatarMemoryObject() { ++update_count_; }
+    uint64_t GetUpdateCount() const { return update_count_; }
+
+private:
+    std::vector<TPose> poses_;
+    uint64_t update_count_ = 0;
+};
+
+}
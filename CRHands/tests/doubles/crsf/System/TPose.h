@@ -0,0 +1,25 @@
+/**
+* Test double of CRSF TPose: position and quaternion of one joint.
+*/
+
+#pragma once
+
+#include <luse.h>
+
+namespace crsf {
+
+class TPose
+{
+public:
+    void MakePosQuat(const LVecBase3f& pos, const LQuaternionf& quat) { position_ = pos; quaternion_ = quat; }
+    void MakePosition(const LVecBase3f& pos) { position_ = pos; }
+
+    const LVecBase3f& GetPosition() const { return position_; }
+    const LQuaternionf& GetQuaternion() const { return quaternion_; }
+
+private:
+    LVecBase3f position_ = LVecBase3f(0);
+    LQuaternionf quaternion_ = LQuaternionf::ident_quat();
+};
+
+}
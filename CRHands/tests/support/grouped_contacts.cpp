@@ -0,0 +1,59 @@
+#include "support/grouped_contacts.hpp"
+
+#include <cmath>
+
+#include "hand/hand_topology.hpp"
+
+namespace {
+
+// penetration directions within a cone, so no pair is opposing and every pair is tested
+LVecBase3f make_cone_direction(int index)
+{
+    const float angle = 0.4f * index;
+    return LVecBase3f(0.5f * std::cos(angle), 0.5f * std::sin(angle), 1.0f).normalized();
+}
+
+}
+
+GroupedContacts::GroupedContacts(int hand_count, int child_count, int particle_count, bool is_opposing)
+{
+    wrists_.resize(hand_count);
+    for (int n = 0; n < hand_count; ++n)
+    {
+        wrists_[n] = std::make_unique<crsf::TWorldObject>();
+        hand_registry_.register_hand(wrists_[n].get(), n / 2);
+    }
+
+    children_.resize(child_count);
+    for (int c = 0; c < child_count; ++c)
+    {
+        children_[c] = std::make_unique<crsf::TCRModel>();
+        auto child = children_[c].get();
+        child->is_contacted = true;
+
+        // each child is touched by one or two hands
+        child->contacted_hand_pointer.push_back(wrists_[c % hand_count].get());
+        if (c % 3 == 0 && hand_count > 1)
+            child->contacted_hand_pointer.push_back(wrists_[(c + 1) % hand_count].get());
+
+        for (int p = 0; p < particle_count; ++p)
+        {
+            interactors_.push_back(std::make_unique<crsf::THandPhysicsInteractor>());
+            auto interactor = interactors_.back().get();
+
+            const int tag = HandTopology::get_joint_index(c % HandTopology::SIDE_COUNT, p % HandTopology::FINGER_COUNT, HandTopology::TIP_SEGMENT);
+            interactor->SetConnectedJointTag(tag);
+            interactor->SetPenetrationDirection(make_cone_direction(c * particle_count + p));
+            child->contacted_physics_particle.push_back(interactor);
+        }
+
+        // last particle of the last child pushes back
+        if (is_opposing && c == child_count - 1)
+            interactors_.back()->SetPenetrationDirection(-make_cone_direction(c * particle_count));
+
+        child_pointers_.push_back(child);
+    }
+
+    for (auto& interactor : interactors_)
+        interactor_pointers_.push_back(interactor.get());
+}
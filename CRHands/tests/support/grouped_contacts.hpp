@@ -0,0 +1,33 @@
+#pragma once
+
+#include <memory>
+#include <vector>
+
+#include <crsf/CRModel/TCRModel.h>
+#include <crsf/CRModel/THandPhysicsInteractor.h>
+
+#include "hand/hand_registry.hpp"
+
+/**
+ * Contacts of a grouped object (ex, 27 cubies of a twisty puzzle) touched by several hands.
+ *
+ * Each child is touched by one or two hands, and penetration directions lie within a cone,
+ * so no pair is opposing unless @a is_opposing makes the last particle push back.
+ */
+class GroupedContacts
+{
+public:
+    GroupedContacts(int hand_count, int child_count, int particle_count, bool is_opposing);
+
+    const HandRegistry& get_hand_registry() const { return hand_registry_; }
+    const std::vector<crsf::TCRModel*>& get_children() const { return child_pointers_; }
+    const std::vector<crsf::THandPhysicsInteractor*>& get_interactors() const { return interactor_pointers_; }
+
+private:
+    HandRegistry hand_registry_;
+    std::vector<std::unique_ptr<crsf::TWorldObject>> wrists_;
+    std::vector<std::unique_ptr<crsf::TCRModel>> children_;
+    std::vector<std::unique_ptr<crsf::THandPhysicsInteractor>> interactors_;
+    std::vector<crsf::TCRModel*> child_pointers_;
+    std::vector<crsf::THandPhysicsInteractor*> interactor_pointers_;
+};
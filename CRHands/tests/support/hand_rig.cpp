@@ -0,0 +1,100 @@
+#include "hand_rig.hpp"
+
+#include <cmath>
+
+#include "hand/hand_topology.hpp"
+
+namespace {
+
+LMatrix4f make_matrix(const LQuaternionf& quat, const LVecBase3f& pos)
+{
+    LMatrix4f mat;
+    quat.extract_to_matrix(mat);
+    mat.set_row(3, pos);
+    return mat;
+}
+
+// finger flexion of joint at frame, in degrees
+float get_flexion(int joint, int frame)
+{
+    return 30.0f + 25.0f * std::sin(0.05f * frame + 0.7f * joint);
+}
+
+}
+
+LQuaternionf make_axis_angle(float angle, const LVecBase3f& axis)
+{
+    LQuaternionf quat;
+    quat.set_from_axis_angle(angle, axis);
+    return quat;
+}
+
+HandRig::HandRig() : hand_(HandTopology::JOINT_COUNT)
+{
+    world_.AddWorldObject(&hand_);
+    hand_.SetMatrix(make_matrix(make_axis_angle(30.0f, LVecBase3f(0, 0, 1)), LVecBase3f(0.1f, 0.2f, 1.0f)));
+
+    models_.resize(HandTopology::JOINT_COUNT);
+    for (auto& model : models_)
+        model = std::make_unique<crsf::TWorldObject>();
+
+    for (int side = 0; side < HandTopology::SIDE_COUNT; ++side)
+    {
+        const float side_sign = side == HandTopology::SIDE_LEFT ? -1.0f : 1.0f;
+
+        auto root = models_[side * HandTopology::SIDE_JOINT_COUNT].get();
+        hand_.AddWorldObject(root);
+        root->SetMatrix(make_matrix(LQuaternionf::ident_quat(), LVecBase3f(0.15f * side_sign, 0, 0)));
+
+        auto wrist = models_[HandTopology::get_wrist_index(side)].get();
+        root->AddWorldObject(wrist);
+        wrist->SetMatrix(make_matrix(make_axis_angle(10.0f * side_sign, LVecBase3f(1, 0, 0)), LVecBase3f(0, 0.05f, 0)));
+
+        for (int finger = 0; finger < HandTopology::FINGER_COUNT; ++finger)
+        {
+            for (int segment = 0; segment < HandTopology::SEGMENT_COUNT; ++segment)
+            {
+                const int joint = HandTopology::get_joint_index(side, finger, segment);
+                const int parent = hand_topology.get_joint(joint).parent;
+
+                models_[parent]->AddWorldObject(models_[joint].get());
+                const LVecBase3f offset = segment == 0 ? LVecBase3f(0.08f * side_sign, 0.02f * (finger - 2), 0) : LVecBase3f(0.03f * side_sign, 0, 0);
+                models_[joint]->SetMatrix(make_matrix(LQuaternionf::ident_quat(), offset));
+            }
+        }
+    }
+
+    for (int k = 0; k < HandTopology::JOINT_COUNT; ++k)
+        hand_.GetJointData(k)->Set3DModel(models_[k].get());
+
+    hand_.Set3DModel_Wrists(models_[HandTopology::get_wrist_index(HandTopology::SIDE_LEFT)].get(),
+        models_[HandTopology::get_wrist_index(HandTopology::SIDE_RIGHT)].get());
+
+    set_frame(0);
+}
+
+void HandRig::set_frame(int frame)
+{
+    for (int k = 0; k < HandTopology::JOINT_COUNT; ++k)
+    {
+        const auto& joint = hand_topology.get_joint(k);
+        if (joint.kind != HandTopology::JOINT_KIND_FINGER)
+            continue;
+
+        auto model = models_[k].get();
+        model->SetMatrix(make_matrix(make_axis_angle(get_flexion(k, frame), LVecBase3f(0, 0, 1)), model->GetMatrix().get_row3(3)));
+    }
+}
+
+void make_device_poses(int frame, std::vector<crsf::TPose>& poses)
+{
+    for (std::size_t k = 0; k < poses.size(); ++k)
+    {
+        const int joint = static_cast<int>(k);
+        const LQuaternionf quat = make_axis_angle(get_flexion(joint, frame), LVecBase3f(0, 0, 1))
+            * make_axis_angle(5.0f * std::cos(0.03f * frame + joint), LVecBase3f(0, 1, 0));
+        const LVecBase3f pos(0.01f * joint, 0.02f * std::sin(0.04f * frame + joint), 0.3f);
+
+        poses[k].MakePosQuat(pos, quat);
+    }
+}
@@ -0,0 +1,54 @@
+#pragma once
+
+#include <memory>
+#include <vector>
+
+#include <crsf/CRModel/TCRHand.h>
+#include <crsf/System/TPose.h>
+
+/**
+ * Hand model of HandTopology layout built from test doubles.
+ *
+ * Joint models follow the topology hierarchy under the hand object:
+ * side root -> wrist -> finger segments, so HandKinematics composes fingers from local transforms.
+ * Poses are closed-form functions of frame number, so every run sees the same input.
+ */
+class HandRig
+{
+public:
+    HandRig();
+
+    crsf::TWorldObject* get_world();
+    crsf::TCRHand* get_hand();
+    crsf::TWorldObject* get_joint_model(int joint);
+
+    /** Set local rotations of all finger joints to the pose of @a frame. */
+    void set_frame(int frame);
+
+private:
+    crsf::TWorldObject world_;
+    crsf::TCRHand hand_;
+    std::vector<std::unique_ptr<crsf::TWorldObject>> models_;
+};
+
+/** Device poses of @a frame for every joint in @a poses (positions in meters). */
+void make_device_poses(int frame, std::vector<crsf::TPose>& poses);
+
+LQuaternionf make_axis_angle(float angle, const LVecBase3f& axis);
+
+// ************************************************************************************************
+
+inline crsf::TWorldObject* HandRig::get_world()
+{
+    return &world_;
+}
+
+inline crsf::TCRHand* HandRig::get_hand()
+{
+    return &hand_;
+}
+
+inline crsf::TWorldObject* HandRig::get_joint_model(int joint)
+{
+    return models_[joint].get();
+}
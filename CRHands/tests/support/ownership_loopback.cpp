@@ -0,0 +1,92 @@
+#include "ownership_loopback.hpp"
+
+OwnershipLoopback::Node::Node(unsigned int system_index, int object_count) :
+    ownership(system_index), amo(GraspOwnershipMemory::get_pose_count(object_count)),
+    states(object_count, GraspOwnership::ObjectState{ LVecBase3f(0), LQuaternionf::ident_quat() })
+{
+    poses = amo.GetAvatarMemory();
+}
+
+OwnershipLoopback::OwnershipLoopback(int node_count, int object_count, int delay_steps, double step_time) :
+    delay_steps_(delay_steps), step_time_(step_time), in_flight_(node_count), delivered_(node_count)
+{
+    for (int k = 0; k < node_count; ++k)
+    {
+        const unsigned int system_index = static_cast<unsigned int>(k + 1);
+        nodes_.push_back(std::make_unique<Node>(system_index, object_count));
+
+        auto& node = *nodes_.back();
+        node.ownership.set_object_count(object_count);
+        node.memory.set_object_count(object_count, static_cast<unsigned int>(node_count));
+        delivered_[k] = node.amo.GetAvatarMemory();
+    }
+}
+
+void OwnershipLoopback::step(const std::vector<unsigned int>& order)
+{
+    // deliver memory published delay steps ago
+    for (std::size_t k = 0, k_end = in_flight_.size(); k < k_end; ++k)
+    {
+        auto& queue = in_flight_[k];
+        while (!queue.empty() && queue.front().step + delay_steps_ <= step_)
+        {
+            delivered_[k] = std::move(queue.front().poses);
+            queue.pop_front();
+        }
+    }
+
+    if (order.empty())
+    {
+        for (std::size_t k = 0, k_end = nodes_.size(); k < k_end; ++k)
+            step_node(k);
+    }
+    else
+    {
+        for (unsigned int system_index: order)
+            step_node(system_index - 1);
+    }
+
+    ++step_;
+}
+
+uint64_t OwnershipLoopback::get_update_count() const
+{
+    uint64_t count = 0;
+    for (const auto& node: nodes_)
+        count += node->amo.GetUpdateCount();
+    return count;
+}
+
+std::size_t OwnershipLoopback::get_bytes_per_update() const
+{
+    return nodes_.front()->poses.size() * 7 * sizeof(float);
+}
+
+bool OwnershipLoopback::is_agreed(int object_id, unsigned int owner) const
+{
+    for (const auto& node: nodes_)
+    {
+        if (node->ownership.get_owner(object_id) != owner)
+            return false;
+    }
+    return true;
+}
+
+void OwnershipLoopback::step_node(std::size_t index)
+{
+    auto& node = *nodes_[index];
+    const double now = step_ * step_time_;
+
+    for (std::size_t k = 0, k_end = nodes_.size(); k < k_end; ++k)
+    {
+        if (k != index)
+            node.memory.read(node.ownership, static_cast<unsigned int>(k + 1), delivered_[k], now);
+    }
+
+    if (!node.memory.write(node.ownership, node.states, node.poses))
+        return;
+
+    node.amo.SetAvatarMemory(node.poses);
+    node.amo.UpdateAvatarMemoryObject();
+    in_flight_[index].push_back(Delivery{ step_, node.poses });
+}
@@ -0,0 +1,85 @@
+#pragma once
+
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <vector>
+
+#include <crsf/CoexistenceInterface/TAvatarMemoryObject.h>
+
+#include "hand/grasp_ownership.hpp"
+#include "hand/grasp_ownership_memory.hpp"
+
+/**
+ * Nodes of grasp ownership connected by a loopback network of avatar memory objects.
+ *
+ * Each node runs the same receive and publish step as HandManager::sync_grasp_ownership,
+ * and a published memory reaches other nodes @a delay_steps steps later (at the earliest, in the next step).
+ * System indices are 1 to node count, and time advances by @a step_time per step.
+ */
+class OwnershipLoopback
+{
+public:
+    struct Node
+    {
+        explicit Node(unsigned int system_index, int object_count);
+
+        GraspOwnership ownership;
+        GraspOwnershipMemory memory;
+        crsf::TAvatarMemoryObject amo;
+        std::vector<crsf::TPose> poses;
+        std::vector<GraspOwnership::ObjectState> states;     ///< simulated states of objects
+    };
+
+public:
+    OwnershipLoopback(int node_count, int object_count, int delay_steps, double step_time = 1.0 / 90.0);
+
+    int get_node_count() const;
+    Node& get_node(unsigned int system_index);
+
+    /** Step all nodes in @a order of system indices (all nodes in index order if empty). */
+    void step(const std::vector<unsigned int>& order = {});
+
+    int get_step() const;
+
+    uint64_t get_update_count() const;
+
+    /** Bytes of avatar memory sent per update: poses of (position, quaternion) in float. */
+    std::size_t get_bytes_per_update() const;
+
+    /** True if all nodes resolve @a object_id to @a owner. */
+    bool is_agreed(int object_id, unsigned int owner) const;
+
+private:
+    struct Delivery
+    {
+        int step;
+        std::vector<crsf::TPose> poses;
+    };
+
+    void step_node(std::size_t index);
+
+    const int delay_steps_;
+    const double step_time_;
+    int step_ = 0;
+    std::vector<std::unique_ptr<Node>> nodes_;
+    std::vector<std::deque<Delivery>> in_flight_;        ///< [system index - 1] published memory not yet delivered
+    std::vector<std::vector<crsf::TPose>> delivered_;    ///< [system index - 1] memory seen by other nodes
+};
+
+// ************************************************************************************************
+
+inline int OwnershipLoopback::get_node_count() const
+{
+    return static_cast<int>(nodes_.size());
+}
+
+inline OwnershipLoopback::Node& OwnershipLoopback::get_node(unsigned int system_index)
+{
+    return *nodes_[system_index - 1];
+}
+
+inline int OwnershipLoopback::get_step() const
+{
+    return step_;
+}
@@ -0,0 +1,198 @@
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "hand/force_feedback_controller.hpp"
+
+namespace {
+
+using namespace std::chrono_literals;
+using Clock = std::chrono::steady_clock;
+
+/** Exoskeleton which timestamps received commands, as Kinesthetic_HandMoCAPInterface reads force memory. */
+class FakeExoskeleton
+{
+public:
+    struct Write
+    {
+        ForceFeedbackController::Command command;
+        Clock::time_point time;
+    };
+
+    void write(const ForceFeedbackController::Command& command)
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        writes_.push_back(Write{ command, Clock::now() });
+    }
+
+    std::vector<Write> get_writes() const
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return writes_;
+    }
+
+private:
+    mutable std::mutex mutex_;
+    std::vector<Write> writes_;
+};
+
+/** Sends output of controller to the device at bounded rate, as HandManager::publish_force_feedback does on main thread. */
+class FakePublisher
+{
+public:
+    FakePublisher(ForceFeedbackController& controller, FakeExoskeleton& device, Clock::duration interval) :
+        controller_(controller), device_(device), interval_(interval)
+    {
+        thread_ = std::thread([this] {
+            Clock::time_point last_publish_time;
+            while (is_running_.load())
+            {
+                const auto now = Clock::now();
+                ForceFeedbackController::Command command;
+                if (now - last_publish_time >= interval_ && controller_.read_output(command))
+                {
+                    last_publish_time = now;
+                    device_.write(command);
+                }
+                std::this_thread::sleep_for(1ms);
+            }
+        });
+    }
+
+    ~FakePublisher()
+    {
+        is_running_.store(false);
+        thread_.join();
+    }
+
+private:
+    ForceFeedbackController& controller_;
+    FakeExoskeleton& device_;
+    const Clock::duration interval_;
+    std::atomic<bool> is_running_{ true };
+    std::thread thread_;
+};
+
+ForceFeedbackController::Parameters make_parameters()
+{
+    ForceFeedbackController::Parameters params;
+    params.period = 2ms;
+    params.input_timeout = 30ms;
+    return params;
+}
+
+constexpr auto PUBLISH_INTERVAL = 10ms;
+
+TEST(ForceFeedbackControllerTest, TicksAtPeriodWithBoundedJitter)
+{
+    const auto params = make_parameters();
+    FakeExoskeleton device;
+    {
+        ForceFeedbackController controller(params);
+        FakePublisher publisher(controller, device, PUBLISH_INTERVAL);
+        std::this_thread::sleep_for(500ms);
+    }
+
+    const auto writes = device.get_writes();
+    ASSERT_GE(writes.size(), 10u);
+
+    // controller period from ticks which the device received
+    const double elapsed_ms = std::chrono::duration<double, std::milli>(writes.back().time - writes.front().time).count();
+    const double tick_period_ms = elapsed_ms / static_cast<double>(writes.back().command.tick - writes.front().command.tick);
+    const double period_ms = std::chrono::duration<double, std::milli>(params.period).count();
+    EXPECT_GT(tick_period_ms, 0.9 * period_ms);
+    EXPECT_LT(tick_period_ms, 1.5 * period_ms);
+
+    // device receives newer ticks at bounded rate
+    std::vector<double> publish_intervals_ms;
+    for (std::size_t k = 1; k < writes.size(); ++k)
+    {
+        EXPECT_GT(writes[k].command.tick, writes[k - 1].command.tick);
+        publish_intervals_ms.push_back(std::chrono::duration<double, std::milli>(writes[k].time - writes[k - 1].time).count());
+    }
+
+    const double publish_interval_ms = std::chrono::duration<double, std::milli>(PUBLISH_INTERVAL).count();
+    EXPECT_GE(*std::min_element(publish_intervals_ms.begin(), publish_intervals_ms.end()), publish_interval_ms);
+
+    std::nth_element(publish_intervals_ms.begin(), publish_intervals_ms.begin() + publish_intervals_ms.size() / 2, publish_intervals_ms.end());
+    EXPECT_LT(publish_intervals_ms[publish_intervals_ms.size() / 2], publish_interval_ms + 5.0);
+}
+
+TEST(ForceFeedbackControllerTest, ReportsJitterOfTicks)
+{
+    const auto params = make_parameters();
+    ForceFeedbackController controller(params);
+    std::this_thread::sleep_for(300ms);
+
+    const auto jitter = controller.get_jitter_histogram().get_snapshot();
+    ASSERT_GT(jitter.count, 100u);
+
+    // sleep_until overshoots on a loaded machine, so only the median is bounded tightly
+    EXPECT_LT(jitter.get_percentile_ns(0.5), static_cast<uint64_t>(std::chrono::nanoseconds(params.period).count() / 2));
+    EXPECT_LT(controller.get_deadline_miss_count(), jitter.count / 10);
+}
+
+TEST(ForceFeedbackControllerTest, ContactReachesDeviceThroughMailbox)
+{
+    constexpr int HAND = 1;
+    constexpr int FINGER = 1;
+    constexpr float DEPTH = 0.005f;
+
+    const auto params = make_parameters();
+    ForceFeedbackController controller(params);
+    FakeExoskeleton device;
+    FakePublisher publisher(controller, device, PUBLISH_INTERVAL);
+
+    // physics step posts contact of one fingertip at 200 Hz
+    const auto contact_start_time = Clock::now();
+    while (Clock::now() - contact_start_time < 200ms)
+    {
+        ForceFeedbackController::ContactInput input = {};
+        input.depths[HAND][FINGER] = DEPTH;
+        input.time = Clock::now();
+        controller.post_contacts(input);
+        std::this_thread::sleep_for(5ms);
+    }
+    const auto contact_end_time = Clock::now();
+
+    // physics stops, and resistance is released after input timeout
+    std::this_thread::sleep_for(params.input_timeout + 150ms);
+
+    const auto writes = device.get_writes();
+    const auto first_contact = std::find_if(writes.begin(), writes.end(), [](const FakeExoskeleton::Write& write) {
+        return write.command.resistances[HAND][FINGER] > 0.0f;
+    });
+    ASSERT_NE(first_contact, writes.end());
+    EXPECT_LT(first_contact->time - contact_start_time, PUBLISH_INTERVAL + 20ms);
+
+    // steady resistance = stiffness * depth, and only the touching finger resists
+    float max_resistance = 0.0f;
+    for (const auto& write: writes)
+    {
+        if (write.time > contact_end_time)
+            break;
+
+        for (int hand = 0; hand < ForceFeedbackController::HAND_COUNT; ++hand)
+        {
+            for (int finger = 0; finger < ForceFeedbackController::FINGER_COUNT; ++finger)
+            {
+                if (hand != HAND || finger != FINGER)
+                {
+                    EXPECT_EQ(write.command.resistances[hand][finger], 0.0f);
+                }
+            }
+        }
+        max_resistance = (std::max)(max_resistance, write.command.resistances[HAND][FINGER]);
+    }
+    EXPECT_NEAR(max_resistance, params.stiffness * DEPTH, 0.05f);
+
+    ASSERT_FALSE(writes.empty());
+    EXPECT_EQ(writes.back().command.resistances[HAND][FINGER], 0.0f);
+}
+
+}
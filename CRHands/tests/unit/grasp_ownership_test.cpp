@@ -0,0 +1,138 @@
+#include <algorithm>
+#include <iostream>
+#include <numeric>
+
+#include <gtest/gtest.h>
+
+#include "support/ownership_loopback.hpp"
+
+namespace {
+
+constexpr int NODE_COUNT = 4;
+constexpr int OBJECT_COUNT = 8;
+constexpr int DELAY_STEPS = 3;
+
+// steps until claims of all nodes reach each other
+constexpr int SETTLE_STEPS = 2 * DELAY_STEPS + 2;
+
+void run(OwnershipLoopback& loopback, int steps, const std::vector<unsigned int>& order = {})
+{
+    for (int k = 0; k < steps; ++k)
+        loopback.step(order);
+}
+
+/** Steps until all nodes agree that @a owner owns @a object_id, or -1 if they do not agree in @a max_steps. */
+int run_until_agreed(OwnershipLoopback& loopback, int object_id, unsigned int owner, int max_steps)
+{
+    for (int k = 0; k < max_steps; ++k)
+    {
+        if (loopback.is_agreed(object_id, owner))
+            return k;
+        loopback.step();
+    }
+    return loopback.is_agreed(object_id, owner) ? max_steps : -1;
+}
+
+TEST(GraspOwnershipTest, SimultaneousClaimsResolveToSameOwner)
+{
+    // same claims in any processing order of nodes give the same owner
+    std::vector<unsigned int> order(NODE_COUNT);
+    std::iota(order.begin(), order.end(), 1u);
+
+    do
+    {
+        OwnershipLoopback loopback(NODE_COUNT, OBJECT_COUNT, DELAY_STEPS);
+        for (unsigned int system_index = 1; system_index <= NODE_COUNT; ++system_index)
+            loopback.get_node(system_index).ownership.request(0);
+
+        // each node owns the object until the other claims arrive
+        for (unsigned int system_index = 1; system_index <= NODE_COUNT; ++system_index)
+            EXPECT_TRUE(loopback.get_node(system_index).ownership.is_local_authority(0));
+
+        run(loopback, SETTLE_STEPS, order);
+
+        // same Lamport stamp is resolved to the lowest system index
+        EXPECT_TRUE(loopback.is_agreed(0, 1)) << "order starts with " << order.front();
+        EXPECT_EQ(loopback.get_node(1).ownership.get_local_claim(0), loopback.get_node(NODE_COUNT).ownership.get_local_claim(0));
+        for (unsigned int system_index = 2; system_index <= NODE_COUNT; ++system_index)
+            EXPECT_FALSE(loopback.get_node(system_index).ownership.is_local_authority(0));
+    } while (std::next_permutation(order.begin(), order.end()));
+}
+
+TEST(GraspOwnershipTest, EarlierStampWinsOverLowerSystemIndex)
+{
+    OwnershipLoopback loopback(NODE_COUNT, OBJECT_COUNT, DELAY_STEPS);
+
+    loopback.get_node(NODE_COUNT).ownership.request(0);
+    run(loopback, SETTLE_STEPS);
+    ASSERT_TRUE(loopback.is_agreed(0, NODE_COUNT));
+
+    // a claim after seeing the owner has a later stamp, so it is queued
+    loopback.get_node(1).ownership.request(0);
+    EXPECT_GT(loopback.get_node(1).ownership.get_local_claim(0), loopback.get_node(NODE_COUNT).ownership.get_local_claim(0));
+
+    run(loopback, SETTLE_STEPS);
+    EXPECT_TRUE(loopback.is_agreed(0, NODE_COUNT));
+
+    // queued claim wins on release
+    loopback.get_node(NODE_COUNT).ownership.release(0);
+    EXPECT_GE(run_until_agreed(loopback, 0, 1, SETTLE_STEPS), 0);
+}
+
+TEST(GraspOwnershipTest, ReportsTransferLatencyAndBytesPerUpdate)
+{
+    OwnershipLoopback loopback(NODE_COUNT, OBJECT_COUNT, DELAY_STEPS);
+
+    // node 1 grasps all objects and moves them
+    for (int k = 0; k < OBJECT_COUNT; ++k)
+        loopback.get_node(1).ownership.request(k);
+    run(loopback, SETTLE_STEPS);
+    for (int k = 0; k < OBJECT_COUNT; ++k)
+        ASSERT_TRUE(loopback.is_agreed(k, 1));
+
+    const uint64_t idle_update_count = loopback.get_update_count();
+    run(loopback, SETTLE_STEPS);
+    EXPECT_EQ(loopback.get_update_count(), idle_update_count) << "idle objects should not update memory";
+
+    // node 2 claims while node 1 holds, then node 1 releases
+    loopback.get_node(2).ownership.request(0);
+    run(loopback, SETTLE_STEPS);
+    ASSERT_TRUE(loopback.is_agreed(0, 1));
+
+    auto& owner = loopback.get_node(1);
+    owner.ownership.release(0);
+    const int transfer_steps = run_until_agreed(loopback, 0, 2, 4 * SETTLE_STEPS);
+    ASSERT_GE(transfer_steps, 0);
+
+    // release reaches other nodes after one delay, and new owner is known to all after one more
+    EXPECT_LE(transfer_steps, 2 * DELAY_STEPS + 1);
+
+    // state of new owner reaches other nodes
+    auto& new_owner = loopback.get_node(2);
+    new_owner.states[0].pos = LVecBase3f(0.1f, 0.2f, 0.3f);
+    const uint64_t before_move_count = loopback.get_update_count();
+    run(loopback, SETTLE_STEPS);
+    EXPECT_EQ(loopback.get_update_count(), before_move_count + 1);
+
+    for (unsigned int system_index = 1; system_index <= NODE_COUNT; ++system_index)
+    {
+        if (system_index == 2)
+            continue;
+
+        GraspOwnership::ObjectState state;
+        ASSERT_TRUE(loopback.get_node(system_index).ownership.get_remote_state(0, 1.0e3, state));
+        EXPECT_NEAR((state.pos - new_owner.states[0].pos).length(), 0.0f, 1e-6f);
+    }
+
+    const std::size_t bytes_per_update = loopback.get_bytes_per_update();
+    EXPECT_EQ(bytes_per_update, GraspOwnershipMemory::get_pose_count(OBJECT_COUNT) * 7 * sizeof(float));
+
+    RecordProperty("transfer_steps", transfer_steps);
+    RecordProperty("bytes_per_update", static_cast<int>(bytes_per_update));
+    RecordProperty("update_count", static_cast<int>(loopback.get_update_count()));
+    std::cout << "[ RESULT   ] transfer: " << transfer_steps << " steps (delay " << DELAY_STEPS << " steps), "
+        << bytes_per_update << " bytes per update, " << loopback.get_update_count() << " updates of "
+        << NODE_COUNT << " nodes" << std::endl;
+}
+
+}
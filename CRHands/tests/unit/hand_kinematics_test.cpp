@@ -0,0 +1,98 @@
+#include <memory>
+
+#include <gtest/gtest.h>
+
+#include "hand/hand_kinematics.hpp"
+#include "hand/hand_topology.hpp"
+#include "support/hand_rig.hpp"
+
+namespace {
+
+constexpr float QUAT_TOLERANCE = 1e-4f;
+
+/**
+ * Scale and shear part of a matrix composed by Panda compose_matrix (LMatrix3::scale_shear_mat of CS_zup_right):
+ * x row = sx * (1, shxy, 0), y row = sy * (0, 1, 0), z row = sz * (shxz, shyz, 1).
+ */
+LMatrix4f make_scale_shear(const LVecBase3f& scale, const LVecBase3f& shear)
+{
+    LMatrix4f mat = LMatrix4f::ident_mat();
+    mat.set_row(0, LVecBase3f(scale[0], shear[0] * scale[0], 0.0f));
+    mat.set_row(1, LVecBase3f(0.0f, scale[1], 0.0f));
+    mat.set_row(2, LVecBase3f(shear[1] * scale[2], shear[2] * scale[2], scale[2]));
+    return mat;
+}
+
+LMatrix4f make_matrix(const LQuaternionf& quat, const LVecBase3f& pos)
+{
+    LMatrix4f mat;
+    quat.extract_to_matrix(mat);
+    mat.set_row(3, pos);
+    return mat;
+}
+
+bool is_same_rotation(const LQuaternionf& a, const LQuaternionf& b)
+{
+    return a.almost_same_direction(b, QUAT_TOLERANCE);
+}
+
+}
+
+TEST(HandKinematicsTest, QuaternionRemovesScaleAndShearAsPandaDecomposes)
+{
+    HandRig rig;
+    HandKinematics kinematics;
+    kinematics.bind(rig.get_hand());
+    kinematics.update(rig.get_world());
+
+    const int joint = HandTopology::get_joint_index(HandTopology::SIDE_RIGHT, 1, 1);
+    const int parent = hand_topology.get_joint(joint).parent;
+    const LQuaternionf parent_quat = kinematics.get_quaternion(parent);
+
+    const LQuaternionf local_quat = make_axis_angle(50.0f, LVecBase3f(0.3f, -0.5f, 0.8f));
+    rig.get_joint_model(joint)->SetMatrix(make_scale_shear(LVecBase3f(1.3f, 0.7f, 2.1f), LVecBase3f(0.4f, -0.3f, 0.6f)) *
+        make_matrix(local_quat, LVecBase3f(0.03f, 0, 0)));
+    kinematics.update(rig.get_world());
+
+    // a * b applies a first, so local rotation is followed by parent rotation
+    EXPECT_TRUE(is_same_rotation(kinematics.get_quaternion(joint), local_quat * parent_quat));
+}
+
+TEST(HandKinematicsTest, QuaternionMatchesRotationWithoutShear)
+{
+    HandRig rig;
+    rig.set_frame(17);
+
+    HandKinematics kinematics;
+    kinematics.bind(rig.get_hand());
+    kinematics.update(rig.get_world());
+
+    for (int k = 0; k < kinematics.get_joint_count(); ++k)
+    {
+        LQuaternionf expected;
+        expected.set_from_matrix(rig.get_joint_model(k)->GetMatrix(rig.get_world()).get_upper_3());
+        EXPECT_TRUE(is_same_rotation(kinematics.get_quaternion(k), expected)) << "joint " << k;
+    }
+}
+
+TEST(HandKinematicsTest, RebindIsNeededWhenJointModelIsReplacedOrReparented)
+{
+    HandRig rig;
+    HandKinematics kinematics;
+    kinematics.bind(rig.get_hand());
+    EXPECT_TRUE(kinematics.is_bound(rig.get_hand()));
+
+    // same hand, another model of a finger joint
+    const int joint = HandTopology::get_joint_index(HandTopology::SIDE_LEFT, 2, 1);
+    auto replaced_model = std::make_unique<crsf::TWorldObject>();
+    rig.get_joint_model(hand_topology.get_joint(joint).parent)->AddWorldObject(replaced_model.get());
+    rig.get_hand()->GetJointData(joint)->Set3DModel(replaced_model.get());
+    EXPECT_FALSE(kinematics.is_bound(rig.get_hand()));
+
+    kinematics.bind(rig.get_hand());
+    EXPECT_TRUE(kinematics.is_bound(rig.get_hand()));
+
+    // same model moved out of topology hierarchy
+    rig.get_world()->AddWorldObject(replaced_model.get());
+    EXPECT_FALSE(kinematics.is_bound(rig.get_hand()));
+}
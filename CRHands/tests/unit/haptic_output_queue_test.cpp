@@ -0,0 +1,188 @@
+#include <chrono>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "util/haptic_output_queue.hpp"
+
+namespace {
+
+using namespace std::chrono_literals;
+
+/** Sink which records sent masks per channel. */
+class RecordingSink
+{
+public:
+    struct Write
+    {
+        HapticOutputQueue::Mask mask;
+        std::chrono::steady_clock::time_point time;
+    };
+
+    void write(int channel, HapticOutputQueue::Mask mask)
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        writes_[channel].push_back(Write{ mask, std::chrono::steady_clock::now() });
+    }
+
+    std::vector<Write> get_writes(int channel) const
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return writes_[channel];
+    }
+
+    /** Wait until @a mask is the last write of @a channel. */
+    bool wait_last(int channel, HapticOutputQueue::Mask mask, std::chrono::milliseconds timeout = 1s) const
+    {
+        const auto deadline = std::chrono::steady_clock::now() + timeout;
+        while (std::chrono::steady_clock::now() < deadline)
+        {
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                if (!writes_[channel].empty() && writes_[channel].back().mask == mask)
+                    return true;
+            }
+            std::this_thread::sleep_for(1ms);
+        }
+        return false;
+    }
+
+private:
+    mutable std::mutex mutex_;
+    std::vector<Write> writes_[HapticOutputQueue::CHANNEL_COUNT];
+};
+
+class HapticOutputQueueTest : public ::testing::Test
+{
+protected:
+    void start(std::chrono::milliseconds min_interval)
+    {
+        queue_ = std::make_unique<HapticOutputQueue>([this](int channel, HapticOutputQueue::Mask mask) {
+            sink_.write(channel, mask);
+        }, min_interval);
+    }
+
+    RecordingSink sink_;
+    std::unique_ptr<HapticOutputQueue> queue_;
+};
+
+TEST_F(HapticOutputQueueTest, CoalescesToNewestMaskWithinInterval)
+{
+    constexpr auto MIN_INTERVAL = 50ms;
+    start(MIN_INTERVAL);
+
+    queue_->submit(0, 1);
+    ASSERT_TRUE(sink_.wait_last(0, 1));
+
+    // burst inside one interval is sent as its newest mask only
+    for (HapticOutputQueue::Mask mask = 2; mask <= 100; ++mask)
+        queue_->submit(0, mask);
+    ASSERT_TRUE(sink_.wait_last(0, 100));
+
+    const auto writes = sink_.get_writes(0);
+    EXPECT_LE(writes.size(), 3u);
+    EXPECT_EQ(queue_->get_submitted_count(), 100u);
+    EXPECT_EQ(queue_->get_sent_count(), writes.size());
+
+    // one write per channel in min interval
+    for (std::size_t k = 1; k < writes.size(); ++k)
+        EXPECT_GE(writes[k].time - writes[k - 1].time, MIN_INTERVAL - 1ms);
+}
+
+TEST_F(HapticOutputQueueTest, SkipsUnchangedMask)
+{
+    start(1ms);
+
+    queue_->submit(1, 5);
+    ASSERT_TRUE(sink_.wait_last(1, 5));
+
+    for (int k = 0; k < 10; ++k)
+    {
+        queue_->submit(1, 5);
+        std::this_thread::sleep_for(2ms);
+    }
+    queue_->submit(1, 6);
+    ASSERT_TRUE(sink_.wait_last(1, 6));
+
+    EXPECT_EQ(sink_.get_writes(1).size(), 2u);
+    EXPECT_TRUE(sink_.get_writes(0).empty());
+}
+
+TEST_F(HapticOutputQueueTest, HoldsMasksWhilePausedAndResendsOnResume)
+{
+    start(1ms);
+
+    queue_->submit(0, 3);
+    ASSERT_TRUE(sink_.wait_last(0, 3));
+
+    // device session swaps the interface while paused
+    queue_->pause();
+    queue_->submit(1, 4);
+    std::this_thread::sleep_for(20ms);
+    EXPECT_TRUE(sink_.get_writes(1).empty());
+
+    queue_->resume();
+    EXPECT_TRUE(sink_.wait_last(1, 4));
+
+    // unchanged mask is sent again to the new device
+    const auto writes = sink_.get_writes(0);
+    ASSERT_EQ(writes.size(), 2u);
+    EXPECT_EQ(writes.back().mask, 3u);
+}
+
+TEST_F(HapticOutputQueueTest, KeepsSubmitOrderPerChannelWithConcurrentProducers)
+{
+    constexpr HapticOutputQueue::Mask LAST_MASK = 20000;
+    start(1ms);
+
+    // one producer per channel while the worker drains
+    std::vector<std::thread> producers;
+    for (int channel = 0; channel < HapticOutputQueue::CHANNEL_COUNT; ++channel)
+    {
+        producers.emplace_back([this, channel] {
+            for (HapticOutputQueue::Mask mask = 1; mask <= LAST_MASK; ++mask)
+                queue_->submit(channel, mask);
+        });
+    }
+    for (auto&& producer: producers)
+        producer.join();
+
+    for (int channel = 0; channel < HapticOutputQueue::CHANNEL_COUNT; ++channel)
+    {
+        ASSERT_TRUE(sink_.wait_last(channel, LAST_MASK)) << "channel " << channel;
+
+        // coalesced masks are a subsequence of submitted masks
+        const auto writes = sink_.get_writes(channel);
+        for (std::size_t k = 1; k < writes.size(); ++k)
+            EXPECT_LT(writes[k - 1].mask, writes[k].mask) << "channel " << channel << ", write " << k;
+    }
+
+    EXPECT_EQ(queue_->get_submitted_count(), HapticOutputQueue::CHANNEL_COUNT * LAST_MASK);
+    EXPECT_LT(queue_->get_sent_count(), queue_->get_submitted_count());
+}
+
+TEST_F(HapticOutputQueueTest, SendsLastMaskAfterManyProducers)
+{
+    start(1ms);
+
+    // several producers share a channel, as physics step and haptic loop do
+    std::vector<std::thread> producers;
+    for (int k = 0; k < 4; ++k)
+    {
+        producers.emplace_back([this, k] {
+            for (HapticOutputQueue::Mask mask = 0; mask < 5000; ++mask)
+                queue_->submit(k % HapticOutputQueue::CHANNEL_COUNT, (mask << 2) | k);
+        });
+    }
+    for (auto&& producer: producers)
+        producer.join();
+
+    queue_->submit(0, 0xFFFFu);
+    queue_->submit(1, 0xFFFFu);
+    EXPECT_TRUE(sink_.wait_last(0, 0xFFFFu));
+    EXPECT_TRUE(sink_.wait_last(1, 0xFFFFu));
+}
+
+}
@@ -0,0 +1,127 @@
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "util/haptic_output_queue.hpp"
+#include "util/haptic_renderer.hpp"
+
+namespace {
+
+using namespace std::chrono_literals;
+
+/** Vibration glove which records writes, as Hand_MoCAPInterface::SetVibration receives them. */
+class FakeGlove
+{
+public:
+    struct Write
+    {
+        int hand;
+        uint32_t mask;
+        std::chrono::steady_clock::time_point time;
+    };
+
+    void set_vibration(int hand, uint32_t mask)
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        writes_.push_back(Write{ hand, mask, std::chrono::steady_clock::now() });
+    }
+
+    std::vector<Write> get_writes() const
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return writes_;
+    }
+
+private:
+    mutable std::mutex mutex_;
+    std::vector<Write> writes_;
+};
+
+/** Renderer writing to the glove through output queue, as HandManager connects them. */
+class HapticRendererTest : public ::testing::Test
+{
+protected:
+    void start(std::chrono::milliseconds min_interval)
+    {
+        output_queue_ = std::make_unique<HapticOutputQueue>([this](int channel, HapticOutputQueue::Mask mask) {
+            glove_.set_vibration(channel, mask);
+        }, min_interval);
+
+        HapticRenderer::Parameters params;
+        params.period = 1ms;
+        params.onset_duration = 30ms;
+        renderer_ = std::make_unique<HapticRenderer>([this](int hand, uint32_t finger_bits) {
+            output_queue_->submit(hand, finger_bits);
+        }, params);
+    }
+
+    void stop()
+    {
+        renderer_.reset();
+        output_queue_.reset();
+    }
+
+    FakeGlove glove_;
+    std::unique_ptr<HapticOutputQueue> output_queue_;
+    std::unique_ptr<HapticRenderer> renderer_;
+};
+
+}
+
+TEST_F(HapticRendererTest, NoContactDoesNotWriteGlove)
+{
+    start(5ms);
+    std::this_thread::sleep_for(50ms);
+    stop();
+
+    EXPECT_TRUE(glove_.get_writes().empty());
+}
+
+TEST_F(HapticRendererTest, GloveWritesAreRateLimited)
+{
+    const auto min_interval = 20ms;
+    start(min_interval);
+
+    // half intensity toggles on/off bits every tick of 1 kHz loop
+    const float max_depth = HapticRenderer::Parameters().max_depth;
+    renderer_->set_contact(0, HapticRenderer::FINGER_INDEX, max_depth * 0.5f, 0.0f);
+
+    const auto start_time = std::chrono::steady_clock::now();
+    std::this_thread::sleep_for(200ms);
+    stop();
+    const auto elapsed = std::chrono::steady_clock::now() - start_time;
+
+    const auto writes = glove_.get_writes();
+    ASSERT_FALSE(writes.empty());
+
+    // one write per interval at most, instead of one per toggle
+    EXPECT_LE(static_cast<long long>(writes.size()), elapsed / min_interval + 1);
+    for (std::size_t k = 1; k < writes.size(); ++k)
+        EXPECT_GE(writes[k].time - writes[k - 1].time, min_interval - 1ms);
+}
+
+TEST_F(HapticRendererTest, OnsetUsesVelocityOfSecondContactStep)
+{
+    start(1ms);
+
+    // first contact step: shallow depth, and velocity is not known yet
+    renderer_->set_contact(1, HapticRenderer::FINGER_THUMB, 1e-6f, 0.0f);
+    std::this_thread::sleep_for(3ms);
+
+    // second contact step: fast approach gives full onset transient
+    renderer_->set_contact(1, HapticRenderer::FINGER_THUMB, 2e-6f, HapticRenderer::Parameters().onset_velocity);
+    std::this_thread::sleep_for(50ms);
+    stop();
+
+    bool is_thumb_on = false;
+    for (const auto& write: glove_.get_writes())
+    {
+        EXPECT_EQ(write.hand, 1);
+        is_thumb_on = is_thumb_on || (write.mask & (1u << HapticRenderer::FINGER_THUMB)) != 0;
+    }
+    EXPECT_TRUE(is_thumb_on);
+}
@@ -0,0 +1,134 @@
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "util/hinge_solver.hpp"
+
+namespace {
+
+const LVecBase3f HINGE_AXIS(1, 0, 0);
+const LVecBase3f SWING_AXIS(0, 0, 1);
+
+struct HingeKeyframe
+{
+    int frame;
+    float twist;        ///< rotation of secondary hand about hinge axis (degrees)
+    float swing;        ///< off-axis wobble of secondary hand (degrees)
+};
+
+// two hand session on jewelry lid (limits [-89, 0]) at 90 Hz: open, push past open limit,
+// close hard against closed limit, wobble while closed, and then reopen to the start pose
+const HingeKeyframe LID_SESSION[] = {
+    {   0,     0.0f,  0.0f },
+    {  30,   -40.0f,  6.0f },
+    {  60,   -70.0f, -4.0f },
+    {  90,   -70.0f,  3.0f },
+    { 120,    10.0f, -8.0f },
+    { 150,    45.0f,  5.0f },
+    { 180,    30.0f, -3.0f },
+    { 210,    45.0f,  2.0f },
+    { 240,     0.0f,  0.0f },
+};
+
+// wrist turns over one and a half turn about hinge axis
+const HingeKeyframe WRIST_TURN_SESSION[] = {
+    {   0,     0.0f,  0.0f },
+    { 100,   540.0f, 10.0f },
+    { 200,     0.0f,  0.0f },
+};
+
+LQuaternionf make_relative_quat(float twist, float swing)
+{
+    LQuaternionf twist_quat;
+    twist_quat.set_from_axis_angle(twist, HINGE_AXIS);
+    LQuaternionf swing_quat;
+    swing_quat.set_from_axis_angle(swing, SWING_AXIS);
+
+    // twist first, then swing, so twist about hinge axis is exactly @a twist
+    return twist_quat * swing_quat;
+}
+
+template <std::size_t N>
+std::vector<LQuaternionf> replay(const HingeKeyframe (&keyframes)[N])
+{
+    std::vector<LQuaternionf> samples;
+    for (std::size_t k = 0; k + 1 < N; ++k)
+    {
+        const auto& from = keyframes[k];
+        const auto& to = keyframes[k + 1];
+        for (int frame = from.frame; frame < to.frame; ++frame)
+        {
+            const float t = static_cast<float>(frame - from.frame) / (to.frame - from.frame);
+            samples.push_back(make_relative_quat(from.twist + (to.twist - from.twist) * t, from.swing + (to.swing - from.swing) * t));
+        }
+    }
+    samples.push_back(make_relative_quat(keyframes[N - 1].twist, keyframes[N - 1].swing));
+    return samples;
+}
+
+float clamp_angle(float angle, float min_angle, float max_angle)
+{
+    return (std::max)(min_angle, (std::min)(angle, max_angle));
+}
+
+}
+
+TEST(HingeSolverTest, TwistAngleIgnoresSwing)
+{
+    EXPECT_NEAR(HingeSolver::get_twist_angle(make_relative_quat(30.0f, 0.0f), HINGE_AXIS), 30.0f, 1e-3f);
+    EXPECT_NEAR(HingeSolver::get_twist_angle(make_relative_quat(30.0f, 25.0f), HINGE_AXIS), 30.0f, 1e-3f);
+    EXPECT_NEAR(HingeSolver::get_twist_angle(make_relative_quat(-170.0f, -15.0f), HINGE_AXIS), -170.0f, 1e-3f);
+}
+
+TEST(HingeSolverTest, LidReplayStaysInLimitsAndHoldsClosedAngle)
+{
+    const float start_angle = -20.0f;
+    const auto samples = replay(LID_SESSION);
+
+    HingeSolver solver;
+    solver.begin(samples.front(), HINGE_AXIS, start_angle, 1.0f);
+
+    int closed_count = 0;
+    for (const auto& sample: samples)
+    {
+        const float angle = solver.solve(sample);
+        const float clamped = clamp_angle(angle, -89.0f, 0.0f);
+
+        ASSERT_GE(clamped, -89.0f);
+        ASSERT_LE(clamped, 0.0f);
+
+        // closed lid stays exactly closed while the hand pushes further
+        if (angle >= 0.0f)
+        {
+            ASSERT_EQ(clamped, 0.0f);
+            ++closed_count;
+        }
+    }
+    EXPECT_GT(closed_count, 0);
+
+    // back at the start pose, the hinge is back at the start angle without drift
+    EXPECT_NEAR(solver.solve(samples.back()), start_angle, 1e-3f);
+}
+
+TEST(HingeSolverTest, WristTurnReplayDoesNotJumpAtHalfTurn)
+{
+    const auto samples = replay(WRIST_TURN_SESSION);
+
+    HingeSolver solver;
+    solver.begin(samples.front(), HINGE_AXIS, 0.0f, -1.0f);
+
+    float last_angle = 0.0f;
+    float min_angle = 0.0f;
+    for (const auto& sample: samples)
+    {
+        const float angle = solver.solve(sample);
+        ASSERT_LT(std::abs(angle - last_angle), 6.0f);
+        last_angle = angle;
+        min_angle = (std::min)(min_angle, angle);
+    }
+
+    EXPECT_NEAR(min_angle, -540.0f, 1e-2f);
+    EXPECT_NEAR(last_angle, 0.0f, 1e-2f);
+}
@@ -0,0 +1,163 @@
+#include <chrono>
+
+#include <gtest/gtest.h>
+
+#include "util/latency_probe.hpp"
+
+namespace {
+
+using namespace std::chrono_literals;
+
+/** Device memory of both wrists, which a device module or the pulse source writes. */
+struct FakeDeviceMemory
+{
+    LatencyProbe::Markers wrists = { LVecBase3f(-0.1f, 0.3f, 0.0f), LVecBase3f(0.1f, 0.3f, 0.0f) };
+};
+
+/** Steps wrists in device memory forth and back, as LatencyPulseSource does. */
+class FakePulseSource
+{
+public:
+    FakePulseSource(LatencyProbe& probe, FakeDeviceMemory& memory) : probe_(probe), memory_(memory)
+    {
+    }
+
+    void inject()
+    {
+        is_stepped_ = !is_stepped_;
+        for (auto&& wrist: memory_.wrists)
+            wrist[0] += is_stepped_ ? STEP : -STEP;
+
+        inject_time_ = LatencyProbe::Clock::now();
+        probe_.begin_pulse(inject_time_, memory_.wrists);
+    }
+
+    LatencyProbe::Clock::time_point get_timeout_time() const
+    {
+        return inject_time_ + 1s;
+    }
+
+private:
+    static constexpr float STEP = 0.02f;
+
+    LatencyProbe& probe_;
+    FakeDeviceMemory& memory_;
+    bool is_stepped_ = false;
+    LatencyProbe::Clock::time_point inject_time_;
+};
+
+/** Stages of hand pipeline with markers, as the Leap path and physics step mark them. */
+class FakeHandPipeline
+{
+public:
+    explicit FakeHandPipeline(LatencyProbe& probe) : probe_(probe)
+    {
+    }
+
+    void render(const FakeDeviceMemory& memory)
+    {
+        probe_.mark(LATENCY_STAGE_CALLBACK, memory.wrists);
+
+        const LatencyProbe::Markers retargeted = memory.wrists;
+        probe_.mark(LATENCY_STAGE_RETARGET, retargeted);
+
+        probe_.mark_scene_write(retargeted);
+
+        probe_.mark(LATENCY_STAGE_PUBLISH);
+    }
+
+    /** Per-step reset task runs every step whether hand has changed or not, and does not read scene. */
+    void step_physics()
+    {
+        probe_.mark_if_scene_has_pulse(LATENCY_STAGE_PHYSICS);
+        probe_.mark(LATENCY_STAGE_GRASP);
+    }
+
+private:
+    LatencyProbe& probe_;
+};
+
+class LatencyProbeTest : public ::testing::Test
+{
+protected:
+    LatencyProbe probe_;
+    FakeDeviceMemory memory_;
+    FakePulseSource source_{ probe_, memory_ };
+    FakeHandPipeline pipeline_{ probe_ };
+};
+
+}
+
+TEST_F(LatencyProbeTest, PulseThroughAllStages)
+{
+    pipeline_.render(memory_);
+    pipeline_.step_physics();
+
+    for (int pulse = 0; pulse < 3; ++pulse)
+    {
+        source_.inject();
+        pipeline_.step_physics();
+        pipeline_.render(memory_);
+        pipeline_.step_physics();
+        EXPECT_TRUE(probe_.update(LatencyProbe::Clock::now()));
+    }
+
+    EXPECT_EQ(probe_.get_pulse_count(), 3u);
+    EXPECT_EQ(probe_.get_end_to_end_histogram().get_snapshot().count, 3u);
+    for (int k = 0; k < LATENCY_STAGE_COUNT; ++k)
+    {
+        const auto stage = static_cast<LatencyStage>(k);
+        EXPECT_EQ(probe_.get_missed_count(stage), 0u) << get_latency_stage_name(stage);
+        EXPECT_EQ(probe_.get_stage_histogram(stage).get_snapshot().count, 3u) << get_latency_stage_name(stage);
+    }
+}
+
+TEST_F(LatencyProbeTest, PhysicsStepAfterSceneIsOverwrittenIsMissed)
+{
+    source_.inject();
+    pipeline_.render(memory_);
+
+    // device sample replaces the pulse in scene before next physics step
+    memory_.wrists[1] += LVecBase3f(0.0f, 0.003f, 0.0f);
+    pipeline_.render(memory_);
+    pipeline_.step_physics();
+
+    EXPECT_TRUE(probe_.update(source_.get_timeout_time()));
+    EXPECT_EQ(probe_.get_missed_count(LATENCY_STAGE_SCENE_WRITE), 0u);
+    EXPECT_EQ(probe_.get_missed_count(LATENCY_STAGE_PHYSICS), 1u);
+    EXPECT_EQ(probe_.get_missed_count(LATENCY_STAGE_GRASP), 1u);
+}
+
+TEST_F(LatencyProbeTest, StagesWithoutPulseAreMissed)
+{
+    pipeline_.render(memory_);
+    source_.inject();
+
+    // physics steps with old scene, then frame renders old memory
+    const FakeDeviceMemory old_memory;
+    pipeline_.step_physics();
+    pipeline_.render(old_memory);
+    pipeline_.step_physics();
+
+    EXPECT_FALSE(probe_.update(LatencyProbe::Clock::now()));
+    EXPECT_TRUE(probe_.update(source_.get_timeout_time()));
+
+    EXPECT_EQ(probe_.get_pulse_count(), 1u);
+    EXPECT_EQ(probe_.get_end_to_end_histogram().get_snapshot().count, 0u);
+    for (int k = 0; k < LATENCY_STAGE_COUNT; ++k)
+        EXPECT_EQ(probe_.get_missed_count(static_cast<LatencyStage>(k)), 1u);
+}
+
+TEST_F(LatencyProbeTest, PulseOverwrittenByDeviceIsMissed)
+{
+    source_.inject();
+
+    // device writes a new sample before callback
+    memory_.wrists[0] += LVecBase3f(0.0f, 0.0f, 0.005f);
+    pipeline_.render(memory_);
+    pipeline_.step_physics();
+
+    EXPECT_TRUE(probe_.update(source_.get_timeout_time()));
+    EXPECT_EQ(probe_.get_missed_count(LATENCY_STAGE_CALLBACK), 1u);
+    EXPECT_EQ(probe_.get_missed_count(LATENCY_STAGE_PHYSICS), 1u);
+}
@@ -0,0 +1,150 @@
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <boost/property_tree/json_parser.hpp>
+#include <boost/property_tree/xml_parser.hpp>
+
+#include <gtest/gtest.h>
+
+#include "util/performance_report.hpp"
+
+namespace {
+
+PerformanceReport::MetricSummary make_summary(uint64_t count, double mean, double stddev)
+{
+    PerformanceReport::MetricSummary summary;
+    summary.count = count;
+    summary.mean = mean;
+    summary.stddev = stddev;
+    summary.p50 = mean;
+    summary.p95 = mean + 2.0 * stddev;
+    summary.max = mean + 4.0 * stddev;
+    return summary;
+}
+
+PerformanceReport make_report(const std::string& metric, const PerformanceReport::MetricSummary& summary)
+{
+    PerformanceReport report;
+    report.add_metric("single_grasp", metric, summary);
+    return report;
+}
+
+TEST(PerformanceReportTest, SummarizesValues)
+{
+    std::vector<double> values = { 5.0, 1.0, 4.0, 2.0, 3.0 };
+    const auto summary = PerformanceReport::summarize(values);
+
+    EXPECT_EQ(summary.count, 5u);
+    EXPECT_DOUBLE_EQ(summary.mean, 3.0);
+    EXPECT_NEAR(summary.stddev, 1.5811388, 1e-6);
+    EXPECT_DOUBLE_EQ(summary.p50, 3.0);
+    EXPECT_DOUBLE_EQ(summary.p95, 5.0);
+    EXPECT_DOUBLE_EQ(summary.max, 5.0);
+}
+
+TEST(PerformanceReportTest, SummarizesHistogramInMicroseconds)
+{
+    StageHistogram histogram;
+    for (int k = 0; k < 1000; ++k)
+        histogram.record(100000);
+
+    const auto summary = PerformanceReport::summarize(histogram.get_snapshot());
+    EXPECT_EQ(summary.count, 1000u);
+    EXPECT_NEAR(summary.mean, 100.0, 0.5);
+    EXPECT_NEAR(summary.p50, 100.0, 100.0 / 8);
+    EXPECT_NEAR(summary.max, 100.0, 0.5);
+    EXPECT_LT(summary.stddev, 100.0 / 8);
+}
+
+TEST(PerformanceReportTest, RegressesOnlyAboveBothThresholds)
+{
+    const PerformanceReport::Thresholds thresholds;
+    const auto baseline = make_report("frame_ms", make_summary(1000, 10.0, 1.0));
+
+    // 10 % slower with many samples
+    auto regressions = make_report("frame_ms", make_summary(1000, 11.0, 1.0)).compare(baseline, thresholds);
+    ASSERT_EQ(regressions.size(), 1u);
+    EXPECT_EQ(regressions[0].scenario, "single_grasp");
+    EXPECT_EQ(regressions[0].metric, "frame_ms");
+    EXPECT_NEAR(regressions[0].relative, 0.1, 1e-9);
+    EXPECT_GT(regressions[0].z_score, thresholds.z_score);
+
+    // significant, but smaller than min_relative
+    EXPECT_TRUE(make_report("frame_ms", make_summary(1000, 10.3, 1.0)).compare(baseline, thresholds).empty());
+
+    // 10 % slower in a short noisy run
+    EXPECT_TRUE(make_report("frame_ms", make_summary(5, 11.0, 3.0)).compare(baseline, thresholds).empty());
+
+    // faster
+    EXPECT_TRUE(make_report("frame_ms", make_summary(1000, 8.0, 1.0)).compare(baseline, thresholds).empty());
+
+    // thresholds are configurable
+    PerformanceReport::Thresholds strict;
+    strict.min_relative = 0.01;
+    strict.z_score = 2.0;
+    EXPECT_EQ(make_report("frame_ms", make_summary(1000, 10.3, 1.0)).compare(baseline, strict).size(), 1u);
+}
+
+TEST(PerformanceReportTest, ListsMetricsMissingInBaseline)
+{
+    const auto baseline = make_report("frame_ms", make_summary(1000, 10.0, 1.0));
+
+    PerformanceReport current = make_report("frame_ms", make_summary(1000, 20.0, 1.0));
+    current.add_metric("single_grasp", "physics_step_ms", make_summary(1000, 20.0, 1.0));
+    current.add_metric("cube_pile", "frame_ms", make_summary(1000, 20.0, 1.0));
+
+    // only metrics in baseline are compared
+    EXPECT_EQ(current.compare(baseline, PerformanceReport::Thresholds()).size(), 1u);
+
+    const auto missing = current.find_missing(baseline);
+    ASSERT_EQ(missing.size(), 2u);
+    EXPECT_EQ(missing[0], std::make_pair(std::string("cube_pile"), std::string("frame_ms")));
+    EXPECT_EQ(missing[1], std::make_pair(std::string("single_grasp"), std::string("physics_step_ms")));
+}
+
+TEST(PerformanceReportTest, RoundTripsJson)
+{
+    PerformanceReport report = make_report("frame_ms", make_summary(1000, 10.0, 1.0));
+    report.add_metric("single_grasp", "stage_us.Hand Update", make_summary(500, 42.5, 3.25));
+
+    std::stringstream json;
+    boost::property_tree::write_json(json, report.to_ptree());
+
+    boost::property_tree::ptree tree;
+    boost::property_tree::read_json(json, tree);
+    const auto parsed = PerformanceReport::from_ptree(tree);
+
+    // same report has no regression and no missing metric
+    EXPECT_TRUE(report.compare(parsed, PerformanceReport::Thresholds()).empty());
+    EXPECT_TRUE(report.find_missing(parsed).empty());
+
+    const auto summary = parsed.to_ptree().get_child(boost::property_tree::ptree::path_type("scenarios/single_grasp/stage_us.Hand Update", '/'));
+    EXPECT_EQ(summary.get<uint64_t>("count"), 500u);
+    EXPECT_DOUBLE_EQ(summary.get<double>("mean"), 42.5);
+    EXPECT_DOUBLE_EQ(summary.get<double>("stddev"), 3.25);
+}
+
+TEST(PerformanceReportTest, BaselineHasAllScenariosOfSuite)
+{
+    boost::property_tree::ptree config;
+    boost::property_tree::read_xml(CRHANDS_CONFIG_DIR "/DynamicModuleConfiguration.xml", config);
+
+    boost::property_tree::ptree baseline_tree;
+    boost::property_tree::read_json(CRHANDS_RESOURCES_DIR "/benchmark/baseline.json", baseline_tree);
+    ASSERT_NO_THROW(PerformanceReport::from_ptree(baseline_tree));
+
+    const auto& benchmark = config.get_child("modules.CRHands.benchmark");
+    EXPECT_EQ(benchmark.get<std::string>("baseline"), "resources/benchmark/baseline.json");
+
+    int scenario_count = 0;
+    for (const auto& scenario: benchmark.get_child("scenarios"))
+    {
+        const std::string name = scenario.second.get<std::string>("name");
+        EXPECT_TRUE(baseline_tree.get_child_optional(boost::property_tree::ptree::path_type("scenarios/" + name, '/'))) << name;
+        ++scenario_count;
+    }
+    EXPECT_EQ(scenario_count, 4);
+}
+
+}
@@ -0,0 +1,132 @@
+#include <chrono>
+#include <cmath>
+#include <random>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "util/jerk_meter.hpp"
+#include "util/pose_resampler.hpp"
+
+namespace {
+
+using Clock = PoseResampler::Clock;
+
+constexpr int WRIST_INDEX = 0;
+constexpr double TWO_PI = 6.283185307179586;
+
+Clock::time_point to_time_point(double seconds)
+{
+    return Clock::time_point(std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(seconds)));
+}
+
+/** Wrist motion of reaching and shaking hand, meters. */
+LVecBase3f get_wrist_position(double time)
+{
+    return LVecBase3f(
+        static_cast<float>(0.12 * std::sin(TWO_PI * 0.8 * time) + 0.02 * std::sin(TWO_PI * 3.1 * time)),
+        static_cast<float>(0.08 * std::sin(TWO_PI * 1.3 * time + 0.5)),
+        static_cast<float>(0.05 * std::cos(TWO_PI * 0.6 * time)));
+}
+
+/**
+ * Leap-like trace: samples taken at @a sensor_rate with jitter and arriving in device memory after transport delay,
+ * while render callback reads device memory at @a render_rate with jitter.
+ */
+class LeapTrace
+{
+public:
+    LeapTrace(double sensor_rate, double render_rate) : sensor_rate_(sensor_rate), render_rate_(render_rate)
+    {
+        std::mt19937 random(7);
+        std::uniform_real_distribution<double> jitter(-0.0005, 0.0005);
+        for (int k = 0; k < static_cast<int>(DURATION * sensor_rate_); ++k)
+        {
+            const double sample_time = k / sensor_rate_ + jitter(random);
+            arrival_times_.push_back(sample_time + TRANSPORT_DELAY);
+            positions_.push_back(get_wrist_position(sample_time));
+        }
+    }
+
+    /** Read device memory every render frame, and measure jerk of raw and rendered wrist. */
+    void play(PoseResampler& resampler, JerkMeter& raw_meter, JerkMeter& resampled_meter) const
+    {
+        std::mt19937 random(11);
+        std::uniform_real_distribution<double> jitter(-0.0003, 0.0003);
+
+        size_t sample = 0;
+        for (int frame = 10; frame < static_cast<int>((DURATION - 0.1) * render_rate_); ++frame)
+        {
+            const double time = frame / render_rate_ + jitter(random);
+            while (sample + 1 < arrival_times_.size() && arrival_times_[sample + 1] <= time)
+                ++sample;
+
+            resampler.set_input(WRIST_INDEX, LQuaternionf::ident_quat(), positions_[sample]);
+            resampler.commit_input(to_time_point(time));
+            ASSERT_TRUE(resampler.evaluate(to_time_point(time)));
+
+            const LVecBase3f resampled = resampler.get_position(WRIST_INDEX);
+            raw_meter.add(time, &positions_[sample], 1);
+            resampled_meter.add(time, &resampled, 1);
+        }
+    }
+
+private:
+    static constexpr double DURATION = 20.0;
+    static constexpr double TRANSPORT_DELAY = 0.002;
+
+    const double sensor_rate_;
+    const double render_rate_;
+    std::vector<double> arrival_times_;
+    std::vector<LVecBase3f> positions_;
+};
+
+struct JerkResult
+{
+    double raw;
+    double resampled;
+};
+
+JerkResult measure_jerk(double sensor_rate, double render_rate, bool enabled)
+{
+    PoseResampler resampler;
+    resampler.set_enabled(enabled);
+    resampler.set_time_offset(std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(-1.2 / sensor_rate)));
+
+    JerkMeter raw_meter;
+    JerkMeter resampled_meter;
+    LeapTrace(sensor_rate, render_rate).play(resampler, raw_meter, resampled_meter);
+
+    return JerkResult{ raw_meter.get_rms_jerk(), resampled_meter.get_rms_jerk() };
+}
+
+}
+
+TEST(PoseResamplerTest, DisabledByDefaultAndHoldsNewestSample)
+{
+    PoseResampler resampler;
+    EXPECT_FALSE(resampler.is_enabled());
+
+    resampler.set_input(WRIST_INDEX, LQuaternionf::ident_quat(), LVecBase3f(1, 0, 0));
+    resampler.commit_input(to_time_point(1.0));
+    resampler.set_input(WRIST_INDEX, LQuaternionf::ident_quat(), LVecBase3f(2, 0, 0));
+    resampler.commit_input(to_time_point(1.01));
+
+    ASSERT_TRUE(resampler.evaluate(to_time_point(1.005)));
+    EXPECT_EQ(resampler.get_position(WRIST_INDEX), LVecBase3f(2, 0, 0));
+}
+
+TEST(PoseResamplerTest, ReducesJerkOfLeapTrace)
+{
+    // sensor slower than render beats, so samples are held for one or two frames.
+    // (faster sensor skips samples, which cannot be recovered without sample time.)
+    const double rates[][2] = { { 60.0, 90.0 }, { 75.0, 90.0 }, { 45.0, 60.0 } };
+    for (const auto& rate: rates)
+    {
+        const JerkResult disabled = measure_jerk(rate[0], rate[1], false);
+        EXPECT_DOUBLE_EQ(disabled.raw, disabled.resampled);
+
+        const JerkResult enabled = measure_jerk(rate[0], rate[1], true);
+        EXPECT_LT(enabled.resampled, enabled.raw * 0.1) << "sensor " << rate[0] << " Hz, render " << rate[1] << " Hz";
+    }
+}
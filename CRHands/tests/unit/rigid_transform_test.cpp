@@ -0,0 +1,121 @@
+#include <gtest/gtest.h>
+
+#include <compose_matrix.h>
+
+#include <crsf/CRModel/TWorldObject.h>
+
+#include "support/hand_rig.hpp"
+#include "util/rigid_transform.hpp"
+
+namespace {
+
+constexpr float TOLERANCE = 1e-4f;
+
+LMatrix4f compose(const LVecBase3f& scale, const LVecBase3f& shear, const LVecBase3f& hpr, const LVecBase3f& translate)
+{
+    LMatrix4f mat;
+    compose_matrix(mat, scale, shear, hpr, translate, CS_zup_right);
+    return mat;
+}
+
+/** Rotation and translation of @a mat as the grasp path got them before RigidTransform. */
+LMatrix4f get_rigid_matrix_by_hpr(const LMatrix4f& mat)
+{
+    LVecBase3f scale;
+    LVecBase3f shear;
+    LVecBase3f hpr;
+    LVecBase3f translate;
+    decompose_matrix(mat, scale, shear, hpr, translate, CS_zup_right);
+
+    LQuaternionf quat;
+    quat.set_hpr(hpr, CS_zup_right);
+
+    LMatrix4f rot_mat;
+    quat.extract_to_matrix(rot_mat);
+    rot_mat.set_row(3, translate);
+    return rot_mat;
+}
+
+/** Wrist under hand model with non-uniform scale, so wrist matrix in world has shear. */
+class ShearedWristTest : public ::testing::TestWithParam<int>
+{
+protected:
+    void SetUp() override
+    {
+        const float k = static_cast<float>(GetParam());
+        world_.AddWorldObject(&hand_);
+        hand_.AddWorldObject(&wrist_);
+        world_.AddWorldObject(&object_);
+
+        hand_.SetMatrix(compose(LVecBase3f(1.0f + 0.1f * k, 2.0f, 0.5f + 0.2f * k), LVecBase3f(0.1f * k, -0.2f, 0.05f * k),
+            LVecBase3f(20.0f + 35.0f * k, -15.0f + 10.0f * k, 40.0f - 25.0f * k), LVecBase3f(0.3f, -0.1f * k, 0.8f)));
+        wrist_.SetMatrix(compose(LVecBase3f(1.0f), LVecBase3f(0.0f),
+            LVecBase3f(-60.0f + 30.0f * k, 45.0f - 12.0f * k, 10.0f * k), LVecBase3f(0.02f * k, 0.1f, -0.03f)));
+        object_.SetMatrix(compose(LVecBase3f(1.0f), LVecBase3f(0.0f), LVecBase3f(5.0f * k, 70.0f, -30.0f), LVecBase3f(0.4f, 0.5f, 0.9f)));
+    }
+
+    crsf::TWorldObject world_;
+    crsf::TWorldObject hand_;
+    crsf::TWorldObject wrist_;
+    crsf::TWorldObject object_;
+};
+
+}
+
+TEST(RigidTransformTest, MatrixRoundTrip)
+{
+    const RigidTransform transform(make_axis_angle(120.0f, LVecBase3f(-0.2f, 0.9f, 0.4f)), LVecBase3f(0.1f, -0.4f, 1.2f));
+    const RigidTransform converted = RigidTransform::from_matrix(transform.get_matrix());
+
+    EXPECT_TRUE(converted.get_quat().almost_same_direction(transform.get_quat(), TOLERANCE));
+    EXPECT_TRUE(converted.get_pos().almost_equal(transform.get_pos(), TOLERANCE));
+}
+
+TEST_P(ShearedWristTest, RotationMatchesPandaDecomposition)
+{
+    const LMatrix4f wrist_to_world = wrist_.GetMatrix(&world_);
+
+    LVecBase3f scale;
+    LVecBase3f shear;
+    LVecBase3f hpr;
+    decompose_matrix(wrist_to_world.get_upper_3(), scale, shear, hpr, CS_zup_right);
+    ASSERT_GT(shear.length(), 0.01f) << "wrist should be sheared";
+
+    LQuaternionf expected;
+    expected.set_hpr(hpr, CS_zup_right);
+
+    EXPECT_TRUE(RigidTransform::get_rotation(wrist_to_world).almost_same_direction(expected, TOLERANCE));
+}
+
+TEST_P(ShearedWristTest, MatrixMatchesObjectPose)
+{
+    const RigidTransform from_object = RigidTransform::from_object(&wrist_, &world_);
+    const RigidTransform from_matrix = RigidTransform::from_matrix(wrist_.GetMatrix(&world_));
+
+    EXPECT_TRUE(from_matrix.get_quat().almost_same_direction(from_object.get_quat(), TOLERANCE));
+    EXPECT_TRUE(from_matrix.get_pos().almost_equal(from_object.get_pos(), TOLERANCE));
+}
+
+// object_update_event: relative transform at grasp start and object pose while grasped
+TEST_P(ShearedWristTest, GraspMatchesHprPath)
+{
+    const LMatrix4f wrist_to_world = wrist_.GetMatrix(&world_);
+    const LMatrix4f object_to_world = object_.GetMatrix(&world_);
+
+    const LMatrix4f rot_mat = get_rigid_matrix_by_hpr(wrist_to_world);
+    const LMatrix4f expected_fixed = object_to_world * invert(rot_mat);
+
+    const RigidTransform hand_to_world = RigidTransform::from_matrix(wrist_to_world);
+    const LMatrix4f fixed = object_to_world * hand_to_world.get_inverse().get_matrix();
+    EXPECT_TRUE(fixed.almost_equal(expected_fixed, TOLERANCE));
+
+    // wrist moves after grasp start
+    wrist_.SetMatrix(compose(LVecBase3f(1.0f), LVecBase3f(0.0f), LVecBase3f(15.0f, -5.0f, 25.0f), LVecBase3f(0.05f, 0.12f, 0.0f)) * wrist_.GetMatrix());
+    const LMatrix4f moved_wrist_to_world = wrist_.GetMatrix(&world_);
+
+    const LMatrix4f expected_object = expected_fixed * get_rigid_matrix_by_hpr(moved_wrist_to_world);
+    const LMatrix4f object = fixed * RigidTransform::from_matrix(moved_wrist_to_world).get_matrix();
+    EXPECT_TRUE(object.almost_equal(expected_object, TOLERANCE));
+}
+
+INSTANTIATE_TEST_SUITE_P(Poses, ShearedWristTest, ::testing::Range(0, 4));
@@ -0,0 +1,266 @@
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <string>
+
+#include <gtest/gtest.h>
+
+#include "util/session_log.hpp"
+
+namespace {
+
+constexpr uint32_t STEPS_PER_CHUNK = 120;
+constexpr uint64_t STEP_COUNT = 350;
+
+// file header, and chunk header before compressed data (see session_log.cpp)
+constexpr std::streamoff FILE_HEADER_SIZE = 12;
+constexpr std::streamoff CHUNK_HEADER_SIZE = 24;
+constexpr std::streamoff CHUNK_COMPRESSED_SIZE_OFFSET = 16;
+
+SessionStep make_step(uint64_t index)
+{
+    const float t = static_cast<float>(index);
+
+    SessionStep step;
+    step.index = index;
+    step.time = index / 90.0;
+
+    for (int k = 0; k < 3; ++k)
+    {
+        LQuaternionf quat(std::cos(0.01f * t), 0.0f, 0.0f, std::sin(0.01f * t));
+        step.hand_joints.emplace_back(quat, LVecBase3(0.1f * k, 0.001f * t, 0.3f));
+    }
+
+    for (uint32_t id = 0; id < 2; ++id)
+    {
+        const bool is_grasped = id == 0 && (index / 50) % 2 == 1;
+        step.bodies.push_back(SessionBodyState{ id, is_grasped, RigidTransform(LQuaternionf::ident_quat(), LVecBase3(0.0f, 0.2f * id, 0.002f * t)),
+            LVecBase3(0.0f, 0.0f, 0.18f), LVecBase3(0.0f, 0.0f, 0.01f * id) });
+    }
+
+    if (index % 50 == 0)
+        step.grasp_events.push_back(SessionGraspEvent{ 0, (index / 50) % 2 == 1 });
+
+    step.vibration_masks = { static_cast<uint32_t>(index & 0x1F), static_cast<uint32_t>((index >> 1) & 0x1F) };
+
+    return step;
+}
+
+void expect_step_eq(const SessionStep& expected, const SessionStep& actual)
+{
+    EXPECT_EQ(actual.index, expected.index);
+    EXPECT_EQ(actual.time, expected.time);
+
+    ASSERT_EQ(actual.hand_joints.size(), expected.hand_joints.size());
+    for (std::size_t k = 0; k < expected.hand_joints.size(); ++k)
+    {
+        EXPECT_EQ(actual.hand_joints[k].get_pos(), expected.hand_joints[k].get_pos());
+        EXPECT_EQ(actual.hand_joints[k].get_quat(), expected.hand_joints[k].get_quat());
+    }
+
+    ASSERT_EQ(actual.bodies.size(), expected.bodies.size());
+    for (std::size_t k = 0; k < expected.bodies.size(); ++k)
+    {
+        EXPECT_EQ(actual.bodies[k].id, expected.bodies[k].id);
+        EXPECT_EQ(actual.bodies[k].is_grasped, expected.bodies[k].is_grasped);
+        EXPECT_EQ(actual.bodies[k].pose.get_pos(), expected.bodies[k].pose.get_pos());
+        EXPECT_EQ(actual.bodies[k].linear_velocity, expected.bodies[k].linear_velocity);
+        EXPECT_EQ(actual.bodies[k].angular_velocity, expected.bodies[k].angular_velocity);
+    }
+
+    ASSERT_EQ(actual.grasp_events.size(), expected.grasp_events.size());
+    for (std::size_t k = 0; k < expected.grasp_events.size(); ++k)
+    {
+        EXPECT_EQ(actual.grasp_events[k].body_id, expected.grasp_events[k].body_id);
+        EXPECT_EQ(actual.grasp_events[k].is_grasped, expected.grasp_events[k].is_grasped);
+    }
+
+    EXPECT_EQ(actual.vibration_masks, expected.vibration_masks);
+}
+
+class SessionLogTest : public ::testing::Test
+{
+protected:
+    void SetUp() override
+    {
+        path_ = ::testing::TempDir() + "session_log_test_" + ::testing::UnitTest::GetInstance()->current_test_info()->name() + ".crhs";
+
+        SessionLogWriter writer(path_, STEPS_PER_CHUNK);
+        ASSERT_TRUE(writer.is_open());
+        for (uint64_t k = 0; k < STEP_COUNT; ++k)
+            writer.write(make_step(k));
+        writer.close();
+
+        file_size_ = writer.get_file_size();
+    }
+
+    void TearDown() override
+    {
+        std::remove(path_.c_str());
+    }
+
+    std::string read_file() const
+    {
+        std::ifstream file(path_, std::ios::binary);
+        return std::string(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+    }
+
+    void write_file(const std::string& data) const
+    {
+        std::ofstream file(path_, std::ios::binary | std::ios::trunc);
+        file.write(data.data(), data.size());
+    }
+
+    /** Offset of chunk in file, found by chunk headers. */
+    std::streamoff get_chunk_offset(const std::string& data, int chunk) const
+    {
+        std::streamoff offset = FILE_HEADER_SIZE;
+        for (int k = 0; k < chunk; ++k)
+        {
+            uint32_t compressed_size = 0;
+            std::memcpy(&compressed_size, data.data() + offset + CHUNK_COMPRESSED_SIZE_OFFSET, sizeof(compressed_size));
+            offset += CHUNK_HEADER_SIZE + compressed_size;
+        }
+        return offset;
+    }
+
+    std::string path_;
+    uint64_t file_size_ = 0;
+};
+
+TEST_F(SessionLogTest, RoundTripsAllStepsAcrossChunks)
+{
+    SessionLogReader reader(path_);
+    ASSERT_TRUE(reader.is_open());
+    EXPECT_EQ(reader.get_chunk_count(), (STEP_COUNT + STEPS_PER_CHUNK - 1) / STEPS_PER_CHUNK);
+    EXPECT_EQ(reader.get_first_step(), 0u);
+    EXPECT_EQ(reader.get_last_step(), STEP_COUNT - 1);
+
+    SessionStep step;
+    for (uint64_t k = 0; k < STEP_COUNT; ++k)
+    {
+        ASSERT_TRUE(reader.read(step)) << "step " << k;
+        expect_step_eq(make_step(k), step);
+    }
+    EXPECT_FALSE(reader.read(step));
+
+    // steps are compressed
+    EXPECT_LT(file_size_, STEP_COUNT * 200);
+}
+
+TEST_F(SessionLogTest, SeeksToKeyframeAndStepInChunk)
+{
+    SessionLogReader reader(path_);
+    ASSERT_TRUE(reader.is_open());
+
+    EXPECT_EQ(reader.find_keyframe(0), 0u);
+    EXPECT_EQ(reader.find_keyframe(250), 240u);
+    EXPECT_EQ(reader.find_keyframe(STEP_COUNT + 10), 240u);
+
+    SessionStep step;
+    ASSERT_TRUE(reader.seek(250));
+    ASSERT_TRUE(reader.read(step));
+    expect_step_eq(make_step(250), step);
+
+    // backward seek reloads chunk
+    ASSERT_TRUE(reader.seek(119));
+    ASSERT_TRUE(reader.read(step));
+    expect_step_eq(make_step(119), step);
+    ASSERT_TRUE(reader.read(step));
+    expect_step_eq(make_step(120), step);
+
+    EXPECT_FALSE(reader.seek(STEP_COUNT));
+}
+
+TEST_F(SessionLogTest, RebuildsIndexWhenIndexIsLost)
+{
+    // app stopped before writing index
+    const std::string data = read_file();
+    write_file(data.substr(0, static_cast<std::size_t>(get_chunk_offset(data, 3))));
+
+    SessionLogReader reader(path_);
+    ASSERT_TRUE(reader.is_open());
+    EXPECT_EQ(reader.get_chunk_count(), 3u);
+    EXPECT_EQ(reader.get_last_step(), STEP_COUNT - 1);
+
+    SessionStep step;
+    ASSERT_TRUE(reader.seek(300));
+    ASSERT_TRUE(reader.read(step));
+    expect_step_eq(make_step(300), step);
+}
+
+TEST_F(SessionLogTest, DropsTruncatedChunk)
+{
+    // app stopped while writing last chunk
+    const std::string data = read_file();
+    write_file(data.substr(0, static_cast<std::size_t>(get_chunk_offset(data, 2) + CHUNK_HEADER_SIZE + 10)));
+
+    SessionLogReader reader(path_);
+    ASSERT_TRUE(reader.is_open());
+    EXPECT_EQ(reader.get_chunk_count(), 2u);
+    EXPECT_EQ(reader.get_last_step(), 2 * STEPS_PER_CHUNK - 1);
+
+    SessionStep step;
+    for (uint64_t k = 0; k < 2 * STEPS_PER_CHUNK; ++k)
+        ASSERT_TRUE(reader.read(step)) << "step " << k;
+    EXPECT_FALSE(reader.read(step));
+}
+
+TEST_F(SessionLogTest, RejectsCorruptChunkByChecksum)
+{
+    std::string data = read_file();
+    data[static_cast<std::size_t>(get_chunk_offset(data, 1) + CHUNK_HEADER_SIZE + 5)] ^= 0x5A;
+    write_file(data);
+
+    // index is intact, so chunks around the corrupt one are still readable
+    {
+        SessionLogReader reader(path_);
+        ASSERT_TRUE(reader.is_open());
+        EXPECT_EQ(reader.get_chunk_count(), 3u);
+
+        SessionStep step;
+        ASSERT_TRUE(reader.seek(10));
+        ASSERT_TRUE(reader.read(step));
+        expect_step_eq(make_step(10), step);
+
+        EXPECT_FALSE(reader.seek(130));
+
+        ASSERT_TRUE(reader.seek(260));
+        ASSERT_TRUE(reader.read(step));
+        expect_step_eq(make_step(260), step);
+    }
+
+    // without index, scan stops at the corrupt chunk
+    write_file(data.substr(0, static_cast<std::size_t>(get_chunk_offset(data, 3))));
+    {
+        SessionLogReader reader(path_);
+        ASSERT_TRUE(reader.is_open());
+        EXPECT_EQ(reader.get_chunk_count(), 1u);
+        EXPECT_EQ(reader.get_last_step(), STEPS_PER_CHUNK - 1);
+    }
+}
+
+TEST_F(SessionLogTest, RejectsCorruptIndex)
+{
+    // index checksum fails, so chunks are scanned instead
+    std::string data = read_file();
+    data[static_cast<std::size_t>(get_chunk_offset(data, 3) + 6)] ^= 0x01;
+    write_file(data);
+
+    SessionLogReader reader(path_);
+    ASSERT_TRUE(reader.is_open());
+    EXPECT_EQ(reader.get_chunk_count(), 3u);
+    EXPECT_EQ(reader.get_last_step(), STEP_COUNT - 1);
+}
+
+TEST_F(SessionLogTest, RejectsOtherFile)
+{
+    write_file("not a session log");
+
+    SessionLogReader reader(path_);
+    EXPECT_FALSE(reader.is_open());
+}
+
+}
@@ -0,0 +1,72 @@
+#include <memory>
+
+#include <gtest/gtest.h>
+
+#include "hand/grasp_detection.hpp"
+#include "hand/hand_registry.hpp"
+#include "support/grouped_contacts.hpp"
+#include "util/allocation_counter.hpp"
+#include "util/frame_arena.hpp"
+
+namespace {
+
+/** Grasp evaluation of one grouped object in a physics step, with scratch as in the grouped object listener. */
+HandRegistry::HandMask evaluate_step(FrameArena& step_arena, const GroupedContacts& contacts)
+{
+    step_arena.reset();
+
+    FrameVector<crsf::TCRModel*> contacted_children{ FrameAllocator<crsf::TCRModel*>(step_arena) };
+    for (auto child : contacts.get_children())
+    {
+        if (child->is_contacted)
+            contacted_children.push_back(child);
+    }
+
+    auto contacted_hand = make_frame_vectors<crsf::TCRModel*, HandRegistry::MAX_HAND_COUNT>(step_arena);
+    const HandRegistry::HandMask contacted_hand_mask = collect_contacted_hands(contacts.get_hand_registry(),
+        contacted_children.data(), contacted_children.size(), contacted_hand.data());
+
+    HandRegistry::HandMask grasped_hand_mask = 0;
+    for (HandRegistry::HandMask mask = contacted_hand_mask; mask;)
+    {
+        const int n = HandRegistry::pop_hand(mask);
+        if (is_grasping(contacted_hand[n].data(), contacted_hand[n].size()))
+            grasped_hand_mask |= HandRegistry::to_mask(n);
+    }
+
+    FrameVector<crsf::THandPhysicsInteractor*> interactors{ FrameAllocator<crsf::THandPhysicsInteractor*>(step_arena) };
+    for (auto interactor : contacts.get_interactors())
+        interactors.push_back(interactor);
+    find_grasping_side(interactors.data(), interactors.size());
+
+    return grasped_hand_mask;
+}
+
+}
+
+TEST(StepAllocationTest, CountingIsAvailable)
+{
+    // this test binary replaces allocation functions, so a missing replacement makes the tests below vacuous
+    ASSERT_TRUE(AllocationCountScope::is_available());
+
+    AllocationCountScope scope;
+    auto value = std::make_unique<int>(1);
+    EXPECT_EQ(scope.get_count(), 1u);
+}
+
+TEST(StepAllocationTest, SteadyStateGraspStepDoesNotAllocate)
+{
+    const GroupedContacts contacts(8, 27, 4, true);
+    FrameArena step_arena(64 * 1024);
+
+    // warm up, as the app reaches steady state after the first steps
+    const HandRegistry::HandMask first_mask = evaluate_step(step_arena, contacts);
+    EXPECT_NE(first_mask, 0u);
+
+    AllocationCountScope scope;
+    for (int step = 0; step < 100; ++step)
+        EXPECT_EQ(evaluate_step(step_arena, contacts), first_mask);
+
+    EXPECT_EQ(scope.get_count(), 0u);
+    EXPECT_EQ(step_arena.get_overflow_count(), 0u);
+}